@@ -14,13 +14,12 @@ layout(set = 0, binding = 0) uniform Camera
 {
     mat4 view;
     mat4 projection;
-    mat4 viewProjection;
     mat4 inverseView;
     mat4 inverseProjection;
 };
 
 #pragma Model
-layout(set = 1, binding = 0) uniform Model
+layout(push_constant) uniform Model
 {
     mat4 model;
 } model;
@@ -38,5 +37,5 @@ void main()
     vertexData.position = p;
     vertexData.normal = mat3(transpose(inverse(model.model))) * normal;
     vertexData.texCoord0 = texCoord0;
-    gl_Position = viewProjection * vec4(p, 1.0);
+    gl_Position = projection * view * vec4(p, 1.0);
 }
\ No newline at end of file
@@ -5,7 +5,6 @@
 #include "importer.h"
 
 #include <boost/uuid/uuid_io.hpp>
-#include <execution>
 #include <thread>
 #include <fstream>
 #include <iostream>
@@ -22,6 +21,8 @@
 
 #include "../ecs/components/RenderTarget.h"
 #include "../ecs/scene.h"
+#include "context.h"
+#include "core/jobSystem.h"
 #include "ecs/Entity.h"
 #include "ecs/components/camera.h"
 #include "graphics/objects/material.h"
@@ -427,36 +428,40 @@ namespace Coral::Asset {
 			textures.emplace_back(uuid, textureData);
 		}
 
-    	std::vector<Graphics::Texture::Builder> builders;
-    	std::vector<stbi_uc*> datas;
-    	std::mutex mtx;
-        std::for_each(std::execution::par, textures.begin(), textures.end(), [this, &builders, &datas, &mtx] (const auto& texture) {
-        	const auto& [strUuid, textureData] = texture;
-            const auto path = textureData["path"].get<std::string>();
-            const auto size = textureData["size"].get<uint32_t>();
-            const auto textureId = _stringToUuid(strUuid);
-            const auto texturePath = m_path + '/' + path;
-
-            int width, height, channels;
-            stbi_uc* data = stbi_load(path.c_str(), &width, &height, &channels, STBI_rgb_alpha);
-            if (!data) {
-                throw std::runtime_error("Failed to load texture: " + path);
-            }
-
-			{
-				std::lock_guard lock(mtx);
-				auto& builder = builders.emplace_back(Graphics::Texture::Builder(textureId));
-
-				builder.Name(path.substr(path.find_last_of('/') + 1))
-					.Data(data)
-					.Width(width)
-					.Height(height)
-					.Format(vk::Format::eR8G8B8A8Unorm)
-					.CreateMipmaps();
-	        }
-        	datas.emplace_back(data);
+    	struct Decoded {
+    		stbi_uc* data = nullptr;
+    		int width = 0;
+    		int height = 0;
+    	};
+    	std::vector<Decoded> decoded(textures.size());
+        Context::JobSystem().ParallelFor(static_cast<uint32_t>(textures.size()), 1, [&textures, &decoded] (const uint32_t begin, const uint32_t end) {
+        	for (uint32_t i = begin; i < end; i++) {
+        		const auto path = textures[i].second["path"].get<std::string>();
+
+        		int channels;
+        		auto& [data, width, height] = decoded[i];
+        		data = stbi_load(path.c_str(), &width, &height, &channels, STBI_rgb_alpha);
+        		if (!data) {
+        			throw std::runtime_error("Failed to load texture: " + path);
+        		}
+        	}
         });
 
+    	std::vector<Graphics::Texture::Builder> builders;
+    	builders.reserve(textures.size());
+    	for (uint32_t i = 0; i < textures.size(); i++) {
+    		const auto& [strUuid, textureData] = textures[i];
+    		const auto path = textureData["path"].get<std::string>();
+    		auto& builder = builders.emplace_back(Graphics::Texture::Builder(_stringToUuid(strUuid)));
+
+    		builder.Name(path.substr(path.find_last_of('/') + 1))
+				.Data(decoded[i].data)
+				.Width(decoded[i].width)
+				.Height(decoded[i].height)
+				.Format(vk::Format::eR8G8B8A8Unorm)
+				.CreateMipmaps();
+    	}
+
     	for (auto& builder : builders) {
     		auto texture = builder.Build();
 			if (!texture) {
@@ -465,7 +470,7 @@ namespace Coral::Asset {
 			Manager::Get().AddTexture(std::move(texture));
 		}
 
-		for (const auto data : datas) {
+		for (const auto& [data, width, height] : decoded) {
 			stbi_image_free(data);
     	}
 
@@ -41,7 +41,12 @@ namespace Coral::Asset {
     }
 
     void Manager::AddMaterial(std::unique_ptr<Graphics::Material> material) {
-        materials[material->UUID()] = std::move(material);
+    	material->m_tableSlot = m_materialTable->Register(material->Parameters());
+    	auto& slot = materials[material->UUID()];
+    	if (slot) {
+    		m_materialTable->Unregister(slot->TableSlot());
+    	}
+        slot = std::move(material);
     	m_materialsChanged = true;
     }
 
@@ -53,12 +58,18 @@ namespace Coral::Asset {
     }
 
     void Manager::RemoveMaterial(const boost::uuids::uuid &id) {
-        materials.erase(id);
+    	if (const auto it = materials.find(id); it != materials.end()) {
+    		m_materialTable->Unregister(it->second->TableSlot());
+    		materials.erase(it);
+    	}
     	m_materialsChanged = true;
     }
 
     void Manager::AddTexture(std::unique_ptr<Graphics::Texture> texture) {
-        textures.emplace(texture->UUID(), std::move(texture));
+    	auto& registered = *texture;
+        if (textures.emplace(texture->UUID(), std::move(texture)).second) {
+        	registered.m_bindlessSlot = m_textureTable->Register(registered);
+        }
     }
 
 	bool Manager::HasTexture(const boost::uuids::uuid &id) const {
@@ -73,7 +84,13 @@ namespace Coral::Asset {
     }
 
     void Manager::RemoveTexture(const boost::uuids::uuid& id) {
-	    textures.erase(id);
+    	if (const auto it = textures.find(id); it != textures.end()) {
+    		for (const auto& material : materials | std::views::values) {
+    			material->RemoveTexture(*it->second);
+    		}
+    		m_textureTable->Unregister(it->second->BindlessSlot());
+    		textures.erase(it);
+    	}
     	m_texturesChanged = true;
     }
 
@@ -103,6 +120,9 @@ namespace Coral::Asset {
 
     Manager::Manager() {
     	instance = this;
+    	m_geometryPool = std::make_unique<Graphics::GeometryPool>(Graphics::GeometryPool::CreateInfo {});
+    	m_textureTable = std::make_unique<Graphics::TextureTable>();
+    	m_materialTable = std::make_unique<Graphics::MaterialTable>(Graphics::MaterialTable::CreateInfo {});
 
         Reset();
 
@@ -112,9 +132,19 @@ namespace Coral::Asset {
     	m_prefabsList = std::make_unique<Reef::PrefabList>();
     }
 
+	void Manager::Update() const {
+    	m_materialTable->Flush();
+    }
+
 	void Manager::Reset() {
 		meshes.clear();
+    	for (const auto& material : materials | std::views::values) {
+    		m_materialTable->Unregister(material->TableSlot());
+    	}
     	materials.clear();
+    	for (const auto& texture : textures | std::views::values) {
+    		m_textureTable->Unregister(texture->BindlessSlot());
+    	}
     	textures.clear();
     	prefabs.clear();
 
@@ -10,6 +10,9 @@
 #include "graphics/objects/material.h"
 #include "graphics/objects/mesh.h"
 #include "graphics/objects/texture.h"
+#include "graphics/geometryPool.h"
+#include "graphics/materialTable.h"
+#include "graphics/textureTable.h"
 #include "gui/layer.h"
 
 
@@ -53,6 +56,13 @@ namespace Coral::Asset {
 
         Graphics::Mesh* GetRandomMesh();
 
+		[[nodiscard]] Graphics::GeometryPool& GeometryPool() const { return *m_geometryPool; }
+		[[nodiscard]] const Graphics::TextureTable& TextureTable() const { return *m_textureTable; }
+		[[nodiscard]] Graphics::MaterialTable& MaterialTable() const { return *m_materialTable; }
+
+		// Uploads material changes, called once per frame before recording
+		void Update() const;
+
 		static Manager& Get() {
 			return *instance;
 		}
@@ -75,6 +85,11 @@ namespace Coral::Asset {
 
 		inline static Manager* instance = nullptr;
 
+		// Declared before the maps so that they outlive every mesh and texture
+		std::unique_ptr<Graphics::GeometryPool> m_geometryPool;
+		std::unique_ptr<Graphics::TextureTable> m_textureTable;
+		std::unique_ptr<Graphics::MaterialTable> m_materialTable;
+
         inline static auto idProvider = boost::uuids::random_generator();
         boost::unordered_map<boost::uuids::uuid, std::unique_ptr<Graphics::Mesh>> meshes {};
         boost::unordered_map<boost::uuids::uuid, std::unique_ptr<Graphics::Material>> materials {};
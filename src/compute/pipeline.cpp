@@ -8,8 +8,10 @@
 #include <utility>
 #include <ranges>
 
+#include "core/deletionQueue.h"
 #include "core/device.h"
 
+#include "memory/descriptor/layoutCache.h"
 #include "memory/descriptor/setLayout.h"
 #include "memory/descriptor/set.h"
 
@@ -22,15 +24,7 @@ namespace Coral::Compute {
             }
             setLayoutBuilders[set].AddBinding(binding, type, vk::ShaderStageFlagBits::eCompute, count);
         }
-        
-        std::vector<std::unique_ptr<Memory::Descriptor::SetLayout>> setLayouts;
-        for (const auto &layoutBuilder : setLayoutBuilders) {
-            setLayouts.emplace_back(layoutBuilder.Build());
-        }
 
-        std::vector<vk::DescriptorSetLayout> layouts = setLayouts
-            | std::views::transform([](const auto &layout) { return **layout; })
-            | std::ranges::to<std::vector<vk::DescriptorSetLayout>>();
 
         std::vector<vk::PushConstantRange> pushConstantRanges;
         for (const auto &[size, offset, name] : m_shader->PushConstantRanges()) {
@@ -40,11 +34,8 @@ namespace Coral::Compute {
                 .setStageFlags(vk::ShaderStageFlagBits::eCompute));
         }
 
-        const auto pipelineLayoutCreateInfo = vk::PipelineLayoutCreateInfo()
-            .setSetLayouts(layouts)
-            .setPushConstantRanges(pushConstantRanges);
-
-        m_pipelineLayout = Context::Device()->createPipelineLayout(pipelineLayoutCreateInfo);
+        m_layout = Context::LayoutCache().AcquirePipelineLayout(setLayoutBuilders, pushConstantRanges);
+        m_pipelineLayout = **m_layout;
 
         const auto shaderStage = vk::PipelineShaderStageCreateInfo()
             .setStage(vk::ShaderStageFlagBits::eCompute)
@@ -63,9 +54,7 @@ namespace Coral::Compute {
     }
 
     Pipeline::~Pipeline() {
-        Context::Device()->waitIdle();
-        Context::Device()->destroyPipeline(m_pipeline);
-        Context::Device()->destroyPipelineLayout(m_pipelineLayout);
+        Context::DeletionQueue().Retire([handle = m_pipeline] { Context::Device()->destroyPipeline(handle); });
     }
 
     void Pipeline::Bind(const vk::CommandBuffer commandBuffer) const {
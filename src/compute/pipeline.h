@@ -4,6 +4,8 @@
 
 #pragma once
 
+#include <memory>
+
 #include "shader/shader.h"
 
 namespace Coral::Core {
@@ -13,6 +15,7 @@ namespace Coral::Core {
 namespace Coral::Memory::Descriptor {
     class SetLayout;
     class Set;
+    class PipelineLayout;
 }
 
 namespace Coral::Compute {
@@ -38,11 +41,14 @@ namespace Coral::Compute {
         void BindDescriptorSet(uint32_t, vk::CommandBuffer, const Memory::Descriptor::Set &) const;
         void BindDescriptorSets(uint32_t, vk::CommandBuffer, const std::vector<Memory::Descriptor::Set> &) const;
 
+        [[nodiscard]] const Memory::Descriptor::PipelineLayout &Layout() const { return *m_layout; }
+
     private:
         Shader::Shader* m_shader;
         std::string m_kernelName;
 
         vk::Pipeline m_pipeline;
+        std::shared_ptr<const Memory::Descriptor::PipelineLayout> m_layout;
         vk::PipelineLayout m_pipelineLayout;
     };
 }
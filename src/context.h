@@ -18,6 +18,20 @@ namespace Coral
 		class Runtime;
 		class Device;
 		class Scheduler;
+		class JobSystem;
+		class DeletionQueue;
+	}
+
+	namespace Memory
+	{
+		class Allocator;
+		class UploadManager;
+		class SamplerCache;
+	}
+
+	namespace Memory::Descriptor
+	{
+		class LayoutCache;
 	}
 
 	namespace Reef
@@ -31,7 +45,14 @@ namespace Coral
 		static const Core::Runtime& Runtime() { return *m_runtime; }
 		static Core::Device& Device() { return *m_device; }
 		static Core::Scheduler& Scheduler() { return *m_scheduler; }
+		static Core::JobSystem& JobSystem() { return *m_jobSystem; }
+		static Core::DeletionQueue& DeletionQueue() { return *m_deletionQueue; }
+		static Memory::Allocator& Allocator() { return *m_allocator; }
+		static Memory::UploadManager& UploadManager() { return *m_uploadManager; }
+		static Memory::Descriptor::LayoutCache& LayoutCache() { return *m_layoutCache; }
+		static Memory::SamplerCache& SamplerCache() { return *m_samplerCache; }
 		static Reef::Manager& GUIManager() { return *m_guiManager; }
+		static bool HasGUI() { return m_guiManager != nullptr; }
 		static Coral::Scene& Scene() { return *m_scene; }
 
 		static UUID GenerateUUID() { return m_uuidGenerator(); }
@@ -39,12 +60,24 @@ namespace Coral
 		friend class Core::Runtime;
 		friend class Core::Device;
 		friend class Core::Scheduler;
+		friend class Core::JobSystem;
+		friend class Core::DeletionQueue;
+		friend class Memory::Allocator;
+		friend class Memory::UploadManager;
+		friend class Memory::Descriptor::LayoutCache;
+		friend class Memory::SamplerCache;
 		friend class Reef::Manager;
 		friend class Coral::Scene;
 
 		inline static Core::Runtime* m_runtime = nullptr;
 		inline static Core::Device* m_device = nullptr;
 		inline static Core::Scheduler* m_scheduler = nullptr;
+		inline static Core::JobSystem* m_jobSystem = nullptr;
+		inline static Core::DeletionQueue* m_deletionQueue = nullptr;
+		inline static Memory::Allocator* m_allocator = nullptr;
+		inline static Memory::UploadManager* m_uploadManager = nullptr;
+		inline static Memory::Descriptor::LayoutCache* m_layoutCache = nullptr;
+		inline static Memory::SamplerCache* m_samplerCache = nullptr;
 		inline static Reef::Manager* m_guiManager = nullptr;
 		inline static Coral::Scene* m_scene = nullptr;
 
@@ -0,0 +1,92 @@
+//
+// Created by radue on 10/17/2026.
+//
+
+#include "deletionQueue.h"
+
+#include <stdexcept>
+
+#include "context.h"
+#include "device.h"
+
+namespace Coral::Core {
+    DeletionQueue::DeletionQueue() {
+        static bool firstTime = true;
+        if (!firstTime) {
+            throw std::runtime_error("DeletionQueue already created!");
+        }
+        firstTime = false;
+        Context::m_deletionQueue = this;
+    }
+
+    DeletionQueue::~DeletionQueue() {
+        Flush();
+    }
+
+    void DeletionQueue::Retire(std::function<void()> deleter) {
+        {
+            std::lock_guard lock(m_mutex);
+            if (!m_immediate) {
+                m_current.emplace_back(std::move(deleter));
+                return;
+            }
+        }
+        deleter();
+    }
+
+    void DeletionQueue::EndFrame(const Queue& queue, const u64 timelineValue) {
+        std::lock_guard lock(m_mutex);
+        if (m_current.empty()) {
+            return;
+        }
+        m_batches.emplace_back(Batch { .queue = &queue, .timelineValue = timelineValue, .deleters = std::move(m_current) });
+        m_current.clear();
+    }
+
+    void DeletionQueue::Collect() {
+        std::vector<std::function<void()>> deleters;
+        {
+            std::lock_guard lock(m_mutex);
+            // Batches are stamped in submission order, the first one still in flight ends the scan
+            while (!m_batches.empty() && m_batches.front().queue->HasCompleted(m_batches.front().timelineValue)) {
+                auto& batch = m_batches.front().deleters;
+                deleters.insert(deleters.end(), std::make_move_iterator(batch.begin()), std::make_move_iterator(batch.end()));
+                m_batches.pop_front();
+            }
+        }
+        // Deleters may retire other objects, e.g. a pipeline releasing its layout, so they run without the lock
+        Run(deleters);
+    }
+
+    void DeletionQueue::Flush() {
+        // Destroying an object can retire the ones it owns, keep going until nothing is left
+        while (true) {
+            std::vector<std::function<void()>> deleters;
+            {
+                std::lock_guard lock(m_mutex);
+                for (auto& batch : m_batches) {
+                    deleters.insert(deleters.end(), std::make_move_iterator(batch.deleters.begin()), std::make_move_iterator(batch.deleters.end()));
+                }
+                m_batches.clear();
+                deleters.insert(deleters.end(), std::make_move_iterator(m_current.begin()), std::make_move_iterator(m_current.end()));
+                m_current.clear();
+            }
+            if (deleters.empty()) {
+                return;
+            }
+            Run(deleters);
+        }
+    }
+
+    void DeletionQueue::SetImmediate(const bool immediate) {
+        std::lock_guard lock(m_mutex);
+        m_immediate = immediate;
+    }
+
+    void DeletionQueue::Run(std::vector<std::function<void()>>& deleters) {
+        for (auto& deleter : deleters) {
+            deleter();
+        }
+        deleters.clear();
+    }
+}
@@ -0,0 +1,55 @@
+//
+// Created by radue on 10/17/2026.
+//
+
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include "utils/types.h"
+
+namespace Coral::Core {
+    class Queue;
+
+    // Defers destroying Vulkan objects until the GPU is done with them. Everything retired while a frame is recorded is
+    // stamped with that frame's timeline value and destroyed once the value completes, so no owner has to wait for the
+    // device to go idle before letting go of its handles.
+    class DeletionQueue {
+    public:
+        DeletionQueue();
+        ~DeletionQueue();
+
+        DeletionQueue(const DeletionQueue&) = delete;
+        DeletionQueue& operator=(const DeletionQueue&) = delete;
+
+        // Safe from any thread, the deleter runs on the thread calling Collect
+        void Retire(std::function<void()> deleter);
+
+        // Stamps everything retired since the last call with the value signaled by the frame's last submission
+        void EndFrame(const Queue& queue, u64 timelineValue);
+        // Destroys the batches whose frame completed, called at the start of a frame when no command is being recorded
+        void Collect();
+        // Destroys everything, only once the device is idle
+        void Flush();
+
+        // Once the device was waited on for the last time retired objects are destroyed right away
+        void SetImmediate(bool immediate);
+
+    private:
+        struct Batch {
+            const Queue* queue = nullptr;
+            u64 timelineValue = 0;
+            std::vector<std::function<void()>> deleters;
+        };
+
+        static void Run(std::vector<std::function<void()>>& deleters);
+
+        std::mutex m_mutex;
+        std::vector<std::function<void()>> m_current;
+        std::deque<Batch> m_batches;
+        bool m_immediate = false;
+    };
+}
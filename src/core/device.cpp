@@ -10,6 +10,8 @@
 #include <unordered_map>
 
 #include "context.h"
+#include "deletionQueue.h"
+#include "jobSystem.h"
 #include "physicalDevice.h"
 #include "runtime.h"
 
@@ -19,11 +21,12 @@ inline static std::thread::id mainThreadId = std::this_thread::get_id();
 namespace Coral::Core {
     Queue::Family::Family(const uint32_t index, const vk::QueueFamilyProperties &properties, const bool canPresent): m_index(index), m_properties(properties), m_canPresent(canPresent) {
         m_remainingQueues = properties.queueCount;
+        m_submitMutexes = std::make_unique<std::mutex[]>(properties.queueCount);
     }
 
-    std::unique_ptr<Queue> Queue::Family::RequestQueue() {
+    std::unique_ptr<Queue> Queue::Family::RequestQueue(const bool exclusive) {
         try {
-            return std::make_unique<Queue>(*this);
+            return std::make_unique<Queue>(*this, exclusive);
         } catch (const std::runtime_error& err) {
             throw std::runtime_error("QueueFamily::RequestQueue : \n" + std::string(err.what()));
         }
@@ -31,60 +34,115 @@ namespace Coral::Core {
 
     std::unique_ptr<Queue> Queue::Family::RequestPresentQueue() {
         if (m_canPresent) {
-            return std::make_unique<Queue>(*this);
+            return std::make_unique<Queue>(*this, false);
         }
         throw std::runtime_error("QueueFamily::RequestPresentQueue : Queue family cannot present");
     }
 
-    Queue::Queue(class Family &family): m_family(family) {
-        if (m_family.m_remainingQueues == 0) {
+    Queue::Queue(class Family &family, const bool exclusive): m_family(family) {
+        if (m_family.m_remainingQueues > 0) {
+            m_index = m_family.m_properties.queueCount - m_family.m_remainingQueues--;
+        } else if (!exclusive && m_family.m_properties.queueCount > 0) {
+            // Devices exposing a single graphics queue still run the upload manager, the render graph and presentation
+            m_index = m_family.m_nextShared++ % m_family.m_properties.queueCount;
+            m_shared = true;
+        } else {
             throw std::runtime_error("Queue::Queue : No more queues available in this family");
         }
-        m_index = m_family.m_properties.queueCount - m_family.m_remainingQueues--;
         m_handle = Context::Device()->getQueue(m_family.Index(), m_index);
+
+        auto timelineCreateInfo = vk::SemaphoreTypeCreateInfo()
+            .setSemaphoreType(vk::SemaphoreType::eTimeline)
+            .setInitialValue(0);
+        m_timeline = Context::Device()->createSemaphore(vk::SemaphoreCreateInfo().setPNext(&timelineCreateInfo));
     }
 
     Queue::~Queue() {
-        m_family.m_remainingQueues++;
+        Context::Device()->destroySemaphore(m_timeline);
+        if (!m_shared) {
+            m_family.m_remainingQueues++;
+        }
     }
 
-    CommandBuffer::CommandBuffer(const Core::Queue& queue, const vk::CommandBuffer commandBuffer, const vk::CommandPool& parentCommandPool)
-        : m_queue(queue), m_parentPool(parentCommandPool) {
-        m_handle = commandBuffer;
-        m_signalSemaphore = Context::Device()->createSemaphore({});
-        m_fence = Context::Device()->createFence(vk::FenceCreateInfo().setFlags(vk::FenceCreateFlagBits::eSignaled));
+    u64 Queue::Submit(const std::vector<Submission>& submissions, const vk::Fence fence) const {
+        if (submissions.empty()) {
+            return m_submittedValue;
+        }
+
+        std::vector<std::vector<vk::CommandBufferSubmitInfo>> commandBufferInfos;
+        std::vector<std::vector<vk::SemaphoreSubmitInfo>> signalInfos;
+        std::vector<vk::SubmitInfo2> submitInfos;
+        commandBufferInfos.reserve(submissions.size());
+        signalInfos.reserve(submissions.size());
+        submitInfos.reserve(submissions.size());
+
+        u64 value = m_submittedValue;
+        for (const auto& submission : submissions) {
+            auto& commandBuffers = commandBufferInfos.emplace_back();
+            for (const auto commandBuffer : submission.commandBuffers) {
+                commandBuffers.emplace_back(vk::CommandBufferSubmitInfo().setCommandBuffer(commandBuffer));
+            }
+
+            auto& signals = signalInfos.emplace_back(submission.signalSemaphores);
+            signals.emplace_back(vk::SemaphoreSubmitInfo()
+                .setSemaphore(m_timeline)
+                .setValue(++value)
+                .setStageMask(submission.signalStages));
+
+            submitInfos.emplace_back(vk::SubmitInfo2()
+                .setWaitSemaphoreInfos(submission.waitSemaphores)
+                .setCommandBufferInfos(commandBuffers)
+                .setSignalSemaphoreInfos(signals));
+        }
+
+        std::lock_guard lock(m_family.m_submitMutexes[m_index]);
+        m_handle.submit2(submitInfos, fence);
+        m_submittedValue = value;
+        return m_submittedValue;
     }
 
-    CommandBuffer::~CommandBuffer() {
-        Context::Device().FreeCommandBuffer(*this);
+    vk::Result Queue::Present(const vk::PresentInfoKHR& presentInfo) const {
+        std::lock_guard lock(m_family.m_submitMutexes[m_index]);
+        return m_handle.presentKHR(presentInfo);
+    }
 
-        Context::Device()->destroySemaphore(m_signalSemaphore);
-        Context::Device()->destroyFence(m_fence);
+    vk::SemaphoreSubmitInfo Queue::TimelineWait(const u64 value, const vk::PipelineStageFlags2 stages) const {
+        return vk::SemaphoreSubmitInfo()
+            .setSemaphore(m_timeline)
+            .setValue(value)
+            .setStageMask(stages);
     }
 
-	void CommandBuffer::Run(const std::function<void(const Core::CommandBuffer&)>& command, vk::Semaphore waitSemaphore) const {
-    	m_handle.begin(vk::CommandBufferBeginInfo().setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
-    	command(*this);
-    	m_handle.end();
+    u64 Queue::CompletedValue() const {
+        m_completedValue = Context::Device()->getSemaphoreCounterValue(m_timeline);
+        return m_completedValue;
+    }
 
-    	const auto commandBuffers = std::array { m_handle };
-    	const auto dstStageMask = std::vector<vk::PipelineStageFlags> { vk::PipelineStageFlagBits::eAllCommands };
-    	auto submitInfo = vk::SubmitInfo()
-			.setCommandBuffers(commandBuffers);
+    bool Queue::HasCompleted(const u64 value) const {
+        return value <= m_completedValue || value <= CompletedValue();
+    }
 
-    	if (waitSemaphore != nullptr)
-    		submitInfo
-				.setWaitSemaphores(waitSemaphore)
-				.setWaitDstStageMask(dstStageMask);
+    void Queue::Wait(const u64 value) const {
+        if (HasCompleted(value)) {
+            return;
+        }
 
-    	if (m_signalSemaphore != nullptr)
-    		submitInfo.setSignalSemaphores(m_signalSemaphore);
+        const auto waitInfo = vk::SemaphoreWaitInfo()
+            .setSemaphores(m_timeline)
+            .setValues(value);
+        if (const auto result = Context::Device()->waitSemaphores(waitInfo, UINT64_MAX); result != vk::Result::eSuccess) {
+            throw std::runtime_error("Queue::Wait : Failed to wait timeline: " + vk::to_string(result));
+        }
+        m_completedValue = std::max(m_completedValue, value);
+    }
 
-    	try {
-    		m_queue->submit(submitInfo, m_fence);
-    	} catch (const std::runtime_error& e) {
-    		std::cerr << e.what() << std::endl;
-    	}
+    CommandBuffer::CommandBuffer(const Core::Queue& queue, const vk::CommandBuffer commandBuffer, const vk::CommandPool& parentCommandPool)
+        : m_queue(queue), m_parentPool(parentCommandPool) {
+        m_handle = commandBuffer;
+    }
+
+    CommandBuffer::~CommandBuffer() {
+        Context::Device().FreeCommandBuffer(*this);
     }
 
     Device::Device() {
@@ -98,7 +156,7 @@ namespace Coral::Core {
         const auto& physicalDevice = Runtime::Get().PhysicalDevice();
         for (const auto& queueFamily : physicalDevice.QueueFamilyProperties()) {
             const auto queueFamilyIndex = static_cast<uint32_t>(&queueFamily - physicalDevice.QueueFamilyProperties().data());
-            const bool canPresent = physicalDevice->getSurfaceSupportKHR(queueFamilyIndex, physicalDevice.Surface());
+            const bool canPresent = physicalDevice.Surface() && physicalDevice->getSurfaceSupportKHR(queueFamilyIndex, physicalDevice.Surface());
 
             m_queueFamilies.emplace_back(queueFamilyIndex, queueFamily, canPresent);
         }
@@ -117,9 +175,30 @@ namespace Coral::Core {
             .setTaskShader(false)
             .setMeshShader(true);
 
+        auto timelineSemaphoreFeatures = vk::PhysicalDeviceTimelineSemaphoreFeatures()
+            .setTimelineSemaphore(true)
+            .setPNext(&deviceMeshShaderFeatures);
+
+        auto synchronization2Features = vk::PhysicalDeviceSynchronization2Features()
+            .setSynchronization2(true)
+            .setPNext(&timelineSemaphoreFeatures);
+
+        auto dynamicRenderingFeatures = vk::PhysicalDeviceDynamicRenderingFeatures()
+            .setDynamicRendering(true)
+            .setPNext(&synchronization2Features);
+
+        // Bindless texture table
+        auto descriptorIndexingFeatures = vk::PhysicalDeviceDescriptorIndexingFeatures()
+            .setShaderSampledImageArrayNonUniformIndexing(true)
+            .setDescriptorBindingSampledImageUpdateAfterBind(true)
+            .setDescriptorBindingUpdateUnusedWhilePending(true)
+            .setDescriptorBindingPartiallyBound(true)
+            .setRuntimeDescriptorArray(true)
+            .setPNext(&dynamicRenderingFeatures);
+
         auto maintenance4Features = vk::PhysicalDeviceMaintenance4Features()
             .setMaintenance4(true)
-            .setPNext(&deviceMeshShaderFeatures);
+            .setPNext(&descriptorIndexingFeatures);
 
         const auto deviceCreateInfo = vk::DeviceCreateInfo()
             .setQueueCreateInfos(queueCreateInfos)
@@ -133,11 +212,17 @@ namespace Coral::Core {
         for (const auto& queueFamily : m_queueFamilies) {
             m_commandPools[queueFamily.Index()] = {};
         }
-        CreateCommandPools(0);
+        // Every thread recording commands gets its own pools, vkCommandPool is externally synchronized
+        m_recordingThreadCount = Context::JobSystem().WorkerCount();
+        for (u32 i = 0; i <= m_recordingThreadCount; i++) {
+            CreateCommandPools(i);
+        }
     }
 
     Device::~Device() {
-        FreeCommandPools(0);
+        for (u32 i = 0; i <= m_recordingThreadCount; i++) {
+            FreeCommandPools(i);
+        }
         m_handle.waitIdle();
         m_handle.destroy();
     }
@@ -158,15 +243,21 @@ namespace Coral::Core {
         }
     }
 
-    std::unique_ptr<Queue> Device::RequestQueue(const vk::QueueFlags type) {
-        for (auto& queueFamily : m_queueFamilies) {
-            if (!(queueFamily.Properties().queueFlags & type)) {
-                continue;
+    std::unique_ptr<Queue> Device::RequestQueue(const vk::QueueFlags type, const vk::QueueFlags excluded, const bool exclusive) {
+        // A free queue of any matching family beats sharing one of the first
+        for (const bool share : { false, !exclusive }) {
+            for (auto& queueFamily : m_queueFamilies) {
+                if (!(queueFamily.Properties().queueFlags & type) || queueFamily.Properties().queueFlags & excluded) {
+                    continue;
+                }
+                try {
+                    return queueFamily.RequestQueue(!share);
+                } catch (const std::runtime_error&) {
+                    continue;
+                }
             }
-            try {
-                return queueFamily.RequestQueue();
-            } catch (const std::runtime_error&) {
-                continue;
+            if (!share && exclusive) {
+                break;
             }
         }
         throw std::runtime_error("Queue::RequestQueue : Failed to find queue with requested flags");
@@ -183,18 +274,21 @@ namespace Coral::Core {
         throw std::runtime_error("Device::RequestPresentQueue: Failed to find suitable present queue!");
     }
 
-    std::unique_ptr<CommandBuffer> Device::RequestCommandBuffer(const Core::Queue& queue, const uint32_t thread) const {
+    std::unique_ptr<CommandBuffer> Device::RequestCommandBuffer(const Core::Queue& queue, const uint32_t thread, const vk::CommandBufferLevel level) const {
         const auto& commandPool = m_commandPools.at(queue.Family().Index()).at(thread);
         const auto commandBufferAllocInfo = vk::CommandBufferAllocateInfo()
             .setCommandPool(commandPool)
-            .setLevel(vk::CommandBufferLevel::ePrimary)
+            .setLevel(level)
             .setCommandBufferCount(1);
         const auto commandBuffers = m_handle.allocateCommandBuffers(commandBufferAllocInfo);
         return std::make_unique<CommandBuffer>(queue, commandBuffers.front(), commandPool);
     }
 
     void Device::FreeCommandBuffer(const CommandBuffer &commandBuffer) const {
-        m_handle.freeCommandBuffers(commandBuffer.ParentPool(), *commandBuffer);
+        // Runs at the start of a later frame on the main thread, when no worker records into the pool
+        Context::DeletionQueue().Retire([this, pool = commandBuffer.ParentPool(), handle = *commandBuffer] {
+            m_handle.freeCommandBuffers(pool, handle);
+        });
     }
 
     const PhysicalDevice& Device::QuerySurfaceCapabilities() const {
@@ -216,43 +310,4 @@ namespace Coral::Core {
         std::cerr << "Failed to find suitable memory type!" << std::endl;
         return std::nullopt;
     }
-
-    void Device::RunSingleTimeCommand(const std::function<void(const Core::CommandBuffer&)> &command, const vk::QueueFlags requiredFlags,
-        const vk::Fence fence, vk::Semaphore waitSemaphore, vk::Semaphore signalSemaphore, bool wait) {
-        const auto threadId = std::this_thread::get_id();
-        uint32_t thread = std::hash<std::thread::id>()(threadId);
-        if (threadId == mainThreadId) {
-            thread = 0;
-        }
-
-        const auto queue = RequestQueue(requiredFlags);
-        const auto commandBuffer = RequestCommandBuffer(*queue, thread);
-
-        (*commandBuffer)->begin(vk::CommandBufferBeginInfo().setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
-        command(*commandBuffer);
-        (*commandBuffer)->end();
-
-        const auto commandBuffers = std::array { **commandBuffer };
-        const auto dstStageMask = std::vector<vk::PipelineStageFlags> { vk::PipelineStageFlagBits::eAllCommands };
-        auto submitInfo = vk::SubmitInfo()
-            .setCommandBuffers(commandBuffers);
-
-        if (waitSemaphore != nullptr)
-            submitInfo
-                .setWaitSemaphores(waitSemaphore)
-                .setWaitDstStageMask(dstStageMask);
-
-        if (signalSemaphore != nullptr)
-            submitInfo.setSignalSemaphores(signalSemaphore);
-
-        try {
-            (*queue)->submit(submitInfo, fence);
-        } catch (const std::runtime_error& e) {
-            std::cerr << e.what() << std::endl;
-        }
-    	if (wait) {
-			(*queue)->waitIdle();
-		}
-    }
 }
-
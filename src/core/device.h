@@ -5,6 +5,7 @@
 #pragma once
 
 #include <functional>
+#include <mutex>
 #include <optional>
 #include <unordered_map>
 
@@ -31,7 +32,7 @@ namespace Coral::Core {
             [[nodiscard]] const vk::QueueFamilyProperties& Properties() const { return m_properties; }
             [[nodiscard]] bool CanPresent() const { return m_canPresent; }
 
-            [[nodiscard]] std::unique_ptr<Queue> RequestQueue();
+            [[nodiscard]] std::unique_ptr<Queue> RequestQueue(bool exclusive);
             [[nodiscard]] std::unique_ptr<Queue> RequestPresentQueue();
 
         private:
@@ -39,36 +40,61 @@ namespace Coral::Core {
             vk::QueueFamilyProperties m_properties;
             uint32_t m_remainingQueues = 0;
             bool m_canPresent = false;
+            // Once every queue is handed out, shared requests get the existing handles round robin
+            uint32_t m_nextShared = 0;
+            // Submitting and presenting need the handle externally synchronized, shared handles have several Queue objects
+            std::unique_ptr<std::mutex[]> m_submitMutexes;
         };
 
-        explicit Queue(Family& family);
+        struct Submission {
+            std::vector<vk::CommandBuffer> commandBuffers;
+            std::vector<vk::SemaphoreSubmitInfo> waitSemaphores;
+            std::vector<vk::SemaphoreSubmitInfo> signalSemaphores;
+            vk::PipelineStageFlags2 signalStages = vk::PipelineStageFlagBits2::eAllCommands;
+        };
+
+        // A shared queue submits to a handle another Queue owns, it keeps its own timeline
+        Queue(Family& family, bool exclusive);
         ~Queue() override;
 
         [[nodiscard]] uint32_t Index() const { return m_index; }
         [[nodiscard]] const Family& Family() const { return m_family; }
+        [[nodiscard]] bool Shared() const { return m_shared; }
+
+        // Submits all batches with a single vkQueueSubmit2, batch i signals the timeline with SubmittedValue() + i + 1.
+        // Returns the timeline value signaled by the last batch.
+        u64 Submit(const std::vector<Submission>& submissions, vk::Fence fence = nullptr) const;
+
+        vk::Result Present(const vk::PresentInfoKHR& presentInfo) const;
+
+        [[nodiscard]] vk::Semaphore Timeline() const { return m_timeline; }
+        [[nodiscard]] vk::SemaphoreSubmitInfo TimelineWait(u64 value, vk::PipelineStageFlags2 stages) const;
+        [[nodiscard]] u64 SubmittedValue() const { return m_submittedValue; }
+        [[nodiscard]] u64 CompletedValue() const;
+        [[nodiscard]] bool HasCompleted(u64 value) const;
+        void Wait(u64 value) const;
 
     private:
         uint32_t m_index;
         class Family& m_family;
+        bool m_shared = false;
+
+        vk::Semaphore m_timeline;
+        mutable u64 m_submittedValue = 0;
+        mutable u64 m_completedValue = 0;
     };
 
     class CommandBuffer final : public EngineWrapper<vk::CommandBuffer> {
     public:
         CommandBuffer(const Core::Queue& queue, vk::CommandBuffer commandBuffer, const vk::CommandPool& parentCommandPool);
         ~CommandBuffer() override;
-		void Run(const std::function<void(const Core::CommandBuffer&)>& command, vk::Semaphore waitSemaphore = nullptr) const;
 
 		[[nodiscard]] const vk::CommandPool& ParentPool() const { return m_parentPool; }
-        [[nodiscard]] const vk::Semaphore& SignalSemaphore() const { return m_signalSemaphore; }
-        [[nodiscard]] const vk::Fence& Fence() const { return m_fence; }
     	[[nodiscard]] const Core::Queue& Queue() const { return m_queue; }
 
     private:
     	const Core::Queue& m_queue;
         const vk::CommandPool& m_parentPool;
-
-        vk::Semaphore m_signalSemaphore;
-        vk::Fence m_fence;
     };
 
     class Device final : public EngineWrapper<vk::Device> {
@@ -79,23 +105,26 @@ namespace Coral::Core {
         Device(const Device &) = delete;
         Device &operator=(const Device &) = delete;
 
-        [[nodiscard]] std::unique_ptr<Queue> RequestQueue(vk::QueueFlags type);
+        // Families exposing any of the excluded flags are skipped, which allows asking for dedicated transfer or compute queues.
+        // When every matching queue is taken, a non-exclusive request shares one instead of failing.
+        [[nodiscard]] std::unique_ptr<Queue> RequestQueue(vk::QueueFlags type, vk::QueueFlags excluded = {}, bool exclusive = false);
         [[nodiscard]] std::unique_ptr<Queue> RequestPresentQueue();
 
         void CreateCommandPools(uint32_t threadId);
         void FreeCommandPools(uint32_t threadId);
 
-        [[nodiscard]] std::unique_ptr<CommandBuffer> RequestCommandBuffer(const Core::Queue& queue, uint32_t thread = 0) const;
+        [[nodiscard]] std::unique_ptr<CommandBuffer> RequestCommandBuffer(const Core::Queue& queue, uint32_t thread = 0, vk::CommandBufferLevel level = vk::CommandBufferLevel::ePrimary) const;
         void FreeCommandBuffer(const CommandBuffer &commandBuffer) const;
 
+        // One pool per JobSystem thread index, 0 being the main thread and 1..RecordingThreadCount() the workers
+        [[nodiscard]] u32 RecordingThreadCount() const { return m_recordingThreadCount; }
+
         [[nodiscard]] const PhysicalDevice& QuerySurfaceCapabilities() const;
         [[nodiscard]] std::optional<uint32_t> FindMemoryType(uint32_t typeFilter, vk::MemoryPropertyFlags properties) const;
 
-        void RunSingleTimeCommand(const std::function<void(const Core::CommandBuffer&)> &command, vk::QueueFlags requiredFlags,
-            vk::Fence fence = nullptr, vk::Semaphore waitSemaphore = nullptr, vk::Semaphore signalSemaphore = nullptr, bool wait = true);
-
     private:
         std::vector<class Queue::Family> m_queueFamilies;
         std::unordered_map<uint32_t, std::unordered_map<uint32_t, vk::CommandPool>> m_commandPools;
+        u32 m_recordingThreadCount = 1;
     };
 }
@@ -0,0 +1,73 @@
+//
+// Created by radue on 10/17/2026.
+//
+
+#include "framePacer.h"
+
+#include <thread>
+
+#include "window.h"
+
+namespace Coral::Core {
+    static constexpr f64 Smoothing = 0.05;
+
+    static f64 Milliseconds(const FramePacer::Clock::duration duration) {
+        return std::chrono::duration<f64, std::milli>(duration).count();
+    }
+
+    FramePacer::FramePacer(const CreateInfo& createInfo)
+        : m_presentMode(createInfo.presentMode), m_targetFrameRate(createInfo.targetFrameRate), m_spinThreshold(createInfo.spinThreshold) {}
+
+    void FramePacer::WaitForNextFrame() {
+        auto now = Clock::now();
+        if (m_targetFrameRate > 0.0f) {
+            const auto period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<f64>(1.0 / m_targetFrameRate));
+
+            // Sleeping overshoots by up to a scheduler quantum, the tail is spun instead
+            if (const auto sleepUntil = m_nextFrame - m_spinThreshold; now < sleepUntil) {
+                std::this_thread::sleep_until(sleepUntil);
+            }
+            while ((now = Clock::now()) < m_nextFrame) {
+                std::this_thread::yield();
+            }
+
+            // After a long stall restart the schedule instead of rushing frames to catch up
+            m_nextFrame = std::max(m_nextFrame + period, now);
+        }
+
+        m_statistics.frameTime = Milliseconds(now - m_lastFrame);
+        m_statistics.averageFrameTime += (m_statistics.frameTime - m_statistics.averageFrameTime) * Smoothing;
+        m_lastFrame = now;
+    }
+
+    void FramePacer::LatchInput() {
+        Window::Get().PollEvents();
+        m_inputLatched = Clock::now();
+    }
+
+    void FramePacer::MarkSubmitted() {
+        m_statistics.inputToSubmit = Milliseconds(Clock::now() - m_inputLatched);
+        m_statistics.averageInputToSubmit += (m_statistics.inputToSubmit - m_statistics.averageInputToSubmit) * Smoothing;
+    }
+
+    void FramePacer::SetPresentMode(const vk::PresentModeKHR presentMode) {
+        if (presentMode == m_presentMode) {
+            return;
+        }
+        m_presentMode = presentMode;
+        m_presentModeChanged = true;
+    }
+
+    std::optional<vk::PresentModeKHR> FramePacer::ConsumePresentModeChange() {
+        if (!m_presentModeChanged) {
+            return std::nullopt;
+        }
+        m_presentModeChanged = false;
+        return m_presentMode;
+    }
+
+    void FramePacer::SetTargetFrameRate(const f32 targetFrameRate) {
+        m_targetFrameRate = std::max(0.0f, targetFrameRate);
+        m_nextFrame = Clock::now();
+    }
+}
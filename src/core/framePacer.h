@@ -0,0 +1,67 @@
+//
+// Created by radue on 10/17/2026.
+//
+
+#pragma once
+
+#include <chrono>
+#include <optional>
+
+#include <vulkan/vulkan.hpp>
+
+#include "utils/types.h"
+
+namespace Coral::Core {
+    // Paces the main loop to a target frame rate, owns the requested present mode and
+    // measures how old the latched input is by the time its frame gets submitted.
+    class FramePacer {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        struct CreateInfo {
+            vk::PresentModeKHR presentMode = vk::PresentModeKHR::eMailbox;
+            // 0 leaves the frame rate to the present mode
+            f32 targetFrameRate = 0.0f;
+            // The limiter sleeps until this close to the deadline and spins for the rest
+            std::chrono::microseconds spinThreshold = std::chrono::microseconds(1500);
+        };
+
+        struct Statistics {
+            f64 frameTime = 0.0;
+            f64 inputToSubmit = 0.0;
+            f64 averageFrameTime = 0.0;
+            f64 averageInputToSubmit = 0.0;
+        };
+
+        explicit FramePacer(const CreateInfo& createInfo);
+
+        // Blocks until the next frame is due
+        void WaitForNextFrame();
+        // Polls the window as late as possible and remembers when the input was sampled
+        void LatchInput();
+        void MarkSubmitted();
+
+        void SetPresentMode(vk::PresentModeKHR presentMode);
+        [[nodiscard]] vk::PresentModeKHR PresentMode() const { return m_presentMode; }
+        // Returns the new mode once after SetPresentMode, the swap chain has to be recreated with it
+        [[nodiscard]] std::optional<vk::PresentModeKHR> ConsumePresentModeChange();
+
+        void SetTargetFrameRate(f32 targetFrameRate);
+        [[nodiscard]] f32 TargetFrameRate() const { return m_targetFrameRate; }
+
+        // Times in milliseconds, averages are exponentially smoothed
+        [[nodiscard]] const Statistics& Stats() const { return m_statistics; }
+
+    private:
+        vk::PresentModeKHR m_presentMode;
+        bool m_presentModeChanged = false;
+
+        f32 m_targetFrameRate;
+        std::chrono::microseconds m_spinThreshold;
+        Clock::time_point m_nextFrame = Clock::now();
+        Clock::time_point m_lastFrame = Clock::now();
+        Clock::time_point m_inputLatched = Clock::now();
+
+        Statistics m_statistics;
+    };
+}
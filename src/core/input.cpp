@@ -99,7 +99,8 @@ namespace Coral {
 
 	void Input::Callbacks::mouseMoveCallback(GLFWwindow *, const double x, const double y) {
     	const Math::Vector2i pos { static_cast<i32>(x), static_cast<i32>(y) };
-    	m_mouseDelta = pos - m_mousePosition;
+    	// Accumulated, the window may be polled more than once per frame
+    	m_mouseDelta = m_mouseDelta + (pos - m_mousePosition);
     	m_mousePosition = pos;
 
     }
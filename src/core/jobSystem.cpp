@@ -0,0 +1,214 @@
+//
+// Created by radue on 10/17/2026.
+//
+
+#include "jobSystem.h"
+
+#include <exception>
+
+#include "context.h"
+
+namespace Coral::Core {
+    JobSystem::JobSystem(const CreateInfo& createInfo) {
+		static bool firstTime = true;
+		if (!firstTime) {
+			throw std::runtime_error("JobSystem already created!");
+		}
+		firstTime = false;
+        Context::m_jobSystem = this;
+        s_mainThread = std::this_thread::get_id();
+
+        auto workerCount = createInfo.workerCount;
+        if (workerCount == 0) {
+            workerCount = std::max(1u, std::thread::hardware_concurrency()) - 1;
+        }
+        workerCount = std::max(1u, workerCount);
+
+        for (u32 i = 0; i <= workerCount; i++) {
+            m_queues.emplace_back(std::make_unique<WorkQueue>());
+        }
+        for (u32 i = 1; i <= workerCount; i++) {
+            m_workers.emplace_back(&JobSystem::WorkerLoop, this, i);
+        }
+    }
+
+    JobSystem::~JobSystem() {
+        {
+            std::lock_guard lock(m_sleepMutex);
+            m_stop = true;
+        }
+        m_wake.notify_all();
+        for (auto& worker : m_workers) {
+            worker.join();
+        }
+        Context::m_jobSystem = nullptr;
+    }
+
+    void JobSystem::Run(Job job, Counter* counter, Counter* dependency) {
+        if (counter) {
+            counter->m_value.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        if (dependency) {
+            std::lock_guard lock(dependency->m_mutex);
+            if (!dependency->Done()) {
+                dependency->m_continuations.emplace_back(Counter::Continuation { .job = std::move(job), .counter = counter });
+                return;
+            }
+        }
+        Push(Task { .job = std::move(job), .counter = counter });
+    }
+
+    void JobSystem::RunOnMainThread(Job job, Counter* counter) {
+        if (counter) {
+            counter->m_value.fetch_add(1, std::memory_order_relaxed);
+        }
+        std::lock_guard lock(m_mainThreadQueue.mutex);
+        m_mainThreadQueue.tasks.emplace_back(Task { .job = std::move(job), .counter = counter });
+    }
+
+    void JobSystem::Wait(Counter& counter) {
+        while (!counter.Done()) {
+            if (IsMainThread()) {
+                ProcessMainThreadJobs();
+            }
+
+            if (Task task; Next(task)) {
+                Execute(task);
+            } else {
+                std::this_thread::yield();
+            }
+        }
+        // The finishing thread may still hold the lock, the counter must outlive it
+        std::lock_guard lock(counter.m_mutex);
+    }
+
+    void JobSystem::ProcessMainThreadJobs() {
+        if (!IsMainThread()) {
+            throw std::runtime_error("JobSystem::ProcessMainThreadJobs : Called outside the main thread");
+        }
+
+        std::deque<Task> tasks;
+        {
+            std::lock_guard lock(m_mainThreadQueue.mutex);
+            tasks.swap(m_mainThreadQueue.tasks);
+        }
+        for (auto& task : tasks) {
+            Execute(task);
+        }
+    }
+
+    void JobSystem::ParallelFor(const u32 count, u32 grainSize, const std::function<void(u32 begin, u32 end)>& function) {
+        if (count == 0) {
+            return;
+        }
+        grainSize = std::max(1u, grainSize);
+        if (count <= grainSize) {
+            function(0, count);
+            return;
+        }
+
+        Counter counter;
+        std::exception_ptr exception;
+        std::mutex exceptionMutex;
+        for (u32 begin = 0; begin < count; begin += grainSize) {
+            const auto end = std::min(count, begin + grainSize);
+            Run([&, begin, end] {
+                try {
+                    function(begin, end);
+                } catch (...) {
+                    std::lock_guard lock(exceptionMutex);
+                    if (!exception) {
+                        exception = std::current_exception();
+                    }
+                }
+            }, &counter);
+        }
+        Wait(counter);
+
+        if (exception) {
+            std::rethrow_exception(exception);
+        }
+    }
+
+    void JobSystem::WorkerLoop(const u32 index) {
+        s_threadIndex = index;
+        while (true) {
+            if (Task task; Next(task)) {
+                Execute(task);
+                continue;
+            }
+
+            std::unique_lock lock(m_sleepMutex);
+            m_wake.wait(lock, [this] { return m_stop || m_queuedTasks.load() > 0; });
+            if (m_stop) {
+                return;
+            }
+        }
+    }
+
+    void JobSystem::Push(Task task) {
+        auto& queue = *m_queues[s_threadIndex < m_queues.size() ? s_threadIndex : 0];
+        {
+            std::lock_guard lock(queue.mutex);
+            queue.tasks.emplace_back(std::move(task));
+        }
+        m_queuedTasks.fetch_add(1);
+
+        // Taking the lock orders the push with a worker that just checked the predicate and is about to sleep
+        { std::lock_guard lock(m_sleepMutex); }
+        m_wake.notify_one();
+    }
+
+    bool JobSystem::Next(Task& task) {
+        const auto count = static_cast<u32>(m_queues.size());
+        const auto own = s_threadIndex < count ? s_threadIndex : 0;
+
+        // Newest work from the own queue first, it is the most likely to still be in cache
+        {
+            auto& queue = *m_queues[own];
+            std::lock_guard lock(queue.mutex);
+            if (!queue.tasks.empty()) {
+                task = std::move(queue.tasks.back());
+                queue.tasks.pop_back();
+                m_queuedTasks.fetch_sub(1);
+                return true;
+            }
+        }
+
+        // Steal the oldest work of the others
+        for (u32 i = 1; i < count; i++) {
+            auto& queue = *m_queues[(own + i) % count];
+            std::lock_guard lock(queue.mutex);
+            if (!queue.tasks.empty()) {
+                task = std::move(queue.tasks.front());
+                queue.tasks.pop_front();
+                m_queuedTasks.fetch_sub(1);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void JobSystem::Execute(Task& task) {
+        task.job();
+        if (task.counter) {
+            Finish(*task.counter);
+        }
+    }
+
+    void JobSystem::Finish(Counter& counter) {
+        // Decrementing under the lock keeps Run from queuing a continuation after the last one was taken
+        std::vector<Counter::Continuation> continuations;
+        {
+            std::lock_guard lock(counter.m_mutex);
+            if (counter.m_value.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+                return;
+            }
+            continuations.swap(counter.m_continuations);
+        }
+        for (auto& [job, continuationCounter] : continuations) {
+            Push(Task { .job = std::move(job), .counter = continuationCounter });
+        }
+    }
+}
@@ -0,0 +1,101 @@
+//
+// Created by radue on 10/17/2026.
+//
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "utils/types.h"
+
+namespace Coral::Core {
+    // Fixed pool of workers, each owning a deque it pops from the back while idle workers steal from the front.
+    // Thread index 0 is any thread outside the pool, workers are 1..WorkerCount(). The main thread is the one that created the system.
+    class JobSystem {
+    public:
+        using Job = std::function<void()>;
+
+        // Counts the jobs still running, jobs can be chained to run once it drops to zero
+        class Counter {
+            friend class JobSystem;
+        public:
+            Counter() = default;
+            Counter(const Counter&) = delete;
+            Counter& operator=(const Counter&) = delete;
+
+            [[nodiscard]] bool Done() const { return m_value.load(std::memory_order_acquire) == 0; }
+
+        private:
+            struct Continuation {
+                Job job;
+                Counter* counter;
+            };
+
+            std::atomic<u32> m_value = 0;
+            std::mutex m_mutex;
+            std::vector<Continuation> m_continuations;
+        };
+
+        struct CreateInfo {
+            // 0 picks one worker per hardware thread besides the main one
+            u32 workerCount = 0;
+        };
+
+        explicit JobSystem(const CreateInfo& createInfo);
+        ~JobSystem();
+
+        JobSystem(const JobSystem&) = delete;
+        JobSystem& operator=(const JobSystem&) = delete;
+
+        // counter is incremented now and decremented once the job finished, dependency delays the job until it is done
+        void Run(Job job, Counter* counter = nullptr, Counter* dependency = nullptr);
+        // For work that has to happen on the main thread, e.g. anything touching a Vulkan queue
+        void RunOnMainThread(Job job, Counter* counter = nullptr);
+        // Executes other jobs while waiting, so waiting from inside a job never deadlocks the pool
+        void Wait(Counter& counter);
+        void ProcessMainThreadJobs();
+
+        // Splits [0, count) into ranges of at most grainSize and waits for all of them, rethrowing the first exception
+        void ParallelFor(u32 count, u32 grainSize, const std::function<void(u32 begin, u32 end)>& function);
+
+        [[nodiscard]] u32 WorkerCount() const { return static_cast<u32>(m_workers.size()); }
+        [[nodiscard]] static u32 ThreadIndex() { return s_threadIndex; }
+        [[nodiscard]] static bool IsMainThread() { return std::this_thread::get_id() == s_mainThread; }
+
+    private:
+        struct Task {
+            Job job;
+            Counter* counter = nullptr;
+        };
+
+        struct WorkQueue {
+            std::mutex mutex;
+            std::deque<Task> tasks;
+        };
+
+        void WorkerLoop(u32 index);
+        void Push(Task task);
+        bool Next(Task& task);
+        void Execute(Task& task);
+        void Finish(Counter& counter);
+
+        inline static thread_local u32 s_threadIndex = 0;
+        inline static std::thread::id s_mainThread;
+
+        std::vector<std::thread> m_workers;
+        // Slot 0 is fed by threads outside the pool, slot i by worker i
+        std::vector<std::unique_ptr<WorkQueue>> m_queues;
+        WorkQueue m_mainThreadQueue;
+
+        std::atomic<u64> m_queuedTasks = 0;
+        std::atomic<bool> m_stop = false;
+        std::mutex m_sleepMutex;
+        std::condition_variable m_wake;
+    };
+}
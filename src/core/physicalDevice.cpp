@@ -2,6 +2,7 @@
 // Created by radue on 10/14/2024.
 //
 
+#include <algorithm>
 #include <iostream>
 
 #include "physicalDevice.h"
@@ -22,6 +23,9 @@ namespace Coral::Core {
     }
 
     void PhysicalDevice::QuerySurfaceCapabilities() {
+        if (!m_surface) {
+            return;
+        }
         m_capabilities = m_handle.getSurfaceCapabilitiesKHR(m_surface);
         m_formats = m_handle.getSurfaceFormatsKHR(m_surface);
         m_presentModes = m_handle.getSurfacePresentModesKHR(m_surface);
@@ -36,6 +40,12 @@ namespace Coral::Core {
             && hasRequiredFeatures(m_runtime.m_deviceFeatures);
     }
 
+    bool PhysicalDevice::SupportsExtension(const std::string_view extension) const {
+        return std::ranges::any_of(m_extensionProperties, [extension](const vk::ExtensionProperties& properties) {
+            return extension == std::string_view(properties.extensionName);
+        });
+    }
+
     bool PhysicalDevice::hasRequiredQueueFamilies(const std::unordered_set<vk::QueueFlagBits>& requiredQueueFamilies) const {
         VkBool32 presentSupported = false;
         std::unordered_set<vk::QueueFlagBits> supportedQueueFamilies {};
@@ -47,10 +57,12 @@ namespace Coral::Core {
                     supportedQueueFamilies.insert(requiredQueueFamily);
                 }
             }
-            presentSupported |= m_handle.getSurfaceSupportKHR(queueFamilyIndex, m_surface);
+            if (m_surface) {
+                presentSupported |= m_handle.getSurfaceSupportKHR(queueFamilyIndex, m_surface);
+            }
         }
 
-        return requiredQueueFamilies == supportedQueueFamilies && presentSupported;
+        return requiredQueueFamilies == supportedQueueFamilies && (presentSupported || !m_surface);
     }
 
     bool PhysicalDevice::hasRequiredExtensions(std::unordered_set<std::string>& requiredExtensions) const {
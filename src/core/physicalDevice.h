@@ -3,6 +3,7 @@
 //
 #pragma once
 
+#include <string_view>
 #include <unordered_set>
 #include <vulkan/vulkan.hpp>
 
@@ -28,6 +29,7 @@ namespace Coral::Core {
         PhysicalDevice &operator=(const PhysicalDevice &) = delete;
 
         [[nodiscard]] bool isSuitable() const;
+        [[nodiscard]] bool SupportsExtension(std::string_view extension) const;
         [[nodiscard]] const std::vector<vk::QueueFamilyProperties>& QueueFamilyProperties() const { return m_queueFamilyProperties; }
 
         [[nodiscard]] const vk::SurfaceKHR& Surface() const { return m_surface; }
@@ -4,6 +4,7 @@
 
 #include "runtime.h"
 
+#include <algorithm>
 #include <iostream>
 
 #include "physicalDevice.h"
@@ -29,10 +30,12 @@ namespace Coral::Core {
 
         m_deviceFeatures = createInfo.deviceFeatures;
         m_deviceExtensions = createInfo.deviceExtensions;
+        m_optionalDeviceExtensions = createInfo.optionalDeviceExtensions;
         m_deviceLayers = createInfo.deviceLayers;
         m_instanceExtensions = createInfo.instanceExtensions;
         m_instanceLayers = createInfo.instanceLayers;
         m_requiredQueueFamilies = createInfo.requiredQueueFamilies;
+        m_headless = createInfo.headless;
 
         CreateInstance();
         Ext::DebugUtils::ImportFunctions(m_instance);
@@ -44,7 +47,9 @@ namespace Coral::Core {
 
     Runtime::~Runtime() {
         m_physicalDevice.reset();
-        m_instance.destroySurfaceKHR(m_surface);
+        if (m_surface) {
+            m_instance.destroySurfaceKHR(m_surface);
+        }
         destroyDebugMessenger();
         m_instance.destroy();
     }
@@ -87,8 +92,26 @@ namespace Coral::Core {
         Ext::DebugUtils::destroyDebugUtilsMessengerEXT(m_instance, m_debugMessenger, nullptr);
     }
 
+    bool Runtime::IsDeviceExtensionEnabled(const std::string_view extension) const {
+        return std::ranges::any_of(m_deviceExtensions, [extension](const char* enabled) { return extension == enabled; });
+    }
+
     void Runtime::SelectPhysicalDevice() {
-        m_surface = Window::Get().CreateSurface(m_instance);
+        if (!m_headless) {
+            m_surface = Window::Get().CreateSurface(m_instance);
+        }
+
+        // Discrete GPUs first, software rasterizers such as lavapipe only as a last resort
+        const auto rank = [](const vk::PhysicalDeviceType type) {
+            switch (type) {
+                case vk::PhysicalDeviceType::eDiscreteGpu: return 0;
+                case vk::PhysicalDeviceType::eIntegratedGpu: return 1;
+                case vk::PhysicalDeviceType::eVirtualGpu: return 2;
+                case vk::PhysicalDeviceType::eCpu: return 3;
+                default: return 4;
+            }
+        };
+
         m_physicalDevices = m_instance.enumeratePhysicalDevices();
         for (const auto physicalDeviceCandidate : m_physicalDevices) {
             const PhysicalDevice::CreateInfo createInfo = {
@@ -97,21 +120,28 @@ namespace Coral::Core {
                 .surface = m_surface,
             };
 
-            if (auto physicalDevice = std::make_unique<Core::PhysicalDevice>(createInfo); physicalDevice->isSuitable()) {
-                if (physicalDevice->m_properties.deviceType != vk::PhysicalDeviceType::eDiscreteGpu) {
-                    continue;
-                }
-
-                // Print physical device information
-                std::cout << "Selected physical device: " << physicalDevice->m_properties.deviceName << std::endl;
-                std::cout << "Device type: " << vk::to_string(physicalDevice->m_properties.deviceType) << std::endl;
-
+            auto physicalDevice = std::make_unique<Core::PhysicalDevice>(createInfo);
+            if (!physicalDevice->isSuitable()) {
+                continue;
+            }
+            if (!m_physicalDevice || rank(physicalDevice->m_properties.deviceType) < rank(m_physicalDevice->m_properties.deviceType)) {
                 m_physicalDevice = std::move(physicalDevice);
-                return;
             }
         }
         if (!m_physicalDevice) {
             throw std::runtime_error("Failed to find a suitable physical device!");
         }
+
+        for (const auto* extension : m_optionalDeviceExtensions) {
+            if (m_physicalDevice->SupportsExtension(extension)) {
+                m_deviceExtensions.emplace_back(extension);
+            } else {
+                std::cerr << "Runtime : Optional device extension " << extension << " not supported" << std::endl;
+            }
+        }
+
+        // Print physical device information
+        std::cout << "Selected physical device: " << m_physicalDevice->m_properties.deviceName << std::endl;
+        std::cout << "Device type: " << vk::to_string(m_physicalDevice->m_properties.deviceType) << std::endl;
     }
 }
\ No newline at end of file
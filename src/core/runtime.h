@@ -22,8 +22,12 @@ namespace Coral::Core {
             std::vector<const char*> instanceLayers;
             std::vector<const char*> instanceExtensions;
             std::vector<const char*> deviceExtensions;
+            // Enabled when the selected device supports them, never part of device selection
+            std::vector<const char*> optionalDeviceExtensions;
             std::vector<const char*> deviceLayers;
             std::unordered_set<vk::QueueFlagBits> requiredQueueFamilies;
+            // No surface is created, device selection then falls back to integrated, virtual and CPU devices
+            bool headless = false;
         };
 
         explicit Runtime(const CreateInfo &createInfo);
@@ -40,6 +44,8 @@ namespace Coral::Core {
         [[nodiscard]] const vk::Instance& Instance() const { return m_instance; }
         [[nodiscard]] const vk::SurfaceKHR& Surface() const { return m_surface; }
         [[nodiscard]] PhysicalDevice& PhysicalDevice() const { return *m_physicalDevice; }
+        [[nodiscard]] bool IsHeadless() const { return m_headless; }
+        [[nodiscard]] bool IsDeviceExtensionEnabled(std::string_view extension) const;
 
 		static const Runtime& Get() {
         	if (!s_runtime) {
@@ -55,8 +61,10 @@ namespace Coral::Core {
         std::vector<const char*> m_instanceLayers;
         std::vector<const char*> m_instanceExtensions;
         std::vector<const char*> m_deviceExtensions;
+        std::vector<const char*> m_optionalDeviceExtensions;
         std::vector<const char*> m_deviceLayers;
         std::unordered_set<vk::QueueFlagBits> m_requiredQueueFamilies;
+        bool m_headless = false;
 
         vk::Instance m_instance;
         vk::DebugUtilsMessengerEXT m_debugMessenger;
@@ -4,36 +4,43 @@
 
 #include "scheduler.h"
 
+#include <array>
+#include <format>
+#include <fstream>
+
 #include "context.h"
+#include "deletionQueue.h"
 #include "ecs/entity.h"
+#include "ecs/sceneManager.h"
 #include "graphics/renderPass.h"
 #include "gui/elements/popup.h"
-#include "memory/descriptor/pool.h"
+#include "memory/buffer.h"
+#include "memory/descriptor/allocator.h"
+#include "memory/uniformRing.h"
+#include "memory/uploadManager.h"
 #include "project/renderGraph.h"
 
 
 namespace Coral::Core {
-	Frame::Frame(const uint32_t imageIndex, const Core::Queue& queue)
-	 : m_imageIndex(imageIndex), m_queue(queue)
+	Frame::Frame(const uint32_t index, const Core::Queue& queue)
+	 : m_index(index), m_queue(queue)
 	{
 		m_imageAvailable = Context::Device()->createSemaphore({});
-		m_readyToPresent = Context::Device()->createSemaphore({});
-		// m_inFlightFence = Context::Device()->createFence(vk::FenceCreateInfo().setFlags(vk::FenceCreateFlagBits::eSignaled));
-		// m_queue = Context::Device().RequestQueue(vk::QueueFlagBits::eGraphics);
-		// m_finalImageTransferCommandBuffer = Context::Device().RequestCommandBuffer(*m_queue);
 
 		m_finalImageTransferCommandBuffer = Context::Device().RequestCommandBuffer(m_queue);
-
+		m_descriptorAllocator = std::make_unique<Memory::Descriptor::Allocator>(Memory::Descriptor::Allocator::CreateInfo {
+			.initialSetCount = 16,
+			.transient = true,
+		});
 	}
 
 	Frame::~Frame() {
 		Context::Device()->destroySemaphore(m_imageAvailable);
-		Context::Device()->destroySemaphore(m_readyToPresent);
-		// Context::Device()->destroyFence(m_inFlightFence);
 	}
 
     Scheduler::Scheduler(const CreateInfo& createInfo)
-        : m_imageCount(createInfo.imageCount)
+        : m_imageCount(createInfo.imageCount), m_framesInFlight(createInfo.framesInFlight),
+          m_headless(createInfo.headless), m_outputDirectory(createInfo.outputDirectory)
     {
 		static bool firstTime = true;
 		if (!firstTime) {
@@ -42,45 +49,126 @@ namespace Coral::Core {
 		firstTime = false;
         Context::m_scheduler = this;
 
-		m_queue = Context::Device().RequestQueue(vk::QueueFlagBits::eGraphics);
-        CreateFrames();
+		if (m_framesInFlight == 0) {
+			throw std::runtime_error("Scheduler : At least one frame in flight is required!");
+		}
 
-        const auto swapChainCreateInfo = Graphics::SwapChain::CreateInfo {
-            .minImageCount = createInfo.minImageCount,
-            .imageCount = m_imageCount,
-            .sampleCount = createInfo.multiSampling,
-        };
-        m_swapChain = std::make_unique<Graphics::SwapChain>(swapChainCreateInfo);
+        m_framePacer = std::make_unique<Core::FramePacer>(Core::FramePacer::CreateInfo {
+            .presentMode = createInfo.presentMode,
+            .targetFrameRate = createInfo.targetFrameRate,
+        });
+
+        if (!m_headless) {
+            const auto swapChainCreateInfo = Graphics::SwapChain::CreateInfo {
+                .minImageCount = createInfo.minImageCount,
+                .imageCount = m_imageCount,
+                .sampleCount = createInfo.multiSampling,
+                .presentMode = createInfo.presentMode,
+            };
+            m_swapChain = std::make_unique<Graphics::SwapChain>(swapChainCreateInfo);
+            m_imagesInFlight.assign(m_swapChain->SwapChainImages().size(), 0);
+        }
 
-        CreateDescriptorPool();
+        m_descriptorAllocator = std::make_unique<Memory::Descriptor::Allocator>(Memory::Descriptor::Allocator::CreateInfo {});
+        m_uniformRing = std::make_unique<Memory::UniformRing>(Memory::UniformRing::CreateInfo {
+            .regionCount = m_framesInFlight,
+        });
 
         const auto renderGraphCreateInfo = Project::RenderGraph::CreateInfo {
-            .frameCount = m_imageCount,
-            .guiEnabled = true,
+            .frameCount = m_framesInFlight,
+            .guiEnabled = createInfo.enableGUI && !m_headless,
+            .mergeSubpasses = createInfo.mergeSubpasses,
         };
 
         m_renderGraph = Reef::MakeContainer<Project::RenderGraph>(renderGraphCreateInfo);
+        CreateFrames();
+
+        if (m_headless) {
+            CreateOffscreenTargets();
+        }
     }
 
     Scheduler::~Scheduler() {
-        Context::Device()->waitIdle();
+        for (const auto& frame : m_frames) {
+            frame->Queue().Wait(frame->TimelineValue());
+        }
+        for (u32 i = 0; i < m_pendingReadbacks.size(); i++) {
+            WriteFrame(i);
+        }
     }
 
-    void Scheduler::CreateDescriptorPool() {
-        m_descriptorPool = Memory::Descriptor::Pool::Builder()
-            .AddPoolSize(vk::DescriptorType::eUniformBuffer, 100)
-            .AddPoolSize(vk::DescriptorType::eStorageBuffer, 100)
-            .AddPoolSize(vk::DescriptorType::eCombinedImageSampler, 100)
-            .AddPoolSize(vk::DescriptorType::eStorageImage, 100)
-            .PoolFlags(vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet)
-            .MaxSets(100)
-            .Build();
+    void Scheduler::CreateOffscreenTargets() {
+        if (!m_outputDirectory.empty()) {
+            // WriteFrame reads the buffer back as four 8 bit channels
+            const auto format = m_renderGraph->OutputImage(0).Format();
+            if (format != vk::Format::eR8G8B8A8Unorm && format != vk::Format::eR8G8B8A8Srgb &&
+                format != vk::Format::eB8G8R8A8Unorm && format != vk::Format::eB8G8R8A8Srgb) {
+                throw std::runtime_error("Scheduler::CreateOffscreenTargets : Frames can only be written from 8 bit RGBA or BGRA output, the render graph outputs "
+                    + vk::to_string(format));
+            }
+            std::filesystem::create_directories(m_outputDirectory);
+        }
+
+        for (uint32_t i = 0; i < m_framesInFlight; i++) {
+            const auto& outputImage = m_renderGraph->OutputImage(i);
+            m_offscreenImages.emplace_back(Memory::Image::Builder()
+                .Format(outputImage.Format())
+                .Extent(outputImage.Extent())
+                .UsageFlags(vk::ImageUsageFlagBits::eTransferDst)
+                .UsageFlags(vk::ImageUsageFlagBits::eTransferSrc)
+                .SampleCount(vk::SampleCountFlagBits::e1)
+                .InitialLayout(vk::ImageLayout::eTransferSrcOptimal)
+                .Build());
+
+            if (!m_outputDirectory.empty()) {
+                auto buffer = Memory::Buffer::Builder()
+                    .InstanceSize(sizeof(std::array<u8, 4>))
+                    .InstanceCount(outputImage.Extent().width * outputImage.Extent().height)
+                    .UsageFlags(vk::BufferUsageFlagBits::eTransferDst)
+                    .MemoryProperty(vk::MemoryPropertyFlagBits::eHostVisible)
+                    .MemoryProperty(vk::MemoryPropertyFlagBits::eHostCoherent)
+                    .Build();
+                buffer->Map<std::byte>();
+                m_readbackBuffers.emplace_back(std::move(buffer));
+            }
+        }
+        m_pendingReadbacks.assign(m_framesInFlight, std::nullopt);
+    }
+
+    void Scheduler::WriteFrame(const u32 frameIndex) {
+        auto& pending = m_pendingReadbacks.at(frameIndex);
+        if (!pending.has_value()) {
+            return;
+        }
+
+        const auto& image = *m_offscreenImages[frameIndex];
+        const auto pixels = m_readbackBuffers[frameIndex]->Read<std::array<u8, 4>>();
+        const bool bgr = image.Format() == vk::Format::eB8G8R8A8Unorm || image.Format() == vk::Format::eB8G8R8A8Srgb;
+
+        const auto path = m_outputDirectory / std::format("frame_{:06}.ppm", pending.value());
+        std::ofstream file(path, std::ios::binary);
+        if (!file) {
+            std::cerr << "Scheduler::WriteFrame : Failed to open " << path << std::endl;
+            pending.reset();
+            return;
+        }
+
+        file << "P6\n" << image.Extent().width << " " << image.Extent().height << "\n255\n";
+        for (const auto& pixel : pixels) {
+            const char rgb[3] = {
+                static_cast<char>(bgr ? pixel[2] : pixel[0]),
+                static_cast<char>(pixel[1]),
+                static_cast<char>(bgr ? pixel[0] : pixel[2]),
+            };
+            file.write(rgb, 3);
+        }
+        pending.reset();
     }
 
     void Scheduler::CreateFrames() {
-        m_frames.reserve(m_imageCount);
-        for (uint32_t i = 0; i < m_imageCount; i++) {
-            m_frames.emplace_back(std::make_unique<Frame>(i, *m_queue));
+        m_frames.reserve(m_framesInFlight);
+        for (uint32_t i = 0; i < m_framesInFlight; i++) {
+            m_frames.emplace_back(std::make_unique<Frame>(i, m_renderGraph->Queue(vk::QueueFlagBits::eGraphics)));
         }
     }
 
@@ -89,131 +177,180 @@ namespace Coral::Core {
         // m_renderGraph->Resize(m_window.Extent());
     }
 
+    void Scheduler::Recreate() {
+        ForgetSwapChainImages();
+        m_swapChain->Resize(Window::Get().Extent());
+        m_renderGraph->Resize(Window::Get().Extent());
+        m_imagesInFlight.assign(m_swapChain->SwapChainImages().size(), 0);
+    }
+
     void Scheduler::Draw() {
-        const auto& frame = CurrentFrame();
+        auto& frame = *m_frames.at(m_currentFrame);
+        const auto& queue = frame.Queue();
+
+        // Only blocks when the GPU is a whole ring of frames behind the CPU
+        queue.Wait(frame.TimelineValue());
+        Context::DeletionQueue().Collect();
+        frame.DescriptorAllocator().Reset();
+        m_uniformRing->Begin(frame.Index());
+
+        // Input is sampled only now that the CPU is allowed to record, so it is as fresh as possible when submitted
+        m_framePacer->LatchInput();
+        if (ECS::SceneManager::Get().IsSceneLoaded()) {
+            ECS::SceneManager::Get().GetLoadedScene().LatchCamera(Window::Get().DeltaTime());
+        }
 
-        const auto& fence = frame.InFlightFence();
-        if (const auto result = Context::Device()->waitForFences(1, &fence, vk::True, UINT64_MAX); result != vk::Result::eSuccess) {
-            throw std::runtime_error("Failed to wait fence: " + vk::to_string(result));
+        if (const auto presentMode = m_framePacer->ConsumePresentModeChange(); presentMode && !m_headless) {
+            ForgetSwapChainImages();
+            m_swapChain->SetPresentMode(*presentMode);
+            m_imagesInFlight.assign(m_swapChain->SwapChainImages().size(), 0);
         }
 
-        if (const auto result = Context::Device()->resetFences(1, &fence); result != vk::Result::eSuccess) {
-            throw std::runtime_error("Failed to reset fence: " + vk::to_string(result));
+        if (m_headless) {
+            WriteFrame(frame.Index());
+        } else {
+            if (const auto result = m_swapChain->Acquire(frame); result == vk::Result::eErrorOutOfDateKHR) {
+                Recreate();
+                return;
+            }
+            frame.m_imageIndex = m_swapChain->CurrentImageIndex();
+
+            // The acquired image may still be used by an older frame from another ring slot
+            queue.Wait(m_imagesInFlight.at(frame.ImageIndex()));
         }
 
-        if (const auto result = m_swapChain->Acquire(frame);
-            result == vk::Result::eErrorOutOfDateKHR || result == vk::Result::eSuboptimalKHR) {
-            m_swapChain->Resize(Window::Get().Extent());
-            m_renderGraph->Resize(Window::Get().Extent());
-            return;
+        std::vector<Queue::Submission> submissions;
+    	m_renderGraph->Execute(frame, submissions);
+
+        // Flushed after recording so that uploads issued while recording are waited on as well
+        const auto uploads = Context::UploadManager().Flush();
+        if (!submissions.empty() && !Context::UploadManager().HasCompleted(uploads)) {
+            submissions.front().waitSemaphores.emplace_back(
+                Context::UploadManager().WaitInfo(uploads, vk::PipelineStageFlagBits2::eAllCommands));
         }
 
-    	m_renderGraph->Execute(frame);
+        auto& barriers = m_renderGraph->Barriers();
+        const auto& commandBuffer = frame.FinalImageTransferCommandBuffer();
+        commandBuffer->begin(vk::CommandBufferBeginInfo().setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+        if (m_headless) {
+            const auto& target = *m_offscreenImages[frame.Index()];
+            RecordFinalImageTransfer(commandBuffer, frame, target, {
+                .layout = vk::ImageLayout::eTransferSrcOptimal,
+                .stages = vk::PipelineStageFlagBits2::eCopy,
+                .access = vk::AccessFlagBits2::eTransferRead,
+            });
+
+            if (!m_readbackBuffers.empty()) {
+                commandBuffer->copyImageToBuffer(*target, vk::ImageLayout::eTransferSrcOptimal, **m_readbackBuffers[frame.Index()],
+                    vk::BufferImageCopy()
+                        .setImageSubresource(vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, 0, 0, 1))
+                        .setImageExtent(vk::Extent3D(target.Extent())));
+                // Waiting on the timeline does not make device writes visible to the host by itself
+                barriers.GlobalBarrier(vk::PipelineStageFlagBits2::eCopy, vk::AccessFlagBits2::eTransferWrite,
+                    vk::PipelineStageFlagBits2::eHost, vk::AccessFlagBits2::eHostRead);
+                barriers.Flush(**commandBuffer);
+                m_pendingReadbacks[frame.Index()] = m_frameNumber;
+            }
+        } else {
+            const auto& target = *m_swapChain->SwapChainImages()[frame.ImageIndex()];
+            // The acquire semaphore is waited on at the transfer stages, the first barrier has to start there to chain with it
+            barriers.Assume(target, { .stages = vk::PipelineStageFlagBits2::eAllTransfer });
+            RecordFinalImageTransfer(commandBuffer, frame, target, {
+                .layout = vk::ImageLayout::ePresentSrcKHR,
+                .stages = vk::PipelineStageFlagBits2::eAllTransfer,
+            });
+        }
+        commandBuffer->end();
+
+        // Rendering never touches the swap chain image, so only the final copy waits for the acquire. The render graph's
+        // submissions are on the same queue and ordered against the copy by its barriers.
+        auto& finalSubmission = submissions.emplace_back();
+        finalSubmission.commandBuffers = { *commandBuffer };
+        if (!m_headless) {
+            finalSubmission.waitSemaphores.emplace_back(vk::SemaphoreSubmitInfo()
+                .setSemaphore(frame.ImageAvailable())
+                .setStageMask(vk::PipelineStageFlagBits2::eAllTransfer));
+            finalSubmission.signalSemaphores.emplace_back(vk::SemaphoreSubmitInfo()
+                .setSemaphore(m_swapChain->ReadyToPresent())
+                .setStageMask(vk::PipelineStageFlagBits2::eAllTransfer));
+        }
+        finalSubmission.signalStages = vk::PipelineStageFlagBits2::eAllTransfer;
 
-        frame.FinalImageTransferCommandBuffer().Run([&](const CommandBuffer& commandBuffer) {
-            const Memory::Image& outputImage = m_renderGraph->OutputImage(frame.ImageIndex());
-            const Memory::Image& swapChainImage = *m_swapChain->SwapChainImages()[frame.ImageIndex()];
+        frame.m_timelineValue = queue.Submit(submissions);
+        Context::DeletionQueue().EndFrame(queue, frame.m_timelineValue);
+        m_framePacer->MarkSubmitted();
 
-            vk::ImageMemoryBarrier outputImageBarrier = vk::ImageMemoryBarrier()
-                .setImage(*outputImage)
-                .setSrcAccessMask(vk::AccessFlagBits::eColorAttachmentWrite)
-                .setDstAccessMask(vk::AccessFlagBits::eColorAttachmentRead)
-                .setOldLayout(vk::ImageLayout::eColorAttachmentOptimal)
-                .setNewLayout(vk::ImageLayout::eTransferSrcOptimal)
-                .setSubresourceRange(vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1));
+        if (!m_headless) {
+            m_imagesInFlight.at(frame.ImageIndex()) = frame.m_timelineValue;
 
-            commandBuffer->pipelineBarrier(
-                vk::PipelineStageFlagBits::eAllGraphics,
-                vk::PipelineStageFlagBits::eAllCommands,
-                vk::DependencyFlags(),
-                nullptr,
-                nullptr,
-                { outputImageBarrier }
-            );
+            if (const auto result = m_swapChain->Present(frame);
+                result == vk::Result::eErrorOutOfDateKHR || result == vk::Result::eSuboptimalKHR) {
+                Recreate();
+            }
+        }
 
+        m_frameNumber++;
+		AdvanceFrame();
+    }
 
-            if (outputImage.SampleCount() != vk::SampleCountFlagBits::e1) {
-                const auto imageResolve = vk::ImageResolve()
+    void Scheduler::RecordFinalImageTransfer(const CommandBuffer& commandBuffer, const Frame& frame, const Memory::Image& target,
+        const Graphics::BarrierTracker::State& targetState) const {
+        const Memory::Image& outputImage = m_renderGraph->OutputImage(frame.Index());
+        auto& barriers = m_renderGraph->Barriers();
+
+        const bool resolve = outputImage.SampleCount() != vk::SampleCountFlagBits::e1;
+        const auto transferStage = resolve ? vk::PipelineStageFlagBits2::eResolve : vk::PipelineStageFlagBits2::eCopy;
+
+        barriers.Require(outputImage, {
+            .layout = vk::ImageLayout::eTransferSrcOptimal,
+            .stages = transferStage,
+            .access = vk::AccessFlagBits2::eTransferRead,
+            // Acquires the output from the queue of the last pass when that was not the graphics queue
+            .queueFamily = frame.Queue().Family().Index(),
+        });
+        barriers.Require(target, {
+            .layout = vk::ImageLayout::eTransferDstOptimal,
+            .stages = transferStage,
+            .access = vk::AccessFlagBits2::eTransferWrite,
+        });
+        barriers.Flush(*commandBuffer);
+
+        if (resolve) {
+            const auto imageResolve = vk::ImageResolve()
+                .setSrcSubresource(vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, 0, 0, 1))
+                .setSrcOffset(vk::Offset3D(0, 0, 0))
+                .setDstSubresource(vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, 0, 0, 1))
+                .setDstOffset(vk::Offset3D(0, 0, 0))
+                .setExtent(vk::Extent3D(outputImage.Extent()));
+
+            commandBuffer->resolveImage(
+                *outputImage,
+                vk::ImageLayout::eTransferSrcOptimal,
+                *target,
+                vk::ImageLayout::eTransferDstOptimal,
+                imageResolve
+            );
+        } else {
+            commandBuffer->copyImage(
+                *outputImage,
+                vk::ImageLayout::eTransferSrcOptimal,
+                *target,
+                vk::ImageLayout::eTransferDstOptimal,
+                { vk::ImageCopy()
                     .setSrcSubresource(vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, 0, 0, 1))
-                    .setSrcOffset(vk::Offset3D(0, 0, 0))
                     .setDstSubresource(vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, 0, 0, 1))
-                    .setDstOffset(vk::Offset3D(0, 0, 0))
-                    .setExtent(vk::Extent3D(outputImage.Extent()));
-
-                commandBuffer->resolveImage(
-                    *outputImage,
-                    vk::ImageLayout::eTransferSrcOptimal,
-                    *swapChainImage,
-                    vk::ImageLayout::eTransferDstOptimal,
-                    imageResolve
-                );
-            } else {
-                vk::ImageMemoryBarrier swapChainImageMemoryBarrier = vk::ImageMemoryBarrier()
-                    .setImage(*swapChainImage)
-                    .setSrcAccessMask(vk::AccessFlagBits::eColorAttachmentWrite)
-                    .setDstAccessMask(vk::AccessFlagBits::eColorAttachmentWrite)
-                    .setOldLayout(vk::ImageLayout::ePresentSrcKHR)
-                    .setNewLayout(vk::ImageLayout::eTransferDstOptimal)
-                    .setSubresourceRange(vk::ImageSubresourceRange(vk::ImageAspectFlagBits::eColor, 0, 1, 0, 1));
-
-                commandBuffer->pipelineBarrier(
-                    vk::PipelineStageFlagBits::eAllGraphics,
-                    vk::PipelineStageFlagBits::eAllCommands,
-                    vk::DependencyFlags(),
-                    nullptr,
-                    nullptr,
-                    { swapChainImageMemoryBarrier }
-                );
-
-                commandBuffer->copyImage(
-                    *outputImage,
-                    vk::ImageLayout::eTransferSrcOptimal,
-                    *swapChainImage,
-                    vk::ImageLayout::eTransferDstOptimal,
-                    { vk::ImageCopy()
-                        .setSrcSubresource(vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, 0, 0, 1))
-                        .setDstSubresource(vk::ImageSubresourceLayers(vk::ImageAspectFlagBits::eColor, 0, 0, 1))
-                        .setExtent(vk::Extent3D(outputImage.Extent())) }
-                );
-
-                swapChainImageMemoryBarrier
-                    .setSrcAccessMask(vk::AccessFlagBits::eColorAttachmentWrite)
-                    .setDstAccessMask(vk::AccessFlagBits::eColorAttachmentWrite)
-                    .setOldLayout(vk::ImageLayout::eTransferDstOptimal)
-                    .setNewLayout(vk::ImageLayout::ePresentSrcKHR);
-
-                commandBuffer->pipelineBarrier(
-                    vk::PipelineStageFlagBits::eAllGraphics,
-                    vk::PipelineStageFlagBits::eAllCommands,
-                    vk::DependencyFlags(),
-                    nullptr,
-                    nullptr,
-                    { swapChainImageMemoryBarrier }
-                );
-            }
-
-            outputImageBarrier
-                .setSrcAccessMask(vk::AccessFlagBits::eColorAttachmentRead)
-                .setDstAccessMask(vk::AccessFlagBits::eColorAttachmentWrite)
-                .setOldLayout(vk::ImageLayout::eTransferSrcOptimal)
-                .setNewLayout(vk::ImageLayout::eColorAttachmentOptimal);
-
-            commandBuffer->pipelineBarrier(
-                vk::PipelineStageFlagBits::eAllCommands,
-                vk::PipelineStageFlagBits::eAllCommands,
-                vk::DependencyFlags(),
-                nullptr,
-                nullptr,
-                { outputImageBarrier }
+                    .setExtent(vk::Extent3D(outputImage.Extent())) }
             );
-        }, frame.ReadyToPresent());
-
-        if (const auto result = m_swapChain->Present(frame);
-            result == vk::Result::eErrorOutOfDateKHR || result == vk::Result::eSuboptimalKHR) {
-            m_swapChain->Resize(Window::Get().Extent());
-            m_renderGraph->Resize(Window::Get().Extent());
         }
 
-		AdvanceFrame();
+        // The output image is left for the next frame's passes to transition back when they need it
+        barriers.Require(target, targetState);
+        barriers.Flush(*commandBuffer);
+    }
+
+    void Scheduler::ForgetSwapChainImages() const {
+        for (const auto* image : m_swapChain->SwapChainImages()) {
+            m_renderGraph->Barriers().Forget(*image);
+        }
     }
 }
@@ -3,12 +3,15 @@
 //
 #pragma once
 
+#include <filesystem>
+#include <optional>
 #include <vector>
 #include <ranges>
 
 #include <vulkan/vulkan.hpp>
 
 #include "device.h"
+#include "framePacer.h"
 #include "graphics/swapChain.h"
 #include "gui/container.h"
 #include "project/renderGraph.h"
@@ -27,7 +30,14 @@ namespace Coral::Graphics {
     class RenderPass;
 }
 
+namespace Coral::Memory {
+    class Buffer;
+    class Image;
+    class UniformRing;
+}
+
 namespace Coral::Memory::Descriptor {
+    class Allocator;
     class Pool;
     class SetLayout;
     class Set;
@@ -35,49 +45,55 @@ namespace Coral::Memory::Descriptor {
 
 namespace Coral::Core {
 	class Frame {
+		friend class Scheduler;
 	public:
-		explicit Frame(uint32_t imageIndex, const Queue& queue);
+		explicit Frame(uint32_t index, const Queue& queue);
 		~Frame();
 
 		Frame(const Frame&) = delete;
 		Frame& operator=(const Frame&) = delete;
 
+		[[nodiscard]] uint32_t Index() const { return m_index; }
+		// Swap chain image acquired for this frame, independent of Index()
 		[[nodiscard]] uint32_t ImageIndex() const { return m_imageIndex; }
 		[[nodiscard]] vk::Semaphore ImageAvailable() const { return m_imageAvailable; }
-		[[nodiscard]] vk::Semaphore ReadyToPresent() const { return m_readyToPresent; }
-		[[nodiscard]] vk::Fence InFlightFence() const { return m_finalImageTransferCommandBuffer->Fence(); }
+		// Graphics timeline value signaled once every submission of this frame retired
+		[[nodiscard]] u64 TimelineValue() const { return m_timelineValue; }
 
 		[[nodiscard]] const CommandBuffer& FinalImageTransferCommandBuffer() const { return *m_finalImageTransferCommandBuffer; }
 		const Core::Queue& Queue() const { return m_queue; }
+		// Sets that live for this frame only, reset once its submissions retired
+		[[nodiscard]] Memory::Descriptor::Allocator& DescriptorAllocator() const { return *m_descriptorAllocator; }
 
 
 	private:
-		uint32_t m_imageIndex;
+		uint32_t m_index;
+		uint32_t m_imageIndex = 0;
 		vk::Semaphore m_imageAvailable;
-		vk::Semaphore m_readyToPresent;
-		// vk::Fence m_inFlightFence;
+		u64 m_timelineValue = 0;
 		std::unique_ptr<CommandBuffer> m_finalImageTransferCommandBuffer;
+		std::unique_ptr<Memory::Descriptor::Allocator> m_descriptorAllocator;
 
-		// std::unique_ptr<Queue> m_queue;
 		const Core::Queue& m_queue;
 	};
 
-    struct SubmitInfo {
-        const CommandBuffer& commandBuffer;
-        std::vector<vk::Semaphore> waitSemaphores;
-        std::vector<vk::PipelineStageFlags> waitStages;
-        std::vector<vk::Semaphore> signalSemaphores;
-        vk::Fence fence = nullptr;
-    };
-
     class Scheduler {
 	    friend class Reef::Manager;
     public:
     	struct CreateInfo {
     		uint32_t minImageCount;
     		uint32_t imageCount;
+    		uint32_t framesInFlight = 2;
     		vk::SampleCountFlagBits multiSampling;
     		bool enableGUI = true;
+    		// Renders into offscreen images instead of a swap chain
+    		bool headless = false;
+    		// Headless frames are written here as PPM files, left empty they are discarded
+    		std::filesystem::path outputDirectory;
+    		vk::PresentModeKHR presentMode = vk::PresentModeKHR::eMailbox;
+    		// 0 leaves the frame rate to the present mode
+    		f32 targetFrameRate = 0.0f;
+    		bool mergeSubpasses = true;
     	};
 
     	explicit Scheduler(const CreateInfo &createInfo);
@@ -89,13 +105,18 @@ namespace Coral::Core {
     	void Draw();
 
     	[[nodiscard]] const Graphics::SwapChain &SwapChain() const { return *m_swapChain; }
-    	[[nodiscard]] const Memory::Descriptor::Pool &DescriptorPool() const { return *m_descriptorPool; }
+    	[[nodiscard]] Memory::Descriptor::Allocator &DescriptorAllocator() const { return *m_descriptorAllocator; }
+    	// Per-frame constants, rewound to the current frame's region at the start of Draw
+    	[[nodiscard]] Memory::UniformRing &UniformRing() const { return *m_uniformRing; }
     	[[nodiscard]] const Frame &CurrentFrame() const { return *m_frames.at(m_currentFrame); }
-    	[[nodiscard]] const Frame &NextFrame() const { return *m_frames.at((m_currentFrame + 1) % m_imageCount); }
-    	void AdvanceFrame() { m_currentFrame = (m_currentFrame + 1) % m_imageCount; }
+    	[[nodiscard]] const Frame &NextFrame() const { return *m_frames.at((m_currentFrame + 1) % m_framesInFlight); }
+    	void AdvanceFrame() { m_currentFrame = (m_currentFrame + 1) % m_framesInFlight; }
     	[[nodiscard]] const vk::Extent2D &Extent() const { return m_extent; }
     	[[nodiscard]] bool IsResized() const { return m_resized; }
     	[[nodiscard]] uint32_t ImageCount() const { return m_imageCount; }
+    	[[nodiscard]] uint32_t FramesInFlight() const { return m_framesInFlight; }
+    	[[nodiscard]] bool IsHeadless() const { return m_headless; }
+    	[[nodiscard]] Core::FramePacer &FramePacer() const { return *m_framePacer; }
 
     	[[nodiscard]] std::vector<Frame*> Frames() const {
     		std::vector<Frame*> frames;
@@ -111,20 +132,38 @@ namespace Coral::Core {
     	std::unique_ptr<Reef::Manager> m_guiManager;
     	Reef::Container<Project::RenderGraph> m_renderGraph = nullptr;
     	u32 m_imageCount;
+    	u32 m_framesInFlight;
     	vk::SampleCountFlagBits m_multiSampling;
 
     	std::unique_ptr<Graphics::SwapChain> m_swapChain;
-
-    	std::unique_ptr<Queue> m_queue;
+    	std::unique_ptr<Core::FramePacer> m_framePacer;
 
 
     	void CreateFrames();
     	u32 m_currentFrame = 0;
     	std::vector<std::unique_ptr<Frame>> m_frames;
-
-
-    	void CreateDescriptorPool();
-    	std::unique_ptr<Memory::Descriptor::Pool> m_descriptorPool;
+    	std::vector<u64> m_imagesInFlight;
+
+    	void Recreate();
+    	// Leaves the target in targetState, which also covers whatever is recorded after the transfer
+    	void RecordFinalImageTransfer(const CommandBuffer& commandBuffer, const Frame& frame, const Memory::Image& target,
+    		const Graphics::BarrierTracker::State& targetState) const;
+    	// Recreating the swap chain gives its images new handles
+    	void ForgetSwapChainImages() const;
+
+    	void CreateOffscreenTargets();
+    	void WriteFrame(u32 frameIndex);
+    	bool m_headless = false;
+    	std::filesystem::path m_outputDirectory;
+    	u64 m_frameNumber = 0;
+    	std::vector<std::unique_ptr<Memory::Image>> m_offscreenImages;
+    	std::vector<std::unique_ptr<Memory::Buffer>> m_readbackBuffers;
+    	// Frame number whose pixels sit in the readback buffer of a ring slot, written out once its submission retired
+    	std::vector<std::optional<u64>> m_pendingReadbacks;
+
+
+    	std::unique_ptr<Memory::Descriptor::Allocator> m_descriptorAllocator;
+    	std::unique_ptr<Memory::UniformRing> m_uniformRing;
 
     	bool m_resized = false;
     	vk::Extent2D m_extent;
@@ -25,6 +25,10 @@ namespace Coral::Core {
     Window::Window(const CreateInfo& createInfo) : m_info(createInfo) {
 		s_window = this;
 
+        if (createInfo.headless) {
+            return;
+        }
+
         if (const auto result = glfwInit(); result == GLFW_FALSE) {
             std::cerr << "Failed to initialize GLFW" << std::endl;
         }
@@ -82,11 +86,17 @@ namespace Coral::Core {
     }
 
     Window::~Window() {
+        if (m_info.headless) {
+            return;
+        }
         glfwDestroyWindow(m_window);
         glfwTerminate();
     }
 
     std::vector <const char*> Window::GetRequiredExtensions() const {
+        if (m_info.headless) {
+            return {};
+        }
         uint32_t glfwExtensionCount = 0;
         const auto glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
         std::vector extensions(glfwExtensions, glfwExtensions + glfwExtensionCount);
@@ -94,6 +104,9 @@ namespace Coral::Core {
     }
 
     vk::SurfaceKHR Window::CreateSurface(const vk::Instance& instance) const {
+        if (m_info.headless) {
+            return nullptr;
+        }
         VkSurfaceKHR surface;
         if (const auto result = glfwCreateWindowSurface(instance, m_window, nullptr, &surface); result != VK_SUCCESS) {
             std::cerr << "Failed to create window surface: " << vk::to_string(static_cast<vk::Result>(result)) << std::endl;
@@ -103,7 +116,7 @@ namespace Coral::Core {
     }
 
     void Window::UpdateDeltaTime() {
-        const double currentTime = glfwGetTime();
+        const double currentTime = Time();
         m_deltaTime = currentTime - m_lastTime;
         m_lastTime = currentTime;
 
@@ -115,6 +128,13 @@ namespace Coral::Core {
 		}
     }
 
+    double Window::Time() const {
+        if (m_info.headless) {
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - m_startTime).count();
+        }
+        return glfwGetTime();
+    }
+
 	void Window::FramebufferResize(GLFWwindow* window, const int width, const int height) {
     	const auto app = static_cast<Window*>(glfwGetWindowUserPointer(window));
 
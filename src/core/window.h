@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <chrono>
 #include <string>
 #define GLFW_INCLUDE_VULKAN
 #include <GLFW/glfw3.h>
@@ -26,12 +27,14 @@ namespace Coral::Core {
          * @param extent Window extent (width, height) in pixels as uint32_t values
          * @param resizable If the window is resizable (when fullscreen the value is ignored)
          * @param fullscreen If the window is fullscreen (overrides the extent value)
+         * @param headless No GLFW window nor surface is created, extent only sizes the offscreen targets
          */
         struct CreateInfo {
             String title;
             Math::Vector2<u32> extent;
             bool resizable;
             bool fullscreen;
+            bool headless = false;
         };
 
         explicit Window(const CreateInfo&);
@@ -40,9 +43,19 @@ namespace Coral::Core {
         Window(const Window &) = delete;
         Window &operator=(const Window &) = delete;
 
-        [[nodiscard]] bool ShouldClose() const { return glfwWindowShouldClose(m_window); }
-        void Close() const { glfwSetWindowShouldClose(m_window, GLFW_TRUE); }
-        void PollEvents() const { glfwPollEvents(); }
+        [[nodiscard]] bool ShouldClose() const { return m_window ? glfwWindowShouldClose(m_window) : m_shouldClose; }
+        void Close() {
+            m_shouldClose = true;
+            if (m_window) {
+                glfwSetWindowShouldClose(m_window, GLFW_TRUE);
+            }
+        }
+        void PollEvents() const {
+            if (m_window) {
+                glfwPollEvents();
+            }
+        }
+        [[nodiscard]] bool IsHeadless() const { return m_info.headless; }
 
         [[nodiscard]] GLFWwindow* operator*() const { return m_window; }
         [[nodiscard]] Math::Vector2<f32> Extent() const { return m_info.extent; }
@@ -55,13 +68,15 @@ namespace Coral::Core {
         void UnPause() { m_paused = false; }
 
         void UpdateDeltaTime();
-        [[nodiscard]] float TimeElapsed() const { return static_cast<float>(glfwGetTime()); }
+        [[nodiscard]] float TimeElapsed() const { return static_cast<float>(Time()); }
         [[nodiscard]] float DeltaTime() const { return static_cast<float>(m_deltaTime); }
     	[[nodiscard]] float FixedDeltaTime() const { return static_cast<float>(std::max(m_fixedDeltaTime, m_deltaTime)); }
 
         void SetTitle(const std::string &title) {
             m_info.title = title;
-            glfwSetWindowTitle(m_window, title.c_str());
+            if (m_window) {
+                glfwSetWindowTitle(m_window, title.c_str());
+            }
         }
 
     	static const Window& Get() {
@@ -74,10 +89,13 @@ namespace Coral::Core {
     private:
     	inline static Window* s_window = nullptr;
     	static void FramebufferResize(GLFWwindow* window, int width, int height);
+    	[[nodiscard]] double Time() const;
 
-        GLFWwindow* m_window;
-        GLFWmonitor* m_monitor;
-        const GLFWvidmode *m_videoMode;
+        GLFWwindow* m_window = nullptr;
+        GLFWmonitor* m_monitor = nullptr;
+        const GLFWvidmode *m_videoMode = nullptr;
+        bool m_shouldClose = false;
+        std::chrono::steady_clock::time_point m_startTime = std::chrono::steady_clock::now();
 
         CreateInfo m_info;
         bool m_paused = false;
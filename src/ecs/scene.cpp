@@ -17,6 +17,7 @@
 #include "core/input.h"
 #include "core/scheduler.h"
 #include "memory/gpuStructs.h"
+#include "memory/uniformRing.h"
 #include "gui/elements/popup.h"
 
 namespace Coral::ECS {
@@ -90,25 +91,9 @@ namespace Coral::ECS {
 
     	m_root->Add<Camera>(firstCameraCreateInfo);
     	m_root->AddChild(std::move(firstCamera));
-
-    	m_setLayout = Memory::Descriptor::SetLayout::Builder()
-			.AddBinding(0, vk::DescriptorType::eUniformBuffer, vk::ShaderStageFlagBits::eTessellationEvaluation)
-			.Build();
-
-		m_cameraBuffer = Memory::Buffer::Builder()
-    		.InstanceCount(1)
-    		.InstanceSize(sizeof(GPU::Camera))
-    		.UsageFlags(vk::BufferUsageFlagBits::eUniformBuffer)
-    		.MemoryProperty(vk::MemoryPropertyFlagBits::eHostVisible)
-    		.MemoryProperty(vk::MemoryPropertyFlagBits::eHostCoherent)
-    		.Build();
-
-    	m_set = Memory::Descriptor::Set::Builder(Context::Scheduler().DescriptorPool(), *m_setLayout)
-			.WriteBuffer(0, m_cameraBuffer->DescriptorInfo())
-			.Build();
     }
 
-	void Scene::Update(const float deltaTime) {
+	void Scene::LatchCamera(const float deltaTime) {
 		auto& mainCamera = MainCamera();
 
 		if (Input::IsMouseButtonHeld(MouseButton::MouseButtonRight)) {
@@ -141,17 +126,15 @@ namespace Coral::ECS {
 		if (mainCamera.Changed() || mainCamera.Moved()) {
 			mainCamera.RecalculateView();
 			mainCamera.RecalculateProjection();
-
-			m_cameraBuffer->Map<GPU::Camera>();
-			m_cameraBuffer->WriteAt(0, GPU::Camera {
-				.view = mainCamera.View(),
-				.projection = mainCamera.Projection(),
-				.inverseView = mainCamera.InverseView(),
-				.inverseProjection = mainCamera.InverseProjection(),
-			});
-			m_cameraBuffer->Flush();
-			m_cameraBuffer->Unmap();
 		}
+
+		// The region is rewound every frame, so the camera is written even when it did not change
+		m_cameraOffset = Context::Scheduler().UniformRing().Push(GPU::Camera {
+			.view = mainCamera.View(),
+			.projection = mainCamera.Projection(),
+			.inverseView = mainCamera.InverseView(),
+			.inverseProjection = mainCamera.InverseProjection(),
+		});
     }
 
     Camera& Scene::MainCamera() {
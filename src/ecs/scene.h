@@ -9,13 +9,6 @@
 
 #include <entt/entt.hpp>
 
-namespace Coral::Memory {
-	class Buffer;
-}
-namespace Coral::Memory::Descriptor {
-	class SetLayout;
-	class Set;
-}
 namespace Coral::Reef {
     class EntityInspector;
 }
@@ -32,11 +25,14 @@ namespace Coral::ECS {
         void OnGUIAttach() override;
 		void Setup();
 
-		void Update(float deltaTime);
+		// Applies the freshly polled input to the main camera and writes it into this frame's uniform ring region,
+		// called right before the frame is recorded
+		void LatchCamera(float deltaTime);
 
         [[nodiscard]] Entity& Root() const { return *m_root; }
 
-    	[[nodiscard]] Memory::Descriptor::Set& DescriptorSet() const { return *m_set; }
+    	// Dynamic offset of the camera constants written by LatchCamera
+    	[[nodiscard]] u32 CameraOffset() const { return m_cameraOffset; }
 
         Camera& MainCamera();
 
@@ -47,8 +43,6 @@ namespace Coral::ECS {
         std::unique_ptr<Entity> m_root = nullptr;
         entt::entity m_selectedObject = entt::null;
 
-    	std::unique_ptr<Memory::Descriptor::SetLayout> m_setLayout;
-    	std::unique_ptr<Memory::Descriptor::Set> m_set;
-    	std::unique_ptr<Memory::Buffer> m_cameraBuffer;
+    	u32 m_cameraOffset = 0;
     };
 }
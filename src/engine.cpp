@@ -1,8 +1,11 @@
 //
 // Created by radue on 10/24/2024.
 //
-#include <chrono>
+#include <algorithm>
+#include <array>
+#include <format>
 
+#include "core/jobSystem.h"
 #include "core/window.h"
 #include "core/input.h"
 #include "core/runtime.h"
@@ -19,19 +22,24 @@
 #include "shader/manager.h"
 
 #include "gui/elements/popup.h"
+#include "tests/benchmark.h"
+#include "tests/selfTest.h"
 
 namespace Coral {
-    Engine::Engine() {
+    Engine::Engine(const CreateInfo& createInfo) : m_info(createInfo) {
+        m_jobSystem = std::make_unique<Core::JobSystem>(Core::JobSystem::CreateInfo {});
+
         const auto windowCreateInfo = Core::Window::CreateInfo {
             .title = "Coral",
-            .extent = { 1920u, 1080u },
+            .extent = createInfo.extent,
             .resizable = true,
-            .fullscreen = false
+            .fullscreen = false,
+            .headless = createInfo.headless,
         };
 
         m_window = std::make_unique<Core::Window>(windowCreateInfo);
 
-        const auto runtimeCreateInfo = Core::Runtime::CreateInfo {
+        auto runtimeCreateInfo = Core::Runtime::CreateInfo {
             .deviceFeatures = vk::PhysicalDeviceFeatures()
 	            .setSamplerAnisotropy(true)
 	            .setFragmentStoresAndAtomics(true)
@@ -48,6 +56,11 @@ namespace Coral {
             .deviceExtensions = {
                 VK_KHR_SWAPCHAIN_EXTENSION_NAME,
                 VK_EXT_MESH_SHADER_EXTENSION_NAME,
+                // Core in 1.3, but the ImGui backend only loads the KHR entry points
+                VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME,
+            },
+            .optionalDeviceExtensions = {
+                VK_EXT_MEMORY_BUDGET_EXTENSION_NAME,
             },
             .deviceLayers = {
                 "VK_LAYER_KHRONOS_validation",
@@ -57,21 +70,40 @@ namespace Coral {
                 vk::QueueFlagBits::eCompute,
                 vk::QueueFlagBits::eTransfer,
             },
+            .headless = createInfo.headless,
         };
+        if (createInfo.headless) {
+            std::erase_if(runtimeCreateInfo.deviceExtensions, [](const char* extension) {
+                return std::string_view(extension) == VK_KHR_SWAPCHAIN_EXTENSION_NAME;
+            });
+        }
 
         m_runtime = std::make_unique<Core::Runtime>(runtimeCreateInfo);
         m_device = std::make_unique<Core::Device>();
+        m_allocator = std::make_unique<Memory::Allocator>(Memory::Allocator::CreateInfo {});
+        m_deletionQueue = std::make_unique<Core::DeletionQueue>();
+        m_layoutCache = std::make_unique<Memory::Descriptor::LayoutCache>();
+        m_samplerCache = std::make_unique<Memory::SamplerCache>();
+        m_uploadManager = std::make_unique<Memory::UploadManager>(Memory::UploadManager::CreateInfo {});
 
     	m_shaderManager = std::make_unique<Shader::Manager>(std::filesystem::path("shaders"));
         const auto schedulerCreateInfo = Core::Scheduler::CreateInfo {
             .minImageCount = m_runtime->PhysicalDevice().SurfaceCapabilities().minImageCount,
             .imageCount = 3,
+            .framesInFlight = 2,
             .multiSampling = vk::SampleCountFlagBits::e2,
+            .enableGUI = !createInfo.headless,
+            .headless = createInfo.headless,
+            .outputDirectory = createInfo.outputDirectory,
+            .presentMode = createInfo.presentMode,
+            .targetFrameRate = createInfo.targetFrameRate,
+            .mergeSubpasses = createInfo.mergeSubpasses,
         };
 
         m_scheduler = std::make_unique<Core::Scheduler>(schedulerCreateInfo);
     	m_sceneManager = std::make_unique<ECS::SceneManager>();
     	m_assetManager = Reef::MakeContainer<Asset::Manager>();
+    	m_memoryPanel = Reef::MakeContainer<Reef::MemoryPanel>();
     }
 
     void Engine::Run() const {
@@ -80,29 +112,76 @@ namespace Coral {
 		Asset::Importer("assets/DamagedHelmet/DamagedHelmet.gltf").Import();
 		// Asset::Importer("E:/main_sponza/NewSponza_Main_glTF_003.gltf").Import();
 
-        while (!m_window->ShouldClose()) {
-	        auto startTime = std::chrono::high_resolution_clock::now();
+        u64 frameCount = 0;
+        while (!m_window->ShouldClose() && (m_info.frameCount == 0 || frameCount < m_info.frameCount)) {
+        	m_scheduler->FramePacer().WaitForNextFrame();
+        	m_allocator->PollBudget();
         	m_window->PollEvents();
+        	HandlePacingHotkeys();
+        	m_jobSystem->ProcessMainThreadJobs();
         	m_window->UpdateDeltaTime();
         	m_shaderManager->Update();
         	m_sceneManager->Update(m_window->DeltaTime());
 
             if (!m_window->IsPaused()) {
-            	if (ECS::SceneManager::Get().IsSceneLoaded())
-					m_sceneManager->GetLoadedScene().Update(m_window->DeltaTime());
+                m_assetManager->Update();
                 m_scheduler->Update(m_window->DeltaTime());
                 m_scheduler->Draw();
+                frameCount++;
             }
 
         	m_shaderManager->LateUpdate();
 
             Input::Update();
 
-            auto end = std::chrono::high_resolution_clock::now();
-            const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(end - startTime).count();
-            m_window->SetTitle("Coral - " + std::to_string(1000000.f / static_cast<float>(elapsed)) + "fps");
+            const auto& pacer = m_scheduler->FramePacer();
+            const auto& stats = pacer.Stats();
+            m_window->SetTitle(std::format("Coral - {:.1f}fps - {:.2f}ms input to submit - {} - {}",
+                stats.averageFrameTime > 0.0 ? 1000.0 / stats.averageFrameTime : 0.0, stats.averageInputToSubmit,
+                vk::to_string(pacer.PresentMode()),
+                pacer.TargetFrameRate() > 0.0f ? std::format("{:.0f}fps cap", pacer.TargetFrameRate()) : "uncapped"));
+        }
+        Shutdown();
+    }
+
+    void Engine::HandlePacingHotkeys() const {
+        auto& pacer = m_scheduler->FramePacer();
+        if (Input::IsKeyPressed(Key::F5)) {
+            constexpr std::array presentModes = {
+                vk::PresentModeKHR::eFifo,
+                vk::PresentModeKHR::eFifoRelaxed,
+                vk::PresentModeKHR::eMailbox,
+                vk::PresentModeKHR::eImmediate,
+            };
+            const auto current = std::ranges::find(presentModes, pacer.PresentMode()) - presentModes.begin();
+            pacer.SetPresentMode(presentModes[(current + 1) % presentModes.size()]);
+        }
+        if (Input::IsKeyPressed(Key::F6)) {
+            constexpr std::array frameRates = { 0.0f, 30.0f, 60.0f, 120.0f, 144.0f };
+            const auto current = std::ranges::find(frameRates, pacer.TargetFrameRate()) - frameRates.begin();
+            pacer.SetTargetFrameRate(frameRates[(current + 1) % frameRates.size()]);
         }
+    }
+
+    u32 Engine::SelfTest(const std::string_view filter) const {
+        const auto failed = Test::RunAll(filter);
+        Shutdown();
+        return failed;
+    }
+
+    void Engine::BenchmarkAllocator() const {
+        Test::BenchmarkAllocator();
+        Shutdown();
+    }
+
+    void Engine::Shutdown() const {
         Context::Device()->waitIdle();
+        // Nothing is in flight anymore, whatever the owners release from here on can go right away
+        m_deletionQueue->Flush();
+        m_deletionQueue->SetImmediate(true);
+        if (!m_info.memoryReport.empty()) {
+            m_allocator->DumpReport(m_info.memoryReport);
+        }
     }
 }
 
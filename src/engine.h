@@ -3,11 +3,20 @@
 //
 
 #pragma once
+#include <filesystem>
 #include <memory>
+#include <string_view>
 
 #include "assets/manager.h"
+#include "core/deletionQueue.h"
+#include "core/jobSystem.h"
 #include "core/scheduler.h"
 #include "ecs/sceneManager.h"
+#include "gui/memoryPanel.h"
+#include "memory/allocator.h"
+#include "memory/descriptor/layoutCache.h"
+#include "memory/samplerCache.h"
+#include "memory/uploadManager.h"
 #include "shader/manager.h"
 
 
@@ -19,16 +28,52 @@ namespace Coral::Core {
 namespace Coral {
 	class Engine {
     public:
-        Engine();
+        struct CreateInfo {
+            Math::Vector2<u32> extent = { 1920u, 1080u };
+            // No window, surface, swap chain nor GUI, the device may be a CPU implementation such as lavapipe
+            bool headless = false;
+            // Stops after this many frames, 0 runs until the window is closed
+            u64 frameCount = 0;
+            // Headless frames are written here, left empty they are discarded
+            std::filesystem::path outputDirectory;
+            // Falls back to FIFO when the surface does not support it
+            vk::PresentModeKHR presentMode = vk::PresentModeKHR::eMailbox;
+            // 0 leaves the frame rate to the present mode
+            f32 targetFrameRate = 0.0f;
+            // The allocator's JSON report is written here on exit, left empty nothing is written
+            std::filesystem::path memoryReport;
+            // Off renders every pass of the graph on its own, which takes the dynamic rendering path
+            bool mergeSubpasses = true;
+        };
+
+        explicit Engine(const CreateInfo& createInfo = {});
         void Run() const;
+        // Runs the tests whose name starts with filter instead of rendering, returns how many failed
+        [[nodiscard]] u32 SelfTest(std::string_view filter) const;
+        // Prints allocate/free timings of the allocator next to vkAllocateMemory
+        void BenchmarkAllocator() const;
 
     private:
+        // F5 cycles the present mode, F6 the frame rate cap
+        void HandlePacingHotkeys() const;
+        void Shutdown() const;
+
+        CreateInfo m_info;
+        std::unique_ptr<Core::JobSystem> m_jobSystem;
         std::unique_ptr<Core::Window> m_window;
         std::unique_ptr<Core::Runtime> m_runtime;
         std::unique_ptr<Core::Device> m_device;
+        std::unique_ptr<Memory::Allocator> m_allocator;
+        // Outlives every owner of GPU objects but still frees into the allocator
+        std::unique_ptr<Core::DeletionQueue> m_deletionQueue;
+        // The caches outlive everything holding a layout or a sampler
+        std::unique_ptr<Memory::Descriptor::LayoutCache> m_layoutCache;
+        std::unique_ptr<Memory::SamplerCache> m_samplerCache;
+        std::unique_ptr<Memory::UploadManager> m_uploadManager;
 		std::unique_ptr<Shader::Manager> m_shaderManager = nullptr;
         std::unique_ptr<Core::Scheduler> m_scheduler;
 		std::unique_ptr<ECS::SceneManager> m_sceneManager = nullptr;
 		Reef::Container<Asset::Manager> m_assetManager = nullptr;
+		Reef::Container<Reef::MemoryPanel> m_memoryPanel = nullptr;
     };
 }
\ No newline at end of file
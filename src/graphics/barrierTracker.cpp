@@ -0,0 +1,233 @@
+//
+// Created by radue on 10/17/2026.
+//
+
+#include "barrierTracker.h"
+
+#include <stdexcept>
+
+#include "memory/image.h"
+
+namespace Coral::Graphics {
+    static constexpr auto WriteAccess = vk::AccessFlagBits2::eShaderWrite | vk::AccessFlagBits2::eShaderStorageWrite |
+        vk::AccessFlagBits2::eColorAttachmentWrite | vk::AccessFlagBits2::eDepthStencilAttachmentWrite |
+        vk::AccessFlagBits2::eTransferWrite | vk::AccessFlagBits2::eHostWrite | vk::AccessFlagBits2::eMemoryWrite;
+
+    void BarrierTracker::Require(const Memory::Image& image, const State& state, const u32 baseMipLevel, const u32 levelCount) {
+        auto& subresources = Subresources(image);
+        for (u32 mipLevel = baseMipLevel; mipLevel < baseMipLevel + levelCount; mipLevel++) {
+            auto& current = subresources.at(mipLevel);
+
+            const bool transition = state.layout != vk::ImageLayout::eUndefined && state.layout != current.layout;
+            const bool foreign = state.queueFamily != vk::QueueFamilyIgnored && current.queueFamily != vk::QueueFamilyIgnored &&
+                state.queueFamily != current.queueFamily;
+            // Discarded contents are not transferred, the new queue simply starts using the image
+            const bool acquire = foreign && !state.discard;
+            const bool writes = Writes(state.access);
+
+            if (acquire) {
+                // The release already made the previous accesses available, the acquire only has to repeat its transition
+                const auto oldLayout = current.releasedLayout.value_or(current.layout);
+                if (state.layout != vk::ImageLayout::eUndefined && state.layout != current.layout) {
+                    throw std::runtime_error("BarrierTracker::Require : Acquired layout differs from the released one");
+                }
+                Queue(image, mipLevel, vk::ImageMemoryBarrier2()
+                    .setDstStageMask(state.stages)
+                    .setDstAccessMask(state.access)
+                    .setOldLayout(oldLayout)
+                    .setNewLayout(current.layout)
+                    .setSrcQueueFamilyIndex(current.queueFamily)
+                    .setDstQueueFamilyIndex(state.queueFamily));
+            } else if (transition || writes) {
+                // A write after reads only has to wait for them to execute, after a write it also has to see the data. The
+                // stages of another queue were waited on by a semaphore, a barrier on this one cannot name them.
+                const auto srcStages = foreign ? vk::PipelineStageFlags2() : current.writeStages | current.readStages;
+                if (!transition && !srcStages) {
+                    m_statistics.skipped++;
+                } else {
+                    Queue(image, mipLevel, vk::ImageMemoryBarrier2()
+                        .setSrcStageMask(srcStages)
+                        .setSrcAccessMask(foreign ? vk::AccessFlags2() : current.writeAccess)
+                        .setDstStageMask(state.stages)
+                        .setDstAccessMask(state.access)
+                        .setOldLayout(transition && state.discard ? vk::ImageLayout::eUndefined : current.layout)
+                        .setNewLayout(transition ? state.layout : current.layout));
+                }
+            } else {
+                const bool visible = !(state.stages & ~current.visibleStages) && !(state.access & ~current.visibleAccess);
+                if (!current.writeStages || visible) {
+                    m_statistics.skipped++;
+                } else {
+                    Queue(image, mipLevel, vk::ImageMemoryBarrier2()
+                        .setSrcStageMask(current.writeStages)
+                        .setSrcAccessMask(current.writeAccess)
+                        .setDstStageMask(state.stages)
+                        .setDstAccessMask(state.access)
+                        .setOldLayout(current.layout)
+                        .setNewLayout(current.layout));
+                }
+                current.visibleStages |= state.stages;
+                current.visibleAccess |= state.access;
+                current.readStages |= state.stages;
+                current.readAccess |= state.access;
+                continue;
+            }
+
+            if (transition) {
+                current.layout = state.layout;
+            }
+            if (state.queueFamily != vk::QueueFamilyIgnored) {
+                current.queueFamily = state.queueFamily;
+            }
+            current.releasedLayout.reset();
+
+            if (writes) {
+                current.writeStages = state.stages;
+                current.writeAccess = state.access & WriteAccess;
+                current.visibleStages = vk::PipelineStageFlags2();
+                current.visibleAccess = vk::AccessFlags2();
+            } else {
+                // Later accesses in other stages still have to wait for the transition
+                current.writeStages = state.stages;
+                current.writeAccess = vk::AccessFlags2();
+                current.visibleStages = state.stages;
+                current.visibleAccess = state.access;
+            }
+            current.readStages = state.stages;
+            current.readAccess = state.access & ~WriteAccess;
+        }
+    }
+
+    void BarrierTracker::Assume(const Memory::Image& image, const State& state, const u32 baseMipLevel, const u32 levelCount) {
+        auto& subresources = Subresources(image);
+        for (u32 mipLevel = baseMipLevel; mipLevel < baseMipLevel + levelCount; mipLevel++) {
+            auto& current = subresources.at(mipLevel);
+            if (state.layout != vk::ImageLayout::eUndefined) {
+                current.layout = state.layout;
+            }
+            if (state.queueFamily != vk::QueueFamilyIgnored) {
+                current.queueFamily = state.queueFamily;
+            }
+            current.releasedLayout.reset();
+
+            if (Writes(state.access)) {
+                current.writeStages = state.stages;
+                current.writeAccess = state.access & WriteAccess;
+                current.readStages = vk::PipelineStageFlags2();
+                current.readAccess = vk::AccessFlags2();
+                current.visibleStages = vk::PipelineStageFlags2();
+                current.visibleAccess = vk::AccessFlags2();
+            } else {
+                current.readStages |= state.stages;
+                current.readAccess |= state.access;
+            }
+        }
+    }
+
+    void BarrierTracker::Release(const Memory::Image& image, const u32 dstQueueFamily, const vk::ImageLayout layout, const u32 baseMipLevel, const u32 levelCount) {
+        auto& subresources = Subresources(image);
+        for (u32 mipLevel = baseMipLevel; mipLevel < baseMipLevel + levelCount; mipLevel++) {
+            auto& current = subresources.at(mipLevel);
+            if (current.queueFamily == vk::QueueFamilyIgnored || current.queueFamily == dstQueueFamily) {
+                continue;
+            }
+
+            const auto newLayout = layout != vk::ImageLayout::eUndefined ? layout : current.layout;
+            Queue(image, mipLevel, vk::ImageMemoryBarrier2()
+                .setSrcStageMask(current.writeStages | current.readStages)
+                .setSrcAccessMask(current.writeAccess)
+                .setOldLayout(current.layout)
+                .setNewLayout(newLayout)
+                .setSrcQueueFamilyIndex(current.queueFamily)
+                .setDstQueueFamilyIndex(dstQueueFamily));
+
+            // The queue family stays until the acquire, which is how Require knows to record it
+            current.releasedLayout = current.layout;
+            current.layout = newLayout;
+        }
+    }
+
+    void BarrierTracker::GlobalBarrier(const vk::PipelineStageFlags2 srcStages, const vk::AccessFlags2 srcAccess,
+        const vk::PipelineStageFlags2 dstStages, const vk::AccessFlags2 dstAccess) {
+        m_memoryBarriers.emplace_back(vk::MemoryBarrier2()
+            .setSrcStageMask(srcStages)
+            .setSrcAccessMask(srcAccess)
+            .setDstStageMask(dstStages)
+            .setDstAccessMask(dstAccess));
+        m_statistics.globalBarriers++;
+    }
+
+    void BarrierTracker::Flush(const vk::CommandBuffer& commandBuffer) {
+        if (m_imageBarriers.empty() && m_memoryBarriers.empty()) {
+            return;
+        }
+
+        commandBuffer.pipelineBarrier2(vk::DependencyInfo()
+            .setMemoryBarriers(m_memoryBarriers)
+            .setImageMemoryBarriers(m_imageBarriers));
+        m_statistics.flushes++;
+
+        m_imageBarriers.clear();
+        m_memoryBarriers.clear();
+    }
+
+    void BarrierTracker::Forget(const Memory::Image& image) {
+        m_subresources.erase(*image);
+    }
+
+    void BarrierTracker::Reset() {
+        m_subresources.clear();
+        m_imageBarriers.clear();
+        m_memoryBarriers.clear();
+    }
+
+    vk::ImageAspectFlags BarrierTracker::AspectMask(const vk::Format format) {
+        switch (format) {
+            case vk::Format::eD16Unorm:
+            case vk::Format::eX8D24UnormPack32:
+            case vk::Format::eD32Sfloat:
+                return vk::ImageAspectFlagBits::eDepth;
+            case vk::Format::eD16UnormS8Uint:
+            case vk::Format::eD24UnormS8Uint:
+            case vk::Format::eD32SfloatS8Uint:
+                return vk::ImageAspectFlagBits::eDepth | vk::ImageAspectFlagBits::eStencil;
+            case vk::Format::eS8Uint:
+                return vk::ImageAspectFlagBits::eStencil;
+            default:
+                return vk::ImageAspectFlagBits::eColor;
+        }
+    }
+
+    bool BarrierTracker::Writes(const vk::AccessFlags2 access) {
+        return static_cast<bool>(access & WriteAccess);
+    }
+
+    std::vector<BarrierTracker::Subresource>& BarrierTracker::Subresources(const Memory::Image& image) {
+        if (const auto it = m_subresources.find(*image); it != m_subresources.end()) {
+            return it->second;
+        }
+        // Whatever happened before the image was first seen was waited on some other way, e.g. the upload batch
+        return m_subresources.emplace(*image, std::vector(image.MipLevels(), Subresource { .layout = image.Layout() })).first->second;
+    }
+
+    void BarrierTracker::Queue(const Memory::Image& image, const u32 mipLevel, vk::ImageMemoryBarrier2 barrier) {
+        barrier
+            .setImage(*image)
+            .setSubresourceRange(vk::ImageSubresourceRange(AspectMask(image.Format()), mipLevel, 1, 0, image.LayerCount()));
+
+        // Several requirements of one pass on the same subresource end up in one barrier
+        for (auto& queued : m_imageBarriers) {
+            if (queued.image == barrier.image && queued.subresourceRange == barrier.subresourceRange &&
+                queued.oldLayout == barrier.oldLayout && queued.newLayout == barrier.newLayout &&
+                queued.srcQueueFamilyIndex == barrier.srcQueueFamilyIndex && queued.dstQueueFamilyIndex == barrier.dstQueueFamilyIndex) {
+                queued.srcStageMask |= barrier.srcStageMask;
+                queued.srcAccessMask |= barrier.srcAccessMask;
+                queued.dstStageMask |= barrier.dstStageMask;
+                queued.dstAccessMask |= barrier.dstAccessMask;
+                return;
+            }
+        }
+        m_imageBarriers.emplace_back(barrier);
+        m_statistics.imageBarriers++;
+    }
+}
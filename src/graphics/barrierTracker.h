@@ -0,0 +1,92 @@
+//
+// Created by radue on 10/17/2026.
+//
+
+#pragma once
+
+#include <optional>
+#include <unordered_map>
+#include <vector>
+
+#include <vulkan/vulkan.hpp>
+
+#include "utils/types.h"
+
+namespace Coral::Memory {
+    class Image;
+}
+
+namespace Coral::Graphics {
+    // Remembers the last layout, stages, accesses and queue family of every image subresource it has seen and turns
+    // the state the next commands need into the narrowest synchronization2 barrier. Barriers are batched until Flush,
+    // so everything a pass needs is recorded as one vkCmdPipelineBarrier2 at its boundary.
+    class BarrierTracker {
+    public:
+        struct State {
+            // Undefined when the commands accept any layout, e.g. a render pass that transitions from undefined itself
+            vk::ImageLayout layout = vk::ImageLayout::eUndefined;
+            vk::PipelineStageFlags2 stages;
+            vk::AccessFlags2 access;
+            // Ignored when ownership does not matter
+            u32 queueFamily = vk::QueueFamilyIgnored;
+            // The previous contents are not needed, a transition starts from an undefined layout
+            bool discard = false;
+        };
+
+        struct Statistics {
+            u32 imageBarriers = 0;
+            u32 globalBarriers = 0;
+            u32 flushes = 0;
+            // Requirements already satisfied by the tracked state
+            u32 skipped = 0;
+        };
+
+        // Queues whatever barrier the state needs for the mip levels, none if earlier barriers already cover it
+        void Require(const Memory::Image& image, const State& state, u32 baseMipLevel = 0, u32 levelCount = 1);
+        // Records commands that changed the image without a barrier of ours, e.g. a render pass and its final layout
+        void Assume(const Memory::Image& image, const State& state, u32 baseMipLevel = 0, u32 levelCount = 1);
+        // The release half of an ownership transfer, recorded on the queue giving the image away. The acquire half is
+        // queued by the next Require with a different queue family.
+        void Release(const Memory::Image& image, u32 dstQueueFamily, vk::ImageLayout layout, u32 baseMipLevel = 0, u32 levelCount = 1);
+        // For hazards the per image state cannot see, such as images aliasing the same memory or host readbacks
+        void GlobalBarrier(vk::PipelineStageFlags2 srcStages, vk::AccessFlags2 srcAccess, vk::PipelineStageFlags2 dstStages, vk::AccessFlags2 dstAccess);
+        // Records every queued barrier, does nothing when none is queued
+        void Flush(const vk::CommandBuffer& commandBuffer);
+
+        // Must be called for images whose handle is recreated, their state is read again from the image
+        void Forget(const Memory::Image& image);
+        void Reset();
+
+        [[nodiscard]] const Statistics& Stats() const { return m_statistics; }
+        // Image barriers queued since the last Flush
+        [[nodiscard]] const std::vector<vk::ImageMemoryBarrier2>& PendingImageBarriers() const { return m_imageBarriers; }
+
+        [[nodiscard]] static vk::ImageAspectFlags AspectMask(vk::Format format);
+        [[nodiscard]] static bool Writes(vk::AccessFlags2 access);
+
+    private:
+        struct Subresource {
+            vk::ImageLayout layout = vk::ImageLayout::eUndefined;
+            u32 queueFamily = vk::QueueFamilyIgnored;
+            // The last write, later accesses have to wait on it
+            vk::PipelineStageFlags2 writeStages;
+            vk::AccessFlags2 writeAccess;
+            // Reads since the last write, a later write only has to wait for them to execute
+            vk::PipelineStageFlags2 readStages;
+            vk::AccessFlags2 readAccess;
+            // Stages and accesses the last write was already made visible to
+            vk::PipelineStageFlags2 visibleStages;
+            vk::AccessFlags2 visibleAccess;
+            // Layout before a pending release, the acquire has to repeat the release's transition
+            std::optional<vk::ImageLayout> releasedLayout;
+        };
+
+        std::vector<Subresource>& Subresources(const Memory::Image& image);
+        void Queue(const Memory::Image& image, u32 mipLevel, vk::ImageMemoryBarrier2 barrier);
+
+        std::unordered_map<vk::Image, std::vector<Subresource>> m_subresources;
+        std::vector<vk::ImageMemoryBarrier2> m_imageBarriers;
+        std::vector<vk::MemoryBarrier2> m_memoryBarriers;
+        Statistics m_statistics;
+    };
+}
@@ -4,17 +4,14 @@
 
 #include "framebuffer.h"
 
+#include "core/deletionQueue.h"
+
 namespace Coral::Graphics {
-	Framebuffer::Framebuffer(const RenderPass &renderPass, const u32 index): m_renderPass(renderPass) {
+	Framebuffer::Framebuffer(const RenderPass &renderPass, const u32 index): m_renderPass(renderPass), m_index(index) {
+		// The render pass recreates its framebuffers whenever the attachment images are resized
 		std::vector<vk::ImageView> attachments;
-		for (const auto& attachment : renderPass.Attachments()) {
-			const auto& imageView = *m_imageViews.emplace_back(
-				Memory::ImageView::Builder(*attachment.images[index])
-					.ViewType(vk::ImageViewType::e2D)
-					.BaseMipLevel(0)
-					.LevelCount(1)
-					.Build());
-			attachments.emplace_back(*imageView);
+		for (u32 i = 0; i < renderPass.Attachments().size(); i++) {
+			attachments.emplace_back(*ImageView(i));
 		}
 
 		const auto createInfo = vk::FramebufferCreateInfo()
@@ -28,6 +25,14 @@ namespace Coral::Graphics {
 	}
 
 	Framebuffer::~Framebuffer() {
-		Context::Device()->destroyFramebuffer(m_handle);
+		Context::DeletionQueue().Retire([handle = m_handle] { Context::Device()->destroyFramebuffer(handle); });
+	}
+
+	const Memory::ImageView& Framebuffer::ImageView(const u32 attachment) const {
+		return Memory::ImageView::Builder(*m_renderPass.Attachments()[attachment].images[m_index])
+			.ViewType(vk::ImageViewType::e2D)
+			.BaseMipLevel(0)
+			.LevelCount(1)
+			.Acquire();
 	}
 }
\ No newline at end of file
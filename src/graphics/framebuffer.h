@@ -12,10 +12,11 @@ namespace Coral::Graphics {
 		explicit Framebuffer(const RenderPass& renderPass, uint32_t index);
 		~Framebuffer() override;
 
-		[[nodiscard]] const Memory::ImageView& ImageView(const uint32_t index) const { return *m_imageViews[index]; }
+		// Acquired again on every call, resizing or recreating an attachment image drops the views it handed out
+		[[nodiscard]] const Memory::ImageView& ImageView(uint32_t attachment) const;
 
 	private:
 		const RenderPass& m_renderPass;
-		std::vector<std::unique_ptr<Memory::ImageView>> m_imageViews;
+		uint32_t m_index;
 	};
 }
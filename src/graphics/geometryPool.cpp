@@ -0,0 +1,164 @@
+//
+// Created by radue on 10/17/2026.
+//
+
+#include "geometryPool.h"
+
+#include <algorithm>
+
+#include "context.h"
+#include "core/deletionQueue.h"
+#include "memory/buffer.h"
+#include "memory/uploadManager.h"
+#include "objects/mesh.h"
+
+namespace Coral::Graphics {
+    GeometryPool::FreeList::FreeList(const u32 capacity) : m_capacity(capacity) {
+        m_ranges.emplace_back(Range { .offset = 0, .count = capacity });
+    }
+
+    std::optional<u32> GeometryPool::FreeList::Allocate(const u32 count) {
+        if (count == 0) {
+            return 0;
+        }
+        for (auto it = m_ranges.begin(); it != m_ranges.end(); ++it) {
+            if (it->count < count) {
+                continue;
+            }
+            const auto offset = it->offset;
+            it->offset += count;
+            it->count -= count;
+            if (it->count == 0) {
+                m_ranges.erase(it);
+            }
+            m_used += count;
+            return offset;
+        }
+        return std::nullopt;
+    }
+
+    void GeometryPool::FreeList::Free(const u32 offset, const u32 count) {
+        if (count == 0) {
+            return;
+        }
+        m_used -= count;
+
+        auto next = std::ranges::lower_bound(m_ranges, offset, {}, &Range::offset);
+        if (next != m_ranges.begin()) {
+            if (const auto previous = std::prev(next); previous->offset + previous->count == offset) {
+                previous->count += count;
+                if (next != m_ranges.end() && previous->offset + previous->count == next->offset) {
+                    previous->count += next->count;
+                    m_ranges.erase(next);
+                }
+                return;
+            }
+        }
+        if (next != m_ranges.end() && offset + count == next->offset) {
+            next->offset = offset;
+            next->count += count;
+            return;
+        }
+        m_ranges.insert(next, Range { .offset = offset, .count = count });
+    }
+
+    GeometryPool::GeometryPool(const CreateInfo &createInfo)
+        : m_vertexCapacity(std::max(1u, createInfo.vertexCapacity)), m_indexCapacity(std::max(1u, createInfo.indexCapacity)) {
+        CreateBlock(m_vertexCapacity, m_indexCapacity);
+    }
+
+    GeometryPool::~GeometryPool() = default;
+
+    GeometryPool::Allocation GeometryPool::Allocate(const std::span<const Vertex> vertices, const std::span<const u32> indices) {
+        const auto vertexCount = static_cast<u32>(vertices.size());
+        const auto indexCount = static_cast<u32>(indices.size());
+
+        auto allocation = Allocation { .vertexCount = vertexCount, .indexCount = indexCount };
+        for (u32 i = 0; i < m_blocks.size() && allocation.block == InvalidBlock; i++) {
+            auto& [vertexBuffer, indexBuffer, blockVertices, blockIndices] = m_blocks[i];
+            const auto vertexOffset = blockVertices.Allocate(vertexCount);
+            if (!vertexOffset) {
+                continue;
+            }
+            const auto firstIndex = blockIndices.Allocate(indexCount);
+            if (!firstIndex) {
+                blockVertices.Free(*vertexOffset, vertexCount);
+                continue;
+            }
+            allocation.block = i;
+            allocation.vertexOffset = *vertexOffset;
+            allocation.firstIndex = *firstIndex;
+        }
+
+        if (allocation.block == InvalidBlock) {
+            CreateBlock(std::max(m_vertexCapacity, vertexCount), std::max(m_indexCapacity, indexCount));
+            allocation.block = static_cast<u32>(m_blocks.size() - 1);
+            allocation.vertexOffset = m_blocks.back().vertices.Allocate(vertexCount).value();
+            allocation.firstIndex = m_blocks.back().indices.Allocate(indexCount).value();
+        }
+
+        const auto& block = m_blocks[allocation.block];
+        if (vertexCount > 0) {
+            Context::UploadManager().Upload(*block.vertexBuffer, std::as_bytes(vertices), allocation.vertexOffset * sizeof(Vertex));
+        }
+        if (indexCount > 0) {
+            Context::UploadManager().Upload(*block.indexBuffer, std::as_bytes(indices), allocation.firstIndex * sizeof(u32));
+        }
+        return allocation;
+    }
+
+    void GeometryPool::Free(const Allocation &allocation) {
+        if (allocation.block == InvalidBlock) {
+            return;
+        }
+        // The frame being recorded may draw from the ranges too, the deletion queue stamps them with the value that frame signals
+        Context::DeletionQueue().Retire([this, allocation] {
+            auto& block = m_blocks[allocation.block];
+            block.vertices.Free(allocation.vertexOffset, allocation.vertexCount);
+            block.indices.Free(allocation.firstIndex, allocation.indexCount);
+        });
+    }
+
+    void GeometryPool::Bind(const vk::CommandBuffer commandBuffer, const u32 block) const {
+        const auto& [vertexBuffer, indexBuffer, vertices, indices] = m_blocks.at(block);
+        commandBuffer.bindVertexBuffers(0, **vertexBuffer, vk::DeviceSize { 0 });
+        commandBuffer.bindIndexBuffer(**indexBuffer, 0, vk::IndexType::eUint32);
+    }
+
+    GeometryPool::Statistics GeometryPool::Stats() const {
+        auto statistics = Statistics { .blockCount = BlockCount() };
+        for (const auto& block : m_blocks) {
+            statistics.vertexCapacity += block.vertices.Capacity();
+            statistics.vertexCount += block.vertices.Used();
+            statistics.indexCapacity += block.indices.Capacity();
+            statistics.indexCount += block.indices.Used();
+        }
+        return statistics;
+    }
+
+    void GeometryPool::CreateBlock(const u32 vertexCapacity, const u32 indexCapacity) {
+        auto vertexBuffer = Memory::Buffer::Builder()
+            .InstanceSize(sizeof(Vertex))
+            .InstanceCount(vertexCapacity)
+            .UsageFlags(vk::BufferUsageFlagBits::eTransferDst)
+            .UsageFlags(vk::BufferUsageFlagBits::eVertexBuffer)
+            .UsageFlags(vk::BufferUsageFlagBits::eStorageBuffer)
+            .MemoryProperty(vk::MemoryPropertyFlagBits::eDeviceLocal)
+            .Build();
+        auto indexBuffer = Memory::Buffer::Builder()
+            .InstanceSize(sizeof(u32))
+            .InstanceCount(indexCapacity)
+            .UsageFlags(vk::BufferUsageFlagBits::eTransferDst)
+            .UsageFlags(vk::BufferUsageFlagBits::eIndexBuffer)
+            .UsageFlags(vk::BufferUsageFlagBits::eStorageBuffer)
+            .MemoryProperty(vk::MemoryPropertyFlagBits::eDeviceLocal)
+            .Build();
+
+        m_blocks.emplace_back(Block {
+            .vertexBuffer = std::move(vertexBuffer),
+            .indexBuffer = std::move(indexBuffer),
+            .vertices = FreeList(vertexCapacity),
+            .indices = FreeList(indexCapacity),
+        });
+    }
+}
@@ -0,0 +1,104 @@
+//
+// Created by radue on 10/17/2026.
+//
+
+#pragma once
+
+#include <memory>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include <vulkan/vulkan.hpp>
+
+#include "utils/types.h"
+
+namespace Coral::Memory {
+    class Buffer;
+}
+
+namespace Coral::Graphics {
+    struct Vertex;
+
+    // Vertices and indices of every mesh sub-allocated from a few large blocks, each holding one vertex and one index
+    // buffer. Draws address their geometry through firstIndex and vertexOffset, so meshes sharing a block bind once.
+    class GeometryPool {
+    public:
+        static constexpr u32 InvalidBlock = UINT32_MAX;
+
+        struct CreateInfo {
+            // Capacity of every new block, larger meshes get a block of their own size
+            u32 vertexCapacity = 1 << 20;
+            u32 indexCapacity = 4 << 20;
+        };
+
+        struct Allocation {
+            u32 block = InvalidBlock;
+            u32 vertexOffset = 0;
+            u32 vertexCount = 0;
+            u32 firstIndex = 0;
+            u32 indexCount = 0;
+        };
+
+        struct Statistics {
+            u32 blockCount;
+            u64 vertexCapacity;
+            u64 vertexCount;
+            u64 indexCapacity;
+            u64 indexCount;
+        };
+
+        // First fit over free ranges kept sorted by offset, neighbours are merged on release
+        class FreeList {
+        public:
+            explicit FreeList(u32 capacity);
+
+            [[nodiscard]] std::optional<u32> Allocate(u32 count);
+            void Free(u32 offset, u32 count);
+
+            [[nodiscard]] u32 Capacity() const { return m_capacity; }
+            [[nodiscard]] u32 Used() const { return m_used; }
+            // Separate free ranges, merging keeps adjacent ones from adding up
+            [[nodiscard]] u32 RangeCount() const { return static_cast<u32>(m_ranges.size()); }
+
+        private:
+            struct Range {
+                u32 offset;
+                u32 count;
+            };
+
+            u32 m_capacity;
+            u32 m_used = 0;
+            std::vector<Range> m_ranges;
+        };
+
+        explicit GeometryPool(const CreateInfo &createInfo);
+        ~GeometryPool();
+        GeometryPool(const GeometryPool &) = delete;
+        GeometryPool &operator=(const GeometryPool &) = delete;
+
+        // Copies the geometry into the first block with room for it and queues the upload
+        [[nodiscard]] Allocation Allocate(std::span<const Vertex> vertices, std::span<const u32> indices);
+        // The ranges are only handed out again once the GPU retired every frame that may still read them
+        void Free(const Allocation &allocation);
+
+        void Bind(vk::CommandBuffer commandBuffer, u32 block) const;
+
+        [[nodiscard]] u32 BlockCount() const { return static_cast<u32>(m_blocks.size()); }
+        [[nodiscard]] Statistics Stats() const;
+
+    private:
+        struct Block {
+            std::unique_ptr<Memory::Buffer> vertexBuffer;
+            std::unique_ptr<Memory::Buffer> indexBuffer;
+            FreeList vertices;
+            FreeList indices;
+        };
+
+        void CreateBlock(u32 vertexCapacity, u32 indexCapacity);
+
+        u32 m_vertexCapacity;
+        u32 m_indexCapacity;
+        std::vector<Block> m_blocks;
+    };
+}
@@ -0,0 +1,108 @@
+//
+// Created by radue on 10/17/2026.
+//
+
+#include "materialTable.h"
+
+#include <algorithm>
+#include <span>
+
+#include "context.h"
+#include "core/deletionQueue.h"
+#include "core/scheduler.h"
+#include "memory/buffer.h"
+#include "memory/descriptor/layoutCache.h"
+#include "memory/descriptor/set.h"
+#include "memory/uploadManager.h"
+
+namespace Coral::Graphics {
+    MaterialTable::MaterialTable(const CreateInfo &createInfo) {
+        m_layout = Context::LayoutCache().AcquireSetLayout(LayoutBuilder());
+        m_parameters.resize(std::max(1u, createInfo.initialCapacity));
+        CreateBuffer();
+    }
+
+    MaterialTable::~MaterialTable() = default;
+
+    Memory::Descriptor::SetLayout::Builder MaterialTable::LayoutBuilder() {
+        auto builder = Memory::Descriptor::SetLayout::Builder();
+        builder.AddBinding(Binding, vk::DescriptorType::eStorageBuffer, vk::ShaderStageFlagBits::eAll);
+        return builder;
+    }
+
+    u32 MaterialTable::Register(const GPU::Material &parameters) {
+        u32 slot;
+        if (!m_freeSlots.empty()) {
+            slot = m_freeSlots.back();
+            m_freeSlots.pop_back();
+        } else {
+            if (m_nextSlot == m_parameters.size()) {
+                // The buffer itself is replaced on the next flush
+                m_parameters.resize(m_parameters.size() * 2);
+            }
+            slot = m_nextSlot++;
+        }
+
+        m_parameters[slot] = parameters;
+        MarkDirty(slot);
+        return slot;
+    }
+
+    u32 MaterialTable::Update(const u32 slot, const GPU::Material &parameters) {
+        const auto newSlot = Register(parameters);
+        Unregister(slot);
+        return newSlot;
+    }
+
+    void MaterialTable::Unregister(const u32 slot) {
+        if (slot == InvalidSlot) {
+            return;
+        }
+        // The frame being recorded may read the slot too, the deletion queue stamps it with the value that frame signals
+        m_retiringCount++;
+        Context::DeletionQueue().Retire([this, slot] {
+            m_freeSlots.emplace_back(slot);
+            m_retiringCount--;
+        });
+    }
+
+    void MaterialTable::Flush() {
+        if (m_buffer->InstanceCount() < m_parameters.size()) {
+            // The old buffer and set retire their handles through the deletion queue once released
+            CreateBuffer();
+            m_dirtyBegin = 0;
+            m_dirtyEnd = m_nextSlot;
+        }
+
+        if (m_dirtyBegin >= m_dirtyEnd) {
+            return;
+        }
+        const auto dirty = std::span(m_parameters).subspan(m_dirtyBegin, m_dirtyEnd - m_dirtyBegin);
+        Context::UploadManager().Upload(*m_buffer, std::as_bytes(dirty), m_dirtyBegin * sizeof(GPU::Material));
+        m_dirtyBegin = UINT32_MAX;
+        m_dirtyEnd = 0;
+    }
+
+    void MaterialTable::Bind(const vk::CommandBuffer commandBuffer, const vk::PipelineLayout layout, const vk::PipelineBindPoint bindPoint) const {
+        commandBuffer.bindDescriptorSets(bindPoint, layout, Set, **m_set, nullptr);
+    }
+
+    void MaterialTable::CreateBuffer() {
+        m_buffer = Memory::Buffer::Builder()
+            .InstanceCount(Capacity())
+            .InstanceSize(sizeof(GPU::Material))
+            .UsageFlags(vk::BufferUsageFlagBits::eStorageBuffer)
+            .UsageFlags(vk::BufferUsageFlagBits::eTransferDst)
+            .MemoryProperty(vk::MemoryPropertyFlagBits::eDeviceLocal)
+            .Build();
+
+        m_set = Memory::Descriptor::Set::Builder(Context::Scheduler().DescriptorAllocator(), *m_layout)
+            .WriteBuffer(Binding, m_buffer->DescriptorInfo())
+            .Build();
+    }
+
+    void MaterialTable::MarkDirty(const u32 slot) {
+        m_dirtyBegin = std::min(m_dirtyBegin, slot);
+        m_dirtyEnd = std::max(m_dirtyEnd, slot + 1);
+    }
+}
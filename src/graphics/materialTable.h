@@ -0,0 +1,77 @@
+//
+// Created by radue on 10/17/2026.
+//
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <vulkan/vulkan.hpp>
+
+#include "memory/descriptor/setLayout.h"
+#include "memory/gpuStructs.h"
+#include "utils/types.h"
+
+namespace Coral::Memory {
+    class Buffer;
+}
+
+namespace Coral::Memory::Descriptor {
+    class Set;
+}
+
+namespace Coral::Graphics {
+    // Parameters of every material packed into one storage buffer, draws select theirs by slot.
+    // Changes are kept in a host copy and uploaded as one dirty range per Flush.
+    class MaterialTable {
+    public:
+        // Descriptor set index reserved for the table in every pipeline layout
+        static constexpr u32 Set = 2;
+        static constexpr u32 Binding = 0;
+        static constexpr u32 InvalidSlot = UINT32_MAX;
+
+        struct CreateInfo {
+            // Doubled whenever every slot is taken
+            u32 initialCapacity = 1024;
+        };
+
+        explicit MaterialTable(const CreateInfo &createInfo);
+        ~MaterialTable();
+        MaterialTable(const MaterialTable &) = delete;
+        MaterialTable &operator=(const MaterialTable &) = delete;
+
+        [[nodiscard]] static Memory::Descriptor::SetLayout::Builder LayoutBuilder();
+
+        [[nodiscard]] u32 Register(const GPU::Material &parameters);
+        // Frames in flight may still read the old slot, so the parameters move to a new one which is returned
+        [[nodiscard]] u32 Update(u32 slot, const GPU::Material &parameters);
+        // The slot is only handed out again once the GPU retired every frame that may still read it
+        void Unregister(u32 slot);
+
+        // Uploads the dirty range, growing the buffer first if needed. Has to run before the frame is recorded.
+        void Flush();
+
+        void Bind(vk::CommandBuffer commandBuffer, vk::PipelineLayout layout, vk::PipelineBindPoint bindPoint = vk::PipelineBindPoint::eGraphics) const;
+
+        [[nodiscard]] u32 Capacity() const { return static_cast<u32>(m_parameters.size()); }
+        [[nodiscard]] u32 Count() const { return m_nextSlot - static_cast<u32>(m_freeSlots.size()) - m_retiringCount; }
+
+    private:
+        void CreateBuffer();
+        void MarkDirty(u32 slot);
+
+        std::shared_ptr<const Memory::Descriptor::SetLayout> m_layout;
+        std::unique_ptr<Memory::Buffer> m_buffer;
+        std::unique_ptr<Memory::Descriptor::Set> m_set;
+
+        std::vector<GPU::Material> m_parameters;
+        u32 m_dirtyBegin = UINT32_MAX;
+        u32 m_dirtyEnd = 0;
+
+        u32 m_nextSlot = 0;
+        std::vector<u32> m_freeSlots;
+        // Unregistered slots waiting in the deletion queue
+        u32 m_retiringCount = 0;
+    };
+}
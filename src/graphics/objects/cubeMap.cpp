@@ -9,7 +9,8 @@
 
 #include "memory/buffer.h"
 #include "memory/image.h"
-#include "memory/sampler.h"
+#include "memory/samplerCache.h"
+#include "memory/uploadManager.h"
 
 namespace Coral::Graphics {
     CubeMap::CubeMap(const Builder &builder) {
@@ -46,44 +47,33 @@ namespace Coral::Graphics {
             .InitialLayout(vk::ImageLayout::eTransferDstOptimal)
             .Build();
 
-        const auto stagingBuffer = Memory::Buffer::Builder()
-    		.InstanceSize(sizeof(Math::Vector4<u8>))
-            .InstanceCount(m_size * m_size)
-            .UsageFlags(vk::BufferUsageFlagBits::eTransferSrc)
-            .MemoryProperty(vk::MemoryPropertyFlagBits::eHostVisible)
-            .MemoryProperty(vk::MemoryPropertyFlagBits::eHostCoherent)
-            .Build();
-
         for (uint32_t i = 0; i < 6; i++) {
-            stagingBuffer->Map<Math::Vector4<u8>>();
-            std::span data(reinterpret_cast<Math::Vector4<u8>*>(colors[i]), m_size * m_size);
-            stagingBuffer->Write(data);
-            stagingBuffer->Unmap();
-
-            m_image->Copy(**stagingBuffer, 0, i);
+            const std::span data(reinterpret_cast<const Math::Vector4<u8>*>(colors[i]), m_size * m_size);
+            Context::UploadManager().Upload(*m_image, std::as_bytes(data), 0, i);
+            stbi_image_free(colors[i]);
         }
 
         m_image->TransitionLayout(vk::ImageLayout::eShaderReadOnlyOptimal);
 
-        m_imageViews.emplace_back(Memory::ImageView::Builder(*m_image)
-            .ViewType(vk::ImageViewType::eCube)
-            .BaseArrayLayer(0)
-            .LayerCount(6)
-            .Build());
-
         const auto samplerCreateInfo = Memory::Sampler::CreateInfo {
             .magFilter = vk::Filter::eLinear,
             .minFilter = vk::Filter::eLinear,
             .addressMode = vk::SamplerAddressMode::eRepeat,
             .mipmapMode = vk::SamplerMipmapMode::eLinear
         };
-        m_sampler = std::make_unique<Memory::Sampler>(samplerCreateInfo);
+        m_sampler = Context::SamplerCache().Acquire(samplerCreateInfo);
     }
 
     vk::DescriptorImageInfo CubeMap::DescriptorInfo() const {
+        // Acquired at use time, resizing or recreating the image drops the views it handed out
+        const auto& imageView = Memory::ImageView::Builder(*m_image)
+            .ViewType(vk::ImageViewType::eCube)
+            .BaseArrayLayer(0)
+            .LayerCount(6)
+            .Acquire();
         return vk::DescriptorImageInfo()
                 .setImageLayout(vk::ImageLayout::eShaderReadOnlyOptimal)
-                .setImageView(**m_imageViews[0])
+                .setImageView(*imageView)
                 .setSampler(**m_sampler);
     }
 }
@@ -81,7 +81,6 @@ namespace Coral::Graphics {
     private:
         uint32_t m_size;
         std::unique_ptr<Memory::Image> m_image;
-        std::vector<std::unique_ptr<Memory::ImageView>> m_imageViews;
-        std::unique_ptr<Memory::Sampler> m_sampler;
+        std::shared_ptr<const Memory::Sampler> m_sampler;
     };
 }
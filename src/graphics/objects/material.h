@@ -9,12 +9,12 @@
 #include <boost/uuid/uuid.hpp>
 #include <glm/glm.hpp>
 
-#include "memory/buffer.h"
-#include "memory/descriptor/set.h"
+#include "memory/gpuStructs.h"
 #include "texture.h"
 
 namespace Coral::Graphics {
     class Material {
+    	friend class Asset::Manager;
     public:
         class Builder {
             friend class Material;
@@ -88,15 +88,20 @@ namespace Coral::Graphics {
         }
 
         [[nodiscard]] const std::string& Name() const { return m_name; }
-    	[[nodiscard]] const Memory::Descriptor::Set& DescriptorSet() const { return *m_descriptorSet; }
+    	[[nodiscard]] const GPU::Material& Parameters() const { return m_parameters; }
+    	// Index into the material table, assigned once the material is registered with the asset manager
+    	[[nodiscard]] u32 TableSlot() const { return m_tableSlot; }
 
+    	void SetParameters(const GPU::Material& parameters);
+    	// Drops every reference to the texture, its bindless slot is about to be handed out again
+    	void RemoveTexture(const Graphics::Texture& texture);
 
     private:
         boost::uuids::uuid m_uuid;
         std::string m_name;
 
-    	std::unique_ptr<Memory::Buffer> m_parametersBuffer;
-    	std::unique_ptr<Memory::Descriptor::Set> m_descriptorSet;
+    	GPU::Material m_parameters;
+    	u32 m_tableSlot = UINT32_MAX;
 
         std::unordered_map<PBR::Usage, const Graphics::Texture*> m_textures {};
 
@@ -12,13 +12,10 @@
 #include <vulkan/vulkan.hpp>
 
 #include "color/color.h"
+#include "graphics/geometryPool.h"
 #include "math/aabb.h"
 #include "math/vector.h"
 
-namespace Coral::Memory {
-	class Buffer;
-}
-
 namespace Coral::Shader {
 	struct InOut;
 	class Shader;
@@ -83,7 +80,8 @@ namespace Coral::Graphics {
         [[nodiscard]] const UUID &Id() const;
 		[[nodiscard]] const std::string &Name() const;
 
-		void Bind(const vk::CommandBuffer &commandBuffer) const;
+		// Where the mesh lives in the geometry pool, the block has to be bound before drawing
+		[[nodiscard]] const GeometryPool::Allocation &Geometry() const { return m_geometry; }
 
 		void Draw(const vk::CommandBuffer &commandBuffer, const uint32_t instanceCount = 1) const;
 
@@ -91,11 +89,6 @@ namespace Coral::Graphics {
         UUID m_uuid;
         String m_name;
     	Math::AABB m_aabb;
-        std::unique_ptr<Memory::Buffer> m_indexBuffer;
-        std::unique_ptr<Memory::Buffer> m_vertexBuffer;
-
-        void CreateVertexBuffer(std::vector<Vertex> &vertices);
-
-		void CreateIndexBuffer(std::vector<u32> &indices);
+    	GeometryPool::Allocation m_geometry;
 	};
 }
\ No newline at end of file
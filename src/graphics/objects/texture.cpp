@@ -5,9 +5,11 @@
 #include "texture.h"
 
 #include "imgui_impl_vulkan.h"
+#include "assets/manager.h"
 #include "memory/buffer.h"
 #include "memory/image.h"
-#include "memory/sampler.h"
+#include "memory/samplerCache.h"
+#include "memory/uploadManager.h"
 
 namespace Coral::Graphics {
     Texture::Texture(const Builder &builder)
@@ -26,34 +28,15 @@ namespace Coral::Graphics {
 			.Build();
 
     	if (builder.m_data) {
-    		const auto stagingBuffer = Memory::Buffer::Builder()
-				.InstanceSize(sizeof(Math::Vector4<u8>))
-				.InstanceCount(builder.m_width * builder.m_height)
-				.UsageFlags(vk::BufferUsageFlagBits::eTransferSrc)
-				.MemoryProperty(vk::MemoryPropertyFlagBits::eHostVisible)
-				.MemoryProperty(vk::MemoryPropertyFlagBits::eHostCoherent)
-				.Build();
-
-    		stagingBuffer->Map<Math::Vector4<u8>>();
-    		const auto copy = std::span(reinterpret_cast<Math::Vector4<u8>*>(builder.m_data), builder.m_width * builder.m_height);
-    		stagingBuffer->Write(copy);
-    		stagingBuffer->Flush();
-    		stagingBuffer->Unmap();
-
+    		const auto data = std::span(reinterpret_cast<const Math::Vector4<u8>*>(builder.m_data), builder.m_width * builder.m_height);
     		m_image->TransitionLayout(vk::ImageLayout::eTransferDstOptimal);
-    		m_image->Copy(**stagingBuffer);
+    		Context::UploadManager().Upload(*m_image, std::as_bytes(data));
     	}
 
     	if (builder.m_createMipmaps)
     		m_image->GenerateMipmaps();
     	m_image->TransitionLayout(vk::ImageLayout::eShaderReadOnlyOptimal);
 
-    	m_imageViews.emplace_back(Memory::ImageView::Builder(*m_image)
-			.ViewType(vk::ImageViewType::e2D)
-			.BaseMipLevel(0)
-			.LevelCount(mipLevels)
-			.Build());
-
     	const auto samplerCreateInfo = Memory::Sampler::CreateInfo {
     		.magFilter = vk::Filter::eLinear,
 			.minFilter = vk::Filter::eLinear,
@@ -61,16 +44,42 @@ namespace Coral::Graphics {
 			.mipmapMode = vk::SamplerMipmapMode::eLinear,
 		};
 
-    	m_sampler = std::make_unique<Memory::Sampler>(samplerCreateInfo);
+    	m_sampler = Context::SamplerCache().Acquire(samplerCreateInfo);
+    	UpdateDescriptorInfo();
+    }
+
+	void Texture::Resize(const Math::Vector3<u32>& extent) {
+    	m_image->Resize(extent);
+    	UpdateDescriptorInfo();
+    }
+
+	void Texture::UpdateDescriptorInfo() {
+    	// Resizing drops the image's views, the cached one is acquired again
+    	m_imageView = &Memory::ImageView::Builder(*m_image)
+			.ViewType(vk::ImageViewType::e2D)
+			.BaseMipLevel(0)
+			.LevelCount(m_image->MipLevels())
+			.Acquire();
 
     	m_descriptorInfo = vk::DescriptorImageInfo()
 			.setSampler(**m_sampler)
-			.setImageView(**m_imageViews[0])
+			.setImageView(**m_imageView)
 			.setImageLayout(vk::ImageLayout::eShaderReadOnlyOptimal);
 
-    	m_imId = ImGui_ImplVulkan_AddTexture(
-    		**m_sampler,
-    		**m_imageViews[0],
-    		static_cast<VkImageLayout>(vk::ImageLayout::eShaderReadOnlyOptimal));
+    	if (m_imId) {
+    		Context::DeletionQueue().Retire([texture = static_cast<VkDescriptorSet>(m_imId)] { ImGui_ImplVulkan_RemoveTexture(texture); });
+    		m_imId = nullptr;
+    	}
+    	// Headless runs never initialize the ImGui backend, m_imId stays null there
+    	if (Context::HasGUI()) {
+    		m_imId = ImGui_ImplVulkan_AddTexture(
+    			**m_sampler,
+    			**m_imageView,
+    			static_cast<VkImageLayout>(vk::ImageLayout::eShaderReadOnlyOptimal));
+    	}
+
+    	if (m_bindlessSlot != Graphics::TextureTable::InvalidSlot) {
+    		Asset::Manager::Get().TextureTable().Update(m_bindlessSlot, *this);
+    	}
     }
 }
@@ -11,6 +11,8 @@
 #include <vulkan/vulkan.hpp>
 
 #include "imgui_impl_vulkan.h"
+#include "context.h"
+#include "core/deletionQueue.h"
 #include "memory/image.h"
 #include "memory/imageView.h"
 #include "memory/sampler.h"
@@ -62,8 +64,13 @@ namespace Coral::PBR
 	}
 }
 
+namespace Coral::Asset {
+	class Manager;
+}
+
 namespace Coral::Graphics {
     class Texture {
+    	friend class Asset::Manager;
     public:
         class Builder {
             friend class Texture;
@@ -133,7 +140,9 @@ namespace Coral::Graphics {
 
         explicit Texture(const Builder& builder);
         ~Texture() {
-	        ImGui_ImplVulkan_RemoveTexture(static_cast<VkDescriptorSet>(m_imId));
+	        if (m_imId) {
+		        Context::DeletionQueue().Retire([texture = static_cast<VkDescriptorSet>(m_imId)] { ImGui_ImplVulkan_RemoveTexture(texture); });
+	        }
         }
 
         Texture(const Texture&) = delete;
@@ -146,35 +155,31 @@ namespace Coral::Graphics {
 
         [[nodiscard]] const Memory::Image& Image() const { return *m_image; }
         [[nodiscard]] const Memory::ImageView& ImageView(
-            const uint32_t baseMipLevel = 0, uint32_t mipLevelCount = std::numeric_limits<uint32_t>::max()) {
+            const uint32_t baseMipLevel = 0, uint32_t mipLevelCount = std::numeric_limits<uint32_t>::max()) const {
             if (mipLevelCount == std::numeric_limits<uint32_t>::max())
                 mipLevelCount = m_image->MipLevels();
 
             if (baseMipLevel + mipLevelCount > m_image->MipLevels())
                 throw std::runtime_error("The requested mipMap interval was not found!");
 
-            for (const auto& imageView : m_imageViews) {
-                if (imageView->Has(0, 1, baseMipLevel, mipLevelCount)) {
-                    return *imageView;
-                }
-            }
-
-            m_imageViews.emplace_back(Memory::ImageView::Builder(*m_image)
+            return Memory::ImageView::Builder(*m_image)
                 .ViewType(vk::ImageViewType::e2D)
                 .BaseMipLevel(baseMipLevel)
                 .LevelCount(mipLevelCount)
                 .BaseArrayLayer(0)
                 .LayerCount(1)
-                .Build());
-
-            return *m_imageViews.back();
-
+                .Acquire();
         }
         [[nodiscard]] const Memory::Sampler& Sampler() const { return *m_sampler; }
     	[[nodiscard]] ImTextureID ImId() const { return m_imId; }
 
 		[[nodiscard]] std::optional<PBR::Usage> Usage() const { return m_usage; }
+		// Index into the bindless texture table, assigned once the texture is registered with the asset manager
+		[[nodiscard]] u32 BindlessSlot() const { return m_bindlessSlot; }
 
+		// The image is recreated, the view, the GUI texture and the bindless slot follow it
+		void Resize(const Math::Vector3<u32>& extent);
+		// Rebuilds everything pointing at the image's view and rewrites the bindless slot
 		void UpdateDescriptorInfo();
     private:
         boost::uuids::uuid m_uuid;
@@ -182,9 +187,10 @@ namespace Coral::Graphics {
         vk::DescriptorImageInfo m_descriptorInfo;
         std::optional<PBR::Usage> m_usage = std::nullopt;
     	ImTextureID m_imId = nullptr;
+    	u32 m_bindlessSlot = UINT32_MAX;
 
         std::unique_ptr<Memory::Image> m_image;
-        std::vector<std::unique_ptr<Memory::ImageView>> m_imageViews;
-        std::unique_ptr<Memory::Sampler> m_sampler;
+        const Memory::ImageView* m_imageView = nullptr;
+        std::shared_ptr<const Memory::Sampler> m_sampler;
     };
 }
@@ -9,10 +9,10 @@
 #include <stb_image.h>
 #include <glm/glm.hpp>
 
-#include <functional>
-#include <thread>
-
-#include "memory/sampler.h"
+#include "context.h"
+#include "core/jobSystem.h"
+#include "memory/samplerCache.h"
+#include "memory/uploadManager.h"
 
 namespace Coral::Graphics {
     uint32_t TextureArray::Id(const std::string &name) const {
@@ -22,36 +22,16 @@ namespace Coral::Graphics {
         return m_imageIndices.at(name);
     }
 
-    void TextureArray::LoadTexture(const ThreadPayload& threadPayload) {
-        auto [tid, numThreads, paths] = threadPayload;
-        const auto size = static_cast<uint32_t>(paths.size());
-        const uint32_t start = tid * size / numThreads;
-        uint32_t end = (tid + 1) * size / numThreads;
-        end = std::min(end, size);
-
-        for (uint32_t i = start; i < end; i++) {
-            const auto& path = paths[i];
-            m_imageIndices[path] = i;
-
-            uint32_t width, height, channels;
-            stbi_uc* image = stbi_load(path.c_str(), reinterpret_cast<int*>(&width), reinterpret_cast<int*>(&height), reinterpret_cast<int*>(&channels), STBI_rgb_alpha);
-
-            const auto stagingBuffer = Memory::Buffer::Builder()
-        		.InstanceSize(sizeof(Math::Vector4<u8>))
-                .InstanceCount(width * height)
-                .UsageFlags(vk::BufferUsageFlagBits::eTransferSrc)
-                .MemoryProperty(vk::MemoryPropertyFlagBits::eHostVisible)
-                .MemoryProperty(vk::MemoryPropertyFlagBits::eHostCoherent)
-                .Build();
-
-            stagingBuffer->Map<Math::Vector4<u8>>();
-            const auto copy = std::span(reinterpret_cast<Math::Vector4<u8>*>(image), width * height);
-            stagingBuffer->Write(copy);
-            stagingBuffer->Unmap();
+    void TextureArray::LoadTexture(const std::string& path, const uint32_t layer, Core::JobSystem::Counter& uploads) const {
+        uint32_t width, height, channels;
+        stbi_uc* image = stbi_load(path.c_str(), reinterpret_cast<int*>(&width), reinterpret_cast<int*>(&height), reinterpret_cast<int*>(&channels), STBI_rgb_alpha);
 
-            m_image->Copy(**stagingBuffer, 0, i);
+        // Decoding runs on the workers, the upload may submit and is handed to the main thread
+        Context::JobSystem().RunOnMainThread([this, image, width, height, layer] {
+            const auto data = std::span(reinterpret_cast<const Math::Vector4<u8>*>(image), width * height);
+            Context::UploadManager().Upload(*m_image, std::as_bytes(data), 0, layer);
             stbi_image_free(image);
-        }
+        }, &uploads);
     }
 
     std::unique_ptr<TextureArray> TextureArray::Builder::Build() const {
@@ -75,50 +55,24 @@ namespace Coral::Graphics {
             .Build();
         m_image->TransitionLayout(vk::ImageLayout::eTransferDstOptimal);
 
-        const uint32_t numThreads = std::thread::hardware_concurrency();
-        std::vector<std::thread> threads;
-        std::vector<ThreadPayload> payloads(numThreads);
-        for (uint32_t i = 0; i < numThreads; i++) {
-            payloads[i] = ThreadPayload {
-                .tid = i,
-                .numThreads = numThreads,
-                .paths = builder.m_images
-            };
-            std::function func = [this] (const ThreadPayload &payload) { return LoadTexture(payload); };
-            threads.emplace_back(func, payloads[i]);
-        }
-
-        for (auto& thread : threads) {
-            thread.join();
+        for (uint32_t i = 0; i < builder.m_images.size(); i++) {
+            m_imageIndices[builder.m_images[i]] = i;
         }
+        Core::JobSystem::Counter uploads;
+        Context::JobSystem().ParallelFor(static_cast<uint32_t>(builder.m_images.size()), 1, [&](const uint32_t begin, const uint32_t end) {
+            for (uint32_t i = begin; i < end; i++) {
+                LoadTexture(builder.m_images[i], i, uploads);
+            }
+        });
+        Context::JobSystem().Wait(uploads);
 
         for (uint32_t i = 0; i < builder.m_data.size(); i++) {
-            const auto stagingBuffer = Memory::Buffer::Builder()
-        		.InstanceSize(sizeof(Math::Vector4<u8>))
-                .InstanceCount(builder.m_width * builder.m_height)
-                .UsageFlags(vk::BufferUsageFlagBits::eTransferSrc)
-                .MemoryProperty(vk::MemoryPropertyFlagBits::eHostVisible)
-                .MemoryProperty(vk::MemoryPropertyFlagBits::eHostCoherent)
-                .Build();
-
-            stagingBuffer->Map<Math::Vector4<u8>>();
-            const auto copy = std::span(static_cast<Math::Vector4<u8>*>(builder.m_data[i]), builder.m_width * builder.m_height);
-            stagingBuffer->Write(copy);
-            stagingBuffer->Unmap();
-
-            m_image->Copy(**stagingBuffer, 0, i + static_cast<uint32_t>(builder.m_images.size()));
+            const auto data = std::span(static_cast<const Math::Vector4<u8>*>(builder.m_data[i]), builder.m_width * builder.m_height);
+            Context::UploadManager().Upload(*m_image, std::as_bytes(data), 0, i + static_cast<uint32_t>(builder.m_images.size()));
         }
 
         m_image->GenerateMipmaps();
 
-        m_imageViews.emplace_back(Memory::ImageView::Builder(*m_image)
-            .ViewType(vk::ImageViewType::e2DArray)
-            .BaseMipLevel(0)
-            .LevelCount(mipLevels)
-            .BaseArrayLayer(0)
-            .LayerCount(static_cast<uint32_t>(builder.m_images.size() + builder.m_data.size()))
-            .Build());
-
         constexpr auto samplerCreateInfo = Memory::Sampler::CreateInfo {
             .magFilter = vk::Filter::eLinear,
             .minFilter = vk::Filter::eLinear,
@@ -126,11 +80,21 @@ namespace Coral::Graphics {
             .mipmapMode = vk::SamplerMipmapMode::eLinear,
         };
 
-        m_sampler = std::make_unique<Memory::Sampler>(samplerCreateInfo);
+        m_sampler = Context::SamplerCache().Acquire(samplerCreateInfo);
+    }
 
-        m_descriptorInfo = vk::DescriptorImageInfo()
+    vk::DescriptorImageInfo TextureArray::DescriptorInfo() const {
+        // Acquired at use time, resizing or recreating the image drops the views it handed out
+        const auto& imageView = Memory::ImageView::Builder(*m_image)
+            .ViewType(vk::ImageViewType::e2DArray)
+            .BaseMipLevel(0)
+            .LevelCount(m_image->MipLevels())
+            .BaseArrayLayer(0)
+            .LayerCount(m_image->LayerCount())
+            .Acquire();
+        return vk::DescriptorImageInfo()
             .setSampler(**m_sampler)
-            .setImageView(**m_imageViews[0])
+            .setImageView(*imageView)
             .setImageLayout(vk::ImageLayout::eShaderReadOnlyOptimal);
     }
 }
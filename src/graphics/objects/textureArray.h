@@ -11,6 +11,7 @@
 
 #include <vulkan/vulkan.hpp>
 
+#include "core/jobSystem.h"
 #include "memory/image.h"
 #include "memory/imageView.h"
 
@@ -18,12 +19,6 @@ namespace Coral::Memory {
     class Sampler;
 }
 
-struct ThreadPayload {
-    uint32_t tid;
-    uint32_t numThreads;
-    std::vector<std::string> paths;
-};
-
 namespace Coral::Graphics {
     class TextureArray {
     public:
@@ -87,21 +82,20 @@ namespace Coral::Graphics {
 
         explicit TextureArray(const Builder& builder);
 
-        [[nodiscard]] const vk::DescriptorImageInfo& DescriptorInfo() const { return m_descriptorInfo; }
+        [[nodiscard]] vk::DescriptorImageInfo DescriptorInfo() const;
         [[nodiscard]] uint32_t Id(const std::string& name) const;
 
     private:
-        void LoadTexture(const ThreadPayload& threadPayload);
+        // Decodes on the calling thread and queues the upload on the main thread, counted by uploads
+        void LoadTexture(const std::string& path, uint32_t layer, Core::JobSystem::Counter& uploads) const;
 
         std::string m_name;
         vk::Format m_format;
         uint32_t m_width;
         uint32_t m_height;
-        vk::DescriptorImageInfo m_descriptorInfo;
 
         std::unique_ptr<Memory::Image> m_image;
-        std::vector<std::unique_ptr<Memory::ImageView>> m_imageViews;
-        std::unique_ptr<Memory::Sampler> m_sampler;
+        std::shared_ptr<const Memory::Sampler> m_sampler;
 
         std::unordered_map<std::string, uint32_t> m_imageIndices;
     };
@@ -4,13 +4,18 @@
 
 #include "pipeline.h"
 
+#include <format>
 #include <iostream>
 #include <ranges>
 
+#include "core/deletionQueue.h"
 #include "shader/shader.h"
 #include "memory/descriptor/set.h"
+#include "memory/uniformRing.h"
 #include "objects/mesh.h"
 #include "renderPass.h"
+#include "materialTable.h"
+#include "textureTable.h"
 #include "utils/functionals.h"
 
 namespace Coral::Graphics {
@@ -96,6 +101,23 @@ namespace Coral::Graphics {
 	}
 
 
+    // Shaders may declare a reserved set themselves, as long as every binding is one the reserved layout provides
+    static void CheckReservedSet(const u32 set, const Memory::Descriptor::SetLayout::Builder& reflected,
+        const Memory::Descriptor::SetLayout::Builder& reserved, const std::string_view owner)
+    {
+        for (const auto& [binding, layoutBinding] : reflected.Bindings()) {
+            const auto it = reserved.Bindings().find(binding);
+            const auto compatible = it != reserved.Bindings().end()
+                && (layoutBinding.descriptorType == it->second.descriptorType
+                    || (layoutBinding.descriptorType == vk::DescriptorType::eUniformBuffer && it->second.descriptorType == vk::DescriptorType::eUniformBufferDynamic))
+                && layoutBinding.descriptorCount <= it->second.descriptorCount;
+            if (!compatible) {
+                throw std::runtime_error(std::format("Pipeline::Builder::Build : Set {} binding {} ({}) does not match the layout {} reserves for it",
+                    set, binding, vk::to_string(layoutBinding.descriptorType), owner));
+            }
+        }
+    }
+
     std::unique_ptr<Pipeline> Pipeline::Builder::Build()
     {
         std::vector<Memory::Descriptor::SetLayout::Builder> layoutBuilders;
@@ -129,19 +151,25 @@ namespace Coral::Graphics {
             }
         }
 
-        for (auto& layoutBuilder : layoutBuilders) {
-            m_setLayouts.emplace_back(layoutBuilder.Build());
+        // The reserved sets always take the ring's and tables' layouts, reflection cannot see dynamic offsets or binding flags
+        if (layoutBuilders.size() > Memory::UniformRing::Set) {
+            auto reserved = Memory::UniformRing::LayoutBuilder();
+            CheckReservedSet(Memory::UniformRing::Set, layoutBuilders[Memory::UniformRing::Set], reserved, "UniformRing");
+            layoutBuilders[Memory::UniformRing::Set] = std::move(reserved);
+        }
+        if (layoutBuilders.size() > TextureTable::Set) {
+            auto reserved = TextureTable::LayoutBuilder();
+            CheckReservedSet(TextureTable::Set, layoutBuilders[TextureTable::Set], reserved, "TextureTable");
+            layoutBuilders[TextureTable::Set] = std::move(reserved);
+        }
+        if (layoutBuilders.size() > MaterialTable::Set) {
+            auto reserved = MaterialTable::LayoutBuilder();
+            CheckReservedSet(MaterialTable::Set, layoutBuilders[MaterialTable::Set], reserved, "MaterialTable");
+            layoutBuilders[MaterialTable::Set] = std::move(reserved);
         }
 
-        std::vector<vk::DescriptorSetLayout> descriptorHandles = m_setLayouts
-            | std::views::transform([](const auto& layout) { return **layout; })
-            | std::ranges::to<std::vector<vk::DescriptorSetLayout>>();
-
-        const auto pipelineLayoutInfo = vk::PipelineLayoutCreateInfo()
-            .setSetLayouts(descriptorHandles)
-            .setPushConstantRanges(pushConstantRanges);
-
-        m_pipelineLayout = Context::Device()->createPipelineLayout(pipelineLayoutInfo);
+        // Hot reloads that keep the shader interface get the same layout back
+        m_pipelineLayout = Context::LayoutCache().AcquirePipelineLayout(layoutBuilders, pushConstantRanges);
 
         std::vector<vk::VertexInputBindingDescription> bindingDescriptions = {};
         std::vector<vk::VertexInputAttributeDescription> attributeDescriptions = {};
@@ -191,7 +219,7 @@ namespace Coral::Graphics {
             .setAttachments(m_colorBlendAttachments);
 
         m_multisampling = vk::PipelineMultisampleStateCreateInfo()
-            .setRasterizationSamples(m_renderPass.SampleCount())
+            .setRasterizationSamples(m_renderPass.SampleCount(m_subpass))
             .setSampleShadingEnable(vk::False)
             .setMinSampleShading(1.0f)
             .setAlphaToCoverageEnable(vk::False)
@@ -201,11 +229,11 @@ namespace Coral::Graphics {
     }
 
     Pipeline::Pipeline(Builder& builder)
-		: m_pipelineLayout(builder.m_pipelineLayout),
-		m_setLayouts(std::move(builder.m_setLayouts)),
+		: m_layout(std::move(builder.m_pipelineLayout)),
+		m_pipelineLayout(**m_layout),
 		m_shaders(std::move(builder.m_shaders))
     {
-        const auto m_createInfo = vk::GraphicsPipelineCreateInfo()
+        auto m_createInfo = vk::GraphicsPipelineCreateInfo()
             .setStages(builder.m_stages)
             .setPVertexInputState(&builder.m_vertexInputInfo)
             .setPInputAssemblyState(&builder.m_inputAssembly)
@@ -216,9 +244,17 @@ namespace Coral::Graphics {
             .setPMultisampleState(&builder.m_multisampling)
             .setPTessellationState(&builder.m_tessellation)
             .setPDynamicState(&builder.m_dynamicState)
-            .setLayout(builder.m_pipelineLayout)
-            .setRenderPass(*builder.m_renderPass)
-            .setSubpass(builder.m_subpass);
+            .setLayout(m_pipelineLayout);
+
+        // Dynamic rendering only needs the attachment formats, the pipeline outlives any render pass object
+        const auto renderingInfo = builder.m_renderPass.RenderingInfo();
+        if (builder.m_renderPass.DynamicRendering()) {
+            m_createInfo.setPNext(&renderingInfo);
+        } else {
+            m_createInfo
+                .setRenderPass(*builder.m_renderPass)
+                .setSubpass(builder.m_subpass);
+        }
 
         try {
             const auto pipeline = Context::Device()->createGraphicsPipeline(nullptr, m_createInfo);
@@ -233,9 +269,21 @@ namespace Coral::Graphics {
 
     Pipeline::~Pipeline()
     {
-        Context::Device()->waitIdle();
-        Context::Device()->destroyPipeline(m_pipeline);
-        Context::Device()->destroyPipelineLayout(m_pipelineLayout);
+        Context::DeletionQueue().Retire([handle = m_pipeline] { Context::Device()->destroyPipeline(handle); });
+    }
+
+    std::optional<vk::ShaderStageFlags> Pipeline::PushConstantStages(const u32 offset, const u32 size) const {
+        vk::ShaderStageFlags stages;
+        // vkCmdPushConstants needs the stages of every range the update overlaps, not only of those containing it
+        for (const auto& range : m_layout->PushConstantRanges()) {
+            if (range.offset < offset + size && offset < range.offset + range.size) {
+                stages |= range.stageFlags;
+            }
+        }
+        if (!stages) {
+            return std::nullopt;
+        }
+        return stages;
     }
 
     void Pipeline::Bind(const vk::CommandBuffer& commandBuffer) const {
@@ -4,12 +4,14 @@
 
 #pragma once
 
+#include <optional>
 #include <unordered_map>
 #include <vector>
 
 #include <vulkan/vulkan.hpp>
 
 #include "shader/shader.h"
+#include "memory/descriptor/layoutCache.h"
 #include "memory/descriptor/set.h"
 #include "objects/mesh.h"
 
@@ -70,7 +72,6 @@ namespace Coral::Graphics {
 			RenderPass &m_renderPass;
             bool m_shouldRebuild = true;
 
-            std::vector<std::unique_ptr<Memory::Descriptor::SetLayout>> m_setLayouts;
             std::unordered_map<Shader::Stage, const Shader::Shader*> m_shaders;
             std::vector<vk::PipelineShaderStageCreateInfo> m_stages;
 
@@ -95,7 +96,7 @@ namespace Coral::Graphics {
             };
             vk::PipelineDynamicStateCreateInfo m_dynamicState;
 
-            vk::PipelineLayout m_pipelineLayout;
+            std::shared_ptr<const Memory::Descriptor::PipelineLayout> m_pipelineLayout;
             uint32_t m_subpass = 0;
         };
 
@@ -120,12 +121,16 @@ namespace Coral::Graphics {
         void BindDescriptorSets(uint32_t, vk::CommandBuffer, const std::vector<Memory::Descriptor::Set> &) const;
 
         [[nodiscard]] const vk::PipelineLayout &Layout() const { return m_pipelineLayout; }
+        [[nodiscard]] u32 SetCount() const { return static_cast<u32>(m_layout->SetLayouts().size()); }
+        // Stages to push [offset, offset + size) with, empty when no declared range overlaps it
+        [[nodiscard]] std::optional<vk::ShaderStageFlags> PushConstantStages(u32 offset, u32 size) const;
 
         const std::unordered_map<Shader::Stage, const Shader::Shader*>& Shaders() { return m_shaders; }
     private:
         vk::Pipeline m_pipeline;
+        // Shared with every pipeline whose shaders declare the same interface
+        std::shared_ptr<const Memory::Descriptor::PipelineLayout> m_layout;
         vk::PipelineLayout m_pipelineLayout;
-        std::vector<std::unique_ptr<Memory::Descriptor::SetLayout>> m_setLayouts;
         std::unordered_map<Shader::Stage, const Shader::Shader*> m_shaders;
     };
 }
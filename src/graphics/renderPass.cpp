@@ -6,7 +6,10 @@
 
 #include <ranges>
 
+#include "core/deletionQueue.h"
 #include "core/device.h"
+#include "core/jobSystem.h"
+#include "core/scheduler.h"
 #include "ecs/components/camera.h"
 #include "ecs/components/renderTarget.h"
 #include "ecs/components/transform.h"
@@ -14,8 +17,13 @@
 #include "ecs/sceneManager.h"
 #include "ecs/entity.h"
 
+#include "barrierTracker.h"
 #include "framebuffer.h"
+#include "materialTable.h"
+#include "textureTable.h"
+#include "assets/manager.h"
 #include "memory/image.h"
+#include "memory/uniformRing.h"
 
 #include "gui/elements/popup.h"
 
@@ -33,10 +41,32 @@ namespace Coral::Graphics {
         m_attachments = std::move(builder->m_attachments);
         m_subpasses = std::move(builder->m_subpasses);
         m_dependencies = builder->m_dependencies;
-        m_sampleCount = m_attachments[0].description.samples;
 
-        CreateRenderPass();
-        CreateFrameBuffers();
+        // Merged passes read what earlier subpasses left in tile memory, only a render pass object can do that
+        m_dynamicRendering = builder->m_dynamicRendering && m_subpasses.size() == 1 && m_subpasses[0].inputAttachments.empty();
+
+        if (!m_dynamicRendering) {
+            CreateRenderPass();
+            CreateFrameBuffers();
+            return;
+        }
+
+        if (m_outputAttachmentIndex >= m_attachments.size()) {
+            throw std::runtime_error("Output attachment index is out of bounds.");
+        }
+        for (const auto& reference : m_subpasses[0].colorAttachments) {
+            m_colorFormats.emplace_back(m_attachments[reference.attachment].description.format);
+        }
+        if (const auto& reference = m_subpasses[0].depthStencilAttachment) {
+            const auto format = m_attachments[reference->attachment].description.format;
+            const auto aspects = BarrierTracker::AspectMask(format);
+            if (aspects & vk::ImageAspectFlagBits::eDepth) {
+                m_depthFormat = format;
+            }
+            if (aspects & vk::ImageAspectFlagBits::eStencil) {
+                m_stencilFormat = format;
+            }
+        }
     }
 
     RenderPass::~RenderPass() {
@@ -44,6 +74,17 @@ namespace Coral::Graphics {
         DestroyRenderPass();
     }
 
+    vk::SampleCountFlagBits RenderPass::SampleCount(const u32 subpass) const {
+        const auto& description = m_subpasses.at(subpass);
+        if (!description.colorAttachments.empty()) {
+            return m_attachments[description.colorAttachments[0].attachment].description.samples;
+        }
+        if (description.depthStencilAttachment.has_value()) {
+            return m_attachments[description.depthStencilAttachment->attachment].description.samples;
+        }
+        return vk::SampleCountFlagBits::e1;
+    }
+
     void RenderPass::CreateRenderPass() {
         std::vector<vk::AttachmentDescription> attachmentDescriptions;
         attachmentDescriptions.reserve(m_attachments.size());
@@ -91,21 +132,40 @@ namespace Coral::Graphics {
 
     void RenderPass::DestroyRenderPass() {
         if (m_handle) {
-            Context::Device()->destroyRenderPass(m_handle);
+            Context::DeletionQueue().Retire([handle = m_handle] { Context::Device()->destroyRenderPass(handle); });
             m_handle = nullptr;
         }
     }
 
     void RenderPass::DestroyFrameBuffers() {
         m_frameBuffers.clear();
-
-        for (auto &imageView : m_imageViews) {
-            imageView.reset();
-        }
     }
 
     void RenderPass::Begin(const Core::CommandBuffer& commandBuffer, const u32 imageIndex) {
         m_inFlightImageIndex = imageIndex;
+        m_currentSubpass = 0;
+
+        m_drawItems.clear();
+        if (!m_pipelines.empty() && ECS::SceneManager::Get().IsSceneLoaded()) {
+            ECS::SceneManager::Get().Registry().group(entt::get<ECS::Entity*, ECS::RenderTarget>).each(
+            [&](const ECS::Entity* entity, const ECS::RenderTarget& renderTarget) {
+                m_drawItems.emplace_back(entity, &renderTarget);
+            });
+        }
+
+        // Commands of a subpass are either all inline or all in secondaries, so the split has to be chosen here
+        m_subpassContents = m_drawItems.size() >= 2 * MinimumDrawsPerThread
+            ? vk::SubpassContents::eSecondaryCommandBuffers
+            : vk::SubpassContents::eInline;
+
+        if (m_dynamicRendering) {
+            BeginRendering(commandBuffer, imageIndex);
+            if (m_subpassContents == vk::SubpassContents::eInline) {
+                commandBuffer->setViewport(0, Viewport());
+                commandBuffer->setScissor(0, Scissor());
+            }
+            return;
+        }
 
         auto clearValues = m_attachments
             | std::views::transform([](const auto& attachment) { return attachment.clearValue; })
@@ -117,22 +177,71 @@ namespace Coral::Graphics {
             .setRenderArea(vk::Rect2D().setExtent({ static_cast<u32>(m_extent.x), static_cast<u32>(m_extent.y) }))
             .setClearValues(clearValues);
 
-        commandBuffer->beginRenderPass(renderPassInfo, vk::SubpassContents::eInline);
+        commandBuffer->beginRenderPass(renderPassInfo, m_subpassContents);
 
-        const auto viewport = vk::Viewport()
-            .setX(0.0f)
-            .setY(0.0f)
-            .setWidth(m_extent.x)
-            .setHeight(m_extent.y)
-            .setMinDepth(0.0f)
-            .setMaxDepth(1.0f);
+        if (m_subpassContents == vk::SubpassContents::eInline) {
+            commandBuffer->setViewport(0, Viewport());
+            commandBuffer->setScissor(0, Scissor());
+        }
+    }
 
-        const auto scissor = vk::Rect2D()
-            .setOffset({0, 0})
-            .setExtent({ static_cast<u32>(m_extent.x), static_cast<u32>(m_extent.y) });
+    void RenderPass::BeginRendering(const Core::CommandBuffer& commandBuffer, const u32 imageIndex) const {
+        const auto& subpass = m_subpasses[0];
+
+        const auto attachmentInfo = [&](const vk::AttachmentReference& reference, const bool stencil) {
+            const auto& attachment = m_attachments[reference.attachment];
+            return vk::RenderingAttachmentInfo()
+                .setImageView(*AttachmentView(reference.attachment, imageIndex))
+                .setImageLayout(reference.layout)
+                .setLoadOp(stencil ? attachment.description.stencilLoadOp : attachment.description.loadOp)
+                .setStoreOp(stencil ? attachment.description.stencilStoreOp : attachment.description.storeOp)
+                .setClearValue(attachment.clearValue);
+        };
+
+        std::vector<vk::RenderingAttachmentInfo> colorAttachments;
+        colorAttachments.reserve(subpass.colorAttachments.size());
+        for (u32 i = 0; i < subpass.colorAttachments.size(); i++) {
+            auto& colorAttachment = colorAttachments.emplace_back(attachmentInfo(subpass.colorAttachments[i], false));
+            // The resolve happens as part of the store, just like a render pass' resolve attachment
+            if (i < subpass.resolveAttachments.size() && subpass.resolveAttachments[i].attachment != vk::AttachmentUnused) {
+                const auto& resolve = subpass.resolveAttachments[i];
+                colorAttachment
+                    .setResolveMode(vk::ResolveModeFlagBits::eAverage)
+                    .setResolveImageView(*AttachmentView(resolve.attachment, imageIndex))
+                    .setResolveImageLayout(resolve.layout);
+            }
+        }
+
+        auto renderingInfo = vk::RenderingInfo()
+            .setRenderArea(vk::Rect2D().setExtent({ m_extent.x, m_extent.y }))
+            .setLayerCount(1)
+            .setColorAttachments(colorAttachments);
+        if (m_subpassContents == vk::SubpassContents::eSecondaryCommandBuffers) {
+            renderingInfo.setFlags(vk::RenderingFlagBits::eContentsSecondaryCommandBuffers);
+        }
+
+        vk::RenderingAttachmentInfo depthAttachment;
+        vk::RenderingAttachmentInfo stencilAttachment;
+        if (const auto& reference = subpass.depthStencilAttachment) {
+            if (m_depthFormat != vk::Format::eUndefined) {
+                depthAttachment = attachmentInfo(*reference, false);
+                renderingInfo.setPDepthAttachment(&depthAttachment);
+            }
+            if (m_stencilFormat != vk::Format::eUndefined) {
+                stencilAttachment = attachmentInfo(*reference, true);
+                renderingInfo.setPStencilAttachment(&stencilAttachment);
+            }
+        }
+
+        commandBuffer->beginRendering(renderingInfo);
+    }
 
-        commandBuffer->setViewport(0, viewport);
-        commandBuffer->setScissor(0, scissor);
+    const Memory::ImageView& RenderPass::AttachmentView(const u32 attachment, const u32 imageIndex) const {
+        return Memory::ImageView::Builder(*m_attachments[attachment].images[imageIndex])
+            .ViewType(vk::ImageViewType::e2D)
+            .BaseMipLevel(0)
+            .LevelCount(1)
+            .Acquire();
     }
 
     void RenderPass::Update(const float deltaTime) {
@@ -150,36 +259,205 @@ namespace Coral::Graphics {
         }
     }
 
-    void RenderPass::Draw(const Core::CommandBuffer& commandBuffer) const {
+    void RenderPass::Draw(const Core::CommandBuffer& commandBuffer) {
 		if (!ECS::SceneManager::Get().IsSceneLoaded())
 			return;
 
-    	for (const auto& pipeline : m_pipelines | std::views::values) {
-            pipeline->Bind(*commandBuffer);
-            pipeline->BindDescriptorSet(0, *commandBuffer, ECS::SceneManager::Get().GetLoadedScene().DescriptorSet());
-            ECS::SceneManager::Get().Registry().group(entt::get<ECS::Entity*, ECS::RenderTarget>).each(
-            [&](const ECS::Entity* entity, const ECS::RenderTarget& renderTarget) {
-                Math::Matrix4<f32> matrix = Math::Matrix4<f32>::Identity();
-            	while (entity) {
-            		auto& transform = entity->Get<ECS::Transform>();
-            		matrix *= transform.Matrix();
-            		entity = entity->Parent();
-            	}
-                for (const auto [mesh, material] : renderTarget.Targets()) {
-                	// pipeline->BindDescriptorSet(1, *commandBuffer, material->DescriptorSet());
-                    pipeline->PushConstants<Math::Matrix4<f32>>(*commandBuffer, vk::ShaderStageFlagBits::eTessellationEvaluation, 0, matrix);
-                    mesh->Bind(*commandBuffer);
-                    mesh->Draw(*commandBuffer);
+        const auto& uniformRing = Context::Scheduler().UniformRing();
+        const auto cameraOffset = ECS::SceneManager::Get().GetLoadedScene().CameraOffset();
+        const auto& textureTable = Asset::Manager::Get().TextureTable();
+        const auto& materialTable = Asset::Manager::Get().MaterialTable();
+
+        if (m_subpassContents == vk::SubpassContents::eInline) {
+            for (u32 subpass = 0; subpass < m_subpasses.size(); subpass++) {
+                for (const auto& [builder, pipeline] : m_pipelines) {
+                    if (builder->m_subpass != subpass) {
+                        continue;
+                    }
+                    NextSubpass(commandBuffer, subpass);
+                    pipeline->Bind(*commandBuffer);
+                    if (pipeline->SetCount() > Memory::UniformRing::Set) {
+                        uniformRing.Bind(*commandBuffer, pipeline->Layout(), cameraOffset);
+                    }
+                    if (pipeline->SetCount() > TextureTable::Set) {
+                        textureTable.Bind(*commandBuffer, pipeline->Layout());
+                    }
+                    if (pipeline->SetCount() > MaterialTable::Set) {
+                        materialTable.Bind(*commandBuffer, pipeline->Layout());
+                    }
+                    RecordDraws(*commandBuffer, *pipeline, m_drawItems);
                 }
-            });
+            }
+            return;
         }
+
+        const auto imageIndex = InFlightImageIndex();
+        const auto drawCount = static_cast<u32>(m_drawItems.size());
+        const auto targetChunkCount = (drawCount + MinimumDrawsPerThread - 1) / MinimumDrawsPerThread;
+        const auto chunkSize = (drawCount + targetChunkCount - 1) / targetChunkCount;
+        const auto chunkCount = (drawCount + chunkSize - 1) / chunkSize;
+
+        if (m_secondaryCommandBuffers.size() <= imageIndex) {
+            m_secondaryCommandBuffers.resize(imageIndex + 1);
+        }
+        auto& threadCommandBuffers = m_secondaryCommandBuffers[imageIndex];
+        threadCommandBuffers.resize(Context::Device().RecordingThreadCount() + 1);
+        // Only ever touched by the thread owning the index
+        std::vector<u32> used(threadCommandBuffers.size(), 0);
+        std::vector<vk::CommandBuffer> recorded(m_pipelines.size() * chunkCount);
+
+        const auto inheritanceRenderingInfo = vk::CommandBufferInheritanceRenderingInfo()
+            .setColorAttachmentFormats(m_colorFormats)
+            .setDepthAttachmentFormat(m_depthFormat)
+            .setStencilAttachmentFormat(m_stencilFormat)
+            .setRasterizationSamples(SampleCount());
+        auto inheritanceInfo = vk::CommandBufferInheritanceInfo();
+        if (m_dynamicRendering) {
+            inheritanceInfo.setPNext(&inheritanceRenderingInfo);
+        } else {
+            inheritanceInfo
+                .setRenderPass(m_handle)
+                .setFramebuffer(**m_frameBuffers[imageIndex]);
+        }
+        // Secondaries continue the subpass of their pipeline
+        std::vector<vk::CommandBufferInheritanceInfo> pipelineInheritanceInfos;
+        for (const auto& builder : m_pipelines | std::views::keys) {
+            pipelineInheritanceInfos.emplace_back(inheritanceInfo).setSubpass(m_dynamicRendering ? 0 : builder->m_subpass);
+        }
+        const auto viewport = Viewport();
+        const auto scissor = Scissor();
+
+        // Whichever thread picks up a chunk records it once per pipeline into secondaries from its own command pool
+        Context::JobSystem().ParallelFor(drawCount, chunkSize, [&](const u32 begin, const u32 end) {
+            const auto thread = Core::JobSystem::ThreadIndex();
+            const auto chunk = begin / chunkSize;
+            auto& commandBuffers = threadCommandBuffers[thread];
+
+            for (u32 i = 0; i < m_pipelines.size(); i++) {
+                if (used[thread] == commandBuffers.size()) {
+                    commandBuffers.emplace_back(Context::Device().RequestCommandBuffer(commandBuffer.Queue(), thread, vk::CommandBufferLevel::eSecondary));
+                }
+                const auto& pipeline = *m_pipelines[i].second;
+                const auto& secondaryCommandBuffer = *commandBuffers[used[thread]++];
+
+                secondaryCommandBuffer->reset(vk::CommandBufferResetFlagBits::eReleaseResources);
+                secondaryCommandBuffer->begin(vk::CommandBufferBeginInfo()
+                    .setFlags(vk::CommandBufferUsageFlagBits::eRenderPassContinue | vk::CommandBufferUsageFlagBits::eOneTimeSubmit)
+                    .setPInheritanceInfo(&pipelineInheritanceInfos[i]));
+                secondaryCommandBuffer->setViewport(0, viewport);
+                secondaryCommandBuffer->setScissor(0, scissor);
+                pipeline.Bind(*secondaryCommandBuffer);
+                if (pipeline.SetCount() > Memory::UniformRing::Set) {
+                    uniformRing.Bind(*secondaryCommandBuffer, pipeline.Layout(), cameraOffset);
+                }
+                if (pipeline.SetCount() > TextureTable::Set) {
+                    textureTable.Bind(*secondaryCommandBuffer, pipeline.Layout());
+                }
+                if (pipeline.SetCount() > MaterialTable::Set) {
+                    materialTable.Bind(*secondaryCommandBuffer, pipeline.Layout());
+                }
+                RecordDraws(*secondaryCommandBuffer, pipeline, std::span(m_drawItems).subspan(begin, end - begin));
+                secondaryCommandBuffer->end();
+
+                recorded[i * chunkCount + chunk] = *secondaryCommandBuffer;
+            }
+        });
+
+        for (u32 subpass = 0; subpass < m_subpasses.size(); subpass++) {
+            std::vector<vk::CommandBuffer> subpassCommandBuffers;
+            for (u32 i = 0; i < m_pipelines.size(); i++) {
+                if (m_pipelines[i].first->m_subpass == subpass) {
+                    subpassCommandBuffers.insert(subpassCommandBuffers.end(), recorded.begin() + i * chunkCount, recorded.begin() + (i + 1) * chunkCount);
+                }
+            }
+            if (!subpassCommandBuffers.empty()) {
+                NextSubpass(commandBuffer, subpass);
+                commandBuffer->executeCommands(subpassCommandBuffers);
+            }
+        }
+    }
+
+    void RenderPass::NextSubpass(const Core::CommandBuffer& commandBuffer, const u32 subpass) {
+        for (; m_currentSubpass < subpass; m_currentSubpass++) {
+            commandBuffer->nextSubpass(m_subpassContents);
+        }
+    }
+
+    void RenderPass::RecordDraws(const vk::CommandBuffer commandBuffer, const Pipeline& pipeline, const std::span<const DrawItem> drawItems) {
+        const auto modelStages = pipeline.PushConstantStages(0, sizeof(Math::Matrix4<f32>));
+        const auto materialStages = pipeline.PushConstantStages(MaterialSlotOffset, sizeof(u32));
+        const auto& geometryPool = Asset::Manager::Get().GeometryPool();
+        // Meshes sharing a pool block share the binding, with a single block the whole pass binds once
+        u32 boundBlock = GeometryPool::InvalidBlock;
+        for (auto [entity, renderTarget] : drawItems) {
+            Math::Matrix4<f32> matrix = Math::Matrix4<f32>::Identity();
+            while (entity) {
+                auto& transform = entity->Get<ECS::Transform>();
+                matrix *= transform.Matrix();
+                entity = entity->Parent();
+            }
+            for (const auto [mesh, material] : renderTarget->Targets()) {
+                if (modelStages) {
+                    pipeline.PushConstants<Math::Matrix4<f32>>(commandBuffer, *modelStages, 0, matrix);
+                }
+                if (materialStages && material) {
+                    pipeline.PushConstants<u32>(commandBuffer, *materialStages, MaterialSlotOffset, material->TableSlot());
+                }
+                if (mesh->Geometry().block != boundBlock) {
+                    boundBlock = mesh->Geometry().block;
+                    geometryPool.Bind(commandBuffer, boundBlock);
+                }
+                mesh->Draw(commandBuffer);
+            }
+        }
+    }
+
+    vk::Viewport RenderPass::Viewport() const {
+        return vk::Viewport()
+            .setX(0.0f)
+            .setY(0.0f)
+            .setWidth(m_extent.x)
+            .setHeight(m_extent.y)
+            .setMinDepth(0.0f)
+            .setMaxDepth(1.0f);
+    }
+
+    vk::Rect2D RenderPass::Scissor() const {
+        return vk::Rect2D()
+            .setOffset({0, 0})
+            .setExtent({ static_cast<u32>(m_extent.x), static_cast<u32>(m_extent.y) });
     }
 
     void RenderPass::End(const Core::CommandBuffer& commandBuffer)  {
-        commandBuffer->endRenderPass();
+        if (m_dynamicRendering) {
+            commandBuffer->endRendering();
+        } else {
+            // Subpasses without anything to draw still have to be passed through
+            NextSubpass(commandBuffer, static_cast<u32>(m_subpasses.size()) - 1);
+            commandBuffer->endRenderPass();
+        }
         m_inFlightImageIndex = std::nullopt;
     }
 
+    vk::PipelineStageFlags2 RenderPass::WaitStages() const {
+        auto stages = vk::PipelineStageFlags2();
+        for (const auto& subpass : m_subpasses) {
+            if (subpass.depthStencilAttachment.has_value()) {
+                stages |= vk::PipelineStageFlagBits2::eEarlyFragmentTests | vk::PipelineStageFlagBits2::eLateFragmentTests;
+            }
+            if (!subpass.colorAttachments.empty() || !subpass.resolveAttachments.empty()) {
+                stages |= vk::PipelineStageFlagBits2::eColorAttachmentOutput;
+            }
+            if (!subpass.inputAttachments.empty()) {
+                stages |= vk::PipelineStageFlagBits2::eFragmentShader;
+            }
+        }
+        if (!stages) {
+            stages = vk::PipelineStageFlagBits2::eAllGraphics;
+        }
+        return stages;
+    }
+
     Memory::Image& RenderPass::OutputImage(const uint32_t index) const {
         return *m_attachments[m_outputAttachmentIndex].images[index];
     }
@@ -194,8 +472,6 @@ namespace Coral::Graphics {
             return false;
         }
 
-        Context::Device()->waitIdle();
-
         DestroyFrameBuffers();
 
         m_imageCount = imageCount;
@@ -204,7 +480,18 @@ namespace Coral::Graphics {
         for (auto &attachment : m_attachments) {
             attachment.Resize(extent);
         }
-        CreateFrameBuffers();
+        // Views are looked up on the images every frame when rendering dynamically, there is nothing to rebuild
+        if (!m_dynamicRendering) {
+            CreateFrameBuffers();
+        }
         return true;
     }
+
+    void RenderPass::SetAttachmentImages(const u32 index, std::vector<Memory::Image*> images) {
+        m_attachments.at(index).images = std::move(images);
+        if (!m_dynamicRendering) {
+            DestroyFrameBuffers();
+            CreateFrameBuffers();
+        }
+    }
 }
@@ -5,6 +5,7 @@
 #pragma once
 
 #include <iostream>
+#include <span>
 
 #include "pipeline.h"
 #include "core/device.h"
@@ -13,6 +14,11 @@
 
 #include "math/vector.h"
 
+namespace Coral::ECS {
+    class Entity;
+    class RenderTarget;
+}
+
 namespace Coral::Graphics {
     class Framebuffer;
 
@@ -32,6 +38,8 @@ namespace Coral::Graphics {
     		std::vector<vk::AttachmentReference> inputAttachments = {};
     		std::vector<vk::AttachmentReference> resolveAttachments = {};
     		std::optional<vk::AttachmentReference> depthStencilAttachment = std::nullopt;
+
+    		bool operator==(const Subpass&) const = default;
     	};
 
         class Builder {
@@ -73,6 +81,13 @@ namespace Coral::Graphics {
                 return *this;
             }
 
+            // Renders straight into the attachment views without a VkRenderPass or framebuffers. Only single subpass
+            // passes without input attachments qualify, the others keep the render pass object.
+            Builder& DynamicRendering(const bool dynamicRendering = true) {
+                m_dynamicRendering = dynamicRendering;
+                return *this;
+            }
+
             std::unique_ptr<RenderPass> Build() {
                 return std::make_unique<RenderPass>(this);
             }
@@ -85,6 +100,7 @@ namespace Coral::Graphics {
             std::vector<RenderPass::Attachment> m_attachments;
             std::vector<struct Subpass> m_subpasses;
             std::vector<vk::SubpassDependency> m_dependencies;
+            bool m_dynamicRendering = false;
         };
 
 
@@ -96,10 +112,13 @@ namespace Coral::Graphics {
 
         void Begin(const Core::CommandBuffer& commandBuffer, uint32_t imageIndex);
         void Update(float deltaTime);
-        void Draw(const Core::CommandBuffer& commandBuffer) const;
+        // Large scenes are split into chunks recorded into secondary command buffers on worker threads
+        void Draw(const Core::CommandBuffer& commandBuffer);
         void End(const Core::CommandBuffer& commandBuffer);
 
         [[nodiscard]] const std::vector<Attachment>& Attachments() const { return m_attachments; }
+        // Earliest pipeline stages at which this pass touches its attachments
+        [[nodiscard]] vk::PipelineStageFlags2 WaitStages() const;
         [[nodiscard]] std::vector<Attachment> SubpassColorAttachments(const uint32_t index) const {
             if (index >= m_subpasses.size()) {
                 std::cerr << "Subpass index out of range" << std::endl;
@@ -117,10 +136,20 @@ namespace Coral::Graphics {
 
         [[nodiscard]] const Framebuffer& Framebuffer(const u32 index) const { return *m_frameBuffers[index]; }
         [[nodiscard]] const Math::Vector2<u32>& Extent() const { return m_extent; }
-        [[nodiscard]] const vk::SampleCountFlagBits& SampleCount() const { return m_sampleCount; }
+        // Taken from the subpass' color attachments, or its depth attachment when it has none
+        [[nodiscard]] vk::SampleCountFlagBits SampleCount(u32 subpass = 0) const;
         [[nodiscard]] u32 OutputImageIndex() const { return m_outputImageIndex; }
         [[nodiscard]] u32 OutputAttachmentIndex() const { return m_outputAttachmentIndex; }
         [[nodiscard]] u32 ImageCount() const { return m_imageCount; }
+        // Without a render pass object layouts are not changed at its start or end, attachments stay in the subpass layouts
+        [[nodiscard]] bool DynamicRendering() const { return m_dynamicRendering; }
+        // Attachment formats pipelines are created against when rendering dynamically
+        [[nodiscard]] vk::PipelineRenderingCreateInfo RenderingInfo() const {
+            return vk::PipelineRenderingCreateInfo()
+                .setColorAttachmentFormats(m_colorFormats)
+                .setDepthAttachmentFormat(m_depthFormat)
+                .setStencilAttachmentFormat(m_stencilFormat);
+        }
         [[nodiscard]] u32 InFlightImageIndex() const {
             if (!m_inFlightImageIndex.has_value()) {
                 std::cerr << "No in flight image index" << std::endl;
@@ -141,10 +170,29 @@ namespace Coral::Graphics {
         	std::unique_ptr<Pipeline> pipeline = pipelineBuilder->Build();
             m_pipelines.emplace_back(std::move(pipelineBuilder), std::move(pipeline));
         }
+        [[nodiscard]] u32 PipelineCount() const { return static_cast<u32>(m_pipelines.size()); }
+        [[nodiscard]] Pipeline::Builder& PipelineBuilder(const u32 index) const { return *m_pipelines.at(index).first; }
 
         bool Resize(uint32_t imageCount, const Math::Vector2<f32>& extent);
+        // Points an attachment at other images of the same format, the pipelines are kept
+        void SetAttachmentImages(uint32_t index, std::vector<Memory::Image*> images);
 
     private:
+        using DrawItem = std::pair<const ECS::Entity*, const ECS::RenderTarget*>;
+
+        // Below this many draws per chunk, handing the work to another thread costs more than it saves
+        static constexpr u32 MinimumDrawsPerThread = 256;
+        // Push constant layout of a draw: the model matrix followed by the material table slot
+        static constexpr u32 MaterialSlotOffset = sizeof(Math::Matrix4<f32>);
+
+        [[nodiscard]] vk::Viewport Viewport() const;
+        [[nodiscard]] vk::Rect2D Scissor() const;
+        static void RecordDraws(vk::CommandBuffer commandBuffer, const Pipeline& pipeline, std::span<const DrawItem> drawItems);
+        void BeginRendering(const Core::CommandBuffer& commandBuffer, uint32_t imageIndex) const;
+        // Advances the render pass up to the subpass, pipelines are drawn in subpass order
+        void NextSubpass(const Core::CommandBuffer& commandBuffer, uint32_t subpass);
+        [[nodiscard]] const Memory::ImageView& AttachmentView(uint32_t attachment, uint32_t imageIndex) const;
+
         uint32_t m_outputAttachmentIndex = 0;
         uint32_t m_outputImageIndex = 0;
         std::optional<uint32_t> m_inFlightImageIndex;
@@ -154,13 +202,21 @@ namespace Coral::Graphics {
         std::vector<std::unique_ptr<Graphics::Framebuffer>> m_frameBuffers;
 
         std::vector<Attachment> m_attachments;
-        std::vector<std::unique_ptr<Memory::ImageView>> m_imageViews;
 
         std::vector<struct Subpass> m_subpasses;
         std::vector<vk::SubpassDependency> m_dependencies;
 
-        vk::SampleCountFlagBits m_sampleCount = vk::SampleCountFlagBits::e1;
+        bool m_dynamicRendering = false;
+        std::vector<vk::Format> m_colorFormats;
+        vk::Format m_depthFormat = vk::Format::eUndefined;
+        vk::Format m_stencilFormat = vk::Format::eUndefined;
 
         std::vector<std::pair<std::unique_ptr<Pipeline::Builder>, std::unique_ptr<Pipeline>>> m_pipelines;
+
+        vk::SubpassContents m_subpassContents = vk::SubpassContents::eInline;
+        uint32_t m_currentSubpass = 0;
+        std::vector<DrawItem> m_drawItems;
+        // [image][job system thread index], each list allocated from and recorded by that thread only
+        std::vector<std::vector<std::vector<std::unique_ptr<Core::CommandBuffer>>>> m_secondaryCommandBuffers;
     };
 }
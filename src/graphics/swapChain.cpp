@@ -7,6 +7,7 @@
 #include <iostream>
 
 #include "renderPass.h"
+#include "core/deletionQueue.h"
 #include "core/device.h"
 #include "core/physicalDevice.h"
 #include "core/runtime.h"
@@ -29,13 +30,13 @@ namespace Coral::Graphics {
         return availableFormats[0];
     }
 
-    vk::PresentModeKHR SwapChain::ChoosePresentMode(const std::vector<vk::PresentModeKHR> &availablePresentModes) {
+    vk::PresentModeKHR SwapChain::ChoosePresentMode(const std::vector<vk::PresentModeKHR> &availablePresentModes, const vk::PresentModeKHR requestedPresentMode) {
         for (const auto &availablePresentMode : availablePresentModes) {
-            if (availablePresentMode == vk::PresentModeKHR::eMailbox) {
+            if (availablePresentMode == requestedPresentMode) {
                 return availablePresentMode;
             }
         }
-        std::cerr << "Failed to find suitable present mode" << std::endl;
+        std::cerr << "Present mode " << vk::to_string(requestedPresentMode) << " not supported, falling back to FIFO" << std::endl;
         return vk::PresentModeKHR::eFifo;
     }
 
@@ -50,11 +51,11 @@ namespace Coral::Graphics {
     }
 
     SwapChain::SwapChain(const CreateInfo& createInfo)
-        : m_sampleCount(createInfo.sampleCount), m_minImageCount(createInfo.minImageCount), m_imageCount(createInfo.imageCount)
+        : m_sampleCount(createInfo.sampleCount), m_minImageCount(createInfo.minImageCount), m_imageCount(createInfo.imageCount),
+          m_requestedPresentMode(createInfo.presentMode)
     {
         m_extent = Math::Vector2<uint32_t>(1);
 
-        Context::Device()->waitIdle();
         m_presentQueue = Context::Device().RequestPresentQueue();
         CreateSwapChain();
     }
@@ -62,7 +63,7 @@ namespace Coral::Graphics {
     void SwapChain::CreateSwapChain() {
         const auto& physicalDevice =Context::Device().QuerySurfaceCapabilities();
         m_surfaceFormat = ChooseSurfaceFormat(physicalDevice.SurfaceFormats());
-        m_presentMode = ChoosePresentMode(physicalDevice.SurfacePresentModes());
+        m_presentMode = ChoosePresentMode(physicalDevice.SurfacePresentModes(), m_requestedPresentMode);
         m_extent = ChooseExtent(physicalDevice.SurfaceCapabilities(), m_extent);
 
         const vk::SwapchainKHR oldSwapChain = m_handle;
@@ -86,7 +87,7 @@ namespace Coral::Graphics {
         m_handle = Context::Device()->createSwapchainKHR(createInfo);
 
         if (oldSwapChain) {
-            Context::Device()->destroySwapchainKHR(oldSwapChain);
+            Retire(oldSwapChain);
         }
 
         const auto swapChainImageHandles = Context::Device()->getSwapchainImagesKHR(m_handle);
@@ -103,13 +104,29 @@ namespace Coral::Graphics {
                 .InitialLayout(vk::ImageLayout::ePresentSrcKHR)
                 .Build());
         }
+        m_readyToPresent.clear();
+        for (u32 i = 0; i < m_swapChainImages.size(); i++) {
+            m_readyToPresent.emplace_back(Context::Device()->createSemaphore({}));
+        }
     }
 
     SwapChain::~SwapChain() {
-        Context::Device()->waitIdle();
-        if (m_handle) {
-            Context::Device()->destroySwapchainKHR(m_handle);
-        }
+        Retire(m_handle);
+    }
+
+    void SwapChain::Retire(const vk::SwapchainKHR swapChain) {
+        auto images = std::make_shared<std::vector<std::unique_ptr<Memory::Image>>>(std::move(m_swapChainImages));
+        Context::DeletionQueue().Retire([swapChain, images, semaphores = std::move(m_readyToPresent)] {
+            images->clear();
+            for (const auto semaphore : semaphores) {
+                Context::Device()->destroySemaphore(semaphore);
+            }
+            if (swapChain) {
+                Context::Device()->destroySwapchainKHR(swapChain);
+            }
+        });
+        m_swapChainImages.clear();
+        m_readyToPresent.clear();
     }
 
     std::vector<Memory::Image *> SwapChain::SwapChainImages() const {
@@ -120,7 +137,11 @@ namespace Coral::Graphics {
 
     void SwapChain::Resize(const Math::Vector2<f32>& newSize) {
         m_extent = newSize;
-        Context::Device()->waitIdle();
+        CreateSwapChain();
+    }
+
+    void SwapChain::SetPresentMode(const vk::PresentModeKHR presentMode) {
+        m_requestedPresentMode = presentMode;
         CreateSwapChain();
     }
 
@@ -139,7 +160,7 @@ namespace Coral::Graphics {
 
     vk::Result SwapChain::Present(const Core::Frame &frame) {
         std::array waitSemaphores = {
-        	frame.FinalImageTransferCommandBuffer().SignalSemaphore()
+        	ReadyToPresent()
         };
 
         std::array swapChains = {
@@ -152,7 +173,7 @@ namespace Coral::Graphics {
             .setImageIndices(m_imageIndex);
 
         try {
-        	return frame.Queue()->presentKHR(presentInfo);
+        	return frame.Queue().Present(presentInfo);
         } catch (const vk::OutOfDateKHRError &) {
             return vk::Result::eErrorOutOfDateKHR;
         }
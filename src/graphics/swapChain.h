@@ -28,6 +28,8 @@ namespace Coral::Graphics {
             uint32_t minImageCount;
             uint32_t imageCount;
             vk::SampleCountFlagBits sampleCount;
+            // Falls back to FIFO, the only mode every surface supports
+            vk::PresentModeKHR presentMode = vk::PresentModeKHR::eMailbox;
         };
 
         explicit SwapChain(const CreateInfo& createInfo);
@@ -40,8 +42,12 @@ namespace Coral::Graphics {
         [[nodiscard]] std::vector<Memory::Image*> SwapChainImages() const;
         [[nodiscard]] vk::Format ImageFormat() const { return m_surfaceFormat.format; }
     	[[nodiscard]] u32 CurrentImageIndex() const { return m_imageIndex; }
+    	[[nodiscard]] vk::PresentModeKHR PresentMode() const { return m_presentMode; }
+    	// Belongs to the acquired image, a frame slot comes around again while the present of its last image may still wait
+    	[[nodiscard]] vk::Semaphore ReadyToPresent() const { return m_readyToPresent.at(m_imageIndex); }
 
         void Resize(const Math::Vector2<f32>& newSize);
+        void SetPresentMode(vk::PresentModeKHR presentMode);
         vk::Result Acquire(const Core::Frame &frame);
         vk::Result Present(const Core::Frame &frame);
 
@@ -53,14 +59,18 @@ namespace Coral::Graphics {
         uint32_t m_imageIndex = 0;
         vk::SurfaceFormatKHR m_surfaceFormat = {};
         vk::PresentModeKHR m_presentMode = {};
+        vk::PresentModeKHR m_requestedPresentMode = vk::PresentModeKHR::eMailbox;
 
         std::unique_ptr<Core::Queue> m_presentQueue;
         std::vector<std::unique_ptr<Memory::Image>> m_swapChainImages;
+        std::vector<vk::Semaphore> m_readyToPresent;
 
         void CreateSwapChain();
+        // Frames still in flight may present the images, the swap chain goes with them once those frames retired
+        void Retire(vk::SwapchainKHR swapChain);
 
         static vk::SurfaceFormatKHR ChooseSurfaceFormat(const std::vector<vk::SurfaceFormatKHR> &availableFormats);
-        static vk::PresentModeKHR ChoosePresentMode(const std::vector<vk::PresentModeKHR> &availablePresentModes);
+        static vk::PresentModeKHR ChoosePresentMode(const std::vector<vk::PresentModeKHR> &availablePresentModes, vk::PresentModeKHR requestedPresentMode);
         static Math::Vector2<uint32_t> ChooseExtent(const vk::SurfaceCapabilitiesKHR &capabilities, const Math::Vector2<uint32_t>& extent);
     };
 }
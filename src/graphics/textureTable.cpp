@@ -0,0 +1,103 @@
+//
+// Created by radue on 10/17/2026.
+//
+
+#include "textureTable.h"
+
+#include <algorithm>
+
+#include "context.h"
+#include "core/deletionQueue.h"
+#include "core/physicalDevice.h"
+#include "core/runtime.h"
+#include "memory/descriptor/layoutCache.h"
+#include "memory/descriptor/pool.h"
+#include "objects/texture.h"
+
+namespace Coral::Graphics {
+    static constexpr u32 DesiredCapacity = 4096;
+
+    TextureTable::TextureTable() {
+        m_layout = Context::LayoutCache().AcquireSetLayout(LayoutBuilder());
+
+        m_pool = Memory::Descriptor::Pool::Builder()
+            .AddPoolSize(vk::DescriptorType::eCombinedImageSampler, Capacity())
+            .PoolFlags(vk::DescriptorPoolCreateFlagBits::eUpdateAfterBind)
+            .MaxSets(1)
+            .Build();
+        m_set = m_pool->Allocate(*m_layout);
+    }
+
+    TextureTable::~TextureTable() = default;
+
+    Memory::Descriptor::SetLayout::Builder TextureTable::LayoutBuilder() {
+        auto builder = Memory::Descriptor::SetLayout::Builder();
+        builder
+            .AddBinding(Binding, vk::DescriptorType::eCombinedImageSampler, vk::ShaderStageFlagBits::eAll, Capacity())
+            .BindingFlags(Binding,
+                vk::DescriptorBindingFlagBits::ePartiallyBound |
+                vk::DescriptorBindingFlagBits::eUpdateAfterBind |
+                vk::DescriptorBindingFlagBits::eUpdateUnusedWhilePending)
+            .Flags(vk::DescriptorSetLayoutCreateFlagBits::eUpdateAfterBindPool);
+        return builder;
+    }
+
+    u32 TextureTable::Capacity() {
+        static const u32 capacity = [] {
+            const auto properties = (*Context::Runtime().PhysicalDevice()).getProperties2<
+                vk::PhysicalDeviceProperties2, vk::PhysicalDeviceDescriptorIndexingProperties>();
+            const auto& indexing = properties.get<vk::PhysicalDeviceDescriptorIndexingProperties>();
+            // Combined image samplers count against both the sampler and the sampled image limits
+            return std::min({
+                DesiredCapacity,
+                indexing.maxDescriptorSetUpdateAfterBindSampledImages,
+                indexing.maxDescriptorSetUpdateAfterBindSamplers,
+                indexing.maxPerStageDescriptorUpdateAfterBindSampledImages,
+                indexing.maxPerStageDescriptorUpdateAfterBindSamplers,
+            });
+        }();
+        return capacity;
+    }
+
+    u32 TextureTable::Register(const Texture &texture) {
+        u32 slot;
+        if (!m_freeSlots.empty()) {
+            slot = m_freeSlots.back();
+            m_freeSlots.pop_back();
+        } else if (m_nextSlot < Capacity()) {
+            slot = m_nextSlot++;
+        } else {
+            throw std::runtime_error("TextureTable::Register : All " + std::to_string(Capacity()) + " slots are in use");
+        }
+
+        Update(slot, texture);
+        return slot;
+    }
+
+    void TextureTable::Update(const u32 slot, const Texture &texture) const {
+        const auto imageInfo = texture.DescriptorInfo();
+        const auto write = vk::WriteDescriptorSet()
+            .setDstSet(m_set)
+            .setDstBinding(Binding)
+            .setDstArrayElement(slot)
+            .setDescriptorType(vk::DescriptorType::eCombinedImageSampler)
+            .setImageInfo(imageInfo);
+        Context::Device()->updateDescriptorSets(write, {});
+    }
+
+    void TextureTable::Unregister(const u32 slot) {
+        if (slot == InvalidSlot) {
+            return;
+        }
+        // The frame being recorded may sample the slot too, the deletion queue stamps it with the value that frame signals
+        m_retiringCount++;
+        Context::DeletionQueue().Retire([this, slot] {
+            m_freeSlots.emplace_back(slot);
+            m_retiringCount--;
+        });
+    }
+
+    void TextureTable::Bind(const vk::CommandBuffer commandBuffer, const vk::PipelineLayout layout, const vk::PipelineBindPoint bindPoint) const {
+        commandBuffer.bindDescriptorSets(bindPoint, layout, Set, m_set, nullptr);
+    }
+}
@@ -0,0 +1,61 @@
+//
+// Created by radue on 10/17/2026.
+//
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <vulkan/vulkan.hpp>
+
+#include "memory/descriptor/setLayout.h"
+#include "utils/types.h"
+
+namespace Coral::Memory::Descriptor {
+    class Pool;
+}
+
+namespace Coral::Graphics {
+    class Texture;
+
+    // One partially bound, update-after-bind array of every registered texture. Shaders index it with the
+    // slots stored in the material data, so nothing texture related is bound per draw.
+    class TextureTable {
+    public:
+        // Descriptor set index reserved for the table in every pipeline layout
+        static constexpr u32 Set = 1;
+        static constexpr u32 Binding = 0;
+        static constexpr u32 InvalidSlot = UINT32_MAX;
+
+        TextureTable();
+        ~TextureTable();
+        TextureTable(const TextureTable &) = delete;
+        TextureTable &operator=(const TextureTable &) = delete;
+
+        // Layout pipelines use for the reserved set, identical to the table's through the layout cache
+        [[nodiscard]] static Memory::Descriptor::SetLayout::Builder LayoutBuilder();
+        // Slot count, limited by what the device supports for update-after-bind sampled images
+        [[nodiscard]] static u32 Capacity();
+
+        [[nodiscard]] u32 Register(const Texture &texture);
+        // Rewrites the slot, e.g. after the texture's view or sampler changed
+        void Update(u32 slot, const Texture &texture) const;
+        // The slot is only handed out again once the GPU retired every frame that may still sample it
+        void Unregister(u32 slot);
+
+        void Bind(vk::CommandBuffer commandBuffer, vk::PipelineLayout layout, vk::PipelineBindPoint bindPoint = vk::PipelineBindPoint::eGraphics) const;
+
+        [[nodiscard]] u32 Count() const { return m_nextSlot - static_cast<u32>(m_freeSlots.size()) - m_retiringCount; }
+
+    private:
+        std::shared_ptr<const Memory::Descriptor::SetLayout> m_layout;
+        std::unique_ptr<Memory::Descriptor::Pool> m_pool;
+        vk::DescriptorSet m_set;
+
+        u32 m_nextSlot = 0;
+        std::vector<u32> m_freeSlots;
+        // Unregistered slots waiting in the deletion queue
+        u32 m_retiringCount = 0;
+    };
+}
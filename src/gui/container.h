@@ -16,17 +16,16 @@ namespace Coral::Reef {
         Container() = default;
 		Container(nullptr_t) : m_layer(nullptr) {}
 
-        explicit Container(T *layer) : m_layer(layer) {
+        // Without a GUI (headless runs) the layer is only owned, never attached
+        explicit Container(T *layer) : m_layer(layer), m_attached(Context::HasGUI()) {
+            if (!m_attached) {
+                return;
+            }
             Context::GUIManager().AddLayer(m_layer);
             static_cast<Layer *>(m_layer)->OnGUIAttach();
         }
         ~Container() {
-            if (m_layer == nullptr) {
-                return;
-            }
-            static_cast<Layer *>(m_layer)->OnGUIDetach();
-            Context::GUIManager().RemoveLayer(m_layer);
-            delete m_layer;
+            reset();
         }
 
         Container(const Container&) = delete;
@@ -34,12 +33,14 @@ namespace Coral::Reef {
 
         Container(Container&& other) noexcept {
 	        m_layer = other.m_layer;
+	        m_attached = other.m_attached;
 			other.m_layer = nullptr;
         }
         Container& operator=(Container&& other) noexcept {
 			if (this != &other) {
 				delete m_layer;
 				m_layer = other.m_layer;
+				m_attached = other.m_attached;
 				other.m_layer = nullptr;
 			}
 			return *this;
@@ -57,8 +58,10 @@ namespace Coral::Reef {
         	if (m_layer == nullptr) {
         		return;
         	}
-        	static_cast<Layer *>(m_layer)->OnGUIDetach();
-        	Context::GUIManager().RemoveLayer(m_layer);
+        	if (m_attached) {
+        		static_cast<Layer *>(m_layer)->OnGUIDetach();
+        		Context::GUIManager().RemoveLayer(m_layer);
+        	}
         	delete m_layer;
         	m_layer = nullptr;
         }
@@ -72,6 +75,7 @@ namespace Coral::Reef {
 		}
     private:
         T* m_layer = nullptr;
+        bool m_attached = false;
     };
 
     template <typename T, typename... Args, typename = std::enable_if_t<std::is_base_of_v<Layer, T>>>
@@ -116,6 +116,8 @@ namespace Coral::Reef {
             .MSAASamples = static_cast<VkSampleCountFlagBits>(m_sampleCount),
             .PipelineCache = nullptr,
             .Subpass = 0,
+            .UseDynamicRendering = m_renderPass.DynamicRendering(),
+            .PipelineRenderingCreateInfo = m_renderPass.RenderingInfo(),
             .Allocator = nullptr,
             .CheckVkResultFn = check_vk_result,
         };
@@ -0,0 +1,65 @@
+//
+// Created by radue on 10/17/2026.
+//
+
+#include "memoryPanel.h"
+
+#include <format>
+
+#include "IconsFontAwesome6.h"
+#include "context.h"
+#include "reef.h"
+#include "memory/allocator.h"
+
+namespace Coral::Reef {
+	static f64 Mebibytes(const vk::DeviceSize bytes) {
+		return static_cast<f64>(bytes) / (1024.0 * 1024.0);
+	}
+
+	MemoryPanel::MemoryPanel(Path reportPath) : m_reportPath(std::move(reportPath)) {}
+
+	void MemoryPanel::OnGUIAttach() {
+		std::vector<Element*> rows;
+
+		rows.emplace_back(new Text(Context::Allocator().HasBudgetExtension() ? "Heaps" : "Heaps (estimated budget)"));
+		const auto heapCount = static_cast<u32>(Context::Allocator().HeapBudgets().size());
+		for (u32 i = 0; i < heapCount; i++) {
+			rows.emplace_back(new DynamicText<String>("{}", std::function<String()>([i] {
+				const auto heap = Context::Allocator().HeapBudgets()[i];
+				return std::format("{}{}: {:.1f} / {:.1f} MiB, peak {:.1f} MiB",
+					i, heap.deviceLocal ? " (device local)" : "",
+					Mebibytes(heap.usage), Mebibytes(heap.budget), Mebibytes(heap.peakUsage));
+			})));
+		}
+
+		rows.emplace_back(new Text("Categories"));
+		for (u32 i = 0; i < Memory::CategoryCount; i++) {
+			rows.emplace_back(new DynamicText<String>("{}", std::function<String()>([i] {
+				const auto stats = Context::Allocator().CategoryStats()[i];
+				return std::format("{}: {:.1f} MiB in {} allocations, peak {:.1f} MiB",
+					Memory::CategoryName(static_cast<Memory::Category>(i)),
+					Mebibytes(stats.bytes), stats.allocationCount, Mebibytes(stats.peakBytes));
+			})));
+		}
+
+		rows.emplace_back(new Button(
+			{ .size = { Grow, 23.f }, .padding = { 8.f, 5.f, 5.f, 5.f }, .cornerRadius = 5.f },
+			[this] {
+				Context::Allocator().DumpReport(m_reportPath);
+			},
+			{ new Text(ICON_FA_FLOPPY_DISK "   Dump JSON report") }
+		));
+
+		AddDockable("memory",
+			new Window(ICON_FA_MEMORY "   Memory",
+				Style {
+					.padding = { 10.f, 10.f, 10.f, 10.f },
+					.spacing = 10.f,
+					.backgroundColor = { 0.0f, 0.0f, 0.0f, 1.f },
+					.direction = Axis::Vertical,
+				},
+				rows
+			)
+		);
+	}
+}
@@ -0,0 +1,20 @@
+//
+// Created by radue on 10/17/2026.
+//
+
+#pragma once
+
+#include "layer.h"
+
+namespace Coral::Reef {
+	// Heap budgets and per category allocator usage, with a button writing the full report as JSON
+	class MemoryPanel final : public Layer {
+	public:
+		explicit MemoryPanel(Path reportPath = "memoryReport.json");
+
+		void OnGUIAttach() override;
+
+	private:
+		Path m_reportPath;
+	};
+}
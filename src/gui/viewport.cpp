@@ -5,15 +5,22 @@
 #include "viewport.h"
 
 #include "context.h"
+#include "core/deletionQueue.h"
 #include "core/scheduler.h"
 #include "ecs/components/camera.h"
 #include "ecs/entity.h"
 #include "ecs/sceneManager.h"
 #include "gui/elements/popup.h"
+#include "memory/imageView.h"
 #include "project/renderGraph.h"
 
 namespace Coral::Reef {
-	Viewport::Viewport(Graphics::RenderPass& renderPass): m_renderPass(renderPass) {
+	// The last GUI frames drawing the texture may still be in flight
+	static void RemoveTexture(const VkDescriptorSet texture) {
+		Context::DeletionQueue().Retire([texture] { ImGui_ImplVulkan_RemoveTexture(texture); });
+	}
+
+	Viewport::Viewport(std::vector<Memory::Image*> images): m_images(std::move(images)) {
 		constexpr auto createInfo = Memory::Sampler::CreateInfo {
 			.magFilter = vk::Filter::eLinear,
 			.minFilter = vk::Filter::eLinear,
@@ -21,23 +28,31 @@ namespace Coral::Reef {
 			.mipmapMode = vk::SamplerMipmapMode::eNearest,
 		};
 
-		m_sampler = std::make_unique<Memory::Sampler>(createInfo);
+		m_sampler = Context::SamplerCache().Acquire(createInfo);
 	}
 
-	void Viewport::OnGUIAttach() {
+	// Views are acquired from the images themselves, passes rendering without framebuffers have none to borrow from
+	void Viewport::CreateTextures() {
 		for (const auto texture : m_viewportTextures) {
-			ImGui_ImplVulkan_RemoveTexture(texture);
+			RemoveTexture(texture);
 		}
 		m_viewportTextures.clear();
-		m_viewportTextures.reserve(m_renderPass.ImageCount());
-		const uint32_t outputAttachmentIndex = m_renderPass.OutputAttachmentIndex();
-		for (uint32_t i = 0; i < m_renderPass.ImageCount(); i++) {
-			const auto& framebuffer = m_renderPass.Framebuffer(i);
+		m_viewportTextures.reserve(m_images.size());
+		for (const auto* image : m_images) {
+			const auto& view = Memory::ImageView::Builder(*image)
+				.ViewType(vk::ImageViewType::e2D)
+				.BaseMipLevel(0)
+				.LevelCount(1)
+				.Acquire();
 			m_viewportTextures.emplace_back(ImGui_ImplVulkan_AddTexture(
 				**m_sampler,
-				*framebuffer.ImageView(outputAttachmentIndex),
+				*view,
 				static_cast<VkImageLayout>(vk::ImageLayout::eShaderReadOnlyOptimal)));
 		}
+	}
+
+	void Viewport::OnGUIAttach() {
+		CreateTextures();
 
 		m_image = new Image(m_viewportTextures[0], Style {
 			.size = { Reef::Grow, Reef::Grow },
@@ -58,33 +73,22 @@ namespace Coral::Reef {
             		auto& scene = ECS::SceneManager::Get().GetLoadedScene();
 					scene.MainCamera().Resize(newSize);
 
-					for (uint32_t i = 0; i < m_renderPass.ImageCount(); i++) {
-						ImGui_ImplVulkan_RemoveTexture(m_viewportTextures[i]);
-					}
-					m_viewportTextures.clear();
-					m_viewportTextures.reserve(m_renderPass.ImageCount());
-					const uint32_t outputAttachmentIndex = m_renderPass.OutputAttachmentIndex();
-					for (uint32_t i = 0; i < m_renderPass.ImageCount(); i++) {
-						const auto& framebuffer = m_renderPass.Framebuffer(i);
-						m_viewportTextures.emplace_back(ImGui_ImplVulkan_AddTexture(
-							**m_sampler,
-							*framebuffer.ImageView(outputAttachmentIndex),
-							static_cast<VkImageLayout>(vk::ImageLayout::eShaderReadOnlyOptimal)));
-					}
-					m_image->SetTexture(m_viewportTextures[Context::Scheduler().CurrentFrame().ImageIndex()]);
+					CreateTextures();
+					m_image->SetTexture(m_viewportTextures[Context::Scheduler().CurrentFrame().Index()]);
 				}
             }
         ));
 	}
 
 	void Viewport::OnGUIDetach() {
-		for (uint32_t i = 0; i < m_renderPass.ImageCount(); i++) {
-			ImGui_ImplVulkan_RemoveTexture(m_viewportTextures[i]);
+		for (const auto texture : m_viewportTextures) {
+			RemoveTexture(texture);
 		}
+		m_viewportTextures.clear();
 	}
 
 	void Viewport::OnGUIUpdate() {
 		Layer::OnGUIUpdate();
-		m_image->SetTexture(m_viewportTextures[Context::Scheduler().CurrentFrame().ImageIndex()]);
+		m_image->SetTexture(m_viewportTextures[Context::Scheduler().CurrentFrame().Index()]);
 	}
 }
@@ -7,8 +7,7 @@
 
 #include "imgui_impl_vulkan.h"
 #include "layer.h"
-#include "graphics/framebuffer.h"
-#include "graphics/renderPass.h"
+#include "memory/image.h"
 #include "memory/sampler.h"
 
 #include "reef.h"
@@ -16,16 +15,19 @@
 namespace Coral::Reef {
 	class Viewport final : public Layer {
 	public:
-		explicit Viewport(Graphics::RenderPass& renderPass);
+		// Shows the image of the current frame, one per frame in flight
+		explicit Viewport(std::vector<Memory::Image*> images);
 
 		void OnGUIAttach() override;
 		void OnGUIDetach() override;
 		void OnGUIUpdate() override;
 
 	private:
-		Graphics::RenderPass& m_renderPass;
+		void CreateTextures();
 
-		std::unique_ptr<Memory::Sampler> m_sampler;
+		std::vector<Memory::Image*> m_images;
+
+		std::shared_ptr<const Memory::Sampler> m_sampler;
 		std::vector<vk::DescriptorSet> m_viewportTextures;
 		Image* m_image = nullptr;
     };
@@ -1,8 +1,65 @@
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+
 #include "engine.h"
 #include "gui/elements/popup.h"
 
-int main()
+int main(const int argc, char** argv)
 {
-    Coral::Engine().Run();
+    // --headless [--frames N] [--output directory] renders offscreen, e.g. for CI and performance runs
+    // --present-mode fifo|fifo-relaxed|mailbox|immediate and --fps N control pacing
+    // --self-test [group] runs the tests headless and exits with the number of failures
+    // --bench-allocator times allocate/free through the allocator against plain vkAllocateMemory
+    // --memory-report path writes the allocator statistics as JSON on exit
+    // --no-subpass-merge keeps the render graph's passes apart, so they render dynamically
+    auto createInfo = Coral::Engine::CreateInfo {};
+    std::optional<std::string_view> selfTest;
+    bool benchAllocator = false;
+    for (int i = 1; i < argc; i++) {
+        const auto argument = std::string_view(argv[i]);
+        if (argument == "--headless") {
+            createInfo.headless = true;
+        } else if (argument == "--frames" && i + 1 < argc) {
+            createInfo.frameCount = std::stoull(argv[++i]);
+        } else if (argument == "--output" && i + 1 < argc) {
+            createInfo.outputDirectory = argv[++i];
+        } else if (argument == "--present-mode" && i + 1 < argc) {
+            const auto mode = std::string_view(argv[++i]);
+            if (mode == "fifo") {
+                createInfo.presentMode = vk::PresentModeKHR::eFifo;
+            } else if (mode == "fifo-relaxed") {
+                createInfo.presentMode = vk::PresentModeKHR::eFifoRelaxed;
+            } else if (mode == "mailbox") {
+                createInfo.presentMode = vk::PresentModeKHR::eMailbox;
+            } else if (mode == "immediate") {
+                createInfo.presentMode = vk::PresentModeKHR::eImmediate;
+            } else {
+                std::cerr << "Unknown present mode " << mode << ", using mailbox" << std::endl;
+            }
+        } else if (argument == "--fps" && i + 1 < argc) {
+            createInfo.targetFrameRate = std::stof(argv[++i]);
+        } else if (argument == "--self-test") {
+            selfTest = i + 1 < argc && argv[i + 1][0] != '-' ? std::string_view(argv[++i]) : std::string_view();
+        } else if (argument == "--memory-report" && i + 1 < argc) {
+            createInfo.memoryReport = argv[++i];
+        } else if (argument == "--no-subpass-merge") {
+            createInfo.mergeSubpasses = false;
+        } else if (argument == "--bench-allocator") {
+            benchAllocator = true;
+        }
+    }
+
+    if (selfTest) {
+        createInfo.headless = true;
+        return static_cast<int>(Coral::Engine(createInfo).SelfTest(*selfTest));
+    }
+    if (benchAllocator) {
+        createInfo.headless = true;
+        Coral::Engine(createInfo).BenchmarkAllocator();
+        return 0;
+    }
+    Coral::Engine(createInfo).Run();
     return 0;
 }
@@ -0,0 +1,636 @@
+//
+// Created by radue on 10/17/2026.
+//
+
+#include "allocator.h"
+
+#include <algorithm>
+#include <bit>
+#include <fstream>
+#include <iostream>
+
+#include <nlohmann/json.hpp>
+
+#include "context.h"
+#include "core/device.h"
+#include "core/physicalDevice.h"
+#include "core/runtime.h"
+
+namespace Coral::Memory {
+    static vk::DeviceSize AlignUp(const vk::DeviceSize value, const vk::DeviceSize alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    const char* CategoryName(const Category category) {
+        switch (category) {
+            case Category::Mesh: return "mesh";
+            case Category::Texture: return "texture";
+            case Category::Attachment: return "attachment";
+            case Category::Staging: return "staging";
+            case Category::Uniform: return "uniform";
+            default: return "other";
+        }
+    }
+
+    Allocator::Statistics& Allocator::Statistics::operator+=(const Statistics& other) {
+        blockCount += other.blockCount;
+        allocationCount += other.allocationCount;
+        dedicatedAllocationCount += other.dedicatedAllocationCount;
+        blockBytes += other.blockBytes;
+        usedBytes += other.usedBytes;
+        dedicatedBytes += other.dedicatedBytes;
+        freeRangeCount += other.freeRangeCount;
+        largestFreeRange = std::max(largestFreeRange, other.largestFreeRange);
+        return *this;
+    }
+
+    Allocator::Block::Block() {
+        for (auto& secondLevel : freeLists) {
+            secondLevel.fill(UINT32_MAX);
+        }
+    }
+
+    u32 Allocator::Block::NewNode() {
+        if (!unusedNodes.empty()) {
+            const auto index = unusedNodes.back();
+            unusedNodes.pop_back();
+            nodes[index] = Node {};
+            return index;
+        }
+        nodes.emplace_back();
+        return static_cast<u32>(nodes.size() - 1);
+    }
+
+    void Allocator::Block::InsertFree(const u32 index) {
+        auto& node = nodes[index];
+        const auto [firstLevel, secondLevel] = Mapping(node.size);
+        auto& head = freeLists[firstLevel][secondLevel];
+
+        node.free = true;
+        node.previousFree = UINT32_MAX;
+        node.nextFree = head;
+        if (head != UINT32_MAX) {
+            nodes[head].previousFree = index;
+        }
+        head = index;
+
+        firstLevelBitmap |= 1ull << firstLevel;
+        secondLevelBitmaps[firstLevel] |= 1u << secondLevel;
+    }
+
+    void Allocator::Block::RemoveFree(const u32 index) {
+        auto& node = nodes[index];
+        const auto [firstLevel, secondLevel] = Mapping(node.size);
+
+        if (node.previousFree != UINT32_MAX) {
+            nodes[node.previousFree].nextFree = node.nextFree;
+        } else {
+            freeLists[firstLevel][secondLevel] = node.nextFree;
+        }
+        if (node.nextFree != UINT32_MAX) {
+            nodes[node.nextFree].previousFree = node.previousFree;
+        }
+        node.free = false;
+        node.previousFree = UINT32_MAX;
+        node.nextFree = UINT32_MAX;
+
+        if (freeLists[firstLevel][secondLevel] == UINT32_MAX) {
+            secondLevelBitmaps[firstLevel] &= ~(1u << secondLevel);
+            if (secondLevelBitmaps[firstLevel] == 0) {
+                firstLevelBitmap &= ~(1ull << firstLevel);
+            }
+        }
+    }
+
+    u32 Allocator::Block::FindFree(const vk::DeviceSize size) const {
+        // Rounding up to the next list guarantees every node of the list found is big enough
+        const auto firstLevelOfSize = static_cast<u32>(std::bit_width(size) - 1);
+        const auto rounded = size + (1ull << (firstLevelOfSize - SecondLevelBits)) - 1;
+        auto [firstLevel, secondLevel] = Mapping(rounded);
+
+        if (firstLevel >= FirstLevelCount) {
+            return UINT32_MAX;
+        }
+
+        u32 secondLevelMap = secondLevelBitmaps[firstLevel] & (~0u << secondLevel);
+        if (secondLevelMap == 0) {
+            if (firstLevel + 1 >= FirstLevelCount) {
+                return UINT32_MAX;
+            }
+            const u64 firstLevelMap = firstLevelBitmap & (~0ull << (firstLevel + 1));
+            if (firstLevelMap == 0) {
+                return UINT32_MAX;
+            }
+            firstLevel = static_cast<u32>(std::countr_zero(firstLevelMap));
+            secondLevelMap = secondLevelBitmaps[firstLevel];
+        }
+        secondLevel = static_cast<u32>(std::countr_zero(secondLevelMap));
+        return freeLists[firstLevel][secondLevel];
+    }
+
+    std::pair<u32, u32> Allocator::Mapping(const vk::DeviceSize size) {
+        const auto firstLevel = static_cast<u32>(std::bit_width(size) - 1);
+        const auto secondLevel = static_cast<u32>((size >> (firstLevel - SecondLevelBits)) ^ (1ull << SecondLevelBits));
+        return { firstLevel, secondLevel };
+    }
+
+    Allocator::Allocator(const CreateInfo& createInfo)
+        : m_blockSize(createInfo.blockSize), m_dedicatedThreshold(createInfo.dedicatedThreshold) {
+		static bool firstTime = true;
+		if (!firstTime) {
+			throw std::runtime_error("Allocator already created!");
+		}
+		firstTime = false;
+        Context::m_allocator = this;
+
+        const auto& physicalDevice = Core::Runtime::Get().PhysicalDevice();
+        m_memoryProperties = physicalDevice->getMemoryProperties();
+        m_nonCoherentAtomSize = physicalDevice->getProperties().limits.nonCoherentAtomSize;
+
+        m_pools.resize(m_memoryProperties.memoryTypeCount * 2);
+        for (u32 i = 0; i < m_memoryProperties.memoryTypeCount; i++) {
+            m_pools[i * 2] = Pool { .memoryTypeIndex = i, .kind = ResourceKind::Buffer };
+            m_pools[i * 2 + 1] = Pool { .memoryTypeIndex = i, .kind = ResourceKind::Image };
+        }
+        m_dedicatedStats.resize(m_memoryProperties.memoryTypeCount);
+
+        m_budgetExtension = Core::Runtime::Get().IsDeviceExtensionEnabled(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+        m_heaps.resize(m_memoryProperties.memoryHeapCount);
+        m_overBudget.resize(m_memoryProperties.memoryHeapCount, false);
+        for (u32 i = 0; i < m_memoryProperties.memoryHeapCount; i++) {
+            const auto& heap = m_memoryProperties.memoryHeaps[i];
+            m_heaps[i].size = heap.size;
+            m_heaps[i].deviceLocal = static_cast<bool>(heap.flags & vk::MemoryHeapFlagBits::eDeviceLocal);
+        }
+        PollBudget();
+    }
+
+    Allocator::~Allocator() {
+        const auto stats = Stats();
+        if (stats.allocationCount + stats.dedicatedAllocationCount > 0) {
+            std::cerr << "Allocator : " << stats.allocationCount + stats.dedicatedAllocationCount << " allocations leaked" << std::endl;
+        }
+        for (auto& pool : m_pools) {
+            for (const auto& block : pool.blocks) {
+                if (block) {
+                    DestroyBlock(*block);
+                }
+            }
+        }
+        Context::m_allocator = nullptr;
+    }
+
+    Allocation Allocator::Allocate(const vk::MemoryRequirements& requirements, const vk::MemoryPropertyFlags properties,
+        const ResourceKind kind, const Category category, const bool dedicated, const void* dedicatedInfo) {
+        std::lock_guard lock(m_mutex);
+
+        const auto memoryTypeIndex = FindMemoryType(requirements.memoryTypeBits, properties);
+        if (!memoryTypeIndex.has_value()) {
+            throw std::runtime_error("Allocator::Allocate : Failed to find suitable memory type");
+        }
+
+        auto alignment = std::max<vk::DeviceSize>(requirements.alignment, 1);
+        auto size = AlignUp(std::max(requirements.size, MinimumNodeSize), MinimumNodeSize);
+        const auto propertyFlags = m_memoryProperties.memoryTypes[memoryTypeIndex.value()].propertyFlags;
+        if (propertyFlags & vk::MemoryPropertyFlagBits::eHostVisible && !(propertyFlags & vk::MemoryPropertyFlagBits::eHostCoherent)) {
+            // Flushes of one allocation must never touch a neighbour's atoms
+            alignment = std::max(alignment, m_nonCoherentAtomSize);
+            size = AlignUp(size, m_nonCoherentAtomSize);
+        }
+
+        if (dedicated || size >= m_dedicatedThreshold) {
+            auto allocation = AllocateDedicated(requirements.size, memoryTypeIndex.value(), dedicatedInfo);
+            allocation.category = category;
+            Account(allocation, true);
+            return allocation;
+        }
+
+        const auto poolIndex = memoryTypeIndex.value() * 2 + static_cast<u32>(kind);
+        auto& pool = m_pools[poolIndex];
+
+        Allocation allocation;
+        allocation.pool = poolIndex;
+        allocation.memoryTypeIndex = memoryTypeIndex.value();
+        allocation.category = category;
+
+        for (u32 i = 0; i < pool.blocks.size(); i++) {
+            if (pool.blocks[i] && AllocateFromBlock(*pool.blocks[i], size, alignment, allocation)) {
+                allocation.block = i;
+                Account(allocation, true);
+                return allocation;
+            }
+        }
+
+        auto& heap = Heap(memoryTypeIndex.value());
+        auto blockSize = std::max(std::min(m_blockSize, heap.size / 8), size + alignment);
+        // Close to the budget only the request itself is allocated, a speculative block would push the heap into paging
+        if (heap.usage + blockSize > heap.budget) {
+            blockSize = size + alignment;
+            if (heap.usage + blockSize > heap.budget) {
+                std::cerr << "Allocator::Allocate : Heap over budget, " << (heap.usage + blockSize) / (1024 * 1024) << " of "
+                    << heap.budget / (1024 * 1024) << " MiB" << std::endl;
+            }
+        }
+
+        auto block = CreateBlock(memoryTypeIndex.value(), blockSize);
+        if (!AllocateFromBlock(*block, size, alignment, allocation)) {
+            DestroyBlock(*block);
+            throw std::runtime_error("Allocator::Allocate : Allocation does not fit in a fresh block");
+        }
+
+        heap.usage += blockSize;
+        heap.peakUsage = std::max(heap.peakUsage, heap.usage);
+
+        const auto freeSlot = std::ranges::find(pool.blocks, nullptr);
+        allocation.block = static_cast<u32>(freeSlot - pool.blocks.begin());
+        if (freeSlot == pool.blocks.end()) {
+            pool.blocks.emplace_back(std::move(block));
+        } else {
+            *freeSlot = std::move(block);
+        }
+        Account(allocation, true);
+        return allocation;
+    }
+
+    Allocation Allocator::AllocateFor(const vk::Buffer buffer, const vk::MemoryPropertyFlags properties, const Category category) {
+        const auto requirements = Context::Device()->getBufferMemoryRequirements2<vk::MemoryRequirements2, vk::MemoryDedicatedRequirements>(
+            vk::BufferMemoryRequirementsInfo2().setBuffer(buffer));
+        const auto& dedicatedRequirements = requirements.get<vk::MemoryDedicatedRequirements>();
+        const auto dedicatedInfo = vk::MemoryDedicatedAllocateInfo().setBuffer(buffer);
+
+        return Allocate(
+            requirements.get<vk::MemoryRequirements2>().memoryRequirements,
+            properties,
+            ResourceKind::Buffer,
+            category,
+            dedicatedRequirements.prefersDedicatedAllocation || dedicatedRequirements.requiresDedicatedAllocation,
+            &dedicatedInfo);
+    }
+
+    Allocation Allocator::AllocateFor(const vk::Image image, const vk::MemoryPropertyFlags properties, const Category category) {
+        const auto requirements = Context::Device()->getImageMemoryRequirements2<vk::MemoryRequirements2, vk::MemoryDedicatedRequirements>(
+            vk::ImageMemoryRequirementsInfo2().setImage(image));
+        const auto& dedicatedRequirements = requirements.get<vk::MemoryDedicatedRequirements>();
+        const auto dedicatedInfo = vk::MemoryDedicatedAllocateInfo().setImage(image);
+
+        return Allocate(
+            requirements.get<vk::MemoryRequirements2>().memoryRequirements,
+            properties,
+            ResourceKind::Image,
+            category,
+            dedicatedRequirements.prefersDedicatedAllocation || dedicatedRequirements.requiresDedicatedAllocation,
+            &dedicatedInfo);
+    }
+
+    void Allocator::Free(Allocation& allocation) {
+        if (!allocation) {
+            return;
+        }
+
+        std::lock_guard lock(m_mutex);
+        Account(allocation, false);
+        if (allocation.pool == UINT32_MAX) {
+            if (allocation.mapped) {
+                Context::Device()->unmapMemory(allocation.memory);
+            }
+            Context::Device()->freeMemory(allocation.memory);
+            Heap(allocation.memoryTypeIndex).usage -= std::min(Heap(allocation.memoryTypeIndex).usage, allocation.size);
+
+            auto& stats = m_dedicatedStats[allocation.memoryTypeIndex];
+            stats.dedicatedAllocationCount--;
+            stats.dedicatedBytes -= allocation.size;
+            allocation = Allocation {};
+            return;
+        }
+
+        auto& pool = m_pools[allocation.pool];
+        auto& block = *pool.blocks[allocation.block];
+
+        u32 index = allocation.node;
+        block.used -= block.nodes[index].size;
+        block.allocationCount--;
+
+        const auto previous = block.nodes[index].previousPhysical;
+        if (previous != UINT32_MAX && block.nodes[previous].free) {
+            block.RemoveFree(previous);
+            block.nodes[previous].size += block.nodes[index].size;
+            block.nodes[previous].nextPhysical = block.nodes[index].nextPhysical;
+            if (block.nodes[index].nextPhysical != UINT32_MAX) {
+                block.nodes[block.nodes[index].nextPhysical].previousPhysical = previous;
+            }
+            block.unusedNodes.emplace_back(index);
+            index = previous;
+        }
+
+        const auto next = block.nodes[index].nextPhysical;
+        if (next != UINT32_MAX && block.nodes[next].free) {
+            block.RemoveFree(next);
+            block.nodes[index].size += block.nodes[next].size;
+            block.nodes[index].nextPhysical = block.nodes[next].nextPhysical;
+            if (block.nodes[next].nextPhysical != UINT32_MAX) {
+                block.nodes[block.nodes[next].nextPhysical].previousPhysical = index;
+            }
+            block.unusedNodes.emplace_back(next);
+        }
+        block.InsertFree(index);
+
+        // Keep one empty block around so a pool oscillating around a block boundary does not thrash vkAllocateMemory
+        if (block.allocationCount == 0) {
+            const auto otherBlocks = std::ranges::count_if(pool.blocks, [](const auto& other) { return other != nullptr; }) - 1;
+            if (otherBlocks > 0) {
+                auto& heap = Heap(allocation.memoryTypeIndex);
+                heap.usage -= std::min(heap.usage, block.size);
+                DestroyBlock(block);
+                pool.blocks[allocation.block].reset();
+            }
+        }
+        allocation = Allocation {};
+    }
+
+    vk::MappedMemoryRange Allocator::MappedRange(const Allocation& allocation, const vk::DeviceSize offset, vk::DeviceSize size) const {
+        if (size == vk::WholeSize) {
+            size = allocation.size - offset;
+        }
+
+        const auto begin = (allocation.offset + offset) / m_nonCoherentAtomSize * m_nonCoherentAtomSize;
+        auto end = AlignUp(allocation.offset + offset + size, m_nonCoherentAtomSize);
+        if (allocation.pool == UINT32_MAX) {
+            end = std::min(end, AlignUp(allocation.size, m_nonCoherentAtomSize));
+            return vk::MappedMemoryRange()
+                .setMemory(allocation.memory)
+                .setOffset(begin)
+                .setSize(end >= allocation.size ? vk::WholeSize : end - begin);
+        }
+
+        std::lock_guard lock(m_mutex);
+        const auto& block = *m_pools[allocation.pool].blocks[allocation.block];
+        return vk::MappedMemoryRange()
+            .setMemory(allocation.memory)
+            .setOffset(begin)
+            .setSize(end >= block.size ? vk::WholeSize : end - begin);
+    }
+
+    Allocator::Statistics Allocator::Stats() const {
+        Statistics total;
+        for (u32 i = 0; i < m_memoryProperties.memoryTypeCount; i++) {
+            total += Stats(i);
+        }
+        return total;
+    }
+
+    Allocator::Statistics Allocator::Stats(const u32 memoryTypeIndex) const {
+        std::lock_guard lock(m_mutex);
+        Statistics stats = m_dedicatedStats.at(memoryTypeIndex);
+        for (const auto kind : { ResourceKind::Buffer, ResourceKind::Image }) {
+            for (const auto& block : m_pools[memoryTypeIndex * 2 + static_cast<u32>(kind)].blocks) {
+                if (!block) {
+                    continue;
+                }
+                stats.blockCount++;
+                stats.blockBytes += block->size;
+                stats.usedBytes += block->used;
+                stats.allocationCount += block->allocationCount;
+                for (const auto& node : block->nodes) {
+                    if (node.free) {
+                        stats.freeRangeCount++;
+                        stats.largestFreeRange = std::max(stats.largestFreeRange, node.size);
+                    }
+                }
+            }
+        }
+        return stats;
+    }
+
+    void Allocator::PollBudget() {
+        std::lock_guard lock(m_mutex);
+        if (m_budgetExtension) {
+            const auto properties = Core::Runtime::Get().PhysicalDevice()->getMemoryProperties2<
+                vk::PhysicalDeviceMemoryProperties2, vk::PhysicalDeviceMemoryBudgetPropertiesEXT>();
+            const auto& budget = properties.get<vk::PhysicalDeviceMemoryBudgetPropertiesEXT>();
+            for (u32 i = 0; i < m_heaps.size(); i++) {
+                m_heaps[i].budget = budget.heapBudget[i];
+                m_heaps[i].usage = budget.heapUsage[i];
+            }
+        } else {
+            for (auto& heap : m_heaps) {
+                heap.budget = EstimatedBudget(heap.size);
+            }
+        }
+
+        for (u32 i = 0; i < m_heaps.size(); i++) {
+            auto& heap = m_heaps[i];
+            heap.peakUsage = std::max(heap.peakUsage, heap.usage);
+
+            const bool overBudget = static_cast<f64>(heap.usage) > static_cast<f64>(heap.budget) * BudgetWarningRatio;
+            if (overBudget && !m_overBudget[i]) {
+                std::cerr << "Allocator::PollBudget : Heap " << i << " at " << heap.usage / (1024 * 1024) << " of "
+                    << heap.budget / (1024 * 1024) << " MiB budget" << std::endl;
+            }
+            m_overBudget[i] = overBudget;
+        }
+    }
+
+    std::vector<Allocator::HeapBudget> Allocator::HeapBudgets() const {
+        std::lock_guard lock(m_mutex);
+        return m_heaps;
+    }
+
+    std::array<Allocator::CategoryStatistics, CategoryCount> Allocator::CategoryStats() const {
+        std::lock_guard lock(m_mutex);
+        return m_categoryStats;
+    }
+
+    nlohmann::json Allocator::Report() const {
+        auto report = nlohmann::json::object();
+        report["budgetExtension"] = m_budgetExtension;
+
+        auto heaps = nlohmann::json::array();
+        for (const auto& heap : HeapBudgets()) {
+            heaps.push_back({
+                { "deviceLocal", heap.deviceLocal },
+                { "size", heap.size },
+                { "budget", heap.budget },
+                { "usage", heap.usage },
+                { "peakUsage", heap.peakUsage },
+            });
+        }
+        report["heaps"] = heaps;
+
+        const auto categoryStats = CategoryStats();
+        auto categories = nlohmann::json::object();
+        for (u32 i = 0; i < CategoryCount; i++) {
+            categories[CategoryName(static_cast<Category>(i))] = {
+                { "allocationCount", categoryStats[i].allocationCount },
+                { "bytes", categoryStats[i].bytes },
+                { "peakBytes", categoryStats[i].peakBytes },
+            };
+        }
+        report["categories"] = categories;
+
+        const auto stats = Stats();
+        report["totals"] = {
+            { "blockCount", stats.blockCount },
+            { "allocationCount", stats.allocationCount },
+            { "dedicatedAllocationCount", stats.dedicatedAllocationCount },
+            { "blockBytes", stats.blockBytes },
+            { "usedBytes", stats.usedBytes },
+            { "dedicatedBytes", stats.dedicatedBytes },
+            { "freeRangeCount", stats.freeRangeCount },
+            { "largestFreeRange", stats.largestFreeRange },
+        };
+        return report;
+    }
+
+    void Allocator::DumpReport(const std::filesystem::path& path) const {
+        std::ofstream file(path);
+        if (!file) {
+            std::cerr << "Allocator::DumpReport : Failed to open " << path << std::endl;
+            return;
+        }
+        file << Report().dump(4);
+        std::cout << "Memory report written to " << path << std::endl;
+    }
+
+    Allocator::HeapBudget& Allocator::Heap(const u32 memoryTypeIndex) {
+        return m_heaps[m_memoryProperties.memoryTypes[memoryTypeIndex].heapIndex];
+    }
+
+    void Allocator::Account(const Allocation& allocation, const bool allocated) {
+        auto& stats = m_categoryStats[static_cast<u32>(allocation.category)];
+        if (allocated) {
+            stats.allocationCount++;
+            stats.bytes += allocation.size;
+            stats.peakBytes = std::max(stats.peakBytes, stats.bytes);
+        } else {
+            stats.allocationCount--;
+            stats.bytes -= allocation.size;
+        }
+    }
+
+    vk::MemoryPropertyFlags Allocator::Preferred(const u32 typeFilter, const vk::MemoryPropertyFlags required, const vk::MemoryPropertyFlags preferred) const {
+        return FindMemoryType(typeFilter, required | preferred).has_value() ? required | preferred : required;
+    }
+
+    std::optional<u32> Allocator::FindMemoryType(const u32 typeFilter, const vk::MemoryPropertyFlags properties) const {
+        for (u32 i = 0; i < m_memoryProperties.memoryTypeCount; i++) {
+            if (typeFilter & 1 << i &&
+                (m_memoryProperties.memoryTypes[i].propertyFlags & properties) == properties) {
+                return i;
+            }
+        }
+        return std::nullopt;
+    }
+
+    Allocation Allocator::AllocateDedicated(const vk::DeviceSize size, const u32 memoryTypeIndex, const void* dedicatedInfo) {
+        const auto allocateInfo = vk::MemoryAllocateInfo()
+            .setAllocationSize(size)
+            .setMemoryTypeIndex(memoryTypeIndex)
+            .setPNext(dedicatedInfo);
+
+        Allocation allocation;
+        allocation.memory = Context::Device()->allocateMemory(allocateInfo);
+        allocation.size = size;
+        allocation.memoryTypeIndex = memoryTypeIndex;
+        if (IsHostVisible(memoryTypeIndex)) {
+            allocation.mapped = static_cast<std::byte*>(Context::Device()->mapMemory(allocation.memory, 0, vk::WholeSize));
+        }
+
+        auto& stats = m_dedicatedStats[memoryTypeIndex];
+        stats.dedicatedAllocationCount++;
+        stats.dedicatedBytes += size;
+
+        auto& heap = Heap(memoryTypeIndex);
+        heap.usage += size;
+        heap.peakUsage = std::max(heap.peakUsage, heap.usage);
+        return allocation;
+    }
+
+    bool Allocator::AllocateFromBlock(Block& block, vk::DeviceSize size, const vk::DeviceSize alignment, Allocation& allocation) const {
+        const auto index = block.FindFree(size + alignment - 1);
+        if (index == UINT32_MAX) {
+            return false;
+        }
+        block.RemoveFree(index);
+
+        const auto alignedOffset = AlignUp(block.nodes[index].offset, alignment);
+        const auto padding = alignedOffset - block.nodes[index].offset;
+        if (padding >= MinimumNodeSize) {
+            const auto front = block.NewNode();
+            auto& node = block.nodes[index];
+            block.nodes[front] = Node {
+                .offset = node.offset,
+                .size = padding,
+                .previousPhysical = node.previousPhysical,
+                .nextPhysical = index,
+            };
+            if (node.previousPhysical != UINT32_MAX) {
+                block.nodes[node.previousPhysical].nextPhysical = front;
+            }
+            node.previousPhysical = front;
+            block.InsertFree(front);
+        } else if (padding > 0) {
+            // Too small to track, the used neighbour in front absorbs it
+            auto& previous = block.nodes[block.nodes[index].previousPhysical];
+            previous.size += padding;
+            block.used += padding;
+        }
+        block.nodes[index].offset = alignedOffset;
+        block.nodes[index].size -= padding;
+
+        const auto remainder = block.nodes[index].size - size;
+        if (remainder >= MinimumNodeSize) {
+            const auto back = block.NewNode();
+            auto& node = block.nodes[index];
+            block.nodes[back] = Node {
+                .offset = node.offset + size,
+                .size = remainder,
+                .previousPhysical = index,
+                .nextPhysical = node.nextPhysical,
+            };
+            if (node.nextPhysical != UINT32_MAX) {
+                block.nodes[node.nextPhysical].previousPhysical = back;
+            }
+            node.nextPhysical = back;
+            node.size = size;
+            block.InsertFree(back);
+        }
+
+        block.used += block.nodes[index].size;
+        block.allocationCount++;
+
+        allocation.memory = block.memory;
+        allocation.offset = block.nodes[index].offset;
+        allocation.size = size;
+        allocation.mapped = block.mapped ? block.mapped + allocation.offset : nullptr;
+        allocation.node = index;
+        return true;
+    }
+
+    std::unique_ptr<Allocator::Block> Allocator::CreateBlock(const u32 memoryTypeIndex, const vk::DeviceSize size) const {
+        auto block = std::make_unique<Block>();
+        block->memory = Context::Device()->allocateMemory(vk::MemoryAllocateInfo()
+            .setAllocationSize(size)
+            .setMemoryTypeIndex(memoryTypeIndex));
+        block->size = size;
+        if (IsHostVisible(memoryTypeIndex)) {
+            block->mapped = static_cast<std::byte*>(Context::Device()->mapMemory(block->memory, 0, vk::WholeSize));
+        }
+
+        const auto root = block->NewNode();
+        block->nodes[root] = Node { .offset = 0, .size = size };
+        block->InsertFree(root);
+        return block;
+    }
+
+    void Allocator::DestroyBlock(Block& block) const {
+        if (block.mapped) {
+            Context::Device()->unmapMemory(block.memory);
+        }
+        Context::Device()->freeMemory(block.memory);
+        block.memory = nullptr;
+    }
+
+    bool Allocator::IsHostVisible(const u32 memoryTypeIndex) const {
+        return static_cast<bool>(m_memoryProperties.memoryTypes[memoryTypeIndex].propertyFlags & vk::MemoryPropertyFlagBits::eHostVisible);
+    }
+}
@@ -0,0 +1,201 @@
+//
+// Created by radue on 10/17/2026.
+//
+
+#pragma once
+
+#include <array>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+#include <nlohmann/json_fwd.hpp>
+#include <vulkan/vulkan.hpp>
+
+#include "utils/types.h"
+
+namespace Coral::Memory {
+    class Allocator;
+
+    // What the memory is spent on, only used for accounting
+    enum class Category : u8 {
+        Mesh,
+        Texture,
+        Attachment,
+        Staging,
+        Uniform,
+        Other,
+        Count,
+    };
+    inline constexpr u32 CategoryCount = static_cast<u32>(Category::Count);
+
+    [[nodiscard]] const char* CategoryName(Category category);
+
+    struct Allocation {
+        vk::DeviceMemory memory = nullptr;
+        vk::DeviceSize offset = 0;
+        vk::DeviceSize size = 0;
+        // Start of the allocation inside a persistently mapped block, null for device local memory
+        std::byte* mapped = nullptr;
+        u32 memoryTypeIndex = 0;
+        Category category = Category::Other;
+
+        [[nodiscard]] explicit operator bool() const { return static_cast<bool>(memory); }
+
+    private:
+        friend class Allocator;
+        u32 pool = UINT32_MAX;
+        u32 block = UINT32_MAX;
+        u32 node = UINT32_MAX;
+    };
+
+    // Sub-allocates large vkDeviceMemory blocks with a two level segregated fit (TLSF) allocator.
+    // Buffers and optimally tiled images never share a block, which keeps them bufferImageGranularity apart.
+    class Allocator {
+    public:
+        enum class ResourceKind {
+            Buffer,
+            Image,
+        };
+
+        struct CreateInfo {
+            vk::DeviceSize blockSize = 256ull * 1024ull * 1024ull;
+            // Requests at least this big get their own vkDeviceMemory
+            vk::DeviceSize dedicatedThreshold = 64ull * 1024ull * 1024ull;
+        };
+
+        struct Statistics {
+            u64 blockCount = 0;
+            u64 allocationCount = 0;
+            u64 dedicatedAllocationCount = 0;
+            vk::DeviceSize blockBytes = 0;
+            vk::DeviceSize usedBytes = 0;
+            vk::DeviceSize dedicatedBytes = 0;
+            // Free ranges inside blocks, a freed allocation merges into the free ranges next to it
+            u64 freeRangeCount = 0;
+            vk::DeviceSize largestFreeRange = 0;
+
+            Statistics& operator+=(const Statistics& other);
+        };
+
+        struct CategoryStatistics {
+            u64 allocationCount = 0;
+            vk::DeviceSize bytes = 0;
+            vk::DeviceSize peakBytes = 0;
+        };
+
+        struct HeapBudget {
+            vk::DeviceSize size = 0;
+            // How much this process may use before the driver starts paging, estimated without VK_EXT_memory_budget
+            vk::DeviceSize budget = 0;
+            vk::DeviceSize usage = 0;
+            vk::DeviceSize peakUsage = 0;
+            bool deviceLocal = false;
+        };
+
+        explicit Allocator(const CreateInfo& createInfo);
+        ~Allocator();
+
+        Allocator(const Allocator&) = delete;
+        Allocator& operator=(const Allocator&) = delete;
+
+        [[nodiscard]] Allocation Allocate(const vk::MemoryRequirements& requirements, vk::MemoryPropertyFlags properties,
+            ResourceKind kind, Category category = Category::Other, bool dedicated = false, const void* dedicatedInfo = nullptr);
+        [[nodiscard]] Allocation AllocateFor(vk::Buffer buffer, vk::MemoryPropertyFlags properties, Category category = Category::Other);
+        [[nodiscard]] Allocation AllocateFor(vk::Image image, vk::MemoryPropertyFlags properties, Category category = Category::Other);
+        void Free(Allocation& allocation);
+
+        // required | preferred when some memory type allowed by typeFilter has both, required otherwise
+        [[nodiscard]] vk::MemoryPropertyFlags Preferred(u32 typeFilter, vk::MemoryPropertyFlags required, vk::MemoryPropertyFlags preferred) const;
+
+        // Range to flush or invalidate, widened to nonCoherentAtomSize and clamped to the owning memory
+        [[nodiscard]] vk::MappedMemoryRange MappedRange(const Allocation& allocation, vk::DeviceSize offset, vk::DeviceSize size) const;
+
+        [[nodiscard]] Statistics Stats() const;
+        [[nodiscard]] Statistics Stats(u32 memoryTypeIndex) const;
+
+        // Refreshes the heap budgets from the driver and warns about heaps close to theirs, meant to run once per frame
+        void PollBudget();
+        [[nodiscard]] std::vector<HeapBudget> HeapBudgets() const;
+        [[nodiscard]] std::array<CategoryStatistics, CategoryCount> CategoryStats() const;
+        [[nodiscard]] bool HasBudgetExtension() const { return m_budgetExtension; }
+        // Without VK_EXT_memory_budget the usage is only what went through this allocator, 80% of the heap is a common safe guess
+        [[nodiscard]] static constexpr vk::DeviceSize EstimatedBudget(const vk::DeviceSize heapSize) { return heapSize / 10 * 8; }
+
+        [[nodiscard]] nlohmann::json Report() const;
+        void DumpReport(const std::filesystem::path& path) const;
+
+    private:
+        static constexpr u32 SecondLevelBits = 4;
+        static constexpr u32 SecondLevelCount = 1u << SecondLevelBits;
+        static constexpr u32 FirstLevelCount = 64;
+        static constexpr vk::DeviceSize MinimumNodeSize = 16;
+        // Fraction of a heap's budget above which PollBudget warns
+        static constexpr f64 BudgetWarningRatio = 0.9;
+
+        struct Node {
+            vk::DeviceSize offset = 0;
+            vk::DeviceSize size = 0;
+            u32 previousPhysical = UINT32_MAX;
+            u32 nextPhysical = UINT32_MAX;
+            u32 previousFree = UINT32_MAX;
+            u32 nextFree = UINT32_MAX;
+            bool free = false;
+        };
+
+        struct Block {
+            vk::DeviceMemory memory = nullptr;
+            vk::DeviceSize size = 0;
+            vk::DeviceSize used = 0;
+            std::byte* mapped = nullptr;
+            u32 allocationCount = 0;
+
+            std::vector<Node> nodes;
+            std::vector<u32> unusedNodes;
+            u64 firstLevelBitmap = 0;
+            std::array<u32, FirstLevelCount> secondLevelBitmaps {};
+            std::array<std::array<u32, SecondLevelCount>, FirstLevelCount> freeLists {};
+
+            Block();
+            u32 NewNode();
+            void InsertFree(u32 index);
+            void RemoveFree(u32 index);
+            [[nodiscard]] u32 FindFree(vk::DeviceSize size) const;
+        };
+
+        struct Pool {
+            u32 memoryTypeIndex = 0;
+            ResourceKind kind = ResourceKind::Buffer;
+            std::vector<std::unique_ptr<Block>> blocks;
+        };
+
+        static std::pair<u32, u32> Mapping(vk::DeviceSize size);
+
+        [[nodiscard]] std::optional<u32> FindMemoryType(u32 typeFilter, vk::MemoryPropertyFlags properties) const;
+        Allocation AllocateDedicated(vk::DeviceSize size, u32 memoryTypeIndex, const void* dedicatedInfo);
+        bool AllocateFromBlock(Block& block, vk::DeviceSize size, vk::DeviceSize alignment, Allocation& allocation) const;
+        std::unique_ptr<Block> CreateBlock(u32 memoryTypeIndex, vk::DeviceSize size) const;
+        void DestroyBlock(Block& block) const;
+        [[nodiscard]] bool IsHostVisible(u32 memoryTypeIndex) const;
+        [[nodiscard]] HeapBudget& Heap(u32 memoryTypeIndex);
+        void Account(const Allocation& allocation, bool allocated);
+
+        vk::DeviceSize m_blockSize;
+        vk::DeviceSize m_dedicatedThreshold;
+        vk::DeviceSize m_nonCoherentAtomSize = 1;
+        vk::PhysicalDeviceMemoryProperties m_memoryProperties;
+
+        std::vector<Pool> m_pools;
+        std::vector<Statistics> m_dedicatedStats;
+
+        bool m_budgetExtension = false;
+        // Usage is tracked between polls so allocations made within a frame are already counted
+        std::vector<HeapBudget> m_heaps;
+        std::vector<bool> m_overBudget;
+        std::array<CategoryStatistics, CategoryCount> m_categoryStats {};
+
+        mutable std::mutex m_mutex;
+    };
+}
@@ -4,6 +4,10 @@
 
 #include "buffer.h"
 
+#include "allocator.h"
+#include "core/deletionQueue.h"
+#include "uploadManager.h"
+
 Coral::Memory::Buffer::Builder::Builder() { m_name = to_string(boost::uuids::random_generator()()); }
 Coral::Memory::Buffer::Builder::~Builder() = default;
 Coral::Memory::Buffer::Builder& Coral::Memory::Buffer::Builder::InstanceSize(const u32 instanceSize) {
@@ -30,6 +34,20 @@ Coral::Memory::Buffer::Builder& Coral::Memory::Buffer::Builder::DeviceAlignment(
 std::unique_ptr<Coral::Memory::Buffer> Coral::Memory::Buffer::Builder::Build() {
 	return std::make_unique<Buffer>(*this);
 }
+static Coral::Memory::Category InferCategory(const vk::BufferUsageFlags usage, const vk::MemoryPropertyFlags properties) {
+	using Coral::Memory::Category;
+	if (usage & (vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eIndexBuffer)) {
+		return Category::Mesh;
+	}
+	if (usage & (vk::BufferUsageFlagBits::eUniformBuffer | vk::BufferUsageFlagBits::eStorageBuffer)) {
+		return Category::Uniform;
+	}
+	if (usage & vk::BufferUsageFlagBits::eTransferSrc && properties & vk::MemoryPropertyFlagBits::eHostVisible) {
+		return Category::Staging;
+	}
+	return Category::Other;
+}
+
 Coral::Memory::Buffer::Buffer(const Builder& builder) : m_instanceCount(builder.m_instanceCount) {
 	for (const auto& flag : builder.m_usageFlagSet) {
 		m_usageFlags |= flag;
@@ -46,24 +64,15 @@ Coral::Memory::Buffer::Buffer(const Builder& builder) : m_instanceCount(builder.
 
 	m_handle = Context::Device()->createBuffer(bufferInfo);
 
-	const auto memRequirements = Context::Device()->getBufferMemoryRequirements(m_handle);
-	const auto memoryTypeIndex =
-		Context::Device().FindMemoryType(memRequirements.memoryTypeBits, m_memoryPropertyFlags);
-
-	if (!memoryTypeIndex.has_value()) {
-		std::cerr << "Buffer : Failed to find suitable memory type" << std::endl;
-	}
-
-	const auto allocInfo =
-		vk::MemoryAllocateInfo().setAllocationSize(memRequirements.size).setMemoryTypeIndex(memoryTypeIndex.value());
-
-	m_memory = Context::Device()->allocateMemory(allocInfo);
-	Context::Device()->bindBufferMemory(m_handle, m_memory, 0);
+	m_allocation = Context::Allocator().AllocateFor(m_handle, m_memoryPropertyFlags, InferCategory(m_usageFlags, m_memoryPropertyFlags));
+	Context::Device()->bindBufferMemory(m_handle, m_allocation.memory, m_allocation.offset);
 }
 Coral::Memory::Buffer::~Buffer() {
 	Unmap();
-	Context::Device()->destroyBuffer(m_handle);
-	Context::Device()->freeMemory(m_memory);
+	Context::DeletionQueue().Retire([handle = m_handle, allocation = m_allocation]() mutable {
+		Context::Device()->destroyBuffer(handle);
+		Context::Allocator().Free(allocation);
+	});
 }
 
 void Coral::Memory::Buffer::Flush(const vk::DeviceSize instanceCount, const vk::DeviceSize offset) const {
@@ -73,14 +82,11 @@ void Coral::Memory::Buffer::Flush(const vk::DeviceSize instanceCount, const vk::
 	}
 
 	if (instanceCount == vk::WholeSize) {
-		Context::Device()->flushMappedMemoryRanges(m_mappedRange);
+		Context::Device()->flushMappedMemoryRanges(Context::Allocator().MappedRange(m_allocation, m_mappedOffset, m_mappedSize));
 		return;
 	}
 
-	const auto range = vk::MappedMemoryRange()
-						   .setMemory(m_memory)
-						   .setSize(instanceCount * m_alignmentSize)
-						   .setOffset(offset * m_alignmentSize);
+	const auto range = Context::Allocator().MappedRange(m_allocation, offset * m_alignmentSize, instanceCount * m_alignmentSize);
 	Context::Device()->flushMappedMemoryRanges(range);
 }
 vk::DescriptorBufferInfo Coral::Memory::Buffer::DescriptorInfo(vk::DeviceSize instanceCount,
@@ -106,13 +112,10 @@ void Coral::Memory::Buffer::Invalidate(const vk::DeviceSize instanceCount, const
 	}
 
 	if (instanceCount == vk::WholeSize) {
-		Context::Device()->invalidateMappedMemoryRanges(m_mappedRange);
+		Context::Device()->invalidateMappedMemoryRanges(Context::Allocator().MappedRange(m_allocation, m_mappedOffset, m_mappedSize));
 		return;
 	}
-	const auto range = vk::MappedMemoryRange()
-						   .setMemory(m_memory)
-						   .setSize(instanceCount * m_alignmentSize)
-						   .setOffset(offset * m_alignmentSize);
+	const auto range = Context::Allocator().MappedRange(m_allocation, offset * m_alignmentSize, instanceCount * m_alignmentSize);
 	Context::Device()->invalidateMappedMemoryRanges(range);
 }
 
@@ -161,12 +164,8 @@ void Coral::Memory::Buffer::CopyBuffer(const std::unique_ptr<Buffer>& srcBuffer,
 		dstOffset = 0;
 	}
 
-	Context::Device().RunSingleTimeCommand(
-		[this, srcOffset, dstOffset, &srcBuffer, size](const Core::CommandBuffer& commandBuffer) {
-			const auto copyRegion = vk::BufferCopy().setSrcOffset(srcOffset).setDstOffset(dstOffset).setSize(size);
-			commandBuffer->copyBuffer(**srcBuffer, m_handle, 1, &copyRegion);
-		},
-		vk::QueueFlagBits::eTransfer);
+	const auto copyRegion = vk::BufferCopy().setSrcOffset(srcOffset).setDstOffset(dstOffset).setSize(size);
+	Context::UploadManager().CopyBuffer(**srcBuffer, *this, copyRegion);
 }
 uint32_t Coral::Memory::Buffer::InstanceCount() const { return m_instanceCount; }
 vk::DeviceSize Coral::Memory::Buffer::AlignmentSize() const { return m_alignmentSize; }
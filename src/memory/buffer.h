@@ -9,6 +9,7 @@
 #include <iostream>
 #include <vulkan/vulkan.hpp>
 
+#include "allocator.h"
 #include "context.h"
 #include "core/device.h"
 
@@ -56,11 +57,11 @@ namespace Coral::Memory {
 
     	template <typename T>
 		std::span<T> Map(vk::DeviceSize instanceCount = vk::WholeSize, const vk::DeviceSize offset = 0) {
-    		if (!(m_handle && m_memory)) {
+    		if (!(m_handle && m_allocation)) {
     			throw std::runtime_error("Buffer::Map : Buffer or memory not ready");
     		}
 
-    		if (!(m_memoryPropertyFlags & vk::MemoryPropertyFlagBits::eHostVisible)) {
+    		if (!(m_memoryPropertyFlags & vk::MemoryPropertyFlagBits::eHostVisible) || !m_allocation.mapped) {
     			throw std::runtime_error("Buffer::Map : Memory not host visible");
     		}
 
@@ -68,19 +69,15 @@ namespace Coral::Memory {
     			instanceCount *= m_alignmentSize;
     		}
 
-    		m_mapped = static_cast<T*>(
-				Context::Device()->mapMemory(m_memory, offset * m_alignmentSize, instanceCount, vk::MemoryMapFlags()));
-
-    		m_mappedRange =
-				vk::MappedMemoryRange().setMemory(m_memory).setSize(instanceCount).setOffset(offset * m_alignmentSize);
+    		// Host visible allocations stay mapped for their whole lifetime, mapping only hands out a pointer
+    		m_mapped = m_allocation.mapped + offset * m_alignmentSize;
+    		m_mappedOffset = offset * m_alignmentSize;
+    		m_mappedSize = instanceCount;
 
     		return std::span<T>(static_cast<T*>(m_mapped), m_instanceCount);
     	}
     	void Unmap() {
-    		if (m_mapped) {
-    			Context::Device()->unmapMemory(m_memory);
-    			m_mapped = nullptr;
-    		}
+    		m_mapped = nullptr;
     	}
     	template <typename T>
 		std::span<T> Read(vk::DeviceSize instanceCount = vk::WholeSize, vk::DeviceSize offset = 0) const {
@@ -142,6 +139,7 @@ namespace Coral::Memory {
 
 		void InvalidateAt(u32 index) const;
 
+		// Recorded into the open upload batch, the source has to stay alive until it completes (UploadManager::Retain)
 		void CopyBuffer(const std::unique_ptr<Buffer> &srcBuffer, vk::DeviceSize instanceCount = vk::WholeSize, vk::DeviceSize srcOffset = 0, vk::DeviceSize dstOffset = 0) const;
 
 		[[nodiscard]] uint32_t InstanceCount() const;
@@ -152,11 +150,12 @@ namespace Coral::Memory {
 
 
 	private:
-        vk::DeviceMemory m_memory;
+        Allocation m_allocation;
 
         u32 m_instanceCount;
         void* m_mapped = nullptr;
-        vk::MappedMemoryRange m_mappedRange;
+        vk::DeviceSize m_mappedOffset = 0;
+        vk::DeviceSize m_mappedSize = vk::WholeSize;
 
         vk::DeviceSize m_alignmentSize;
         vk::BufferUsageFlags m_usageFlags;
@@ -0,0 +1,80 @@
+//
+// Created by radue on 10/17/2026.
+//
+
+#include "allocator.h"
+
+namespace Coral::Memory::Descriptor {
+    Allocator::Allocator(const CreateInfo &createInfo)
+        : m_descriptorsPerSet(createInfo.descriptorsPerSet), m_nextSetCount(std::max(1u, createInfo.initialSetCount)),
+          m_maxSetCount(std::max(m_nextSetCount, createInfo.maxSetCount)), m_transient(createInfo.transient) {}
+
+    Allocator::Allocation Allocator::Allocate(const SetLayout &layout) {
+        std::lock_guard lock(m_mutex);
+
+        if (m_current == UINT32_MAX) {
+            m_current = AcquirePool();
+        }
+        if (const auto set = m_pools[m_current].pool->TryAllocate(layout)) {
+            m_pools[m_current].liveSets++;
+            return { *set, m_current };
+        }
+
+        // The full pool leaves the rotation until all of its sets are freed
+        m_current = AcquirePool();
+        if (const auto set = m_pools[m_current].pool->TryAllocate(layout)) {
+            m_pools[m_current].liveSets++;
+            return { *set, m_current };
+        }
+        throw std::runtime_error("Descriptor::Allocator::Allocate : Layout does not fit into an empty pool");
+    }
+
+    void Allocator::Free(const Allocation &allocation) {
+        if (m_transient) {
+            throw std::runtime_error("Descriptor::Allocator::Free : Transient sets are released by Reset");
+        }
+
+        std::lock_guard lock(m_mutex);
+        auto& [pool, liveSets] = m_pools.at(allocation.pool);
+        pool->Free(allocation.set);
+        if (--liveSets == 0 && allocation.pool != m_current) {
+            pool->Reset();
+            m_freePools.emplace_back(allocation.pool);
+        }
+    }
+
+    void Allocator::Reset() {
+        if (!m_transient) {
+            throw std::runtime_error("Descriptor::Allocator::Reset : Only transient allocators can be reset");
+        }
+
+        std::lock_guard lock(m_mutex);
+        m_freePools.clear();
+        for (u32 i = 0; i < m_pools.size(); i++) {
+            m_pools[i].pool->Reset();
+            m_pools[i].liveSets = 0;
+            m_freePools.emplace_back(i);
+        }
+        m_current = UINT32_MAX;
+    }
+
+    u32 Allocator::AcquirePool() {
+        if (!m_freePools.empty()) {
+            const auto index = m_freePools.back();
+            m_freePools.pop_back();
+            return index;
+        }
+
+        auto builder = Pool::Builder().MaxSets(m_nextSetCount);
+        for (const auto& poolSize : m_descriptorsPerSet) {
+            builder.AddPoolSize(poolSize.type, poolSize.descriptorCount * m_nextSetCount);
+        }
+        if (!m_transient) {
+            builder.PoolFlags(vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet);
+        }
+        m_nextSetCount = std::min(m_nextSetCount * 2, m_maxSetCount);
+
+        m_pools.emplace_back(PoolEntry { .pool = builder.Build() });
+        return static_cast<u32>(m_pools.size() - 1);
+    }
+}
@@ -0,0 +1,70 @@
+//
+// Created by radue on 10/17/2026.
+//
+
+#pragma once
+
+#include <mutex>
+#include <vector>
+
+#include "pool.h"
+
+namespace Coral::Memory::Descriptor {
+    // Hands out descriptor sets from a growing list of pools. A full pool is swapped for a recycled or a new,
+    // larger one instead of failing, and pools whose sets were all freed are reset and reused as a whole.
+    class Allocator {
+    public:
+        struct CreateInfo {
+            // Descriptors reserved per set, multiplied by the set count of each pool
+            std::vector<vk::DescriptorPoolSize> descriptorsPerSet = {
+                { vk::DescriptorType::eUniformBuffer, 2 },
+                { vk::DescriptorType::eUniformBufferDynamic, 1 },
+                { vk::DescriptorType::eStorageBuffer, 2 },
+                { vk::DescriptorType::eCombinedImageSampler, 8 },
+                { vk::DescriptorType::eStorageImage, 1 },
+            };
+            u32 initialSetCount = 64;
+            // Every new pool doubles the set count up to this limit
+            u32 maxSetCount = 4096;
+            // Transient sets cannot be freed one by one, they all go away with Reset
+            bool transient = false;
+        };
+
+        struct Allocation {
+            vk::DescriptorSet set = nullptr;
+            u32 pool = UINT32_MAX;
+        };
+
+        explicit Allocator(const CreateInfo &createInfo);
+        Allocator(const Allocator &) = delete;
+        Allocator &operator=(const Allocator &) = delete;
+
+        [[nodiscard]] Allocation Allocate(const SetLayout &layout);
+        void Free(const Allocation &allocation);
+        // Only for transient allocators, the caller guarantees the GPU is done with every set
+        void Reset();
+
+        [[nodiscard]] bool IsTransient() const { return m_transient; }
+        [[nodiscard]] u32 PoolCount() const { return static_cast<u32>(m_pools.size()); }
+
+    private:
+        struct PoolEntry {
+            std::unique_ptr<Pool> pool;
+            u32 liveSets = 0;
+        };
+
+        u32 AcquirePool();
+
+        std::vector<vk::DescriptorPoolSize> m_descriptorsPerSet;
+        u32 m_nextSetCount;
+        u32 m_maxSetCount;
+        bool m_transient;
+
+        std::vector<PoolEntry> m_pools;
+        // Empty pools ready to become the current one
+        std::vector<u32> m_freePools;
+        u32 m_current = UINT32_MAX;
+
+        std::mutex m_mutex;
+    };
+}
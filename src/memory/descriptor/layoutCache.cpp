@@ -0,0 +1,169 @@
+//
+// Created by radue on 10/17/2026.
+//
+
+#include "layoutCache.h"
+
+#include <algorithm>
+#include <iostream>
+#include <ranges>
+#include <tuple>
+
+#include "context.h"
+#include "core/deletionQueue.h"
+
+namespace Coral::Memory::Descriptor {
+    static void HashCombine(std::size_t &seed, const std::size_t value) {
+        seed ^= value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2);
+    }
+
+    PipelineLayout::PipelineLayout(std::vector<std::shared_ptr<const SetLayout>> setLayouts, const std::vector<vk::PushConstantRange> &pushConstantRanges)
+        : m_setLayouts(std::move(setLayouts)), m_pushConstantRanges(pushConstantRanges)
+    {
+        const auto handles = m_setLayouts
+            | std::views::transform([](const auto &layout) { return **layout; })
+            | std::ranges::to<std::vector<vk::DescriptorSetLayout>>();
+
+        const auto pipelineLayoutInfo = vk::PipelineLayoutCreateInfo()
+            .setSetLayouts(handles)
+            .setPushConstantRanges(pushConstantRanges);
+
+        m_handle = Context::Device()->createPipelineLayout(pipelineLayoutInfo);
+    }
+
+    PipelineLayout::~PipelineLayout() {
+        Context::DeletionQueue().Retire([handle = m_handle] { Context::Device()->destroyPipelineLayout(handle); });
+    }
+
+    std::size_t LayoutCache::KeyHash::operator()(const SetLayoutKey &key) const {
+        std::size_t seed = key.bindings.size();
+        for (const auto &binding : key.bindings) {
+            HashCombine(seed, binding.binding);
+            HashCombine(seed, static_cast<std::size_t>(binding.descriptorType));
+            HashCombine(seed, binding.descriptorCount);
+            HashCombine(seed, static_cast<vk::ShaderStageFlags::MaskType>(binding.stageFlags));
+        }
+        for (const auto &flags : key.bindingFlags) {
+            HashCombine(seed, static_cast<vk::DescriptorBindingFlags::MaskType>(flags));
+        }
+        HashCombine(seed, static_cast<vk::DescriptorSetLayoutCreateFlags::MaskType>(key.flags));
+        return seed;
+    }
+
+    std::size_t LayoutCache::KeyHash::operator()(const PipelineLayoutKey &key) const {
+        std::size_t seed = key.setLayouts.size();
+        for (const auto &setLayout : key.setLayouts) {
+            HashCombine(seed, std::hash<VkDescriptorSetLayout>{}(static_cast<VkDescriptorSetLayout>(setLayout)));
+        }
+        for (const auto &range : key.pushConstantRanges) {
+            HashCombine(seed, range.offset);
+            HashCombine(seed, range.size);
+            HashCombine(seed, static_cast<vk::ShaderStageFlags::MaskType>(range.stageFlags));
+        }
+        return seed;
+    }
+
+    LayoutCache::LayoutCache() {
+        static bool firstTime = true;
+        if (!firstTime) {
+            throw std::runtime_error("LayoutCache already created!");
+        }
+        firstTime = false;
+        Context::m_layoutCache = this;
+    }
+
+    LayoutCache::~LayoutCache() {
+        if (!m_setLayouts.empty() || !m_pipelineLayouts.empty()) {
+            std::cerr << "LayoutCache : " << m_setLayouts.size() << " set layouts and " << m_pipelineLayouts.size()
+                << " pipeline layouts outlive the cache" << std::endl;
+        }
+        Context::m_layoutCache = nullptr;
+    }
+
+    std::shared_ptr<const SetLayout> LayoutCache::AcquireSetLayout(const SetLayout::Builder &builder) {
+        SetLayoutKey key;
+        for (const auto &binding : builder.Bindings() | std::views::values) {
+            key.bindings.emplace_back(binding);
+        }
+        std::ranges::sort(key.bindings, {}, &vk::DescriptorSetLayoutBinding::binding);
+        for (const auto &binding : key.bindings) {
+            key.bindingFlags.emplace_back(builder.BindingFlagsOf(binding.binding));
+        }
+        key.flags = builder.CreateFlags();
+
+        std::lock_guard lock(m_mutex);
+        auto &entry = m_setLayouts[key];
+        if (auto layout = entry.lock()) {
+            return layout;
+        }
+
+        auto layout = std::shared_ptr<const SetLayout>(new SetLayout(builder), [this, key](const SetLayout *setLayout) {
+            {
+                std::lock_guard deleterLock(m_mutex);
+                // A new layout may already have taken the slot
+                if (const auto it = m_setLayouts.find(key); it != m_setLayouts.end() && it->second.expired()) {
+                    m_setLayouts.erase(it);
+                }
+            }
+            delete setLayout;
+        });
+        entry = layout;
+        return layout;
+    }
+
+    std::shared_ptr<const PipelineLayout> LayoutCache::AcquirePipelineLayout(
+        const std::vector<SetLayout::Builder> &setLayouts, std::vector<vk::PushConstantRange> pushConstantRanges)
+    {
+        std::vector<std::shared_ptr<const SetLayout>> acquired;
+        acquired.reserve(setLayouts.size());
+        for (const auto &builder : setLayouts) {
+            acquired.emplace_back(AcquireSetLayout(builder));
+        }
+        return AcquirePipelineLayout(std::move(acquired), std::move(pushConstantRanges));
+    }
+
+    std::shared_ptr<const PipelineLayout> LayoutCache::AcquirePipelineLayout(
+        std::vector<std::shared_ptr<const SetLayout>> setLayouts, std::vector<vk::PushConstantRange> pushConstantRanges)
+    {
+        std::ranges::sort(pushConstantRanges, [](const vk::PushConstantRange &a, const vk::PushConstantRange &b) {
+            return std::tie(a.offset, a.size) < std::tie(b.offset, b.size);
+        });
+
+        PipelineLayoutKey key {
+            .setLayouts = setLayouts
+                | std::views::transform([](const auto &layout) { return **layout; })
+                | std::ranges::to<std::vector<vk::DescriptorSetLayout>>(),
+            .pushConstantRanges = pushConstantRanges,
+        };
+
+        // setLayouts outlives the lock, dropping the last reference inside it would deadlock in the deleter
+        std::lock_guard lock(m_mutex);
+        auto &entry = m_pipelineLayouts[key];
+        if (auto layout = entry.lock()) {
+            return layout;
+        }
+
+        auto layout = std::shared_ptr<const PipelineLayout>(new PipelineLayout(setLayouts, pushConstantRanges),
+            [this, key](const PipelineLayout *pipelineLayout) {
+                {
+                    std::lock_guard deleterLock(m_mutex);
+                    if (const auto it = m_pipelineLayouts.find(key); it != m_pipelineLayouts.end() && it->second.expired()) {
+                        m_pipelineLayouts.erase(it);
+                    }
+                }
+                delete pipelineLayout;
+            });
+        entry = layout;
+        return layout;
+    }
+
+    u32 LayoutCache::SetLayoutCount() const {
+        std::lock_guard lock(m_mutex);
+        return static_cast<u32>(m_setLayouts.size());
+    }
+
+    u32 LayoutCache::PipelineLayoutCount() const {
+        std::lock_guard lock(m_mutex);
+        return static_cast<u32>(m_pipelineLayouts.size());
+    }
+}
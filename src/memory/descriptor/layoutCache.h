@@ -0,0 +1,75 @@
+//
+// Created by radue on 10/17/2026.
+//
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include "setLayout.h"
+
+namespace Coral::Memory::Descriptor {
+    // Keeps the set layouts it was created with alive
+    class PipelineLayout final : public EngineWrapper<vk::PipelineLayout> {
+    public:
+        PipelineLayout(std::vector<std::shared_ptr<const SetLayout>> setLayouts, const std::vector<vk::PushConstantRange> &pushConstantRanges);
+        ~PipelineLayout() override;
+        PipelineLayout(const PipelineLayout &) = delete;
+        PipelineLayout &operator=(const PipelineLayout &) = delete;
+
+        [[nodiscard]] const std::vector<std::shared_ptr<const SetLayout>> &SetLayouts() const { return m_setLayouts; }
+        [[nodiscard]] const std::vector<vk::PushConstantRange> &PushConstantRanges() const { return m_pushConstantRanges; }
+
+    private:
+        std::vector<std::shared_ptr<const SetLayout>> m_setLayouts;
+        std::vector<vk::PushConstantRange> m_pushConstantRanges;
+    };
+
+    // Deduplicates layouts by their canonical description, so identical layouts share one handle.
+    // Entries are ref-counted and destroyed as soon as the last user releases them.
+    class LayoutCache {
+    public:
+        LayoutCache();
+        ~LayoutCache();
+        LayoutCache(const LayoutCache &) = delete;
+        LayoutCache &operator=(const LayoutCache &) = delete;
+
+        [[nodiscard]] std::shared_ptr<const SetLayout> AcquireSetLayout(const SetLayout::Builder &builder);
+        [[nodiscard]] std::shared_ptr<const PipelineLayout> AcquirePipelineLayout(
+            const std::vector<SetLayout::Builder> &setLayouts, std::vector<vk::PushConstantRange> pushConstantRanges);
+        [[nodiscard]] std::shared_ptr<const PipelineLayout> AcquirePipelineLayout(
+            std::vector<std::shared_ptr<const SetLayout>> setLayouts, std::vector<vk::PushConstantRange> pushConstantRanges);
+
+        [[nodiscard]] u32 SetLayoutCount() const;
+        [[nodiscard]] u32 PipelineLayoutCount() const;
+
+    private:
+        struct SetLayoutKey {
+            // Sorted by binding, flags in the same order
+            std::vector<vk::DescriptorSetLayoutBinding> bindings;
+            std::vector<vk::DescriptorBindingFlags> bindingFlags;
+            vk::DescriptorSetLayoutCreateFlags flags;
+            bool operator==(const SetLayoutKey &) const = default;
+        };
+
+        struct PipelineLayoutKey {
+            std::vector<vk::DescriptorSetLayout> setLayouts;
+            // Sorted by offset, then size
+            std::vector<vk::PushConstantRange> pushConstantRanges;
+            bool operator==(const PipelineLayoutKey &) const = default;
+        };
+
+        struct KeyHash {
+            std::size_t operator()(const SetLayoutKey &key) const;
+            std::size_t operator()(const PipelineLayoutKey &key) const;
+        };
+
+        // Layouts are only ever released outside the lock, their deleters take it again
+        mutable std::mutex m_mutex;
+        std::unordered_map<SetLayoutKey, std::weak_ptr<const SetLayout>, KeyHash> m_setLayouts;
+        std::unordered_map<PipelineLayoutKey, std::weak_ptr<const PipelineLayout>, KeyHash> m_pipelineLayouts;
+    };
+}
@@ -52,6 +52,24 @@ namespace Coral::Memory::Descriptor {
         return Context::Device()->allocateDescriptorSets(allocateInfo).front();
     }
 
+    std::optional<vk::DescriptorSet> Pool::TryAllocate(const SetLayout &layout) const {
+        const auto layoutHandle = *layout;
+        const auto allocateInfo = vk::DescriptorSetAllocateInfo()
+            .setDescriptorPool(m_pool)
+            .setSetLayouts({layoutHandle});
+
+        vk::DescriptorSet descriptorSet;
+        switch (const auto result = Context::Device()->allocateDescriptorSets(&allocateInfo, &descriptorSet)) {
+            case vk::Result::eSuccess:
+                return descriptorSet;
+            case vk::Result::eErrorOutOfPoolMemory:
+            case vk::Result::eErrorFragmentedPool:
+                return std::nullopt;
+            default:
+                throw std::runtime_error("Pool::TryAllocate : Failed to allocate descriptor set: " + vk::to_string(result));
+        }
+    }
+
     std::vector<vk::DescriptorSet> Pool::Allocate(const std::vector<SetLayout> &layouts) const {
         auto layoutHandles = std::vector<vk::DescriptorSetLayout>();
         for (const auto &layout: layouts) {
@@ -6,6 +6,7 @@
 
 #include "setLayout.h"
 
+#include <optional>
 #include <vector>
 
 #include "context.h"
@@ -36,6 +37,8 @@ namespace Coral::Memory::Descriptor {
 
         [[nodiscard]] vk::DescriptorSet Allocate(const SetLayout &layout) const;
         [[nodiscard]] std::vector<vk::DescriptorSet> Allocate(const std::vector<SetLayout> &layouts) const;
+        // Empty when the pool ran out of memory or is too fragmented, other failures throw
+        [[nodiscard]] std::optional<vk::DescriptorSet> TryAllocate(const SetLayout &layout) const;
 
         void Free(const vk::DescriptorSet &descriptorSet) const;
         void Free(const std::vector<vk::DescriptorSet> &descriptorSets) const;
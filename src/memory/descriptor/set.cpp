@@ -6,6 +6,9 @@
 
 #include <iostream>
 
+#include "context.h"
+#include "core/deletionQueue.h"
+
 namespace Coral::Memory::Descriptor {
     Set::Builder & Set::Builder::WriteBuffer(const uint32_t binding, const vk::DescriptorBufferInfo &bufferInfo) {
         if (!m_layout.HasBinding(binding)) {
@@ -50,8 +53,9 @@ namespace Coral::Memory::Descriptor {
     }
 
 
-    Set::Set(Builder &builder) : m_pool{builder.m_pool}, m_layout{builder.m_layout} {
-        m_handle = m_pool.Allocate(m_layout);
+    Set::Set(Builder &builder) : m_allocator{builder.m_allocator}, m_layout{builder.m_layout} {
+        m_allocation = m_allocator.Allocate(m_layout);
+        m_handle = m_allocation.set;
         for (auto &write: builder.m_writes) {
             write.setDstSet(m_handle);
         }
@@ -59,7 +63,10 @@ namespace Coral::Memory::Descriptor {
     }
 
     Set::~Set() {
-        Context::Device()->waitIdle();
-        m_pool.Free(m_handle);
+        // Transient sets are released together when their allocator is reset
+        if (m_allocator.IsTransient()) {
+            return;
+        }
+        Context::DeletionQueue().Retire([allocator = &m_allocator, allocation = m_allocation] { allocator->Free(allocation); });
     }
 }
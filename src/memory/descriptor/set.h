@@ -4,7 +4,7 @@
 
 #pragma once
 
-#include "pool.h"
+#include "allocator.h"
 #include "setLayout.h"
 
 namespace Coral::Memory::Descriptor {
@@ -15,7 +15,7 @@ namespace Coral::Memory::Descriptor {
         class Builder {
             friend class Set;
         public:
-            explicit Builder(const Pool &pool, const SetLayout &layout) : m_pool{pool}, m_layout{layout} {}
+            explicit Builder(Allocator &allocator, const SetLayout &layout) : m_allocator{allocator}, m_layout{layout} {}
 
             Builder &WriteBuffer(uint32_t binding, const vk::DescriptorBufferInfo& bufferInfo);
             Builder &WriteImage(uint32_t binding, const vk::DescriptorImageInfo& imageInfo);
@@ -23,7 +23,7 @@ namespace Coral::Memory::Descriptor {
             [[nodiscard]] std::unique_ptr<Set> Build();
 
         private:
-            const Pool &m_pool;
+            Allocator &m_allocator;
             const SetLayout &m_layout;
             std::vector<vk::WriteDescriptorSet> m_writes = {};
         };
@@ -34,7 +34,8 @@ namespace Coral::Memory::Descriptor {
         Set &operator=(const Set &) = delete;
 
     private:
-        const Pool &m_pool;
+        Allocator &m_allocator;
+        Allocator::Allocation m_allocation;
         const SetLayout &m_layout;
     };
 }
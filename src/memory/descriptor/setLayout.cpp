@@ -8,6 +8,7 @@
 #include <ranges>
 
 #include "context.h"
+#include "core/deletionQueue.h"
 
 namespace Coral::Memory::Descriptor {
     SetLayout::Builder & SetLayout::Builder::AddBinding(
@@ -29,6 +30,16 @@ namespace Coral::Memory::Descriptor {
         return *this;
     }
 
+    SetLayout::Builder & SetLayout::Builder::BindingFlags(const uint32_t binding, const vk::DescriptorBindingFlags flags) {
+        m_bindingFlags[binding] = flags;
+        return *this;
+    }
+
+    SetLayout::Builder & SetLayout::Builder::Flags(const vk::DescriptorSetLayoutCreateFlags flags) {
+        m_flags = flags;
+        return *this;
+    }
+
     bool SetLayout::Builder::HasBinding(const uint32_t binding) const {
         return m_bindings.contains(binding);
     }
@@ -43,18 +54,27 @@ namespace Coral::Memory::Descriptor {
 
     SetLayout::SetLayout(const Builder &builder) {
         std::vector<vk::DescriptorSetLayoutBinding> bindings;
+        std::vector<vk::DescriptorBindingFlags> bindingFlags;
         for (const auto &binding: builder.m_bindings | std::views::values) {
             bindings.emplace_back(binding);
+            bindingFlags.emplace_back(builder.BindingFlagsOf(binding.binding));
         }
 
-        const auto layoutCreateInfo = vk::DescriptorSetLayoutCreateInfo()
-            .setBindings(bindings);
+        const auto bindingFlagsCreateInfo = vk::DescriptorSetLayoutBindingFlagsCreateInfo()
+            .setBindingFlags(bindingFlags);
+
+        auto layoutCreateInfo = vk::DescriptorSetLayoutCreateInfo()
+            .setBindings(bindings)
+            .setFlags(builder.m_flags);
+        if (!builder.m_bindingFlags.empty()) {
+            layoutCreateInfo.setPNext(&bindingFlagsCreateInfo);
+        }
 
         m_handle = Context::Device()->createDescriptorSetLayout(layoutCreateInfo);
         m_bindings = builder.m_bindings;
     }
 
     SetLayout::~SetLayout() {
-        Context::Device()->destroyDescriptorSetLayout(m_handle);
+        Context::DeletionQueue().Retire([handle = m_handle] { Context::Device()->destroyDescriptorSetLayout(handle); });
     }
 }
@@ -13,13 +13,23 @@ namespace Coral::Memory::Descriptor {
             friend class SetLayout;
         public:
             Builder &AddBinding(uint32_t binding, vk::DescriptorType type, vk::ShaderStageFlags stageFlags, uint32_t count = 1);
+            Builder &BindingFlags(uint32_t binding, vk::DescriptorBindingFlags flags);
+            Builder &Flags(vk::DescriptorSetLayoutCreateFlags flags);
 
             [[nodiscard]] bool HasBinding(uint32_t binding) const;
             [[nodiscard]] vk::DescriptorSetLayoutBinding &Binding(uint32_t binding);
+            [[nodiscard]] const std::unordered_map<uint32_t, vk::DescriptorSetLayoutBinding> &Bindings() const { return m_bindings; }
+            [[nodiscard]] vk::DescriptorBindingFlags BindingFlagsOf(const uint32_t binding) const {
+                const auto it = m_bindingFlags.find(binding);
+                return it != m_bindingFlags.end() ? it->second : vk::DescriptorBindingFlags {};
+            }
+            [[nodiscard]] vk::DescriptorSetLayoutCreateFlags CreateFlags() const { return m_flags; }
             [[nodiscard]] std::unique_ptr<SetLayout> Build() const;
 
         private:
             std::unordered_map<uint32_t, vk::DescriptorSetLayoutBinding> m_bindings;
+            std::unordered_map<uint32_t, vk::DescriptorBindingFlags> m_bindingFlags;
+            vk::DescriptorSetLayoutCreateFlags m_flags = {};
         };
 
         explicit SetLayout(const Builder &builder);
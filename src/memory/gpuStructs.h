@@ -45,5 +45,12 @@ namespace Coral::GPU {
 		float metallicFactor;
 		alignas(16) glm::vec3 emissiveFactor;
 		alignas(16) glm::vec4 baseColorFactor;
+		// Bindless texture table slots, UINT32_MAX when the material has no texture of that kind
+		uint32_t albedoTexture;
+		uint32_t normalTexture;
+		uint32_t metallicTexture;
+		uint32_t roughnessTexture;
+		uint32_t emissiveTexture;
+		uint32_t ambientOcclusionTexture;
 	};
 }
\ No newline at end of file
@@ -7,51 +7,38 @@
 #include <iostream>
 #include <thread>
 
+#include "allocator.h"
 #include "context.h"
+#include "core/deletionQueue.h"
 #include "core/device.h"
 #include "math/vector.h"
+#include "uploadManager.h"
 
 namespace Coral::Memory {
+    static Category InferCategory(const vk::ImageUsageFlags usage) {
+        if (usage & (vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eDepthStencilAttachment | vk::ImageUsageFlagBits::eTransientAttachment)) {
+            return Category::Attachment;
+        }
+        if (usage & vk::ImageUsageFlagBits::eSampled) {
+            return Category::Texture;
+        }
+        return Category::Other;
+    }
+
     Image::Image(const Builder &builder)
         : m_format(builder.m_format), m_extent(builder.m_extent),m_sampleCount(builder.m_sampleCount),
-            m_mipLevels(builder.m_mipLevels), m_layerCount(builder.m_layersCount) {
+            m_mipLevels(builder.m_mipLevels), m_layerCount(builder.m_layersCount), m_aliased(builder.m_aliased) {
 
     	for (const auto& usageFlag : builder.m_usageFlagsSet) {
 			m_usageFlags |= usageFlag;
 		}
 
         if (!builder.m_image.has_value()) {
-            const vk::ImageCreateFlags imageCreateFlags = builder.m_layersCount == 6 ? vk::ImageCreateFlagBits::eCubeCompatible : vk::ImageCreateFlags();
-            const auto imageCreateInfo = vk::ImageCreateInfo()
-                .setImageType(vk::ImageType::e2D)
-                .setFormat(builder.m_format)
-                .setExtent(vk::Extent3D()
-					.setWidth(builder.m_extent.x)
-					.setHeight(builder.m_extent.y)
-					.setDepth(builder.m_extent.z))
-                .setMipLevels(builder.m_mipLevels)
-                .setArrayLayers(builder.m_layersCount)
-                .setSamples(builder.m_sampleCount)
-                .setTiling(vk::ImageTiling::eOptimal)
-                .setUsage(m_usageFlags)
-                .setSharingMode(vk::SharingMode::eExclusive)
-                .setInitialLayout(vk::ImageLayout::eUndefined)
-                .setFlags(imageCreateFlags);
-
-            m_handle = Context::Device()->createImage(imageCreateInfo);
-
-            const vk::MemoryRequirements memoryRequirements = Context::Device()->getImageMemoryRequirements(m_handle);
-            const auto memoryTypeIndex = Context::Device().FindMemoryType(memoryRequirements.memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal);
-            if (!memoryTypeIndex.has_value()) {
-                std::cerr << "Image : Failed to find suitable memory type" << std::endl;
+            CreateHandle();
+            if (!m_aliased) {
+                m_allocation = Context::Allocator().AllocateFor(m_handle, MemoryProperties(), InferCategory(m_usageFlags));
+                Context::Device()->bindImageMemory(m_handle, m_allocation.memory, m_allocation.offset);
             }
-
-            const auto allocInfo = vk::MemoryAllocateInfo()
-                .setAllocationSize(memoryRequirements.size)
-                .setMemoryTypeIndex(memoryTypeIndex.value());
-
-            m_imageMemory = Context::Device()->allocateMemory(allocInfo);
-            Context::Device()->bindImageMemory(m_handle, m_imageMemory, 0);
         } else {
             m_handle = builder.m_image.value();
         }
@@ -62,13 +49,91 @@ namespace Coral::Memory {
     }
 
     Image::~Image() {
-        if (m_imageMemory) {
-            Context::Device()->freeMemory(m_imageMemory);
-            Context::Device()->destroyImage(m_handle);
+        m_views.clear();
+        if (m_allocation || m_aliased) {
+            Context::DeletionQueue().Retire([handle = m_handle, allocation = m_allocation]() mutable {
+                Context::Device()->destroyImage(handle);
+                Context::Allocator().Free(allocation);
+            });
+        }
+    }
+
+    void Image::CreateHandle() {
+        const auto imageCreateInfo = vk::ImageCreateInfo()
+            .setImageType(vk::ImageType::e2D)
+            .setFormat(m_format)
+            .setExtent(vk::Extent3D()
+				.setWidth(m_extent.x)
+				.setHeight(m_extent.y)
+				.setDepth(m_extent.z))
+            .setMipLevels(m_mipLevels)
+            .setArrayLayers(m_layerCount)
+            .setSamples(m_sampleCount)
+            .setTiling(vk::ImageTiling::eOptimal)
+            .setUsage(m_usageFlags)
+            .setSharingMode(vk::SharingMode::eExclusive)
+            .setInitialLayout(vk::ImageLayout::eUndefined)
+            .setFlags(m_layerCount == 6 ? vk::ImageCreateFlagBits::eCubeCompatible : vk::ImageCreateFlags());
+        m_handle = Context::Device()->createImage(imageCreateInfo);
+    }
+
+    void Image::Recreate(const Math::Vector3<u32>& extent) {
+        // Every cached view points at the old handle, callers re-acquire theirs after the resize
+        {
+            std::lock_guard lock(m_viewMutex);
+            m_views.clear();
+        }
+        Context::DeletionQueue().Retire([handle = m_handle] { Context::Device()->destroyImage(handle); });
+
+        m_extent = extent;
+        CreateHandle();
+    }
+
+    vk::MemoryPropertyFlags Image::MemoryProperties() const {
+        if (!(m_usageFlags & vk::ImageUsageFlagBits::eTransientAttachment)) {
+            return vk::MemoryPropertyFlagBits::eDeviceLocal;
+        }
+        const auto requirements = Context::Device()->getImageMemoryRequirements(m_handle);
+        return Context::Allocator().Preferred(requirements.memoryTypeBits,
+            vk::MemoryPropertyFlagBits::eDeviceLocal, vk::MemoryPropertyFlagBits::eLazilyAllocated);
+    }
+
+    Math::Vector3<u32> Image::MipExtent(const uint32_t mipLevel) const {
+        auto extent = m_extent;
+        for (uint32_t i = 0; i < mipLevel; i++) {
+            extent.width = std::max<uint32_t>(1u, extent.width / 2);
+            extent.height = std::max<uint32_t>(1u, extent.height / 2);
+            extent.depth = std::max<uint32_t>(1u, extent.depth / 2);
         }
+        return extent;
     }
 
-    void Image::Copy(const vk::Buffer &buffer, const uint32_t mipLevel, const uint32_t layer) const {
+    const ImageView& Image::View(const ImageView::Description& description) const {
+        if (description.baseMipLevel + description.levelCount > m_mipLevels) {
+            throw std::runtime_error("Image::View : Mip range out of bounds");
+        }
+        if (description.baseArrayLayer + description.layerCount > m_layerCount) {
+            throw std::runtime_error("Image::View : Layer range out of bounds");
+        }
+
+        auto builder = ImageView::Builder(*this);
+        builder.m_description = description;
+
+        // Keyed on the resolved description so defaulted and explicit formats share a view
+        std::lock_guard lock(m_viewMutex);
+        auto& view = m_views[builder.Resolved()];
+        if (!view) {
+            view = builder.Build();
+        }
+        return *view;
+    }
+
+    u32 Image::ViewCount() const {
+        std::lock_guard lock(m_viewMutex);
+        return static_cast<u32>(m_views.size());
+    }
+
+    void Image::Copy(const vk::Buffer &buffer, const uint32_t mipLevel, const uint32_t layer, const vk::DeviceSize bufferOffset) const {
         if (!(m_usageFlags & vk::ImageUsageFlagBits::eTransferDst)) {
             throw std::runtime_error("Image : Image must have transfer destination usage flag");
         }
@@ -79,30 +144,22 @@ namespace Coral::Memory {
             throw std::runtime_error("Image : Layer out of range");
         }
 
-        Context::Device().RunSingleTimeCommand([this, buffer, layer, mipLevel] (const Core::CommandBuffer& commandBuffer) {
-            auto extent = m_extent;
-            for (uint32_t i = 0; i < mipLevel; i++) {
-                extent.width = std::max<uint32_t>(1u, extent.width / 2);
-                extent.height = std::max<uint32_t>(1u, extent.height / 2);
-                extent.depth = std::max<uint32_t>(1u, extent.depth / 2);
-            }
-
-            const auto region = vk::BufferImageCopy()
-                .setBufferOffset(0)
-                .setBufferRowLength(0)
-                .setBufferImageHeight(0)
-                .setImageSubresource(vk::ImageSubresourceLayers()
-                    .setAspectMask(vk::ImageAspectFlagBits::eColor)
-                    .setMipLevel(mipLevel)
-                    .setBaseArrayLayer(layer)
-                    .setLayerCount(1))
-                .setImageOffset({ 0, 0, 0 })
-                .setImageExtent(vk::Extent3D()
-					.setWidth(extent.x)
-					.setHeight(extent.y)
-					.setDepth(extent.z));
-            commandBuffer->copyBufferToImage(buffer, m_handle, vk::ImageLayout::eTransferDstOptimal, region);
-        }, vk::QueueFlagBits::eTransfer);
+        const auto extent = MipExtent(mipLevel);
+        const auto region = vk::BufferImageCopy()
+            .setBufferOffset(bufferOffset)
+            .setBufferRowLength(0)
+            .setBufferImageHeight(0)
+            .setImageSubresource(vk::ImageSubresourceLayers()
+                .setAspectMask(vk::ImageAspectFlagBits::eColor)
+                .setMipLevel(mipLevel)
+                .setBaseArrayLayer(layer)
+                .setLayerCount(1))
+            .setImageOffset({ 0, 0, 0 })
+            .setImageExtent(vk::Extent3D()
+				.setWidth(extent.x)
+				.setHeight(extent.y)
+				.setDepth(extent.z));
+        Context::UploadManager().CopyBufferToImage(buffer, *this, region);
     }
 
     void Image::TransitionLayout(const vk::ImageLayout newLayout) {
@@ -110,7 +167,12 @@ namespace Coral::Memory {
             return;
         }
 
-        Context::Device().RunSingleTimeCommand([this, newLayout] (const Core::CommandBuffer &commandBuffer) {
+        // Preparing a fresh image for its first copy is valid on a transfer-only queue, everything else needs graphics stages
+        const auto queueType = m_layout == vk::ImageLayout::eUndefined && newLayout == vk::ImageLayout::eTransferDstOptimal
+            ? vk::QueueFlagBits::eTransfer
+            : vk::QueueFlagBits::eGraphics;
+
+        Context::UploadManager().Record([this, newLayout] (const Core::CommandBuffer &commandBuffer) {
             auto barrier = vk::ImageMemoryBarrier()
                 .setOldLayout(m_layout)
                 .setNewLayout(newLayout)
@@ -227,7 +289,7 @@ namespace Coral::Memory {
 
             m_layout = newLayout;
         },
-        vk::QueueFlagBits::eGraphics);
+        queueType);
     }
 
     void Image::Barrier(const vk::CommandBuffer &commandBuffer,
@@ -269,38 +331,18 @@ namespace Coral::Memory {
     void Image::Resize(const Math::Vector3<u32> &extent) {
         if (m_extent == extent || (extent.width == 0 || extent.height == 0 || extent.depth == 0))
             return;
+        if (m_aliased) {
+            throw std::runtime_error("Image::Resize : Aliased images are resized through their TransientPool");
+        }
 
-        Context::Device()->freeMemory(m_imageMemory);
-        Context::Device()->destroyImage(m_handle);
-
-        m_extent = extent;
-        const auto imageCreateInfo = vk::ImageCreateInfo()
-            .setImageType(vk::ImageType::e2D)
-            .setFormat(m_format)
-            .setExtent(vk::Extent3D()
-				.setWidth(m_extent.x)
-				.setHeight(m_extent.y)
-				.setDepth(m_extent.z))
-            .setMipLevels(m_mipLevels)
-            .setArrayLayers(m_layerCount)
-            .setSamples(m_sampleCount)
-            .setTiling(vk::ImageTiling::eOptimal)
-            .setUsage(m_usageFlags)
-            .setSharingMode(vk::SharingMode::eExclusive)
-            .setInitialLayout(vk::ImageLayout::eUndefined)
-            .setFlags(m_layerCount == 6 ? vk::ImageCreateFlagBits::eCubeCompatible : vk::ImageCreateFlags());
-        m_handle = Context::Device()->createImage(imageCreateInfo);
+        // Recorded but not yet submitted uploads may still reference the old handle
+        Context::UploadManager().WaitIdle();
 
-        const vk::MemoryRequirements memoryRequirements = Context::Device()->getImageMemoryRequirements(m_handle);
-        const auto memoryTypeIndex = Context::Device().FindMemoryType(memoryRequirements.memoryTypeBits, vk::MemoryPropertyFlagBits::eDeviceLocal);
-        if (!memoryTypeIndex.has_value()) {
-            std::cerr << "Image : Failed to find suitable memory type" << std::endl;
-        }
+        Context::DeletionQueue().Retire([allocation = m_allocation]() mutable { Context::Allocator().Free(allocation); });
+        Recreate(extent);
 
-        m_imageMemory = Context::Device()->allocateMemory(vk::MemoryAllocateInfo()
-            .setAllocationSize(memoryRequirements.size)
-            .setMemoryTypeIndex(memoryTypeIndex.value()));
-        Context::Device()->bindImageMemory(m_handle, m_imageMemory, 0);
+        m_allocation = Context::Allocator().AllocateFor(m_handle, MemoryProperties(), InferCategory(m_usageFlags));
+        Context::Device()->bindImageMemory(m_handle, m_allocation.memory, m_allocation.offset);
 
         if (m_layout != vk::ImageLayout::eUndefined) {
             const auto layout = m_layout;
@@ -314,7 +356,7 @@ namespace Coral::Memory {
             return;
         }
 
-        Context::Device().RunSingleTimeCommand([this] (const Core::CommandBuffer &commandBuffer) {
+        Context::UploadManager().Record([this] (const Core::CommandBuffer &commandBuffer) {
             auto mipWidth = static_cast<int32_t>(m_extent.width);
             auto mipHeight = static_cast<int32_t>(m_extent.height);
 
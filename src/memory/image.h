@@ -6,10 +6,14 @@
 
 #include <boost/uuid/random_generator.hpp>
 #include <boost/uuid/uuid_io.hpp>
+#include <mutex>
 #include <optional>
+#include <unordered_map>
 #include <unordered_set>
 #include <vulkan/vulkan.hpp>
 
+#include "allocator.h"
+#include "imageView.h"
 #include "math/matrix.h"
 #include "utils/globalWrapper.h"
 
@@ -19,6 +23,8 @@ namespace Coral::Core {
 }
 
 namespace Coral::Memory {
+    class TransientPool;
+
     class Image final : public EngineWrapper<vk::Image> {
     public:
         struct Builder {
@@ -68,6 +74,18 @@ namespace Coral::Memory {
                 return *this;
             }
 
+            // Contents never leave the render pass, lazily allocated memory is used where the device has it
+            Builder& Transient() {
+                m_usageFlagsSet.emplace(vk::ImageUsageFlagBits::eTransientAttachment);
+                return *this;
+            }
+
+            // Created without memory, a TransientPool binds it next to the images it may alias
+            Builder& Aliased() {
+                m_aliased = true;
+                return *this;
+            }
+
             [[nodiscard]] std::unique_ptr<Memory::Image> Build() const {
                 if (m_extent.width == 0 || m_extent.height == 0 || m_extent.depth == 0) {
                     throw std::runtime_error("Image : Extent must be set");
@@ -84,6 +102,7 @@ namespace Coral::Memory {
         	u32 m_maxMips = 1;
             u32 m_layersCount = 1;
             vk::ImageLayout m_layout = vk::ImageLayout::eUndefined;
+            bool m_aliased = false;
 
             std::optional<vk::Image> m_image = std::nullopt;
         };
@@ -101,15 +120,29 @@ namespace Coral::Memory {
         [[nodiscard]] const vk::SampleCountFlagBits& SampleCount() const { return m_sampleCount; }
         [[nodiscard]] const uint32_t& MipLevels() const { return m_mipLevels; }
         [[nodiscard]] const uint32_t& LayerCount() const { return m_layerCount; }
+        [[nodiscard]] Math::Vector3<u32> MipExtent(uint32_t mipLevel) const;
+
+        // Views are created on first request and live until the image is resized or destroyed, prefer ImageView::Builder::Acquire
+        [[nodiscard]] const ImageView& View(const ImageView::Description& description) const;
+        [[nodiscard]] u32 ViewCount() const;
 
-        void Copy(const vk::Buffer& buffer, uint32_t mipLevel = 0, uint32_t layer = 0) const;
+        // Copy, TransitionLayout and GenerateMipmaps are recorded into the open upload batch, see UploadManager
+        void Copy(const vk::Buffer& buffer, uint32_t mipLevel = 0, uint32_t layer = 0, vk::DeviceSize bufferOffset = 0) const;
         void TransitionLayout(vk::ImageLayout newLayout);
         void Barrier(const vk::CommandBuffer& commandBuffer, vk::AccessFlags srcAccessMask, vk::AccessFlags dstAccessMask, vk::PipelineStageFlags srcStage, vk::PipelineStageFlags dstStage) const;
         void GenerateMipmaps();
         void Resize(const Math::Vector3<u32>& extent);
 
     private:
-        vk::DeviceMemory m_imageMemory;
+        friend class TransientPool;
+
+        void CreateHandle();
+        // Replaces the handle with an unbound one of the new extent
+        void Recreate(const Math::Vector3<u32>& extent);
+        [[nodiscard]] vk::MemoryPropertyFlags MemoryProperties() const;
+
+        Allocation m_allocation;
+        bool m_aliased = false;
 
         vk::Format m_format;
         Math::Vector3<u32> m_extent;
@@ -120,6 +153,9 @@ namespace Coral::Memory {
 
         uint32_t m_mipLevels;
         uint32_t m_layerCount;
+
+        mutable std::mutex m_viewMutex;
+        mutable std::unordered_map<ImageView::Description, std::unique_ptr<ImageView>, ImageView::DescriptionHash> m_views;
     };
 
 }
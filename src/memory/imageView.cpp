@@ -10,44 +10,76 @@
 #include <memory>
 
 #include "context.h"
+#include "core/deletionQueue.h"
 
 namespace Coral::Memory {
-    ImageView::ImageView(const Builder &builder)
-        : m_image(builder.m_image), m_viewType(builder.m_viewType),
-          m_baseMipLevel(builder.m_baseMipLevel), m_mipLevelCount(builder.m_levelCount),
-          m_baseArrayLayer(builder.m_baseArrayLayer), m_arrayLayerCount(builder.m_layerCount) {
-        vk::ImageAspectFlags aspectMask = {};
-        if (m_image.UsageFlags() & vk::ImageUsageFlagBits::eDepthStencilAttachment) {
-            aspectMask = vk::ImageAspectFlagBits::eDepth;
-            if (m_image.Format() == vk::Format::eD32SfloatS8Uint || m_image.Format() == vk::Format::eD24UnormS8Uint) {
-                aspectMask |= vk::ImageAspectFlagBits::eStencil;
+    static void HashCombine(std::size_t& seed, const std::size_t value) {
+        seed ^= value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2);
+    }
+
+    std::size_t ImageView::DescriptionHash::operator()(const Description& description) const {
+        std::size_t seed = 0;
+        HashCombine(seed, static_cast<std::size_t>(description.viewType));
+        HashCombine(seed, static_cast<std::size_t>(description.format));
+        HashCombine(seed, static_cast<vk::ImageAspectFlags::MaskType>(description.aspectMask));
+        HashCombine(seed, description.baseMipLevel);
+        HashCombine(seed, description.levelCount);
+        HashCombine(seed, description.baseArrayLayer);
+        HashCombine(seed, description.layerCount);
+        HashCombine(seed, static_cast<std::size_t>(description.components.r));
+        HashCombine(seed, static_cast<std::size_t>(description.components.g));
+        HashCombine(seed, static_cast<std::size_t>(description.components.b));
+        HashCombine(seed, static_cast<std::size_t>(description.components.a));
+        return seed;
+    }
+
+    const ImageView& ImageView::Builder::Acquire() const {
+        return m_image.View(m_description);
+    }
+
+    ImageView::Description ImageView::Builder::Resolved() const {
+        auto description = m_description;
+        if (description.format == vk::Format::eUndefined) {
+            description.format = m_image.Format();
+        }
+        if (!description.aspectMask) {
+            if (m_image.UsageFlags() & vk::ImageUsageFlagBits::eDepthStencilAttachment) {
+                description.aspectMask = vk::ImageAspectFlagBits::eDepth;
+                if (m_image.Format() == vk::Format::eD32SfloatS8Uint || m_image.Format() == vk::Format::eD24UnormS8Uint) {
+                    description.aspectMask |= vk::ImageAspectFlagBits::eStencil;
+                }
+            } else {
+                description.aspectMask = vk::ImageAspectFlagBits::eColor;
             }
-        } else {
-            aspectMask = vk::ImageAspectFlagBits::eColor;
         }
+        return description;
+    }
 
+    ImageView::ImageView(const Builder &builder)
+        : m_image(builder.m_image), m_description(builder.Resolved()) {
         const auto viewInfo = vk::ImageViewCreateInfo()
             .setImage(*m_image)
-            .setViewType(builder.m_viewType)
-            .setFormat(m_image.Format())
+            .setViewType(m_description.viewType)
+            .setFormat(m_description.format)
+            .setComponents(m_description.components)
             .setSubresourceRange(vk::ImageSubresourceRange()
-                .setAspectMask(aspectMask)
-                .setBaseMipLevel(builder.m_baseMipLevel)
-                .setLevelCount(builder.m_levelCount)
-                .setBaseArrayLayer(builder.m_baseArrayLayer)
-                .setLayerCount(builder.m_layerCount));
+                .setAspectMask(m_description.aspectMask)
+                .setBaseMipLevel(m_description.baseMipLevel)
+                .setLevelCount(m_description.levelCount)
+                .setBaseArrayLayer(m_description.baseArrayLayer)
+                .setLayerCount(m_description.layerCount));
 
         m_handle = Context::Device()->createImageView(viewInfo);
     }
 
     ImageView::~ImageView() {
-        Context::Device()->destroyImageView(m_handle);
+        Context::DeletionQueue().Retire([handle = m_handle] { Context::Device()->destroyImageView(handle); });
     }
 
     bool ImageView::Has(
         const uint32_t baseArrayLayer, const uint32_t arrayLayerCount,
         const uint32_t baseMipLevel, const uint32_t mipLevelCount) const {
-        return baseArrayLayer == m_baseArrayLayer && arrayLayerCount == m_arrayLayerCount &&
-            baseMipLevel == m_baseMipLevel && mipLevelCount == m_mipLevelCount;
+        return baseArrayLayer == m_description.baseArrayLayer && arrayLayerCount == m_description.layerCount &&
+            baseMipLevel == m_description.baseMipLevel && mipLevelCount == m_description.levelCount;
     }
-}
\ No newline at end of file
+}
@@ -20,48 +20,86 @@ namespace Coral::Core {
 namespace Coral::Memory {
     class ImageView final : public EngineWrapper<vk::ImageView> {
     public:
+        // Everything a view is created from besides the image, used as the key of the image's view cache
+        struct Description {
+            vk::ImageViewType viewType = vk::ImageViewType::e2D;
+            // eUndefined and empty aspects are resolved from the image
+            vk::Format format = vk::Format::eUndefined;
+            vk::ImageAspectFlags aspectMask = {};
+            uint32_t baseMipLevel = 0;
+            uint32_t levelCount = 1;
+            uint32_t baseArrayLayer = 0;
+            uint32_t layerCount = 1;
+            vk::ComponentMapping components = {};
+
+            bool operator==(const Description&) const = default;
+        };
+
+        struct DescriptionHash {
+            std::size_t operator()(const Description& description) const;
+        };
+
         class Builder {
             friend class ImageView;
+            friend class Memory::Image;
         public:
             explicit Builder(const Memory::Image& image) : m_image(image) {}
             ~Builder() = default;
 
             Builder& ViewType(const vk::ImageViewType viewType) {
-                m_viewType = viewType;
+                m_description.viewType = viewType;
+                return *this;
+            }
+
+            Builder& Format(const vk::Format format) {
+                m_description.format = format;
+                return *this;
+            }
+
+            Builder& AspectMask(const vk::ImageAspectFlags aspectMask) {
+                m_description.aspectMask = aspectMask;
                 return *this;
             }
 
             Builder& BaseMipLevel(const uint32_t baseMipLevel) {
-                m_baseMipLevel = baseMipLevel;
+                m_description.baseMipLevel = baseMipLevel;
                 return *this;
             }
 
             Builder& LevelCount(const uint32_t levelCount) {
-                m_levelCount = levelCount;
+                m_description.levelCount = levelCount;
                 return *this;
             }
 
             Builder& BaseArrayLayer(const uint32_t baseArrayLayer) {
-                m_baseArrayLayer = baseArrayLayer;
+                m_description.baseArrayLayer = baseArrayLayer;
                 return *this;
             }
 
             Builder& LayerCount(const uint32_t layerCount) {
-                m_layerCount = layerCount;
+                m_description.layerCount = layerCount;
+                return *this;
+            }
+
+            Builder& Components(const vk::ComponentMapping& components) {
+                m_description.components = components;
                 return *this;
             }
 
+            // A view owned by the caller
             [[nodiscard]] std::unique_ptr<ImageView> Build() const {
                 return std::make_unique<ImageView>(*this);
             }
 
+            // The view cached on the image, valid until the image is resized or destroyed
+            [[nodiscard]] const ImageView& Acquire() const;
+
+            // The description with the format and aspect filled in from the image
+            [[nodiscard]] Description Resolved() const;
+
         private:
             const Memory::Image& m_image;
-            vk::ImageViewType m_viewType = vk::ImageViewType::e2D;
-            uint32_t m_baseMipLevel = 0;
-            uint32_t m_levelCount = 1;
-            uint32_t m_baseArrayLayer = 0;
-            uint32_t m_layerCount = 1;
+            Description m_description;
         };
 
         explicit ImageView(const Builder& builder);
@@ -71,21 +109,17 @@ namespace Coral::Memory {
         ImageView& operator=(const ImageView&) = delete;
 
         [[nodiscard]] const Memory::Image& Image() const { return m_image; }
-        [[nodiscard]] const vk::ImageViewType& ViewType() const { return m_viewType; }
-        [[nodiscard]] const uint32_t& BaseMipLevel() const { return m_baseMipLevel; }
-        [[nodiscard]] const uint32_t& MipLevelCount() const { return m_mipLevelCount; }
-        [[nodiscard]] const uint32_t& BaseArrayLayer() const { return m_baseArrayLayer; }
-        [[nodiscard]] const uint32_t& ArrayLayerCount() const { return m_arrayLayerCount; }
+        [[nodiscard]] const Description& Info() const { return m_description; }
+        [[nodiscard]] const vk::ImageViewType& ViewType() const { return m_description.viewType; }
+        [[nodiscard]] const uint32_t& BaseMipLevel() const { return m_description.baseMipLevel; }
+        [[nodiscard]] const uint32_t& MipLevelCount() const { return m_description.levelCount; }
+        [[nodiscard]] const uint32_t& BaseArrayLayer() const { return m_description.baseArrayLayer; }
+        [[nodiscard]] const uint32_t& ArrayLayerCount() const { return m_description.layerCount; }
 
         bool Has(uint32_t baseArrayLayer, uint32_t arrayLayerCount, uint32_t baseMipLevel, uint32_t mipLevelCount) const;
 
     private:
         const Memory::Image& m_image;
-
-        vk::ImageViewType m_viewType;
-        uint32_t m_baseMipLevel;
-        uint32_t m_mipLevelCount;
-        uint32_t m_baseArrayLayer;
-        uint32_t m_arrayLayerCount;
+        Description m_description;
     };
 }
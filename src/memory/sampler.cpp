@@ -5,32 +5,33 @@
 #include "sampler.h"
 
 #include "context.h"
+#include "core/deletionQueue.h"
 #include "core/device.h"
 
 namespace Coral::Memory {
     Sampler::Sampler(const CreateInfo& createInfo)
-        : m_magFilter(createInfo.magFilter), m_minFilter(createInfo.minFilter), m_addressMode(createInfo.addressMode), m_mipmapMode(createInfo.mipmapMode) {
+        : m_info(createInfo), m_magFilter(createInfo.magFilter), m_minFilter(createInfo.minFilter), m_addressMode(createInfo.addressMode), m_mipmapMode(createInfo.mipmapMode) {
         const auto samplerInfo = vk::SamplerCreateInfo()
             .setMagFilter(m_magFilter)
             .setMinFilter(m_minFilter)
             .setAddressModeU(m_addressMode)
             .setAddressModeV(m_addressMode)
             .setAddressModeW(m_addressMode)
-            .setAnisotropyEnable(vk::True)
-            .setMaxAnisotropy(16)
-            .setBorderColor(vk::BorderColor::eIntOpaqueBlack)
+            .setAnisotropyEnable(createInfo.anisotropyEnable)
+            .setMaxAnisotropy(createInfo.maxAnisotropy)
+            .setBorderColor(createInfo.borderColor)
             .setUnnormalizedCoordinates(vk::False)
-            .setCompareEnable(vk::False)
-            .setCompareOp(vk::CompareOp::eAlways)
+            .setCompareEnable(createInfo.compareEnable)
+            .setCompareOp(createInfo.compareOp)
             .setMipmapMode(m_mipmapMode)
-            .setMipLodBias(0.0f)
-            .setMinLod(0.0f)
-            .setMaxLod(vk::LodClampNone);
+            .setMipLodBias(createInfo.mipLodBias)
+            .setMinLod(createInfo.minLod)
+            .setMaxLod(createInfo.maxLod);
 
         m_handle = Context::Device()->createSampler(samplerInfo);
     }
 
     Sampler::~Sampler() {
-        Context::Device()->destroySampler(m_handle);
+        Context::DeletionQueue().Retire([handle = m_handle] { Context::Device()->destroySampler(handle); });
     }
 }
@@ -7,6 +7,7 @@
 #include <vulkan/vulkan.hpp>
 
 #include "utils/globalWrapper.h"
+#include "utils/types.h"
 
 namespace Coral::Core {
     class Device;
@@ -21,17 +22,30 @@ namespace Coral::Memory {
             vk::Filter minFilter = vk::Filter::eLinear;
             vk::SamplerAddressMode addressMode = vk::SamplerAddressMode::eRepeat;
             vk::SamplerMipmapMode mipmapMode = vk::SamplerMipmapMode::eLinear;
+            bool anisotropyEnable = true;
+            f32 maxAnisotropy = 16.0f;
+            f32 mipLodBias = 0.0f;
+            f32 minLod = 0.0f;
+            f32 maxLod = vk::LodClampNone;
+            bool compareEnable = false;
+            vk::CompareOp compareOp = vk::CompareOp::eAlways;
+            vk::BorderColor borderColor = vk::BorderColor::eIntOpaqueBlack;
+
+            bool operator==(const CreateInfo&) const = default;
         };
 
         explicit Sampler(const CreateInfo& createInfo);
         ~Sampler() override;
 
+        [[nodiscard]] const CreateInfo& Info() const { return m_info; }
+
         [[nodiscard]] vk::Filter MagFilter() const { return m_magFilter; }
         [[nodiscard]] vk::Filter MinFilter() const { return m_minFilter; }
         [[nodiscard]] vk::SamplerAddressMode AddressMode() const { return m_addressMode; }
         [[nodiscard]] vk::SamplerMipmapMode MipmapMode() const { return m_mipmapMode; }
 
     private:
+        CreateInfo m_info;
         vk::Filter m_magFilter = vk::Filter::eLinear;
         vk::Filter m_minFilter = vk::Filter::eLinear;
         vk::SamplerAddressMode m_addressMode = vk::SamplerAddressMode::eRepeat;
@@ -0,0 +1,80 @@
+//
+// Created by radue on 10/17/2026.
+//
+
+#include "samplerCache.h"
+
+#include <bit>
+#include <iostream>
+
+#include "context.h"
+
+namespace Coral::Memory {
+    static void HashCombine(std::size_t& seed, const std::size_t value) {
+        seed ^= value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2);
+    }
+
+    // -0.0f == 0.0f, so both have to hash the same
+    static std::size_t HashFloat(const f32 value) {
+        return std::bit_cast<u32>(value == 0.0f ? 0.0f : value);
+    }
+
+    std::size_t SamplerCache::CreateInfoHash::operator()(const Sampler::CreateInfo& createInfo) const {
+        std::size_t seed = 0;
+        HashCombine(seed, static_cast<std::size_t>(createInfo.magFilter));
+        HashCombine(seed, static_cast<std::size_t>(createInfo.minFilter));
+        HashCombine(seed, static_cast<std::size_t>(createInfo.addressMode));
+        HashCombine(seed, static_cast<std::size_t>(createInfo.mipmapMode));
+        HashCombine(seed, createInfo.anisotropyEnable);
+        HashCombine(seed, HashFloat(createInfo.maxAnisotropy));
+        HashCombine(seed, HashFloat(createInfo.mipLodBias));
+        HashCombine(seed, HashFloat(createInfo.minLod));
+        HashCombine(seed, HashFloat(createInfo.maxLod));
+        HashCombine(seed, createInfo.compareEnable);
+        HashCombine(seed, static_cast<std::size_t>(createInfo.compareOp));
+        HashCombine(seed, static_cast<std::size_t>(createInfo.borderColor));
+        return seed;
+    }
+
+    SamplerCache::SamplerCache() {
+        static bool firstTime = true;
+        if (!firstTime) {
+            throw std::runtime_error("SamplerCache already created!");
+        }
+        firstTime = false;
+        Context::m_samplerCache = this;
+    }
+
+    SamplerCache::~SamplerCache() {
+        if (!m_samplers.empty()) {
+            std::cerr << "SamplerCache : " << m_samplers.size() << " samplers outlive the cache" << std::endl;
+        }
+        Context::m_samplerCache = nullptr;
+    }
+
+    std::shared_ptr<const Sampler> SamplerCache::Acquire(const Sampler::CreateInfo& createInfo) {
+        std::lock_guard lock(m_mutex);
+        auto& entry = m_samplers[createInfo];
+        if (auto sampler = entry.lock()) {
+            return sampler;
+        }
+
+        auto sampler = std::shared_ptr<const Sampler>(new Sampler(createInfo), [this, createInfo](const Sampler* released) {
+            {
+                std::lock_guard deleterLock(m_mutex);
+                // A new sampler may already have taken the slot
+                if (const auto it = m_samplers.find(createInfo); it != m_samplers.end() && it->second.expired()) {
+                    m_samplers.erase(it);
+                }
+            }
+            delete released;
+        });
+        entry = sampler;
+        return sampler;
+    }
+
+    u32 SamplerCache::Count() const {
+        std::lock_guard lock(m_mutex);
+        return static_cast<u32>(m_samplers.size());
+    }
+}
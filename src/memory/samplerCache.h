@@ -0,0 +1,35 @@
+//
+// Created by radue on 10/17/2026.
+//
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+#include "sampler.h"
+
+namespace Coral::Memory {
+    // Hands out one shared sampler per distinct CreateInfo, destroyed once its last user released it
+    class SamplerCache {
+    public:
+        SamplerCache();
+        ~SamplerCache();
+        SamplerCache(const SamplerCache&) = delete;
+        SamplerCache& operator=(const SamplerCache&) = delete;
+
+        [[nodiscard]] std::shared_ptr<const Sampler> Acquire(const Sampler::CreateInfo& createInfo);
+
+        [[nodiscard]] u32 Count() const;
+
+    private:
+        struct CreateInfoHash {
+            std::size_t operator()(const Sampler::CreateInfo& createInfo) const;
+        };
+
+        // Samplers are only ever released outside the lock, their deleters take it again
+        mutable std::mutex m_mutex;
+        std::unordered_map<Sampler::CreateInfo, std::weak_ptr<const Sampler>, CreateInfoHash> m_samplers;
+    };
+}
@@ -0,0 +1,48 @@
+//
+// Created by radue on 10/17/2026.
+//
+
+#include "stagingRing.h"
+
+#include "buffer.h"
+
+namespace Coral::Memory {
+    StagingRing::StagingRing(const vk::DeviceSize size) : m_size(size) {
+        m_buffer = Memory::Buffer::Builder()
+            .InstanceSize(1)
+            .InstanceCount(static_cast<u32>(size))
+            .UsageFlags(vk::BufferUsageFlagBits::eTransferSrc)
+            .MemoryProperty(vk::MemoryPropertyFlagBits::eHostVisible)
+            .MemoryProperty(vk::MemoryPropertyFlagBits::eHostCoherent)
+            .Build();
+        m_mapped = m_buffer->Map<std::byte>().data();
+    }
+
+    StagingRing::~StagingRing() {
+        m_buffer->Unmap();
+    }
+
+    std::optional<StagingRing::Allocation> StagingRing::Allocate(const vk::DeviceSize size, const vk::DeviceSize alignment) {
+        if (size == 0 || size > m_size) {
+            return std::nullopt;
+        }
+
+        u64 begin = GetAlignment(m_head, alignment);
+        if (begin % m_size + size > m_size) {
+            // Never split an allocation across the end of the buffer
+            begin = (begin / m_size + 1) * m_size;
+        }
+        const u64 end = begin + size;
+        if (end - m_tail > m_size) {
+            return std::nullopt;
+        }
+
+        m_head = end;
+        const auto offset = begin % m_size;
+        return Allocation { .offset = offset, .data = m_mapped + offset };
+    }
+
+    void StagingRing::Release(const u64 position) {
+        m_tail = std::max(m_tail, std::min(position, m_head));
+    }
+}
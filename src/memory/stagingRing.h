@@ -0,0 +1,48 @@
+//
+// Created by radue on 10/17/2026.
+//
+
+#pragma once
+
+#include <memory>
+#include <optional>
+
+#include <vulkan/vulkan.hpp>
+
+#include "utils/types.h"
+
+namespace Coral::Memory {
+    class Buffer;
+
+    // Persistently mapped host-visible buffer handed out front to back. Positions grow monotonically,
+    // the owner releases everything before a position once the GPU work reading it retired.
+    class StagingRing {
+    public:
+        struct Allocation {
+            vk::DeviceSize offset;
+            std::byte* data;
+        };
+
+        explicit StagingRing(vk::DeviceSize size);
+        ~StagingRing();
+
+        StagingRing(const StagingRing&) = delete;
+        StagingRing& operator=(const StagingRing&) = delete;
+
+        [[nodiscard]] std::optional<Allocation> Allocate(vk::DeviceSize size, vk::DeviceSize alignment);
+        void Release(u64 position);
+
+        [[nodiscard]] u64 Head() const { return m_head; }
+        [[nodiscard]] vk::DeviceSize Size() const { return m_size; }
+        [[nodiscard]] vk::DeviceSize Used() const { return m_head - m_tail; }
+        [[nodiscard]] const Memory::Buffer& Buffer() const { return *m_buffer; }
+
+    private:
+        vk::DeviceSize m_size;
+        std::unique_ptr<Memory::Buffer> m_buffer;
+        std::byte* m_mapped = nullptr;
+
+        u64 m_head = 0;
+        u64 m_tail = 0;
+    };
+}
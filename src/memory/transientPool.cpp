@@ -0,0 +1,109 @@
+//
+// Created by radue on 10/17/2026.
+//
+
+#include "transientPool.h"
+
+#include <algorithm>
+#include <numeric>
+
+#include "context.h"
+#include "core/deletionQueue.h"
+#include "core/device.h"
+
+namespace Coral::Memory {
+    TransientPool::~TransientPool() {
+        m_entries.clear();
+        Release();
+    }
+
+    Image& TransientPool::Add(Image::Builder builder, const Lifetime& lifetime) {
+        if (lifetime.first > lifetime.last) {
+            throw std::runtime_error("TransientPool::Add : Lifetime ends before it starts");
+        }
+        builder.Aliased();
+        return *m_entries.emplace_back(Entry { .image = builder.Build(), .lifetime = lifetime }).image;
+    }
+
+    void TransientPool::Bind() {
+        Release();
+
+        struct Slot {
+            std::vector<u32> entries;
+            vk::MemoryRequirements requirements;
+            bool lazilyAllocated = false;
+        };
+
+        std::vector<vk::MemoryRequirements> requirements;
+        requirements.reserve(m_entries.size());
+        for (const auto& entry : m_entries) {
+            requirements.emplace_back(Context::Device()->getImageMemoryRequirements(**entry.image));
+        }
+
+        // Largest first, so a slot is sized by its first image and later ones rarely grow it
+        std::vector<u32> order(m_entries.size());
+        std::iota(order.begin(), order.end(), 0u);
+        std::ranges::sort(order, [&](const u32 a, const u32 b) { return requirements[a].size > requirements[b].size; });
+
+        m_statistics = Statistics { .imageCount = static_cast<u32>(m_entries.size()) };
+
+        std::vector<Slot> slots;
+        for (const auto index : order) {
+            const auto& entry = m_entries[index];
+            const auto& entryRequirements = requirements[index];
+            const bool lazilyAllocated = static_cast<bool>(entry.image->UsageFlags() & vk::ImageUsageFlagBits::eTransientAttachment);
+            m_statistics.requestedBytes += entryRequirements.size;
+
+            const auto fits = [&](const Slot& slot) {
+                return slot.lazilyAllocated == lazilyAllocated &&
+                    (slot.requirements.memoryTypeBits & entryRequirements.memoryTypeBits) != 0 &&
+                    std::ranges::none_of(slot.entries, [&](const u32 other) { return m_entries[other].lifetime.Overlaps(entry.lifetime); });
+            };
+
+            if (const auto slot = std::ranges::find_if(slots, fits); slot != slots.end()) {
+                slot->entries.emplace_back(index);
+                slot->requirements.size = std::max(slot->requirements.size, entryRequirements.size);
+                slot->requirements.alignment = std::max(slot->requirements.alignment, entryRequirements.alignment);
+                slot->requirements.memoryTypeBits &= entryRequirements.memoryTypeBits;
+            } else {
+                slots.emplace_back(Slot { .entries = { index }, .requirements = entryRequirements, .lazilyAllocated = lazilyAllocated });
+            }
+        }
+
+        for (const auto& slot : slots) {
+            auto properties = vk::MemoryPropertyFlags(vk::MemoryPropertyFlagBits::eDeviceLocal);
+            if (slot.lazilyAllocated) {
+                properties = Context::Allocator().Preferred(slot.requirements.memoryTypeBits, properties, vk::MemoryPropertyFlagBits::eLazilyAllocated);
+            }
+
+            const auto& allocation = m_allocations.emplace_back(
+                Context::Allocator().Allocate(slot.requirements, properties, Allocator::ResourceKind::Image, Category::Attachment));
+            for (const auto index : slot.entries) {
+                Context::Device()->bindImageMemory(**m_entries[index].image, allocation.memory, allocation.offset);
+            }
+            m_statistics.allocatedBytes += slot.requirements.size;
+        }
+        m_statistics.slotCount = static_cast<u32>(slots.size());
+    }
+
+    void TransientPool::Resize(const Math::Vector3<u32>& extent) {
+        if (m_entries.empty() || m_entries.front().image->Extent() == extent ||
+            extent.width == 0 || extent.height == 0 || extent.depth == 0) {
+            return;
+        }
+
+        Release();
+        for (const auto& entry : m_entries) {
+            entry.image->Recreate(extent);
+        }
+        Bind();
+    }
+
+    void TransientPool::Release() {
+        // Images of frames still in flight may live in the memory, it is freed once they retire
+        for (auto& allocation : m_allocations) {
+            Context::DeletionQueue().Retire([allocation]() mutable { Context::Allocator().Free(allocation); });
+        }
+        m_allocations.clear();
+    }
+}
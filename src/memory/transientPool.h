@@ -0,0 +1,60 @@
+//
+// Created by radue on 10/17/2026.
+//
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "allocator.h"
+#include "image.h"
+
+namespace Coral::Memory {
+    // Owns images whose contents never outlive a range of passes and lets the ones with disjoint ranges share memory.
+    class TransientPool {
+    public:
+        // Inclusive range of pass indices within a frame
+        struct Lifetime {
+            u32 first = 0;
+            u32 last = 0;
+
+            [[nodiscard]] bool Overlaps(const Lifetime& other) const { return first <= other.last && other.first <= last; }
+        };
+
+        struct Statistics {
+            u32 imageCount = 0;
+            u32 slotCount = 0;
+            // What the images would take with memory of their own
+            vk::DeviceSize requestedBytes = 0;
+            vk::DeviceSize allocatedBytes = 0;
+        };
+
+        TransientPool() = default;
+        ~TransientPool();
+
+        TransientPool(const TransientPool&) = delete;
+        TransientPool& operator=(const TransientPool&) = delete;
+
+        // The image has no memory until the next Bind
+        Image& Add(Image::Builder builder, const Lifetime& lifetime);
+        // Packs every image into as few allocations as their lifetimes allow and binds them
+        void Bind();
+        // Recreates every image at the new extent and packs them again, the old images and memory retire with the frame
+        void Resize(const Math::Vector3<u32>& extent);
+
+        [[nodiscard]] const Statistics& Stats() const { return m_statistics; }
+
+    private:
+        struct Entry {
+            std::unique_ptr<Image> image;
+            Lifetime lifetime;
+        };
+
+        void Release();
+
+        std::vector<Entry> m_entries;
+        std::vector<Allocation> m_allocations;
+        Statistics m_statistics;
+    };
+}
@@ -0,0 +1,79 @@
+//
+// Created by radue on 10/17/2026.
+//
+
+#include "uniformRing.h"
+
+#include <format>
+
+#include "buffer.h"
+#include "context.h"
+#include "core/physicalDevice.h"
+#include "core/runtime.h"
+#include "core/scheduler.h"
+#include "descriptor/layoutCache.h"
+#include "descriptor/set.h"
+
+namespace Coral::Memory {
+    UniformRing::UniformRing(const CreateInfo &createInfo) : m_regionCount(std::max(1u, createInfo.regionCount)) {
+        const auto limits = Core::Runtime::Get().PhysicalDevice()->getProperties().limits;
+        m_alignment = std::max<vk::DeviceSize>(1, limits.minUniformBufferOffsetAlignment);
+        m_bindingRange = std::min<vk::DeviceSize>(createInfo.bindingRange, limits.maxUniformBufferRange);
+        m_regionSize = GetAlignment(std::max(createInfo.regionSize, m_bindingRange), m_alignment);
+
+        // The tail lets a binding range starting anywhere in the last region stay inside the buffer
+        m_buffer = Memory::Buffer::Builder()
+            .InstanceSize(1)
+            .InstanceCount(static_cast<u32>(m_regionSize * m_regionCount + m_bindingRange))
+            .UsageFlags(vk::BufferUsageFlagBits::eUniformBuffer)
+            .MemoryProperty(vk::MemoryPropertyFlagBits::eHostVisible)
+            .MemoryProperty(vk::MemoryPropertyFlagBits::eHostCoherent)
+            .Build();
+        m_mapped = m_buffer->Map<std::byte>().data();
+
+        m_layout = Context::LayoutCache().AcquireSetLayout(LayoutBuilder());
+        m_set = Descriptor::Set::Builder(Context::Scheduler().DescriptorAllocator(), *m_layout)
+            .WriteBuffer(Binding, vk::DescriptorBufferInfo()
+                .setBuffer(**m_buffer)
+                .setOffset(0)
+                .setRange(m_bindingRange))
+            .Build();
+    }
+
+    UniformRing::~UniformRing() {
+        m_set.reset();
+        m_buffer->Unmap();
+    }
+
+    Descriptor::SetLayout::Builder UniformRing::LayoutBuilder() {
+        auto builder = Descriptor::SetLayout::Builder();
+        builder.AddBinding(Binding, vk::DescriptorType::eUniformBufferDynamic, vk::ShaderStageFlagBits::eAll);
+        return builder;
+    }
+
+    void UniformRing::Begin(const u32 region) {
+        if (region >= m_regionCount) {
+            throw std::runtime_error("UniformRing::Begin : Region out of bounds");
+        }
+        m_regionBegin = region * m_regionSize;
+        m_head = m_regionBegin;
+    }
+
+    UniformRing::Allocation UniformRing::Allocate(const vk::DeviceSize size) {
+        if (size == 0 || size > m_bindingRange) {
+            throw std::runtime_error(std::format("UniformRing::Allocate : {} bytes do not fit in a binding range of {}", size, m_bindingRange));
+        }
+
+        const auto begin = GetAlignment(m_head, m_alignment);
+        if (begin + size > m_regionBegin + m_regionSize) {
+            throw std::runtime_error(std::format("UniformRing::Allocate : Region of {} bytes exhausted", m_regionSize));
+        }
+
+        m_head = begin + size;
+        return Allocation { .offset = static_cast<u32>(begin), .data = m_mapped + begin };
+    }
+
+    void UniformRing::Bind(const vk::CommandBuffer commandBuffer, const vk::PipelineLayout layout, const u32 offset, const vk::PipelineBindPoint bindPoint) const {
+        commandBuffer.bindDescriptorSets(bindPoint, layout, Set, **m_set, offset);
+    }
+}
@@ -0,0 +1,88 @@
+//
+// Created by radue on 10/17/2026.
+//
+
+#pragma once
+
+#include <cstring>
+#include <memory>
+#include <type_traits>
+
+#include <vulkan/vulkan.hpp>
+
+#include "descriptor/setLayout.h"
+#include "utils/types.h"
+
+namespace Coral::Memory {
+    class Buffer;
+}
+
+namespace Coral::Memory::Descriptor {
+    class Set;
+}
+
+namespace Coral::Memory {
+    // Persistently mapped uniform buffer split into one region per frame in flight. A frame bump allocates its
+    // constants from its own region and shaders reach them through the dynamic offset of a single descriptor set.
+    class UniformRing {
+    public:
+        // Descriptor set index reserved for the ring in every pipeline layout
+        static constexpr u32 Set = 0;
+        static constexpr u32 Binding = 0;
+
+        struct CreateInfo {
+            // One region per frame in flight
+            u32 regionCount = 2;
+            vk::DeviceSize regionSize = 1 << 20;
+            // Largest block a shader sees through one dynamic offset, clamped to maxUniformBufferRange
+            vk::DeviceSize bindingRange = 16 << 10;
+        };
+
+        struct Allocation {
+            u32 offset;
+            std::byte* data;
+        };
+
+        explicit UniformRing(const CreateInfo &createInfo);
+        ~UniformRing();
+        UniformRing(const UniformRing &) = delete;
+        UniformRing &operator=(const UniformRing &) = delete;
+
+        [[nodiscard]] static Descriptor::SetLayout::Builder LayoutBuilder();
+
+        // Rewinds the region of a frame, the GPU must have retired the last submission reading it
+        void Begin(u32 region);
+
+        // The returned offset is what Bind expects, the data stays valid until the region is rewound
+        [[nodiscard]] Allocation Allocate(vk::DeviceSize size);
+
+        template <typename T>
+        [[nodiscard]] u32 Push(const T &data) {
+            static_assert(std::is_trivially_copyable_v<T>, "UniformRing::Push : Type has to be trivially copyable");
+            const auto allocation = Allocate(sizeof(T));
+            std::memcpy(allocation.data, &data, sizeof(T));
+            return allocation.offset;
+        }
+
+        void Bind(vk::CommandBuffer commandBuffer, vk::PipelineLayout layout, u32 offset, vk::PipelineBindPoint bindPoint = vk::PipelineBindPoint::eGraphics) const;
+
+        [[nodiscard]] vk::DeviceSize RegionSize() const { return m_regionSize; }
+        [[nodiscard]] vk::DeviceSize Used() const { return m_head - m_regionBegin; }
+        [[nodiscard]] vk::DeviceSize Alignment() const { return m_alignment; }
+
+    private:
+        u32 m_regionCount;
+        vk::DeviceSize m_regionSize;
+        vk::DeviceSize m_bindingRange;
+        vk::DeviceSize m_alignment;
+
+        std::unique_ptr<Memory::Buffer> m_buffer;
+        std::byte* m_mapped = nullptr;
+
+        std::shared_ptr<const Descriptor::SetLayout> m_layout;
+        std::unique_ptr<Descriptor::Set> m_set;
+
+        vk::DeviceSize m_regionBegin = 0;
+        vk::DeviceSize m_head = 0;
+    };
+}
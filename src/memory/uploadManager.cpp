@@ -0,0 +1,399 @@
+//
+// Created by radue on 10/17/2026.
+//
+
+#include "uploadManager.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "context.h"
+#include "core/jobSystem.h"
+#include "core/physicalDevice.h"
+#include "core/runtime.h"
+#include "buffer.h"
+#include "image.h"
+
+namespace Coral::Memory {
+    UploadManager::UploadManager(const CreateInfo& createInfo)
+        : m_maxPendingBytes(createInfo.maxPendingBytes) {
+		static bool firstTime = true;
+		if (!firstTime) {
+			throw std::runtime_error("UploadManager already created!");
+		}
+		firstTime = false;
+        Context::m_uploadManager = this;
+
+        const std::array transferCandidates = {
+            vk::QueueFlags(vk::QueueFlagBits::eGraphics | vk::QueueFlagBits::eCompute),
+            vk::QueueFlags(vk::QueueFlagBits::eGraphics),
+            vk::QueueFlags(),
+        };
+        for (const auto& excluded : transferCandidates) {
+            try {
+                m_transferQueue = Context::Device().RequestQueue(vk::QueueFlagBits::eTransfer, excluded, true);
+                break;
+            } catch (const std::runtime_error&) {}
+        }
+        if (!m_transferQueue) {
+            // Graphics queues always support transfers even if the family does not advertise it, on devices with a single
+            // graphics queue this one and the render graph's share the handle
+            m_transferQueue = Context::Device().RequestQueue(vk::QueueFlagBits::eGraphics);
+        }
+        m_graphicsQueue = Context::Device().RequestQueue(vk::QueueFlagBits::eGraphics);
+
+        const auto commandPoolCreateInfo = vk::CommandPoolCreateInfo()
+            .setFlags(vk::CommandPoolCreateFlagBits::eTransient | vk::CommandPoolCreateFlagBits::eResetCommandBuffer);
+        m_transferCommandPool = Context::Device()->createCommandPool(vk::CommandPoolCreateInfo(commandPoolCreateInfo)
+            .setQueueFamilyIndex(m_transferQueue->Family().Index()));
+        m_graphicsCommandPool = Context::Device()->createCommandPool(vk::CommandPoolCreateInfo(commandPoolCreateInfo)
+            .setQueueFamilyIndex(m_graphicsQueue->Family().Index()));
+
+        const auto limits = Core::Runtime::Get().PhysicalDevice()->getProperties().limits;
+        m_copyAlignment = std::max<vk::DeviceSize>(m_copyAlignment, limits.optimalBufferCopyOffsetAlignment);
+        m_stagingRing = std::make_unique<StagingRing>(createInfo.stagingRingSize);
+    }
+
+    UploadManager::~UploadManager() {
+        WaitIdle();
+
+        m_current.reset();
+        m_inFlight.clear();
+        m_freeBatches.clear();
+        m_stagingRing.reset();
+
+        Context::Device()->destroyCommandPool(m_transferCommandPool);
+        Context::Device()->destroyCommandPool(m_graphicsCommandPool);
+        Context::m_uploadManager = nullptr;
+    }
+
+    void UploadManager::Upload(const Buffer& dstBuffer, const std::span<const std::byte> data, const vk::DeviceSize dstOffset) {
+        std::lock_guard lock(m_mutex);
+        BeginTransfer();
+        const auto [srcBuffer, srcOffset] = Stage(data);
+        RecordBufferCopy(srcBuffer, dstBuffer, vk::BufferCopy()
+            .setSrcOffset(srcOffset)
+            .setDstOffset(dstOffset)
+            .setSize(data.size()));
+        AutoFlush();
+    }
+
+    void UploadManager::Upload(const Image& dstImage, const std::span<const std::byte> data, const u32 mipLevel, const u32 layer) {
+        std::lock_guard lock(m_mutex);
+        BeginTransfer();
+        const auto [srcBuffer, srcOffset] = Stage(data);
+        const auto extent = dstImage.MipExtent(mipLevel);
+        RecordImageCopy(srcBuffer, dstImage, vk::BufferImageCopy()
+            .setBufferOffset(srcOffset)
+            .setImageSubresource(vk::ImageSubresourceLayers()
+                .setAspectMask(vk::ImageAspectFlagBits::eColor)
+                .setMipLevel(mipLevel)
+                .setBaseArrayLayer(layer)
+                .setLayerCount(1))
+            .setImageExtent(vk::Extent3D(extent.x, extent.y, extent.z)));
+        AutoFlush();
+    }
+
+    void UploadManager::CopyBuffer(const vk::Buffer& srcBuffer, const Buffer& dstBuffer, const vk::BufferCopy& region) {
+        std::lock_guard lock(m_mutex);
+        RecordBufferCopy(srcBuffer, dstBuffer, region);
+        AutoFlush();
+    }
+
+    void UploadManager::CopyBufferToImage(const vk::Buffer& srcBuffer, const Image& dstImage, const vk::BufferImageCopy& region) {
+        std::lock_guard lock(m_mutex);
+        RecordImageCopy(srcBuffer, dstImage, region);
+        AutoFlush();
+    }
+
+    void UploadManager::RecordBufferCopy(const vk::Buffer& srcBuffer, const Buffer& dstBuffer, const vk::BufferCopy& region) {
+        const auto& commandBuffer = BeginTransfer();
+        commandBuffer->copyBuffer(srcBuffer, *dstBuffer, region);
+        m_current->pendingBytes += region.size;
+
+        // Only the written range changes owner, the rest of the buffer never held content on the transfer family
+        if (NeedsOwnershipTransfer()) {
+            m_current->bufferReleases.emplace_back(vk::BufferMemoryBarrier2()
+                .setSrcStageMask(vk::PipelineStageFlagBits2::eCopy)
+                .setSrcAccessMask(vk::AccessFlagBits2::eTransferWrite)
+                .setSrcQueueFamilyIndex(m_transferQueue->Family().Index())
+                .setDstQueueFamilyIndex(m_graphicsQueue->Family().Index())
+                .setBuffer(*dstBuffer)
+                .setOffset(region.dstOffset)
+                .setSize(region.size));
+        }
+    }
+
+    void UploadManager::RecordImageCopy(const vk::Buffer& srcBuffer, const Image& dstImage, const vk::BufferImageCopy& region) {
+        const auto& commandBuffer = BeginTransfer();
+        commandBuffer->copyBufferToImage(srcBuffer, *dstImage, vk::ImageLayout::eTransferDstOptimal, region);
+        // Texel size is not known here, four bytes is enough to bound the batch
+        m_current->pendingBytes += static_cast<vk::DeviceSize>(region.imageExtent.width) * region.imageExtent.height * region.imageExtent.depth * 4;
+
+        // The whole image moves, mips and layers without a copy were still transitioned on the transfer family
+        const auto alreadyReleased = std::ranges::any_of(m_current->imageReleases, [&](const vk::ImageMemoryBarrier2& barrier) {
+            return barrier.image == *dstImage;
+        });
+        if (NeedsOwnershipTransfer() && !alreadyReleased) {
+            m_current->imageReleases.emplace_back(vk::ImageMemoryBarrier2()
+                .setSrcStageMask(vk::PipelineStageFlagBits2::eCopy)
+                .setSrcAccessMask(vk::AccessFlagBits2::eTransferWrite)
+                .setOldLayout(vk::ImageLayout::eTransferDstOptimal)
+                .setNewLayout(vk::ImageLayout::eTransferDstOptimal)
+                .setSrcQueueFamilyIndex(m_transferQueue->Family().Index())
+                .setDstQueueFamilyIndex(m_graphicsQueue->Family().Index())
+                .setImage(*dstImage)
+                .setSubresourceRange(vk::ImageSubresourceRange()
+                    .setAspectMask(region.imageSubresource.aspectMask)
+                    .setBaseMipLevel(0)
+                    .setLevelCount(dstImage.MipLevels())
+                    .setBaseArrayLayer(0)
+                    .setLayerCount(dstImage.LayerCount())));
+        }
+    }
+
+    std::pair<vk::Buffer, vk::DeviceSize> UploadManager::Stage(const std::span<const std::byte> data) {
+        auto allocation = m_stagingRing->Allocate(data.size(), m_copyAlignment);
+        if (!allocation.has_value()) {
+            Retire();
+            allocation = m_stagingRing->Allocate(data.size(), m_copyAlignment);
+        }
+
+        if (allocation.has_value()) {
+            std::memcpy(allocation->data, data.data(), data.size());
+            m_current->ringEnd = m_stagingRing->Head();
+            return { *m_stagingRing->Buffer(), allocation->offset };
+        }
+
+        // Payloads larger than the ring, or a ring still busy with in flight batches, get their own buffer
+        auto stagingBuffer = Memory::Buffer::Builder()
+            .InstanceSize(1)
+            .InstanceCount(static_cast<u32>(data.size()))
+            .UsageFlags(vk::BufferUsageFlagBits::eTransferSrc)
+            .MemoryProperty(vk::MemoryPropertyFlagBits::eHostVisible)
+            .MemoryProperty(vk::MemoryPropertyFlagBits::eHostCoherent)
+            .Build();
+        std::memcpy(stagingBuffer->Map<std::byte>().data(), data.data(), data.size());
+        stagingBuffer->Unmap();
+
+        const auto buffer = **stagingBuffer;
+        m_current->stagingBuffers.emplace_back(std::move(stagingBuffer));
+        return { buffer, 0 };
+    }
+
+    void UploadManager::Record(const std::function<void(const Core::CommandBuffer&)>& command, const vk::QueueFlagBits type) {
+        std::lock_guard lock(m_mutex);
+        if (type == vk::QueueFlagBits::eTransfer) {
+            command(BeginTransfer());
+        } else if (type == vk::QueueFlagBits::eGraphics) {
+            command(BeginGraphics());
+        } else {
+            throw std::runtime_error("UploadManager::Record : Only transfer and graphics work can be recorded");
+        }
+    }
+
+    void UploadManager::Retain(std::unique_ptr<Buffer> stagingBuffer) {
+        std::lock_guard lock(m_mutex);
+        // The copy reading the buffer is either still open or went out with the latest submitted batch
+        if (m_current) {
+            m_current->stagingBuffers.emplace_back(std::move(stagingBuffer));
+        } else if (!m_inFlight.empty()) {
+            m_inFlight.back()->stagingBuffers.emplace_back(std::move(stagingBuffer));
+        }
+    }
+
+    UploadManager::Token UploadManager::Flush() {
+        std::lock_guard lock(m_mutex);
+        return FlushLocked();
+    }
+
+    UploadManager::Token UploadManager::Pending() const {
+        std::lock_guard lock(m_mutex);
+        if (m_current && !m_current->Empty()) {
+            return { m_graphicsQueue->SubmittedValue() + 1 };
+        }
+        return { m_lastSubmitted };
+    }
+
+    UploadManager::Token UploadManager::LastSubmitted() const {
+        std::lock_guard lock(m_mutex);
+        return { m_lastSubmitted };
+    }
+
+    bool UploadManager::HasCompleted(const Token token) const {
+        return m_graphicsQueue->HasCompleted(token.value);
+    }
+
+    void UploadManager::Wait(const Token token) const {
+        m_graphicsQueue->Wait(token.value);
+    }
+
+    void UploadManager::WaitIdle() {
+        std::lock_guard lock(m_mutex);
+        Wait(FlushLocked());
+        Retire();
+    }
+
+    vk::SemaphoreSubmitInfo UploadManager::WaitInfo(const Token token, const vk::PipelineStageFlags2 stages) const {
+        return m_graphicsQueue->TimelineWait(token.value, stages);
+    }
+
+    const Core::CommandBuffer& UploadManager::BeginTransfer() {
+        if (m_current && m_current->transferClosed) {
+            // Graphics work of the open batch must not observe copies recorded after it
+            FlushLocked();
+        }
+        if (!m_current) {
+            if (m_freeBatches.empty()) {
+                m_current = std::make_unique<Batch>();
+            } else {
+                m_current = std::move(m_freeBatches.back());
+                m_freeBatches.pop_back();
+            }
+        }
+
+        auto& batch = *m_current;
+        if (!batch.transferBegun) {
+            if (!batch.transferCommandBuffer) {
+                const auto commandBuffers = Context::Device()->allocateCommandBuffers(vk::CommandBufferAllocateInfo()
+                    .setCommandPool(m_transferCommandPool)
+                    .setLevel(vk::CommandBufferLevel::ePrimary)
+                    .setCommandBufferCount(1));
+                batch.transferCommandBuffer = std::make_unique<Core::CommandBuffer>(*m_transferQueue, commandBuffers.front(), m_transferCommandPool);
+            }
+            (*batch.transferCommandBuffer)->begin(vk::CommandBufferBeginInfo().setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+            batch.transferBegun = true;
+        }
+        return *batch.transferCommandBuffer;
+    }
+
+    const Core::CommandBuffer& UploadManager::BeginGraphics() {
+        if (!m_current) {
+            if (m_freeBatches.empty()) {
+                m_current = std::make_unique<Batch>();
+            } else {
+                m_current = std::move(m_freeBatches.back());
+                m_freeBatches.pop_back();
+            }
+        }
+
+        auto& batch = *m_current;
+        if (!batch.graphicsBegun) {
+            if (!batch.graphicsCommandBuffer) {
+                const auto commandBuffers = Context::Device()->allocateCommandBuffers(vk::CommandBufferAllocateInfo()
+                    .setCommandPool(m_graphicsCommandPool)
+                    .setLevel(vk::CommandBufferLevel::ePrimary)
+                    .setCommandBufferCount(1));
+                batch.graphicsCommandBuffer = std::make_unique<Core::CommandBuffer>(*m_graphicsQueue, commandBuffers.front(), m_graphicsCommandPool);
+            }
+            (*batch.graphicsCommandBuffer)->begin(vk::CommandBufferBeginInfo().setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+            batch.graphicsBegun = true;
+        }
+        CloseTransfer();
+        return *batch.graphicsCommandBuffer;
+    }
+
+    void UploadManager::CloseTransfer() {
+        auto& batch = *m_current;
+        if (batch.transferClosed || !batch.transferBegun) {
+            return;
+        }
+        batch.transferClosed = true;
+
+        if (batch.bufferReleases.empty() && batch.imageReleases.empty()) {
+            return;
+        }
+
+        (*batch.transferCommandBuffer)->pipelineBarrier2(vk::DependencyInfo()
+            .setBufferMemoryBarriers(batch.bufferReleases)
+            .setImageMemoryBarriers(batch.imageReleases));
+
+        // The matching acquire goes first on the graphics side, before any graphics work of the batch
+        for (auto& barrier : batch.bufferReleases) {
+            barrier
+                .setSrcStageMask(vk::PipelineStageFlagBits2::eNone)
+                .setSrcAccessMask(vk::AccessFlagBits2::eNone)
+                .setDstStageMask(vk::PipelineStageFlagBits2::eAllCommands)
+                .setDstAccessMask(vk::AccessFlagBits2::eMemoryRead | vk::AccessFlagBits2::eMemoryWrite);
+        }
+        for (auto& barrier : batch.imageReleases) {
+            barrier
+                .setSrcStageMask(vk::PipelineStageFlagBits2::eNone)
+                .setSrcAccessMask(vk::AccessFlagBits2::eNone)
+                .setDstStageMask(vk::PipelineStageFlagBits2::eAllCommands)
+                .setDstAccessMask(vk::AccessFlagBits2::eMemoryRead | vk::AccessFlagBits2::eMemoryWrite);
+        }
+
+        if (!batch.graphicsBegun) {
+            BeginGraphics();
+        }
+        (*batch.graphicsCommandBuffer)->pipelineBarrier2(vk::DependencyInfo()
+            .setBufferMemoryBarriers(batch.bufferReleases)
+            .setImageMemoryBarriers(batch.imageReleases));
+    }
+
+    void UploadManager::AutoFlush() {
+        if (!m_current || m_current->pendingBytes < m_maxPendingBytes) {
+            return;
+        }
+        if (Core::JobSystem::IsMainThread()) {
+            FlushLocked();
+        } else if (!m_flushScheduled) {
+            // Workers may stage and record, submitting is left to the main thread
+            m_flushScheduled = true;
+            Context::JobSystem().RunOnMainThread([this] { Flush(); });
+        }
+    }
+
+    UploadManager::Token UploadManager::FlushLocked() {
+        m_flushScheduled = false;
+        Retire();
+        if (!m_current || m_current->Empty()) {
+            return { m_lastSubmitted };
+        }
+
+        CloseTransfer();
+        auto batch = std::move(m_current);
+
+        auto graphicsSubmission = Core::Queue::Submission {};
+        if (batch->transferBegun) {
+            (*batch->transferCommandBuffer)->end();
+            const auto transferValue = m_transferQueue->Submit({
+                Core::Queue::Submission { .commandBuffers = { **batch->transferCommandBuffer } }
+            });
+            graphicsSubmission.waitSemaphores.emplace_back(
+                m_transferQueue->TimelineWait(transferValue, vk::PipelineStageFlagBits2::eAllCommands));
+        }
+        if (batch->graphicsBegun) {
+            (*batch->graphicsCommandBuffer)->end();
+            graphicsSubmission.commandBuffers.emplace_back(**batch->graphicsCommandBuffer);
+        }
+
+        batch->value = m_graphicsQueue->Submit({ graphicsSubmission });
+        m_lastSubmitted = batch->value;
+        m_inFlight.emplace_back(std::move(batch));
+        return { m_lastSubmitted };
+    }
+
+    void UploadManager::Retire() {
+        while (!m_inFlight.empty() && m_graphicsQueue->HasCompleted(m_inFlight.front()->value)) {
+            auto batch = std::move(m_inFlight.front());
+            m_inFlight.pop_front();
+            m_stagingRing->Release(batch->ringEnd);
+
+            batch->stagingBuffers.clear();
+            batch->bufferReleases.clear();
+            batch->imageReleases.clear();
+            batch->transferBegun = false;
+            batch->transferClosed = false;
+            batch->graphicsBegun = false;
+            batch->pendingBytes = 0;
+            batch->ringEnd = 0;
+            m_freeBatches.emplace_back(std::move(batch));
+        }
+    }
+
+    bool UploadManager::NeedsOwnershipTransfer() const {
+        return m_transferQueue->Family().Index() != m_graphicsQueue->Family().Index();
+    }
+}
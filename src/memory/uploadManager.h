@@ -0,0 +1,116 @@
+//
+// Created by radue on 10/17/2026.
+//
+
+#pragma once
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+
+#include <vulkan/vulkan.hpp>
+
+#include "core/device.h"
+#include "stagingRing.h"
+
+namespace Coral::Memory {
+    class Buffer;
+    class Image;
+
+    // Records host-to-device copies and the layout work that follows them into a few command buffers.
+    // Copies run on a dedicated transfer queue when the device exposes one, everything that needs graphics
+    // capabilities (blits, shader read transitions) runs on a graphics queue after the copies of the same batch.
+    class UploadManager {
+    public:
+        struct CreateInfo {
+            vk::DeviceSize stagingRingSize = 64ull * 1024ull * 1024ull;
+            // An open batch is submitted on its own once it stages this many bytes
+            vk::DeviceSize maxPendingBytes = 32ull * 1024ull * 1024ull;
+        };
+
+        // Completion token of a batch, it is the value the upload graphics timeline reaches once the batch retired
+        struct Token {
+            u64 value = 0;
+        };
+
+        explicit UploadManager(const CreateInfo& createInfo);
+        ~UploadManager();
+
+        UploadManager(const UploadManager&) = delete;
+        UploadManager& operator=(const UploadManager&) = delete;
+
+        // Copies the data into the staging ring, or a dedicated staging buffer when it does not fit, and records the upload
+        void Upload(const Buffer& dstBuffer, std::span<const std::byte> data, vk::DeviceSize dstOffset = 0);
+        // The destination must already be in eTransferDstOptimal, data holds one tightly packed mip level of one layer
+        void Upload(const Image& dstImage, std::span<const std::byte> data, u32 mipLevel = 0, u32 layer = 0);
+
+        void CopyBuffer(const vk::Buffer& srcBuffer, const Buffer& dstBuffer, const vk::BufferCopy& region);
+        // The destination must already be in eTransferDstOptimal
+        void CopyBufferToImage(const vk::Buffer& srcBuffer, const Image& dstImage, const vk::BufferImageCopy& region);
+        // Records arbitrary commands on the transfer or the graphics command buffer of the open batch
+        void Record(const std::function<void(const Core::CommandBuffer&)>& command, vk::QueueFlagBits type);
+        // Keeps a staging buffer alive until the batch reading from it completed
+        void Retain(std::unique_ptr<Buffer> stagingBuffer);
+
+        Token Flush();
+        [[nodiscard]] Token Pending() const;
+        [[nodiscard]] Token LastSubmitted() const;
+        [[nodiscard]] bool HasCompleted(Token token) const;
+        void Wait(Token token) const;
+        void WaitIdle();
+
+        [[nodiscard]] vk::SemaphoreSubmitInfo WaitInfo(Token token, vk::PipelineStageFlags2 stages) const;
+        [[nodiscard]] const Core::Queue& TransferQueue() const { return *m_transferQueue; }
+        [[nodiscard]] const Core::Queue& GraphicsQueue() const { return *m_graphicsQueue; }
+
+    private:
+        struct Batch {
+            std::unique_ptr<Core::CommandBuffer> transferCommandBuffer;
+            std::unique_ptr<Core::CommandBuffer> graphicsCommandBuffer;
+            std::vector<std::unique_ptr<Buffer>> stagingBuffers;
+
+            std::vector<vk::BufferMemoryBarrier2> bufferReleases;
+            std::vector<vk::ImageMemoryBarrier2> imageReleases;
+
+            bool transferBegun = false;
+            bool transferClosed = false;
+            bool graphicsBegun = false;
+            vk::DeviceSize pendingBytes = 0;
+            u64 ringEnd = 0;
+            u64 value = 0;
+
+            [[nodiscard]] bool Empty() const { return !transferBegun && !graphicsBegun && stagingBuffers.empty(); }
+        };
+
+        const Core::CommandBuffer& BeginTransfer();
+        const Core::CommandBuffer& BeginGraphics();
+        void CloseTransfer();
+        void RecordBufferCopy(const vk::Buffer& srcBuffer, const Buffer& dstBuffer, const vk::BufferCopy& region);
+        void RecordImageCopy(const vk::Buffer& srcBuffer, const Image& dstImage, const vk::BufferImageCopy& region);
+        [[nodiscard]] std::pair<vk::Buffer, vk::DeviceSize> Stage(std::span<const std::byte> data);
+        void AutoFlush();
+        Token FlushLocked();
+        void Retire();
+        [[nodiscard]] bool NeedsOwnershipTransfer() const;
+
+        vk::DeviceSize m_maxPendingBytes;
+        vk::DeviceSize m_copyAlignment = 16;
+        std::unique_ptr<StagingRing> m_stagingRing;
+
+        std::unique_ptr<Core::Queue> m_transferQueue;
+        std::unique_ptr<Core::Queue> m_graphicsQueue;
+        vk::CommandPool m_transferCommandPool;
+        vk::CommandPool m_graphicsCommandPool;
+
+        std::unique_ptr<Batch> m_current;
+        std::deque<std::unique_ptr<Batch>> m_inFlight;
+        std::vector<std::unique_ptr<Batch>> m_freeBatches;
+        u64 m_lastSubmitted = 0;
+        // A worker filled the open batch and asked the main thread to submit it
+        bool m_flushScheduled = false;
+
+        mutable std::recursive_mutex m_mutex;
+    };
+}
@@ -4,8 +4,10 @@
 
 #include "renderGraph.h"
 
-#include <queue>
-#include <boost/uuid/nil_generator.hpp>
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <map>
 
 #include "core/scheduler.h"
 #include "ecs/entity.h"
@@ -13,196 +15,96 @@
 #include "gui/container.h"
 #include "gui/elements/popup.h"
 #include "gui/viewport.h"
+#include "memory/imageView.h"
+#include "memory/samplerCache.h"
+#include "memory/descriptor/layoutCache.h"
+#include "memory/descriptor/set.h"
 #include "shader/manager.h"
 #include "graphics/renderPass.h"
 #include "gui/templates/renderPipelineTemplate.h"
 
 
 namespace Coral::Project {
+	static constexpr auto AttachmentStages = vk::PipelineStageFlagBits2::eEarlyFragmentTests | vk::PipelineStageFlagBits2::eLateFragmentTests |
+		vk::PipelineStageFlagBits2::eColorAttachmentOutput | vk::PipelineStageFlagBits2::eFragmentShader;
+	static constexpr auto AttachmentWrites = vk::AccessFlagBits2::eColorAttachmentWrite | vk::AccessFlagBits2::eDepthStencilAttachmentWrite;
+	// Everything that may have written memory now aliased by another image
+	static constexpr auto AliasStages = AttachmentStages | vk::PipelineStageFlagBits2::eComputeShader | vk::PipelineStageFlagBits2::eCopy;
+	static constexpr auto AliasWrites = AttachmentWrites | vk::AccessFlagBits2::eShaderStorageWrite | vk::AccessFlagBits2::eTransferWrite;
+
+	// Render passes only take the legacy masks, every attachment stage and access has the same bit in both
+	static vk::PipelineStageFlags LegacyStages(const vk::PipelineStageFlags2 stages) {
+		return vk::PipelineStageFlags(static_cast<VkPipelineStageFlags>(static_cast<VkPipelineStageFlags2>(stages)));
+	}
+
+	static vk::AccessFlags LegacyAccess(const vk::AccessFlags2 access) {
+		return vk::AccessFlags(static_cast<VkAccessFlags>(static_cast<VkAccessFlags2>(access)));
+	}
+
+	// The implicit external dependencies start and end at the top and bottom of the pipe, so the render pass' layout
+	// transitions would not chain with the barriers recorded around it. Each attachment transitions around the first and
+	// last subpass using it, which is why every subpass gets both.
+	static void AddExternalDependencies(Graphics::RenderPass::Builder& builder, const u32 subpassCount, const vk::PipelineStageFlags2 stages, const vk::AccessFlags2 access) {
+		for (u32 subpass = 0; subpass < subpassCount; subpass++) {
+			builder.Dependency(vk::SubpassDependency()
+				.setSrcSubpass(vk::SubpassExternal)
+				.setDstSubpass(subpass)
+				.setSrcStageMask(LegacyStages(stages))
+				.setDstStageMask(LegacyStages(stages))
+				.setDstAccessMask(LegacyAccess(access)));
+			builder.Dependency(vk::SubpassDependency()
+				.setSrcSubpass(subpass)
+				.setDstSubpass(vk::SubpassExternal)
+				.setSrcStageMask(LegacyStages(stages))
+				.setSrcAccessMask(LegacyAccess(access & AttachmentWrites))
+				.setDstStageMask(LegacyStages(stages)));
+		}
+	}
+
 	RenderGraph::RenderGraph(const CreateInfo& createInfo)
-		: m_guiEnabled(createInfo.guiEnabled), m_frameCount(createInfo.frameCount) {
-		m_generator = boost::uuids::random_generator_mt19937();
+		: m_guiEnabled(createInfo.guiEnabled), m_dynamicRendering(createInfo.dynamicRendering), m_frameCount(createInfo.frameCount) {
+		m_transientPool = std::make_unique<Memory::TransientPool>();
 
 		m_pipelineTemplate = std::make_unique<Reef::RenderPipelineTemplate>();
 
-		auto windowSize = Core::Window::Get().Extent();
-		Math::Vector3u extent = { static_cast<u32>(windowSize.width), static_cast<u32>(windowSize.height), 1u };
+		const auto windowSize = Core::Window::Get().Extent();
+		m_extent = { static_cast<f32>(windowSize.width), static_cast<f32>(windowSize.height) };
 
-		auto idGui = boost::uuids::nil_uuid();
-		if (m_guiEnabled) {
-            idGui = m_generator();
-            m_images.emplace(idGui, std::vector<Memory::Image*>());
-        }
-
-		auto idDepth = m_generator();
-		auto idColor = m_generator();
-		auto idColorResolve = m_generator();
-		m_images.emplace(idDepth, std::vector<Memory::Image*>());
-		m_images.emplace(idColor, std::vector<Memory::Image*>());
-		m_images.emplace(idColorResolve, std::vector<Memory::Image*>());
-
-		for (uint32_t i = 0; i < m_frameCount; i++) {
-			Memory::Image* depthImage = m_imageStorage.emplace_back(
-				Memory::Image::Builder()
-					.Format(vk::Format::eD32SfloatS8Uint)
-					.Extent(extent)
-					.UsageFlags(vk::ImageUsageFlagBits::eDepthStencilAttachment)
-					.SampleCount(vk::SampleCountFlagBits::e2)
-					.InitialLayout(vk::ImageLayout::eDepthStencilAttachmentOptimal)
-					.Build()).get();
-			m_images.at(idDepth).emplace_back(depthImage);
+		m_queues[vk::QueueFlagBits::eGraphics] = Context::Device().RequestQueue(vk::QueueFlagBits::eGraphics);
+		const auto& queue = *m_queues.at(vk::QueueFlagBits::eGraphics);
+		// Dedicated queues let compute and copy passes overlap with rasterization, without them the passes run on Queue()'s fallback.
+		// They are never shared: their nodes wait on graphics work submitted later, which would stall a handle other submissions use.
+		try {
+			m_queues[vk::QueueFlagBits::eCompute] = Context::Device().RequestQueue(vk::QueueFlagBits::eCompute, vk::QueueFlagBits::eGraphics, true);
+		} catch (const std::runtime_error&) {}
+		try {
+			m_queues[vk::QueueFlagBits::eTransfer] = Context::Device().RequestQueue(vk::QueueFlagBits::eTransfer,
+				vk::QueueFlagBits::eGraphics | vk::QueueFlagBits::eCompute, true);
+		} catch (const std::runtime_error&) {}
+
+		m_sampler = Context::SamplerCache().Acquire(Memory::Sampler::CreateInfo {
+			.magFilter = vk::Filter::eLinear,
+			.minFilter = vk::Filter::eLinear,
+			.addressMode = vk::SamplerAddressMode::eClampToEdge,
+			.mipmapMode = vk::SamplerMipmapMode::eNearest,
+		});
+
+		m_compiler = std::make_unique<RenderGraphCompiler>(createInfo.description, createInfo.mergeSubpasses);
+		Build(m_compiler->Compile());
 
-			Memory::Image* colorImage = m_imageStorage.emplace_back(
-				Memory::Image::Builder()
+		if (m_guiEnabled)
+		{
+			for (uint32_t i = 0; i < m_frameCount; i++) {
+				m_guiImages.emplace_back(Memory::Image::Builder()
 					.Format(vk::Format::eB8G8R8A8Unorm)
-					.Extent(extent)
+					.Extent({ static_cast<u32>(windowSize.width), static_cast<u32>(windowSize.height), 1u })
 					.UsageFlags(vk::ImageUsageFlagBits::eColorAttachment)
-					.UsageFlags(vk::ImageUsageFlagBits::eSampled)
 					.UsageFlags(vk::ImageUsageFlagBits::eTransferSrc)
 					.SampleCount(vk::SampleCountFlagBits::e2)
-					.InitialLayout(vk::ImageLayout::eShaderReadOnlyOptimal)
-					.Build()).get();
-			m_images.at(idColor).emplace_back(colorImage);
-
-			Memory::Image* colorResolveImage = m_imageStorage.emplace_back(
-				Memory::Image::Builder()
-					.Format(vk::Format::eB8G8R8A8Unorm)
-					.Extent(extent)
-					.UsageFlags(vk::ImageUsageFlagBits::eColorAttachment)
-					.UsageFlags(vk::ImageUsageFlagBits::eSampled)
-					.UsageFlags(vk::ImageUsageFlagBits::eTransferSrc).SampleCount(vk::SampleCountFlagBits::e1)
-					.InitialLayout(vk::ImageLayout::eShaderReadOnlyOptimal)
-					.Build()).get();
-			m_images.at(idColorResolve).emplace_back(colorResolveImage);
-
-			if (m_guiEnabled) {
-				Memory::Image* guiImage = m_imageStorage.emplace_back(
-					Memory::Image::Builder()
-						.Format(vk::Format::eB8G8R8A8Unorm)
-						.Extent(extent)
-						.UsageFlags(vk::ImageUsageFlagBits::eColorAttachment)
-						.UsageFlags(vk::ImageUsageFlagBits::eTransferSrc)
-						.SampleCount(vk::SampleCountFlagBits::e2)
-						.InitialLayout(vk::ImageLayout::eColorAttachmentOptimal)
-						.Build()).get();
-				m_images.at(idGui).emplace_back(guiImage);
-			}
-		}
-
-		auto depthPassDepthDescription = vk::AttachmentDescription()
-			.setFormat(vk::Format::eD32SfloatS8Uint)
-			.setSamples(vk::SampleCountFlagBits::e2)
-			.setLoadOp(vk::AttachmentLoadOp::eClear)
-			.setStoreOp(vk::AttachmentStoreOp::eStore)
-			.setStencilLoadOp(vk::AttachmentLoadOp::eDontCare)
-			.setStencilStoreOp(vk::AttachmentStoreOp::eDontCare)
-			.setInitialLayout(vk::ImageLayout::eDepthStencilAttachmentOptimal)
-			.setFinalLayout(vk::ImageLayout::eDepthStencilAttachmentOptimal);
-
-		auto depthPassDepthReference = vk::AttachmentReference()
-			.setAttachment(0)
-			.setLayout(vk::ImageLayout::eDepthStencilAttachmentOptimal);
-
-		auto depthAttachment = Graphics::RenderPass::Attachment {
-			.description = depthPassDepthDescription,
-			.reference = depthPassDepthReference,
-			.images = m_images.at(idDepth),
-			.clearValue = vk::ClearDepthStencilValue(1.0f, 0)
-		};
-
-		auto depthSubpass = Graphics::RenderPass::Subpass {
-			.depthStencilAttachment = depthPassDepthReference
-		};
-
-		m_renderPasses.emplace("depth", Graphics::RenderPass::Builder()
-			.OutputImageIndex(0)
-			.Extent({ 1920u, 1080u })
-			.Attachment(0, depthAttachment)
-			.Subpass(depthSubpass)
-			.ImageCount(m_frameCount)
-			.Build());
-
-		auto colorPassDepthDescription = vk::AttachmentDescription()
-			.setFormat(vk::Format::eD32SfloatS8Uint)
-			.setSamples(vk::SampleCountFlagBits::e2)
-			.setLoadOp(vk::AttachmentLoadOp::eLoad)
-			.setStoreOp(vk::AttachmentStoreOp::eDontCare)
-			.setStencilLoadOp(vk::AttachmentLoadOp::eDontCare)
-			.setStencilStoreOp(vk::AttachmentStoreOp::eDontCare)
-			.setInitialLayout(vk::ImageLayout::eDepthStencilAttachmentOptimal)
-			.setFinalLayout(vk::ImageLayout::eDepthStencilAttachmentOptimal);
-
-		auto colorPassDepthReference = vk::AttachmentReference()
-			.setAttachment(1)
-			.setLayout(vk::ImageLayout::eDepthStencilAttachmentOptimal);
-
-		auto colorAttachmentDepth = Graphics::RenderPass::Attachment {
-			.description = colorPassDepthDescription,
-			.reference = colorPassDepthReference,
-			.images = m_images.at(idDepth),
-			.clearValue = vk::ClearDepthStencilValue(1.0f, 0)
-		};
-
-		auto colorPassColorDescription = vk::AttachmentDescription()
-			.setFormat(vk::Format::eB8G8R8A8Unorm)
-			.setSamples(vk::SampleCountFlagBits::e2)
-			.setLoadOp(vk::AttachmentLoadOp::eClear)
-			.setStoreOp(vk::AttachmentStoreOp::eStore)
-			.setStencilLoadOp(vk::AttachmentLoadOp::eDontCare)
-			.setStencilStoreOp(vk::AttachmentStoreOp::eDontCare)
-			.setInitialLayout(vk::ImageLayout::eUndefined)
-			.setFinalLayout(vk::ImageLayout::eShaderReadOnlyOptimal);
-
-		auto colorPassColorReference = vk::AttachmentReference()
-			.setAttachment(0)
-			.setLayout(vk::ImageLayout::eColorAttachmentOptimal);
-
-		auto colorAttachmentColor = Graphics::RenderPass::Attachment {
-			.description = colorPassColorDescription,
-			.reference = colorPassColorReference,
-			.images = m_images.at(idColor),
-			.clearValue = vk::ClearColorValue(std::array { 0.0f, 0.0f, 0.0f, 1.0f })
-		};
-
-		auto colorPassColorResolveDescription = vk::AttachmentDescription()
-			.setFormat(vk::Format::eB8G8R8A8Unorm)
-			.setSamples(vk::SampleCountFlagBits::e1)
-			.setLoadOp(vk::AttachmentLoadOp::eDontCare)
-			.setStoreOp(vk::AttachmentStoreOp::eStore)
-			.setStencilLoadOp(vk::AttachmentLoadOp::eDontCare)
-			.setStencilStoreOp(vk::AttachmentStoreOp::eDontCare)
-			.setInitialLayout(vk::ImageLayout::eUndefined)
-			.setFinalLayout(vk::ImageLayout::eShaderReadOnlyOptimal);
-
-		auto colorPassColorResolveReference = vk::AttachmentReference()
-			.setAttachment(2)
-			.setLayout(vk::ImageLayout::eColorAttachmentOptimal);
-
-		auto colorAttachmentColorResolve = Graphics::RenderPass::Attachment {
-			.description = colorPassColorResolveDescription,
-			.reference = colorPassColorResolveReference,
-			.images = m_images.at(idColorResolve),
-			.clearValue = vk::ClearColorValue(std::array { 0.0f, 0.0f, 0.0f, 1.0f })
-		};
-
-		auto colorSubpass = Graphics::RenderPass::Subpass{
-			.colorAttachments = {colorPassColorReference},
-			.resolveAttachments = {colorPassColorResolveReference},
-			.depthStencilAttachment = colorPassDepthReference
-		};
-
-		m_renderPasses.emplace("color", Graphics::RenderPass::Builder()
-			.OutputImageIndex(2)
-			.Attachment(0, colorAttachmentColor)
-			.Attachment(1, colorAttachmentDepth)
-			.Attachment(2, colorAttachmentColorResolve)
-			.Extent({ 1920u, 1080u })
-			.Subpass(colorSubpass)
-			.ImageCount(m_frameCount)
-			.Build());
+					.InitialLayout(vk::ImageLayout::eColorAttachmentOptimal)
+					.Build());
+			}
 
-		if (m_guiEnabled)
-		{
 			auto guiPassColorDescription = vk::AttachmentDescription()
 				.setFormat(vk::Format::eB8G8R8A8Unorm)
 				.setSamples(vk::SampleCountFlagBits::e2)
@@ -217,10 +119,15 @@ namespace Coral::Project {
 				.setAttachment(0)
 				.setLayout(vk::ImageLayout::eColorAttachmentOptimal);
 
+			std::vector<Memory::Image*> guiImages;
+			for (const auto& image : m_guiImages) {
+				guiImages.emplace_back(image.get());
+			}
+
 			auto guiPassColor = Graphics::RenderPass::Attachment {
 				.description = guiPassColorDescription,
 				.reference = guiPassColorReference,
-				.images = m_images.at(idGui),
+				.images = guiImages,
 				.clearValue = vk::ClearColorValue(std::array { 0.0f, 0.0f, 0.0f, 1.0f })
 			};
 
@@ -228,66 +135,19 @@ namespace Coral::Project {
 				.colorAttachments = { guiPassColorReference },
 			};
 
-			m_guiRenderPass = Graphics::RenderPass::Builder()
+			Graphics::RenderPass::Builder guiBuilder;
+			guiBuilder
 				.OutputImageIndex(0)
 				.Attachment(0, guiPassColor)
-				.Extent({ 1920u, 1080u })
+				.Extent({ static_cast<u32>(windowSize.width), static_cast<u32>(windowSize.height) })
 				.Subpass(guiSubpass)
 				.ImageCount(m_frameCount)
-				.Build();
-		}
+				.DynamicRendering(m_dynamicRendering);
+			AddExternalDependencies(guiBuilder, 1, vk::PipelineStageFlagBits2::eColorAttachmentOutput, vk::AccessFlagBits2::eColorAttachmentWrite);
+			m_guiRenderPass = guiBuilder.Build();
 
-		m_queues[vk::QueueFlagBits::eGraphics] = Context::Device().RequestQueue(vk::QueueFlagBits::eGraphics);
-
-		m_runNodes.emplace_back(std::make_unique<RunNode>(std::vector<std::string> { "depth" }));
-		m_runNodes.emplace_back(std::make_unique<RunNode>(std::vector<std::string> { "color" }));
-
-		const auto& queue = *m_queues.at(vk::QueueFlagBits::eGraphics);
-		for (auto& node : m_runNodes) {
-			auto&[passes, commandBuffers] = *node;
-            for (uint32_t i = 0; i < m_frameCount; i++) {
-                commandBuffers.emplace_back(Context::Device().RequestCommandBuffer(queue));
-            }
-        }
-
-		// TODO: Delete this:
-
-
-		auto* vertexShader = Shader::Manager::Get().GetShader("wireframe", "vertexMain");
-		auto* hullShader = Shader::Manager::Get().GetShader("wireframe", "hullMain");
-		auto* domainShader = Shader::Manager::Get().GetShader("wireframe", "domainMain");
-		// auto* geometryShader = Shader::Manager::Get().GetShader("wireframe", "geometryMain");
-		auto* fragmentShader = Shader::Manager::Get().GetShader("wireframe", "fragmentMain");
-
-		// const auto vertexShader = Core::Shader("wireframe/wireframe.vert");
-		// const auto fragmentShader = Core::Shader("wireframe/wireframe.frag");
-
-		auto pipelineBuilder = std::make_unique<Graphics::Pipeline::Builder>(*m_renderPasses.at("color"));
-		(*pipelineBuilder)
-			.AddShader(vertexShader)
-			.AddShader(hullShader)
-			.AddShader(domainShader)
-			// .AddShader(geometryShader)
-			.AddShader(fragmentShader)
-			.Rasterizer(vk::PipelineRasterizationStateCreateInfo()
-				.setPolygonMode(vk::PolygonMode::eFill)
-				.setCullMode(vk::CullModeFlagBits::eNone)
-				.setFrontFace(vk::FrontFace::eClockwise)
-				.setLineWidth(1.0f))
-			.InputAssemblyState(vk::PipelineInputAssemblyStateCreateInfo()
-				.setTopology(vk::PrimitiveTopology::ePatchList)
-				.setPrimitiveRestartEnable(vk::False))
-			.Tessellation(vk::PipelineTessellationStateCreateInfo()
-				.setPatchControlPoints(3));
-
-		m_pipelineBuilder = pipelineBuilder.get();
-		m_renderPasses.at("color")->AddPipeline(std::move(pipelineBuilder));
-
-		// ------------------
-
-		if (m_guiEnabled) {
 			const auto guiCreateInfo = Reef::Manager::CreateInfo {
-				.queue = *m_queues.at(vk::QueueFlagBits::eGraphics),
+				.queue = queue,
 				.renderPass = *m_guiRenderPass,
 				.frameCount = m_frameCount,
 				.imageFormat = vk::Format::eB8G8R8A8Unorm,
@@ -300,8 +160,7 @@ namespace Coral::Project {
 				m_guiCommandBuffers.emplace_back(Context::Device().RequestCommandBuffer(queue));
 			}
 
-			auto& finalRenderPass = *m_renderPasses.at("color").get();
-			m_viewport = Reef::MakeContainer<Reef::Viewport>(finalRenderPass);
+			m_viewport = Reef::MakeContainer<Reef::Viewport>(m_images.at(m_compiled.output));
 		}
 	}
 
@@ -309,8 +168,495 @@ namespace Coral::Project {
 		m_viewport.reset();
 	}
 
-	void RenderGraph::Update(const float deltaTime) const
+	void RenderGraph::Build(RenderGraphCompiler::Result compiled) {
+		std::vector<std::vector<AttachmentUse>> uses;
+		for (const auto& pass : compiled.passes) {
+			uses.emplace_back(Uses(pass));
+		}
+
+		std::vector<std::vector<AttachmentUse>> previousUses;
+		for (const auto& pass : m_compiled.passes) {
+			previousUses.emplace_back(Uses(pass));
+		}
+
+		// The viewport holds on to the output images, it is recreated once the images are in place
+		m_viewport.reset();
+
+		// Aliasing depends on how every pass uses the images, so they are only kept if neither changed
+		const bool keepImages = !m_images.empty() && compiled.resources == m_compiled.resources && uses == previousUses;
+		if (!keepImages) {
+			ForgetImages();
+			m_images.clear();
+			m_imageStorage.clear();
+			m_transientPool = std::make_unique<Memory::TransientPool>();
+
+			const Math::Vector3u extent = { static_cast<u32>(m_extent.x), static_cast<u32>(m_extent.y), 1u };
+			boost::unordered_map<String, Memory::Image::Builder> builders;
+			for (const auto& resource : compiled.resources) {
+				auto builder = Memory::Image::Builder()
+					.Format(resource.format)
+					.Extent(extent)
+					.SampleCount(resource.samples)
+					.InitialLayout(resource.initialLayout);
+				for (u32 bit = 0; bit < 32; bit++) {
+					if (const auto usage = static_cast<vk::ImageUsageFlagBits>(1u << bit); resource.usage & usage) {
+						builder.UsageFlags(usage);
+					}
+				}
+				builders.emplace(resource.name, std::move(builder));
+			}
+			m_lifetimes = AnalyzeLifetimes(uses);
+			CreateImages(builders, m_lifetimes);
+		}
+
+		std::unordered_map<std::string, std::unique_ptr<Graphics::RenderPass>> renderPasses;
+		std::unordered_map<std::string, std::unique_ptr<Compute::Pipeline>> computePipelines;
+		for (const auto& pass : compiled.passes) {
+			const auto previous = std::ranges::find(m_compiled.passes, pass.name, &RenderGraphCompiler::Pass::name);
+			const bool unchanged = previous != m_compiled.passes.end() && *previous == pass;
+			if (pass.dispatch) {
+				// Descriptor sets are written every frame, so the pipeline does not depend on the images
+				if (const auto existing = m_computePipelines.find(pass.name); existing != m_computePipelines.end() && unchanged) {
+					computePipelines.emplace(pass.name, std::move(existing->second));
+				} else {
+					auto* shader = Shader::Manager::Get().GetShader(pass.dispatch->module, pass.dispatch->entryPoint);
+					computePipelines.emplace(pass.name, std::make_unique<Compute::Pipeline>(shader, shader->EntryPointName()));
+				}
+				continue;
+			}
+			if (!pass.Rasterizes()) {
+				continue;
+			}
+			if (const auto existing = m_renderPasses.find(pass.name); existing != m_renderPasses.end() && unchanged) {
+				// Only the images changed, the pass and its pipelines stay
+				if (!keepImages) {
+					for (u32 i = 0; i < pass.attachments.size(); i++) {
+						existing->second->SetAttachmentImages(i, m_images.at(pass.attachments[i].resource));
+					}
+				}
+				renderPasses.emplace(pass.name, std::move(existing->second));
+				continue;
+			}
+			renderPasses.emplace(pass.name, CreateRenderPass(pass));
+		}
+		m_renderPasses = std::move(renderPasses);
+		m_computePipelines = std::move(computePipelines);
+
+		m_pipelineBuilder = nullptr;
+		for (const auto& pass : compiled.passes) {
+			if (const auto renderPass = m_renderPasses.find(pass.name);
+				renderPass != m_renderPasses.end() && renderPass->second->PipelineCount() > 0) {
+				m_pipelineBuilder = &renderPass->second->PipelineBuilder(0);
+				break;
+			}
+		}
+
+		if (compiled.runNodes != m_compiled.runNodes) {
+			m_runNodes.clear();
+			for (const auto& description : compiled.runNodes) {
+				const auto& queue = Queue(description.queue);
+				auto& node = *m_runNodes.emplace_back(std::make_unique<RunNode>(description));
+				for (uint32_t i = 0; i < m_frameCount; i++) {
+					node.commandBuffers.emplace_back(Context::Device().RequestCommandBuffer(queue));
+				}
+			}
+		}
+
+		for (const auto& culled : compiled.culled) {
+			std::cout << "RenderGraph::Build : Culled pass " << culled << " as it does not contribute to " << compiled.output << std::endl;
+		}
+		m_compiled = std::move(compiled);
+		PlanReleases();
+
+		if (m_guiManager) {
+			m_viewport = Reef::MakeContainer<Reef::Viewport>(m_images.at(m_compiled.output));
+			if (Context::HasGUI()) {
+				OnGUIAttach();
+			}
+		}
+	}
+
+	std::unique_ptr<Graphics::RenderPass> RenderGraph::CreateRenderPass(const RenderGraphCompiler::Pass& pass) const {
+		Graphics::RenderPass::Builder builder;
+		builder.OutputImageIndex(pass.outputAttachmentIndex)
+			.Extent({ static_cast<u32>(m_extent.x), static_cast<u32>(m_extent.y) })
+			.ImageCount(m_frameCount)
+			.DynamicRendering(m_dynamicRendering);
+
+		for (u32 i = 0; i < pass.attachments.size(); i++) {
+			const auto& attachment = pass.attachments[i];
+			builder.Attachment(i, Graphics::RenderPass::Attachment {
+				.description = attachment.description,
+				.reference = vk::AttachmentReference(i, attachment.description.finalLayout),
+				.images = m_images.at(attachment.resource),
+				.clearValue = attachment.clearValue
+			});
+		}
+		for (const auto& subpass : pass.subpasses) {
+			builder.Subpass(subpass);
+		}
+		for (const auto& dependency : pass.dependencies) {
+			builder.Dependency(dependency);
+		}
+
+		auto stages = vk::PipelineStageFlags2();
+		auto access = vk::AccessFlags2();
+		for (const auto& state : AttachmentStates(pass)) {
+			stages |= state.stages;
+			access |= state.access;
+		}
+		AddExternalDependencies(builder, static_cast<u32>(pass.subpasses.size()), stages, access);
+
+		auto renderPass = builder.Build();
+		for (const auto& pipeline : pass.pipelines) {
+			auto pipelineBuilder = std::make_unique<Graphics::Pipeline::Builder>(*renderPass);
+			pipelineBuilder->Subpass(pipeline.subpass);
+			for (const auto& entryPoint : pipeline.entryPoints) {
+				pipelineBuilder->AddShader(Shader::Manager::Get().GetShader(pipeline.module, entryPoint));
+			}
+			(*pipelineBuilder)
+				.Rasterizer(vk::PipelineRasterizationStateCreateInfo()
+					.setPolygonMode(pipeline.polygonMode)
+					.setCullMode(pipeline.cullMode)
+					.setFrontFace(pipeline.frontFace)
+					.setLineWidth(1.0f))
+				.InputAssemblyState(vk::PipelineInputAssemblyStateCreateInfo()
+					.setTopology(pipeline.topology)
+					.setPrimitiveRestartEnable(vk::False));
+			if (pipeline.patchControlPoints > 0) {
+				pipelineBuilder->Tessellation(vk::PipelineTessellationStateCreateInfo()
+					.setPatchControlPoints(pipeline.patchControlPoints));
+			}
+			renderPass->AddPipeline(std::move(pipelineBuilder));
+		}
+		return renderPass;
+	}
+
+	std::vector<Graphics::BarrierTracker::State> RenderGraph::AttachmentStates(const RenderGraphCompiler::Pass& pass) const {
+		const auto queueFamily = Queue(vk::QueueFlagBits::eGraphics).Family().Index();
+		std::vector states(pass.attachments.size(), Graphics::BarrierTracker::State { .queueFamily = queueFamily });
+
+		const auto use = [&](const vk::AttachmentReference& reference, const vk::PipelineStageFlags2 stages, const vk::AccessFlags2 access) {
+			if (reference.attachment == vk::AttachmentUnused) {
+				return;
+			}
+			auto& state = states.at(reference.attachment);
+			if (!state.stages) {
+				state.layout = reference.layout;
+			}
+			state.stages |= stages;
+			state.access |= access;
+		};
+
+		for (const auto& subpass : pass.subpasses) {
+			for (const auto& reference : subpass.colorAttachments) {
+				use(reference, vk::PipelineStageFlagBits2::eColorAttachmentOutput, vk::AccessFlagBits2::eColorAttachmentWrite);
+			}
+			for (const auto& reference : subpass.resolveAttachments) {
+				use(reference, vk::PipelineStageFlagBits2::eColorAttachmentOutput, vk::AccessFlagBits2::eColorAttachmentWrite);
+			}
+			for (const auto& reference : subpass.inputAttachments) {
+				use(reference, vk::PipelineStageFlagBits2::eFragmentShader, vk::AccessFlagBits2::eInputAttachmentRead);
+			}
+			if (const auto& reference = subpass.depthStencilAttachment) {
+				const bool readOnly = reference->layout == vk::ImageLayout::eDepthStencilReadOnlyOptimal ||
+					reference->layout == vk::ImageLayout::eDepthReadOnlyOptimal;
+				use(*reference, vk::PipelineStageFlagBits2::eEarlyFragmentTests | vk::PipelineStageFlagBits2::eLateFragmentTests,
+					readOnly ? vk::AccessFlagBits2::eDepthStencilAttachmentRead
+						: vk::AccessFlagBits2::eDepthStencilAttachmentRead | vk::AccessFlagBits2::eDepthStencilAttachmentWrite);
+			}
+		}
+
+		// Loading happens in the stage that first uses the attachment and reads what the previous pass left there
+		for (u32 i = 0; i < states.size(); i++) {
+			const auto& description = pass.attachments[i].description;
+			if (description.loadOp == vk::AttachmentLoadOp::eLoad && states[i].stages & vk::PipelineStageFlagBits2::eColorAttachmentOutput) {
+				states[i].access |= vk::AccessFlagBits2::eColorAttachmentRead;
+			}
+		}
+		return states;
+	}
+
+	std::vector<RenderGraph::ImageState> RenderGraph::RequiredStates(const RenderGraphCompiler::Pass& pass) const {
+		const auto queueFamily = Queue(pass.queue).Family().Index();
+		std::vector<ImageState> states;
+
+		if (pass.Rasterizes()) {
+			const auto& renderPass = *m_renderPasses.at(pass.name);
+			const auto attachmentStates = AttachmentStates(pass);
+			for (u32 i = 0; i < pass.attachments.size(); i++) {
+				const auto& attachment = pass.attachments[i];
+				auto state = attachmentStates[i];
+				if (renderPass.DynamicRendering()) {
+					// Nothing transitions the attachment once rendering begins, so it has to be in the subpass layout already
+					state.discard = attachment.description.initialLayout == vk::ImageLayout::eUndefined;
+				} else {
+					// An undefined initial layout lets the render pass discard the contents itself
+					state.layout = attachment.description.initialLayout;
+				}
+				states.emplace_back(ImageState { .image = attachment.resource, .state = state });
+			}
+		}
+
+		if (pass.dispatch) {
+			for (const auto& binding : pass.dispatch->bindings) {
+				if (binding.type == vk::DescriptorType::eCombinedImageSampler) {
+					states.emplace_back(ImageState { .image = binding.resource, .state = {
+						.layout = vk::ImageLayout::eShaderReadOnlyOptimal,
+						.stages = vk::PipelineStageFlagBits2::eComputeShader,
+						.access = vk::AccessFlagBits2::eShaderSampledRead,
+						.queueFamily = queueFamily,
+					}});
+					continue;
+				}
+				auto access = vk::AccessFlags2();
+				if (binding.read) {
+					access |= vk::AccessFlagBits2::eShaderStorageRead;
+				}
+				if (binding.write) {
+					access |= vk::AccessFlagBits2::eShaderStorageWrite;
+				}
+				states.emplace_back(ImageState { .image = binding.resource, .state = {
+					.layout = vk::ImageLayout::eGeneral,
+					.stages = vk::PipelineStageFlagBits2::eComputeShader,
+					.access = access,
+					.queueFamily = queueFamily,
+					.discard = !binding.read,
+				}});
+			}
+		}
+
+		for (const auto& copy : pass.copies) {
+			states.emplace_back(ImageState { .image = copy.source, .state = {
+				.layout = vk::ImageLayout::eTransferSrcOptimal,
+				.stages = vk::PipelineStageFlagBits2::eCopy,
+				.access = vk::AccessFlagBits2::eTransferRead,
+				.queueFamily = queueFamily,
+			}});
+			states.emplace_back(ImageState { .image = copy.destination, .state = {
+				.layout = vk::ImageLayout::eTransferDstOptimal,
+				.stages = vk::PipelineStageFlagBits2::eCopy,
+				.access = vk::AccessFlagBits2::eTransferWrite,
+				.queueFamily = queueFamily,
+				.discard = true,
+			}});
+		}
+		return states;
+	}
+
+	void RenderGraph::RequireImages(const RenderGraphCompiler::Pass& pass, const u32 passIndex, const u32 frameIndex) {
+		const auto& transientStatistics = m_transientPool->Stats();
+
+		for (const auto& [image, state] : RequiredStates(pass)) {
+			m_barriers.Require(*m_images.at(image)[frameIndex], state);
+
+			// Memory shared with other transient images was last written through another handle, which the tracker cannot see
+			if (const auto lifetime = m_lifetimes.find(image);
+				lifetime != m_lifetimes.end() && lifetime->second.transient && lifetime->second.lifetime.first == passIndex &&
+				transientStatistics.slotCount < transientStatistics.imageCount) {
+				m_barriers.GlobalBarrier(AliasStages, AliasWrites, state.stages, state.access);
+			}
+		}
+	}
+
+	void RenderGraph::AssumeAttachments(const RenderGraphCompiler::Pass& pass, const Graphics::RenderPass& renderPass, const u32 frameIndex) {
+		const auto states = AttachmentStates(pass);
+		for (u32 i = 0; i < pass.attachments.size(); i++) {
+			const auto& attachment = pass.attachments[i];
+			auto state = states[i];
+			// Final layouts are only applied by render pass objects, otherwise the next user transitions the image
+			if (!renderPass.DynamicRendering()) {
+				state.layout = attachment.description.finalLayout;
+			}
+			m_barriers.Assume(*m_images.at(attachment.resource)[frameIndex], state);
+		}
+	}
+
+	void RenderGraph::PlanReleases() {
+		struct Use {
+			u32 node;
+			Graphics::BarrierTracker::State state;
+		};
+		// Consumers of the output after the graph, the GUI or the final copy, are not part of any node
+		constexpr auto external = std::numeric_limits<u32>::max();
+
+		boost::unordered_map<String, std::vector<Use>> uses;
+		for (u32 node = 0; node < m_compiled.runNodes.size(); node++) {
+			for (const auto& name : m_compiled.runNodes[node].passes) {
+				for (const auto& [image, state] : RequiredStates(*std::ranges::find(m_compiled.passes, name, &RenderGraphCompiler::Pass::name))) {
+					uses[image].emplace_back(Use { .node = node, .state = state });
+				}
+			}
+		}
+		uses[m_compiled.output].emplace_back(Use { .node = external, .state = {
+			.layout = m_guiEnabled ? vk::ImageLayout::eShaderReadOnlyOptimal : vk::ImageLayout::eTransferSrcOptimal,
+			.queueFamily = Queue(vk::QueueFlagBits::eGraphics).Family().Index(),
+		}});
+
+		m_releases.assign(m_compiled.runNodes.size(), {});
+		for (const auto& [image, imageUses] : uses) {
+			for (u32 i = 0; i < imageUses.size(); i++) {
+				// The last use hands the image over to the first one of the next frame
+				const auto& use = imageUses[i];
+				const auto& next = imageUses[(i + 1) % imageUses.size()];
+				// Discarded contents need no ownership transfer, the semaphore between the nodes is enough
+				if (use.node == external || next.node == use.node || next.state.discard || next.state.queueFamily == use.state.queueFamily) {
+					continue;
+				}
+				m_releases[use.node].emplace_back(Release { .image = image, .queueFamily = next.state.queueFamily, .layout = next.state.layout });
+			}
+		}
+	}
+
+	void RenderGraph::RecordDispatch(const RenderGraphCompiler::Pass& pass, const Core::CommandBuffer& commandBuffer, const Core::Frame& frame) const {
+		const auto& dispatch = *pass.dispatch;
+		const auto& pipeline = *m_computePipelines.at(pass.name);
+		const auto& setLayouts = pipeline.Layout().SetLayouts();
+
+		std::map<u32, std::vector<const RenderGraphCompiler::Binding*>> sets;
+		for (const auto& binding : dispatch.bindings) {
+			if (binding.set >= setLayouts.size()) {
+				std::cerr << "RenderGraph::RecordDispatch : " << dispatch.module << "::" << dispatch.entryPoint << " has no set " << binding.set
+					<< ", pass " << pass.name << " is skipped" << std::endl;
+				return;
+			}
+			sets[binding.set].emplace_back(&binding);
+		}
+
+		pipeline.Bind(*commandBuffer);
+		for (const auto& [set, bindings] : sets) {
+			// Allocated from the frame's pool, which is reset once the frame retires
+			Memory::Descriptor::Set::Builder builder(frame.DescriptorAllocator(), *setLayouts[set]);
+			for (const auto* binding : bindings) {
+				const bool sampled = binding->type == vk::DescriptorType::eCombinedImageSampler;
+				const auto& view = Memory::ImageView::Builder(*m_images.at(binding->resource)[frame.Index()])
+					.ViewType(vk::ImageViewType::e2D)
+					.BaseMipLevel(0)
+					.LevelCount(1)
+					.Acquire();
+				builder.WriteImage(binding->binding, vk::DescriptorImageInfo()
+					.setSampler(sampled ? **m_sampler : nullptr)
+					.setImageView(*view)
+					.setImageLayout(sampled ? vk::ImageLayout::eShaderReadOnlyOptimal : vk::ImageLayout::eGeneral));
+			}
+			pipeline.BindDescriptorSet(set, *commandBuffer, *builder.Build());
+		}
+
+		const auto width = static_cast<u32>(m_extent.x);
+		const auto height = static_cast<u32>(m_extent.y);
+		commandBuffer->dispatch((width + dispatch.groupSizeX - 1) / dispatch.groupSizeX, (height + dispatch.groupSizeY - 1) / dispatch.groupSizeY, 1);
+	}
+
+	void RenderGraph::RecordCopies(const RenderGraphCompiler::Pass& pass, const Core::CommandBuffer& commandBuffer, const u32 frameIndex) const {
+		for (const auto& copy : pass.copies) {
+			const auto& source = *m_images.at(copy.source)[frameIndex];
+			const auto& destination = *m_images.at(copy.destination)[frameIndex];
+			const auto layers = vk::ImageSubresourceLayers(Graphics::BarrierTracker::AspectMask(source.Format()), 0, 0, source.LayerCount());
+			commandBuffer->copyImage(*source, vk::ImageLayout::eTransferSrcOptimal, *destination, vk::ImageLayout::eTransferDstOptimal,
+				vk::ImageCopy()
+					.setSrcSubresource(layers)
+					.setDstSubresource(layers)
+					.setExtent(vk::Extent3D(source.Extent())));
+		}
+	}
+
+	void RenderGraph::ForgetImages() {
+		for (const auto& images : m_images | std::views::values) {
+			for (const auto* image : images) {
+				m_barriers.Forget(*image);
+			}
+		}
+	}
+
+	std::vector<RenderGraph::AttachmentUse> RenderGraph::Uses(const RenderGraphCompiler::Pass& pass) {
+		std::vector<AttachmentUse> uses;
+		for (const auto& attachment : pass.attachments) {
+			uses.emplace_back(AttachmentUse { .image = attachment.resource, .description = attachment.description });
+		}
+		if (pass.dispatch) {
+			for (const auto& binding : pass.dispatch->bindings) {
+				uses.emplace_back(AttachmentUse { .image = binding.resource, .attachment = false });
+			}
+		}
+		for (const auto& copy : pass.copies) {
+			uses.emplace_back(AttachmentUse { .image = copy.source, .attachment = false });
+			uses.emplace_back(AttachmentUse { .image = copy.destination, .attachment = false });
+		}
+		return uses;
+	}
+
+	boost::unordered_map<String, RenderGraph::ImageLifetime> RenderGraph::AnalyzeLifetimes(const std::vector<std::vector<AttachmentUse>>& passes) {
+		boost::unordered_map<String, ImageLifetime> lifetimes;
+		boost::unordered_map<String, vk::AttachmentDescription> lastUses;
+
+		for (u32 pass = 0; pass < passes.size(); pass++) {
+			for (const auto& [image, description, attachment] : passes[pass]) {
+				if (const auto it = lifetimes.find(image); it != lifetimes.end()) {
+					it->second.lifetime.last = pass;
+					it->second.transient &= attachment;
+				} else {
+					// Memory shared with other images holds garbage, so the first use must neither load nor expect a layout
+					const bool discardsPrevious = description.loadOp != vk::AttachmentLoadOp::eLoad &&
+						description.stencilLoadOp != vk::AttachmentLoadOp::eLoad &&
+						description.initialLayout == vk::ImageLayout::eUndefined;
+					lifetimes.emplace(image, ImageLifetime { .lifetime = { pass, pass }, .transient = attachment && discardsPrevious });
+				}
+				lastUses.insert_or_assign(image, description);
+			}
+		}
+
+		for (auto& [image, imageLifetime] : lifetimes) {
+			const auto& lastUse = lastUses.at(image);
+			imageLifetime.transient &= lastUse.storeOp == vk::AttachmentStoreOp::eDontCare &&
+				lastUse.stencilStoreOp == vk::AttachmentStoreOp::eDontCare;
+			imageLifetime.lazilyAllocated = imageLifetime.transient && imageLifetime.lifetime.first == imageLifetime.lifetime.last;
+		}
+		return lifetimes;
+	}
+
+	void RenderGraph::CreateImages(boost::unordered_map<String, Memory::Image::Builder>& builders,
+		const boost::unordered_map<String, ImageLifetime>& lifetimes) {
+		constexpr auto attachmentUsages = vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eDepthStencilAttachment |
+			vk::ImageUsageFlagBits::eInputAttachment;
+
+		for (auto& [id, builder] : builders) {
+			const auto lifetime = lifetimes.find(id);
+			if (lifetime == lifetimes.end() || !lifetime->second.transient) {
+				auto& images = m_images[id];
+				for (u32 i = 0; i < m_frameCount; i++) {
+					images.emplace_back(m_imageStorage.emplace_back(builder.Build()).get());
+				}
+				continue;
+			}
+
+			// Lazily allocated memory is only valid for images used as nothing but attachments
+			const bool attachmentOnly = std::ranges::all_of(builder.m_usageFlagsSet, [&](const vk::ImageUsageFlagBits usage) {
+				return static_cast<bool>(attachmentUsages & usage);
+			});
+			if (lifetime->second.lazilyAllocated && attachmentOnly) {
+				builder.Transient();
+			}
+			// Each pass starts the image from an undefined layout
+			builder.InitialLayout(vk::ImageLayout::eUndefined);
+
+			auto& image = m_transientPool->Add(builder, lifetime->second.lifetime);
+			m_images[id] = std::vector(m_frameCount, &image);
+		}
+		m_transientPool->Bind();
+	}
+
+	void RenderGraph::Update(const float deltaTime)
 	{
+		// A broken description is reported by the compiler and the current graph keeps running. Whatever the rebuild
+		// replaces retires with the frames still using it. The file is only checked a few times a second.
+		m_recompileTimer += deltaTime;
+		if (m_recompileTimer >= RecompileInterval) {
+			m_recompileTimer = 0.0f;
+			if (auto compiled = m_compiler->CompileIfChanged(); compiled && *compiled != m_compiled) {
+				Build(std::move(*compiled));
+			}
+		}
+
 		for (const auto& renderPass : m_renderPasses | std::views::values) {
 			renderPass->Update(deltaTime);
 		}
@@ -319,94 +665,140 @@ namespace Coral::Project {
 		}
 	}
 
-	void RenderGraph::Execute(const Core::Frame& frame) {
-		const auto& queue = *m_queues.at(vk::QueueFlagBits::eGraphics);
-		for (int i = 0; i < m_runNodes.size(); i++) {
-			const auto& commandBuffer = *m_runNodes[i]->commandBuffers[frame.ImageIndex()];
-			const auto& commands = m_runNodes[i]->passes;
+	void RenderGraph::Execute(const Core::Frame& frame, std::vector<Core::Queue::Submission>& submissions) {
+		const auto& graphicsQueue = Queue(vk::QueueFlagBits::eGraphics);
+		const auto queueFamily = graphicsQueue.Family().Index();
+
+		// Timeline value each node signals. Graphics values follow from the position in submissions, the caller
+		// submits them after the other queues, which timeline semaphores allow to wait on values not yet signaled.
+		std::vector<u64> signaled(m_runNodes.size(), 0);
+		std::vector<std::pair<const Core::Queue*, std::vector<Core::Queue::Submission>>> otherSubmissions;
+		// Last value of every other queue no graphics submission waits on yet
+		std::unordered_map<const Core::Queue*, u64> unwaited;
+
+		for (u32 n = 0; n < m_runNodes.size(); n++) {
+			const auto& node = *m_runNodes[n];
+			const auto& queue = Queue(node.description.queue);
+			const auto& commandBuffer = *node.commandBuffers[frame.Index()];
 
             commandBuffer->reset(vk::CommandBufferResetFlagBits::eReleaseResources);
 			commandBuffer->begin(vk::CommandBufferBeginInfo().setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
 
-			for (const auto& renderPass : commands) {
-				m_renderPasses.at(renderPass)->Begin(commandBuffer, frame.ImageIndex());
-				m_renderPasses.at(renderPass)->Draw(commandBuffer);
-				m_renderPasses.at(renderPass)->End(commandBuffer);
+			for (const auto& name : node.description.passes) {
+				const auto pass = std::ranges::find(m_compiled.passes, name, &RenderGraphCompiler::Pass::name);
+
+				RequireImages(*pass, static_cast<u32>(std::distance(m_compiled.passes.begin(), pass)), frame.Index());
+				m_barriers.Flush(*commandBuffer);
+				if (pass->Rasterizes()) {
+					auto& renderPass = *m_renderPasses.at(name);
+					renderPass.Begin(commandBuffer, frame.Index());
+					renderPass.Draw(commandBuffer);
+					renderPass.End(commandBuffer);
+					AssumeAttachments(*pass, renderPass, frame.Index());
+				} else if (pass->dispatch) {
+					RecordDispatch(*pass, commandBuffer, frame);
+				} else {
+					RecordCopies(*pass, commandBuffer, frame.Index());
+				}
+			}
+			for (const auto& release : m_releases[n]) {
+				m_barriers.Release(*m_images.at(release.image)[frame.Index()], release.queueFamily, release.layout);
 			}
+			m_barriers.Flush(*commandBuffer);
 			commandBuffer->end();
 
-			const auto commandBuffers = std::array { *commandBuffer };
-
-			std::vector<vk::Semaphore> waitSemaphores;
-			if (i > 0) {
-				const auto& previousCommandBuffer = *m_runNodes[i - 1]->commandBuffers[frame.ImageIndex()];
-				waitSemaphores.emplace_back(previousCommandBuffer.SignalSemaphore());
-			} else {
-				waitSemaphores.emplace_back(frame.ImageAvailable());
+			auto submission = Core::Queue::Submission { .commandBuffers = { *commandBuffer } };
+			for (const auto wait : node.description.waits) {
+				// Without a dedicated queue both nodes went to the same one, which keeps them in order already
+				const auto& waitQueue = Queue(m_runNodes[wait]->description.queue);
+				if (&waitQueue == &queue) {
+					continue;
+				}
+				submission.waitSemaphores.emplace_back(waitQueue.TimelineWait(signaled[wait], vk::PipelineStageFlagBits2::eAllCommands));
+				if (const auto value = unwaited.find(&waitQueue); &queue == &graphicsQueue && value != unwaited.end() && value->second <= signaled[wait]) {
+					unwaited.erase(value);
+				}
 			}
 
-			constexpr auto destMask = vk::PipelineStageFlags()
-				| vk::PipelineStageFlagBits::eColorAttachmentOutput;
-
-			std::vector signalSemaphores = {
-				commandBuffer.SignalSemaphore()
-			};
-
-			if (!m_guiEnabled && i == m_runNodes.size() - 1) {
-				signalSemaphores.emplace_back(frame.ReadyToPresent());
+			if (&queue == &graphicsQueue) {
+				signaled[n] = graphicsQueue.SubmittedValue() + submissions.size() + 1;
+				submissions.emplace_back(std::move(submission));
+				continue;
+			}
+			auto batch = std::ranges::find(otherSubmissions, &queue, &decltype(otherSubmissions)::value_type::first);
+			if (batch == otherSubmissions.end()) {
+				batch = otherSubmissions.emplace(otherSubmissions.end(), &queue, std::vector<Core::Queue::Submission>());
 			}
+			signaled[n] = queue.SubmittedValue() + batch->second.size() + 1;
+			batch->second.emplace_back(std::move(submission));
+			unwaited[&queue] = signaled[n];
+		}
 
-			const auto submitInfo = vk::SubmitInfo()
-				.setCommandBuffers(commandBuffers)
-				.setWaitSemaphores(waitSemaphores)
-				.setSignalSemaphores(signalSemaphores)
-				.setWaitDstStageMask(destMask);
+		for (const auto& [queue, batch] : otherSubmissions) {
+			queue->Submit(batch);
+		}
 
-			try {
-                queue->submit(submitInfo);
-            } catch (const vk::OutOfDateKHRError&) {
-                // Recreate framebuffers
-            }
+		// The frame is retired through the graphics timeline, so it has to cover the work of the other queues as well
+		std::vector<vk::SemaphoreSubmitInfo> tailWaits;
+		for (const auto& [queue, value] : unwaited) {
+			tailWaits.emplace_back(queue->TimelineWait(value, vk::PipelineStageFlagBits2::eAllCommands));
 		}
 
 		if (m_guiEnabled) {
-            const auto& guiCommandBuffer = *m_guiCommandBuffers[frame.ImageIndex()];
+            const auto& guiCommandBuffer = *m_guiCommandBuffers[frame.Index()];
             guiCommandBuffer->reset(vk::CommandBufferResetFlagBits::eReleaseResources);
 
             guiCommandBuffer->begin(vk::CommandBufferBeginInfo().setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
-			m_guiRenderPass->Begin(guiCommandBuffer, frame.ImageIndex());
+
+			// The viewport samples the scene output from the fragment shader
+			m_barriers.Require(*m_images.at(m_compiled.output)[frame.Index()], {
+				.layout = vk::ImageLayout::eShaderReadOnlyOptimal,
+				.stages = vk::PipelineStageFlagBits2::eFragmentShader,
+				.access = vk::AccessFlagBits2::eShaderSampledRead,
+				.queueFamily = queueFamily,
+			});
+			const auto guiState = Graphics::BarrierTracker::State {
+				.layout = vk::ImageLayout::eColorAttachmentOptimal,
+				.stages = vk::PipelineStageFlagBits2::eColorAttachmentOutput,
+				.access = vk::AccessFlagBits2::eColorAttachmentWrite,
+				.queueFamily = queueFamily,
+				// Cleared on load
+				.discard = true,
+			};
+			m_barriers.Require(*m_guiImages[frame.Index()], guiState);
+			m_barriers.Flush(*guiCommandBuffer);
+
+			m_guiRenderPass->Begin(guiCommandBuffer, frame.Index());
             m_guiManager->Render(guiCommandBuffer);
 			m_guiRenderPass->End(guiCommandBuffer);
 			guiCommandBuffer->end();
+			m_barriers.Assume(*m_guiImages[frame.Index()], guiState);
 
-            const auto guiCommandBuffers = std::array { *guiCommandBuffer };
-
-			constexpr auto destMask = vk::PipelineStageFlags()
-				| vk::PipelineStageFlagBits::eColorAttachmentOutput;
-
-			std::vector signalSemaphores = { frame.ReadyToPresent() };
-
-            const auto guiSubmitInfo = vk::SubmitInfo()
-                .setCommandBuffers(guiCommandBuffers)
-                .setWaitSemaphores(m_runNodes.back()->commandBuffers[frame.ImageIndex()]->SignalSemaphore())
-                .setSignalSemaphores(signalSemaphores)
-                .setWaitDstStageMask(destMask);
-
-            try {
-                queue->submit(guiSubmitInfo);
-            } catch (const vk::OutOfDateKHRError&) {
-                // Recreate framebuffers
-            }
-        }
+			submissions.emplace_back(Core::Queue::Submission { .commandBuffers = { *guiCommandBuffer }, .waitSemaphores = std::move(tailWaits) });
+        } else if (!tailWaits.empty()) {
+			submissions.emplace_back(Core::Queue::Submission { .waitSemaphores = std::move(tailWaits) });
+		}
 	}
 
 	void RenderGraph::Resize(const Math::Vector2<f32>& size, const bool inner) {
+		// The tracker knows the images by their handles, the resizes replace them
 		if (m_guiEnabled && !inner) {
+			for (const auto& image : m_guiImages) {
+				m_barriers.Forget(*image);
+			}
 			m_guiRenderPass->Resize(m_frameCount, size);
 		} else {
+			ForgetImages();
+			m_extent = size;
+			// The pool recreates its images in place, the passes then only rebuild their framebuffers
+			m_transientPool->Resize({ static_cast<u32>(size.x), static_cast<u32>(size.y), 1u });
 			for (const auto& renderPass : m_renderPasses | std::views::values) {
 				renderPass->Resize(m_frameCount, size);
 			}
+			// Images only dispatches and copies touch belong to no render pass
+			for (const auto& image : m_imageStorage) {
+				image->Resize({ static_cast<u32>(size.x), static_cast<u32>(size.y), 1u });
+			}
 		}
 	}
 
@@ -414,18 +806,25 @@ namespace Coral::Project {
 		if (m_guiEnabled) {
             return m_guiRenderPass->OutputImage(frameIndex);
         }
-		const auto lastPassName = m_runNodes.back()->passes.back();
-		return m_renderPasses.at(lastPassName)->OutputImage(frameIndex);
+		return *m_images.at(m_compiled.output)[frameIndex];
 	}
 
-	vk::Semaphore RenderGraph::RenderFinished(const uint32_t frameIndex) const {
-		if (m_guiEnabled) {
-			return m_guiCommandBuffers[frameIndex]->SignalSemaphore();
+	const Core::Queue& RenderGraph::Queue(const vk::QueueFlagBits type) const {
+		if (const auto queue = m_queues.find(type); queue != m_queues.end()) {
+			return *queue->second;
+		}
+		// Compute queues copy as well, graphics queues do everything
+		if (type == vk::QueueFlagBits::eTransfer && m_queues.contains(vk::QueueFlagBits::eCompute)) {
+			return *m_queues.at(vk::QueueFlagBits::eCompute);
 		}
-		return m_runNodes.back()->commandBuffers[frameIndex]->SignalSemaphore();
+		return *m_queues.at(vk::QueueFlagBits::eGraphics);
 	}
 
 	void RenderGraph::OnGUIAttach() {
+		if (!m_pipelineBuilder) {
+			RemoveDockable("Graphics Pipeline");
+			return;
+		}
 		AddDockable("Graphics Pipeline",
 			new Reef::Window(ICON_FA_PAINTBRUSH "   Graphics Pipeline",
 				Reef::Style{
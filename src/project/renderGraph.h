@@ -5,14 +5,17 @@
 #pragma once
 
 #include <boost/unordered_map.hpp>
-#include <boost/uuid/random_generator.hpp>
-#include <boost/uuid/uuid.hpp>
 #include <memory>
 
+#include "compute/pipeline.h"
+#include "graphics/barrierTracker.h"
 #include "graphics/renderPass.h"
 #include "gui/container.h"
 #include "gui/manager.h"
 #include "gui/viewport.h"
+#include "memory/sampler.h"
+#include "memory/transientPool.h"
+#include "renderGraphCompiler.h"
 
 namespace Coral::Core {
     class Frame;
@@ -24,43 +27,125 @@ namespace Coral::Project {
         struct CreateInfo {
             uint32_t frameCount = 2;
             bool guiEnabled = true;
+            // Recompiled whenever the file changes
+            Path description = "assets/renderGraphs/renderGraph.json";
+            // Passes that can render without render pass objects and framebuffers do so
+            bool dynamicRendering = true;
+            // Off keeps the passes apart instead of merging them into subpasses, so each can render dynamically
+            bool mergeSubpasses = true;
         };
 
         struct RunNode {
-            std::vector<std::string> passes;
+            RenderGraphCompiler::RunNode description;
+            // Allocated from the queue the node runs on
             std::vector<std::unique_ptr<Core::CommandBuffer>> commandBuffers {};
 
-            explicit RunNode(std::vector<std::string> passes)
-                : passes(std::move(passes)) {}
+            explicit RunNode(RenderGraphCompiler::RunNode description)
+                : description(std::move(description)) {}
         };
 
+        struct AttachmentUse {
+            String image;
+            vk::AttachmentDescription description;
+            // Dispatches and copies access the image outside of a render pass, it always keeps its contents
+            bool attachment = true;
+
+            bool operator==(const AttachmentUse&) const = default;
+        };
+
+        struct ImageLifetime {
+            Memory::TransientPool::Lifetime lifetime;
+            // Nothing before the first pass is loaded and nothing after the last one is stored
+            bool transient = false;
+            // Transient and confined to a single pass, so it never has to reach memory
+            bool lazilyAllocated = false;
+        };
+
+        // passes holds the uses of every pass in execution order
+        static boost::unordered_map<String, ImageLifetime> AnalyzeLifetimes(const std::vector<std::vector<AttachmentUse>>& passes);
+
         explicit RenderGraph(const CreateInfo& createInfo);
         ~RenderGraph() override;
 
-        void Update(float deltaTime) const;
-        void Execute(const Core::Frame& frame);
+        void Update(float deltaTime);
+        // Records every node for the frame. Graphics nodes are appended to submissions, which the caller has to submit to
+        // Queue(eGraphics) before anything else, the nodes of other queues are submitted right away and wait on them.
+        void Execute(const Core::Frame& frame, std::vector<Core::Queue::Submission>& submissions);
         void Resize(const Math::Vector2<f32>& size, bool inner = false);
 
         [[nodiscard]] const Memory::Image& OutputImage(uint32_t frameIndex) const;
-        [[nodiscard]] vk::Semaphore RenderFinished(uint32_t frameIndex) const;
+        // Falls back to a queue that can do the same work when the device has no dedicated one
+        [[nodiscard]] const Core::Queue& Queue(vk::QueueFlagBits type) const;
+        [[nodiscard]] const Memory::TransientPool& TransientPool() const { return *m_transientPool; }
+        // Knows the state every graph image was left in, work recorded after the graph continues from it
+        [[nodiscard]] Graphics::BarrierTracker& Barriers() { return m_barriers; }
 
 	protected:
 		void OnGUIAttach() override;
 
 	private:
+        struct ImageState {
+            String image;
+            Graphics::BarrierTracker::State state;
+        };
+
+        // Hands an image to the queue family of its next user at the end of a node
+        struct Release {
+            String image;
+            u32 queueFamily;
+            vk::ImageLayout layout;
+        };
+
+        // Every image the pass touches, attachments first
+        static std::vector<AttachmentUse> Uses(const RenderGraphCompiler::Pass& pass);
+        // Transient images get one instance shared by all frames from the transient pool, the others one per frame
+        void CreateImages(boost::unordered_map<String, Memory::Image::Builder>& builders,
+            const boost::unordered_map<String, ImageLifetime>& lifetimes);
+        // Keeps the images and passes the new graph leaves untouched, whatever it replaces retires through the deletion queue
+        void Build(RenderGraphCompiler::Result compiled);
+        [[nodiscard]] std::unique_ptr<Graphics::RenderPass> CreateRenderPass(const RenderGraphCompiler::Pass& pass) const;
+        // Stages, accesses and subpass layout of every attachment of the pass
+        [[nodiscard]] std::vector<Graphics::BarrierTracker::State> AttachmentStates(const RenderGraphCompiler::Pass& pass) const;
+        // The state every image the pass touches has to be in before it begins, owned by the family of its queue
+        [[nodiscard]] std::vector<ImageState> RequiredStates(const RenderGraphCompiler::Pass& pass) const;
+        // Queues the barriers a pass needs before it begins
+        void RequireImages(const RenderGraphCompiler::Pass& pass, u32 passIndex, u32 frameIndex);
+        // Records the layouts the pass leaves its attachments in
+        void AssumeAttachments(const RenderGraphCompiler::Pass& pass, const Graphics::RenderPass& renderPass, u32 frameIndex);
+        // Finds the images whose next user, possibly in the next frame, runs on another queue family
+        void PlanReleases();
+        void RecordDispatch(const RenderGraphCompiler::Pass& pass, const Core::CommandBuffer& commandBuffer, const Core::Frame& frame) const;
+        void RecordCopies(const RenderGraphCompiler::Pass& pass, const Core::CommandBuffer& commandBuffer, u32 frameIndex) const;
+        void ForgetImages();
+
         bool m_guiEnabled = true;
+        bool m_dynamicRendering = true;
         std::unique_ptr<Reef::Manager> m_guiManager;
         std::unique_ptr<Graphics::RenderPass> m_guiRenderPass;
         std::vector<std::unique_ptr<Core::CommandBuffer>> m_guiCommandBuffers;
+        std::vector<std::unique_ptr<Memory::Image>> m_guiImages;
         Reef::Container<Reef::Viewport> m_viewport;
 
-        boost::uuids::random_generator_mt19937 m_generator;
+        // Seconds between checks of the description file for edits
+        static constexpr f32 RecompileInterval = 0.5f;
+
+        std::unique_ptr<RenderGraphCompiler> m_compiler;
+        RenderGraphCompiler::Result m_compiled;
+        f32 m_recompileTimer = 0.0f;
         std::unordered_map<vk::QueueFlagBits, std::unique_ptr<Core::Queue>> m_queues;
         uint32_t m_frameCount;
-        boost::unordered_map<boost::uuids::uuid, std::vector<Memory::Image*>> m_images;
+        Math::Vector2<f32> m_extent;
+        boost::unordered_map<String, std::vector<Memory::Image*>> m_images;
         std::vector<std::unique_ptr<Memory::Image>> m_imageStorage;
+        std::unique_ptr<Memory::TransientPool> m_transientPool;
+        boost::unordered_map<String, ImageLifetime> m_lifetimes;
+        Graphics::BarrierTracker m_barriers;
         std::unordered_map<std::string, std::unique_ptr<Graphics::RenderPass>> m_renderPasses;
+        std::unordered_map<std::string, std::unique_ptr<Compute::Pipeline>> m_computePipelines;
+        std::shared_ptr<const Memory::Sampler> m_sampler;
         std::vector<std::unique_ptr<RunNode>> m_runNodes;
+        // Indexed like m_runNodes
+        std::vector<std::vector<Release>> m_releases;
 
     //  temp:
         std::unique_ptr<Reef::RenderPipelineTemplate> m_pipelineTemplate = nullptr;
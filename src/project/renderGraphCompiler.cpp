@@ -0,0 +1,765 @@
+//
+// Created by radue on 10/17/2026.
+//
+
+#include "renderGraphCompiler.h"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cstring>
+#include <format>
+#include <fstream>
+#include <iostream>
+#include <unordered_map>
+
+#include <nlohmann/json.hpp>
+
+namespace Coral::Project {
+    // Accepts "vk::Format::eD32Sfloat" as well as "eD32Sfloat", Vulkan-Hpp prints the enumerator as "D32Sfloat"
+    static String EnumeratorName(const String& text) {
+        auto name = text.substr(text.rfind("::") == String::npos ? 0 : text.rfind("::") + 2);
+        if (name.size() > 1 && name[0] == 'e' && !std::islower(static_cast<unsigned char>(name[1]))) {
+            name.erase(0, 1);
+        }
+        return name;
+    }
+
+    // Every value vk::to_string has a name for, built once per enum. Core values count up from 0, extension values
+    // sit in blocks of 1000 per extension number above 1000000000, e.g. ePresentSrcKHR.
+    template <typename E>
+    static const std::unordered_map<String, E>& Enumerators() {
+        static const auto enumerators = [] {
+            constexpr u32 CoreValueCount = 1024;
+            constexpr u32 ExtensionBase = 1000000000;
+            constexpr u32 ExtensionCount = 1000;
+            constexpr u32 ValuesPerExtension = 64;
+
+            std::unordered_map<String, E> names;
+            const auto add = [&names](const u32 value) {
+                const auto enumerator = static_cast<E>(value);
+                if (auto name = vk::to_string(enumerator); !name.starts_with("invalid")) {
+                    names.emplace(std::move(name), enumerator);
+                }
+            };
+            for (u32 value = 0; value < CoreValueCount; value++) {
+                add(value);
+            }
+            for (u32 extension = 0; extension < ExtensionCount; extension++) {
+                for (u32 offset = 0; offset < ValuesPerExtension; offset++) {
+                    add(ExtensionBase + extension * 1000 + offset);
+                }
+            }
+            return names;
+        }();
+        return enumerators;
+    }
+
+    template <typename E>
+    static E ParseEnum(const nlohmann::json& value) {
+        const auto& enumerators = Enumerators<E>();
+        if (const auto it = enumerators.find(EnumeratorName(value.get<String>())); it != enumerators.end()) {
+            return it->second;
+        }
+        throw std::runtime_error(std::format("RenderGraphCompiler::Compile : Unknown enumerator '{}'", value.get<String>()));
+    }
+
+    template <typename Bits>
+    static Bits ParseBit(const nlohmann::json& value) {
+        const auto name = EnumeratorName(value.get<String>());
+        for (u32 i = 0; i < 32; i++) {
+            if (const auto bit = static_cast<Bits>(1u << i); vk::to_string(bit) == name) {
+                return bit;
+            }
+        }
+        throw std::runtime_error(std::format("RenderGraphCompiler::Compile : Unknown flag '{}'", value.get<String>()));
+    }
+
+    // A single flag may be given as a string, several as an array
+    template <typename Bits>
+    static vk::Flags<Bits> ParseFlags(const nlohmann::json& value) {
+        if (value.is_string()) {
+            return ParseBit<Bits>(value);
+        }
+        vk::Flags<Bits> flags;
+        for (const auto& bit : value) {
+            flags |= ParseBit<Bits>(bit);
+        }
+        return flags;
+    }
+
+    static vk::AttachmentReference ParseReference(const nlohmann::json& value) {
+        return vk::AttachmentReference()
+            .setAttachment(value.at("attachment").get<u32>())
+            .setLayout(ParseEnum<vk::ImageLayout>(value.at("layout")));
+    }
+
+    static std::vector<vk::AttachmentReference> ParseReferences(const nlohmann::json& pass, const char* key) {
+        std::vector<vk::AttachmentReference> references;
+        if (pass.contains(key)) {
+            for (const auto& reference : pass.at(key)) {
+                references.emplace_back(ParseReference(reference));
+            }
+        }
+        return references;
+    }
+
+    static u32 ParseSubpassIndex(const nlohmann::json& value) {
+        if (value.is_string() && value.get<String>() == "external") {
+            return vk::SubpassExternal;
+        }
+        return value.get<u32>();
+    }
+
+    static vk::QueueFlagBits ParseQueue(const String& queue) {
+        if (queue == "graphics") {
+            return vk::QueueFlagBits::eGraphics;
+        }
+        if (queue == "compute") {
+            return vk::QueueFlagBits::eCompute;
+        }
+        if (queue == "transfer") {
+            return vk::QueueFlagBits::eTransfer;
+        }
+        throw std::runtime_error(std::format("RenderGraphCompiler::Compile : Unknown queue '{}'", queue));
+    }
+
+    static const RenderGraphCompiler::Resource& FindResource(const std::vector<RenderGraphCompiler::Resource>& resources, const String& pass, const String& name) {
+        const auto resource = std::ranges::find(resources, name, &RenderGraphCompiler::Resource::name);
+        if (resource == resources.end()) {
+            throw std::runtime_error(std::format("RenderGraphCompiler::Compile : Pass '{}' uses undeclared resource '{}'", pass, name));
+        }
+        return *resource;
+    }
+
+    static void AddUnique(std::vector<String>& names, const String& name) {
+        if (std::ranges::find(names, name) == names.end()) {
+            names.emplace_back(name);
+        }
+    }
+
+    bool RenderGraphCompiler::Attachment::operator==(const Attachment& other) const {
+        return resource == other.resource && description == other.description &&
+            std::memcmp(&clearValue, &other.clearValue, sizeof(vk::ClearValue)) == 0;
+    }
+
+    RenderGraphCompiler::RenderGraphCompiler(std::filesystem::path path, const bool merge) : m_path(std::move(path)), m_merge(merge) {}
+
+    RenderGraphCompiler::Result RenderGraphCompiler::Compile() {
+        std::ifstream file(m_path);
+        if (!file) {
+            throw std::runtime_error("RenderGraphCompiler::Compile : Failed to open " + m_path.string());
+        }
+        m_lastWriteTime = std::filesystem::last_write_time(m_path);
+        return Compile(nlohmann::json::parse(file), m_merge);
+    }
+
+    std::optional<RenderGraphCompiler::Result> RenderGraphCompiler::CompileIfChanged() {
+        std::error_code error;
+        const auto writeTime = std::filesystem::last_write_time(m_path, error);
+        if (error || writeTime == m_lastWriteTime) {
+            return std::nullopt;
+        }
+
+        try {
+            return Compile();
+        } catch (const std::exception& e) {
+            // Keeps the previous graph running until the description is fixed
+            m_lastWriteTime = writeTime;
+            std::cerr << "Failed to recompile render graph: " << e.what() << std::endl;
+            return std::nullopt;
+        }
+    }
+
+    RenderGraphCompiler::Result RenderGraphCompiler::Compile(const nlohmann::json& description, const bool merge) {
+        const auto resources = ParseResources(description);
+
+        std::vector<Pass> passes;
+        for (const auto& pass : description.at("renderPasses")) {
+            passes.emplace_back(ParsePass(pass, resources));
+            if (std::ranges::count(passes, passes.back().name, &Pass::name) > 1) {
+                throw std::runtime_error(std::format("RenderGraphCompiler::Compile : Pass '{}' declared twice", passes.back().name));
+            }
+        }
+
+        auto result = Result { .output = description.at("output").get<String>() };
+        if (std::ranges::find(resources, result.output, &Resource::name) == resources.end()) {
+            throw std::runtime_error(std::format("RenderGraphCompiler::Compile : Output '{}' is not a declared resource", result.output));
+        }
+
+        std::vector<std::vector<u32>> edges;
+        std::vector<std::vector<u32>> producers;
+        BuildDependencies(passes, edges, producers);
+        const auto order = Sort(passes, edges);
+        const auto live = Cull(passes, producers, result.output);
+
+        std::vector<u32> nodes(passes.size(), UINT32_MAX);
+        for (const auto index : order) {
+            auto& pass = passes[index];
+            if (!live[index]) {
+                result.culled.emplace_back(pass.name);
+                continue;
+            }
+
+            if (merge && !result.passes.empty() && result.passes.back().queue == pass.queue && CanMerge(result.passes.back(), pass)) {
+                Merge(result.passes.back(), std::move(pass));
+                result.runNodes.back().passes.back() = result.passes.back().name;
+            } else {
+                if (result.runNodes.empty() || result.passes.back().queue != pass.queue) {
+                    result.runNodes.emplace_back(RunNode { .queue = pass.queue });
+                }
+                result.runNodes.back().passes.emplace_back(pass.name);
+                result.passes.emplace_back(std::move(pass));
+            }
+            nodes[index] = static_cast<u32>(result.runNodes.size() - 1);
+
+            if (std::ranges::find(result.passes.back().writes, result.output) != result.passes.back().writes.end()) {
+                result.outputPass = result.passes.back().name;
+            }
+        }
+
+        // Barriers only order passes recorded on the same queue, every edge between queues becomes a semaphore wait
+        for (u32 from = 0; from < edges.size(); from++) {
+            for (const auto to : edges[from]) {
+                if (nodes[from] == UINT32_MAX || nodes[to] == UINT32_MAX) {
+                    continue;
+                }
+                auto& node = result.runNodes[nodes[to]];
+                if (result.runNodes[nodes[from]].queue != node.queue && std::ranges::find(node.waits, nodes[from]) == node.waits.end()) {
+                    node.waits.emplace_back(nodes[from]);
+                }
+            }
+        }
+        for (auto& node : result.runNodes) {
+            std::ranges::sort(node.waits);
+        }
+
+        for (auto& pass : result.passes) {
+            if (pass.name != result.outputPass) {
+                continue;
+            }
+            for (u32 i = 0; i < pass.attachments.size(); i++) {
+                if (pass.attachments[i].resource == result.output) {
+                    pass.outputAttachmentIndex = i;
+                }
+            }
+        }
+
+        for (const auto& resource : resources) {
+            const bool used = std::ranges::any_of(result.passes, [&](const Pass& pass) {
+                return std::ranges::find(pass.attachments, resource.name, &Attachment::resource) != pass.attachments.end() ||
+                    std::ranges::find(pass.reads, resource.name) != pass.reads.end() ||
+                    std::ranges::find(pass.writes, resource.name) != pass.writes.end();
+            });
+            if (used) {
+                result.resources.emplace_back(resource);
+            }
+        }
+        return result;
+    }
+
+    std::vector<RenderGraphCompiler::Resource> RenderGraphCompiler::ParseResources(const nlohmann::json& description) {
+        std::vector<Resource> resources;
+        for (const auto& [name, resource] : description.at("resources").items()) {
+            resources.emplace_back(Resource {
+                .name = name,
+                .format = ParseEnum<vk::Format>(resource.at("format")),
+                .samples = resource.contains("samples") ? ParseBit<vk::SampleCountFlagBits>(resource.at("samples")) : vk::SampleCountFlagBits::e1,
+                .usage = ParseFlags<vk::ImageUsageFlagBits>(resource.at("usage")),
+                .initialLayout = resource.contains("initialLayout") ? ParseEnum<vk::ImageLayout>(resource.at("initialLayout")) : vk::ImageLayout::eUndefined,
+            });
+        }
+        return resources;
+    }
+
+    RenderGraphCompiler::Pass RenderGraphCompiler::ParsePass(const nlohmann::json& description, const std::vector<Resource>& resources) {
+        auto pass = Pass {
+            .name = description.at("name").get<String>(),
+            .queue = ParseQueue(description.value("queue", String("graphics"))),
+            .sideEffects = description.value("sideEffects", false),
+            .merge = description.value("merge", true),
+            .outputAttachmentIndex = description.value("outputAttachmentIndex", 0u),
+        };
+
+        for (const auto& attachment : description.value("attachments", nlohmann::json::array())) {
+            const auto& name = attachment.at("resource").get<String>();
+            const auto& resource = FindResource(resources, pass.name, name);
+
+            // Format and sample count follow the resource unless the description overrides them
+            const auto& attachmentDescription = attachment.at("description");
+            auto& parsed = pass.attachments.emplace_back(Attachment {
+                .resource = name,
+                .description = vk::AttachmentDescription()
+                    .setFormat(attachmentDescription.contains("format") ? ParseEnum<vk::Format>(attachmentDescription.at("format")) : resource.format)
+                    .setSamples(attachmentDescription.contains("samples") ? ParseBit<vk::SampleCountFlagBits>(attachmentDescription.at("samples")) : resource.samples)
+                    .setLoadOp(ParseEnum<vk::AttachmentLoadOp>(attachmentDescription.at("loadOp")))
+                    .setStoreOp(ParseEnum<vk::AttachmentStoreOp>(attachmentDescription.at("storeOp")))
+                    .setStencilLoadOp(ParseEnum<vk::AttachmentLoadOp>(attachmentDescription.value("stencilLoadOp", nlohmann::json("eDontCare"))))
+                    .setStencilStoreOp(ParseEnum<vk::AttachmentStoreOp>(attachmentDescription.value("stencilStoreOp", nlohmann::json("eDontCare"))))
+                    .setInitialLayout(ParseEnum<vk::ImageLayout>(attachmentDescription.at("initialLayout")))
+                    .setFinalLayout(ParseEnum<vk::ImageLayout>(attachmentDescription.at("finalLayout"))),
+            });
+
+            if (attachment.contains("clearValue")) {
+                if (const auto& clearValue = attachment.at("clearValue"); clearValue.contains("depthStencil")) {
+                    // Set in place, the union starts zeroed so that comparing its bytes is meaningful
+                    parsed.clearValue.setDepthStencil(vk::ClearDepthStencilValue(
+                        clearValue.at("depthStencil").value("depth", 1.0f),
+                        clearValue.at("depthStencil").value("stencil", 0u)));
+                } else {
+                    parsed.clearValue.setColor(vk::ClearColorValue(clearValue.at("color").get<std::array<f32, 4>>()));
+                }
+            }
+
+            if (parsed.description.loadOp == vk::AttachmentLoadOp::eLoad || parsed.description.stencilLoadOp == vk::AttachmentLoadOp::eLoad) {
+                AddUnique(pass.reads, name);
+            }
+        }
+
+        for (const auto& subpass : description.value("subpasses", nlohmann::json::array())) {
+            auto& parsed = pass.subpasses.emplace_back(Graphics::RenderPass::Subpass {
+                .colorAttachments = ParseReferences(subpass, "colorAttachments"),
+                .inputAttachments = ParseReferences(subpass, "inputAttachments"),
+                .resolveAttachments = ParseReferences(subpass, "resolveAttachments"),
+            });
+            if (subpass.contains("depthStencilAttachment") && !subpass.at("depthStencilAttachment").is_null()) {
+                parsed.depthStencilAttachment = ParseReference(subpass.at("depthStencilAttachment"));
+            }
+
+            const auto attachmentName = [&](const vk::AttachmentReference& reference) -> const String& {
+                if (reference.attachment >= pass.attachments.size()) {
+                    throw std::runtime_error(std::format("RenderGraphCompiler::Compile : Pass '{}' references attachment {} out of bounds",
+                        pass.name, reference.attachment));
+                }
+                return pass.attachments[reference.attachment].resource;
+            };
+            for (const auto& reference : parsed.inputAttachments) {
+                AddUnique(pass.reads, attachmentName(reference));
+            }
+            for (const auto& reference : parsed.colorAttachments) {
+                AddUnique(pass.writes, attachmentName(reference));
+            }
+            for (const auto& reference : parsed.resolveAttachments) {
+                AddUnique(pass.writes, attachmentName(reference));
+            }
+            if (parsed.depthStencilAttachment.has_value()) {
+                AddUnique(pass.writes, attachmentName(*parsed.depthStencilAttachment));
+            }
+        }
+
+        for (const auto& dependency : description.value("dependencies", nlohmann::json::array())) {
+            pass.dependencies.emplace_back(vk::SubpassDependency()
+                .setSrcSubpass(ParseSubpassIndex(dependency.at("srcSubpass")))
+                .setDstSubpass(ParseSubpassIndex(dependency.at("dstSubpass")))
+                .setSrcStageMask(ParseFlags<vk::PipelineStageFlagBits>(dependency.at("srcStageMask")))
+                .setDstStageMask(ParseFlags<vk::PipelineStageFlagBits>(dependency.at("dstStageMask")))
+                .setSrcAccessMask(ParseFlags<vk::AccessFlagBits>(dependency.value("srcAccessMask", nlohmann::json::array())))
+                .setDstAccessMask(ParseFlags<vk::AccessFlagBits>(dependency.value("dstAccessMask", nlohmann::json::array())))
+                .setDependencyFlags(dependency.value("byRegion", false) ? vk::DependencyFlagBits::eByRegion : vk::DependencyFlags()));
+        }
+
+        for (const auto& pipeline : description.value("pipelines", nlohmann::json::array())) {
+            auto& parsed = pass.pipelines.emplace_back(Pipeline {
+                .module = pipeline.at("module").get<String>(),
+                .entryPoints = pipeline.at("entryPoints").get<std::vector<String>>(),
+                .patchControlPoints = pipeline.value("patchControlPoints", 0u),
+                .subpass = pipeline.value("subpass", 0u),
+            });
+            if (parsed.subpass >= pass.subpasses.size()) {
+                throw std::runtime_error(std::format("RenderGraphCompiler::Compile : Pass '{}' has a pipeline for subpass {} out of bounds",
+                    pass.name, parsed.subpass));
+            }
+            if (pipeline.contains("topology")) {
+                parsed.topology = ParseEnum<vk::PrimitiveTopology>(pipeline.at("topology"));
+            }
+            if (pipeline.contains("polygonMode")) {
+                parsed.polygonMode = ParseEnum<vk::PolygonMode>(pipeline.at("polygonMode"));
+            }
+            if (pipeline.contains("cullMode")) {
+                parsed.cullMode = ParseEnum<vk::CullModeFlagBits>(pipeline.at("cullMode"));
+            }
+            if (pipeline.contains("frontFace")) {
+                parsed.frontFace = ParseEnum<vk::FrontFace>(pipeline.at("frontFace"));
+            }
+        }
+
+        if (description.contains("dispatch")) {
+            const auto& dispatch = description.at("dispatch");
+            const auto groupSize = dispatch.value("groupSize", std::array { 8u, 8u });
+            auto& parsed = pass.dispatch.emplace(Dispatch {
+                .module = dispatch.at("module").get<String>(),
+                .entryPoint = dispatch.at("entryPoint").get<String>(),
+                .groupSizeX = std::max(groupSize[0], 1u),
+                .groupSizeY = std::max(groupSize[1], 1u),
+            });
+
+            for (const auto& binding : dispatch.at("bindings")) {
+                const auto& resource = FindResource(resources, pass.name, binding.at("resource").get<String>());
+                const auto access = binding.value("access", String("read"));
+                if (access != "read" && access != "write" && access != "readWrite") {
+                    throw std::runtime_error(std::format("RenderGraphCompiler::Compile : Pass '{}' binds '{}' with unknown access '{}'",
+                        pass.name, resource.name, access));
+                }
+
+                const auto& parsedBinding = parsed.bindings.emplace_back(Binding {
+                    .resource = resource.name,
+                    .set = binding.value("set", 0u),
+                    .binding = binding.at("binding").get<u32>(),
+                    .type = binding.contains("type") ? ParseEnum<vk::DescriptorType>(binding.at("type")) : vk::DescriptorType::eStorageImage,
+                    .read = access != "write",
+                    .write = access != "read",
+                });
+                if (parsedBinding.type == vk::DescriptorType::eStorageImage) {
+                    if (!(resource.usage & vk::ImageUsageFlagBits::eStorage)) {
+                        throw std::runtime_error(std::format("RenderGraphCompiler::Compile : Pass '{}' binds '{}' as a storage image without storage usage",
+                            pass.name, resource.name));
+                    }
+                } else if (parsedBinding.type == vk::DescriptorType::eCombinedImageSampler) {
+                    if (parsedBinding.write || !(resource.usage & vk::ImageUsageFlagBits::eSampled)) {
+                        throw std::runtime_error(std::format("RenderGraphCompiler::Compile : Pass '{}' binds '{}' as a sampled image without sampled usage or for writing",
+                            pass.name, resource.name));
+                    }
+                } else {
+                    throw std::runtime_error(std::format("RenderGraphCompiler::Compile : Pass '{}' binds '{}' as {}, only storage images and combined image samplers are supported",
+                        pass.name, resource.name, vk::to_string(parsedBinding.type)));
+                }
+
+                if (parsedBinding.read) {
+                    AddUnique(pass.reads, resource.name);
+                }
+                if (parsedBinding.write) {
+                    AddUnique(pass.writes, resource.name);
+                }
+            }
+        }
+
+        for (const auto& copy : description.value("copies", nlohmann::json::array())) {
+            const auto& source = FindResource(resources, pass.name, copy.at("source").get<String>());
+            const auto& destination = FindResource(resources, pass.name, copy.at("destination").get<String>());
+            if (source.format != destination.format || source.samples != destination.samples) {
+                throw std::runtime_error(std::format("RenderGraphCompiler::Compile : Pass '{}' copies '{}' to '{}' of another format or sample count",
+                    pass.name, source.name, destination.name));
+            }
+            if (!(source.usage & vk::ImageUsageFlagBits::eTransferSrc) || !(destination.usage & vk::ImageUsageFlagBits::eTransferDst)) {
+                throw std::runtime_error(std::format("RenderGraphCompiler::Compile : Pass '{}' copies '{}' to '{}' without transfer usage",
+                    pass.name, source.name, destination.name));
+            }
+            pass.copies.emplace_back(Copy { .source = source.name, .destination = destination.name });
+            AddUnique(pass.reads, source.name);
+            AddUnique(pass.writes, destination.name);
+        }
+
+        if (static_cast<u32>(pass.Rasterizes()) + static_cast<u32>(pass.dispatch.has_value()) + static_cast<u32>(!pass.copies.empty()) != 1) {
+            throw std::runtime_error(std::format("RenderGraphCompiler::Compile : Pass '{}' has to either rasterize, dispatch or copy", pass.name));
+        }
+        // Every queue copies, only graphics queues rasterize and transfer queues cannot dispatch
+        if ((pass.Rasterizes() && pass.queue != vk::QueueFlagBits::eGraphics) || (pass.dispatch && pass.queue == vk::QueueFlagBits::eTransfer)) {
+            throw std::runtime_error(std::format("RenderGraphCompiler::Compile : Pass '{}' cannot run on the {} queue", pass.name, vk::to_string(pass.queue)));
+        }
+
+        // Resources sampled or written outside of attachments
+        for (const auto& name : description.value("reads", std::vector<String>())) {
+            AddUnique(pass.reads, name);
+        }
+        for (const auto& name : description.value("writes", std::vector<String>())) {
+            AddUnique(pass.writes, name);
+        }
+        for (const auto& name : pass.reads) {
+            if (std::ranges::find(resources, name, &Resource::name) == resources.end()) {
+                throw std::runtime_error(std::format("RenderGraphCompiler::Compile : Pass '{}' reads undeclared resource '{}'", pass.name, name));
+            }
+        }
+        return pass;
+    }
+
+    // Stages and accesses of every reference the subpass makes to the attachment
+    static void SubpassAccess(const Graphics::RenderPass::Subpass& subpass, const u32 attachment, vk::PipelineStageFlags& stages, vk::AccessFlags& access) {
+        const auto references = [&](const std::vector<vk::AttachmentReference>& list) {
+            return std::ranges::find(list, attachment, &vk::AttachmentReference::attachment) != list.end();
+        };
+        if (references(subpass.colorAttachments) || references(subpass.resolveAttachments)) {
+            stages |= vk::PipelineStageFlagBits::eColorAttachmentOutput;
+            access |= vk::AccessFlagBits::eColorAttachmentRead | vk::AccessFlagBits::eColorAttachmentWrite;
+        }
+        if (subpass.depthStencilAttachment && subpass.depthStencilAttachment->attachment == attachment) {
+            stages |= vk::PipelineStageFlagBits::eEarlyFragmentTests | vk::PipelineStageFlagBits::eLateFragmentTests;
+            access |= vk::AccessFlagBits::eDepthStencilAttachmentRead | vk::AccessFlagBits::eDepthStencilAttachmentWrite;
+        }
+        if (references(subpass.inputAttachments)) {
+            stages |= vk::PipelineStageFlagBits::eFragmentShader;
+            access |= vk::AccessFlagBits::eInputAttachmentRead;
+        }
+    }
+
+    bool RenderGraphCompiler::CanMerge(const Pass& into, const Pass& pass) {
+        if (!pass.merge || !into.Rasterizes() || !pass.Rasterizes()) {
+            return false;
+        }
+
+        const auto attached = [](const Pass& owner, const String& name) {
+            return std::ranges::find(owner.attachments, name, &Attachment::resource) != owner.attachments.end();
+        };
+        // Sampling needs the whole image to be finished, which only the end of the render pass guarantees
+        for (const auto& name : pass.reads) {
+            if (!attached(pass, name) && std::ranges::find(into.writes, name) != into.writes.end()) {
+                return false;
+            }
+        }
+        for (const auto& name : pass.writes) {
+            if (!attached(into, name) && std::ranges::find(into.reads, name) != into.reads.end()) {
+                return false;
+            }
+        }
+
+        bool shared = false;
+        for (const auto& attachment : pass.attachments) {
+            const auto existing = std::ranges::find(into.attachments, attachment.resource, &Attachment::resource);
+            if (existing == into.attachments.end()) {
+                continue;
+            }
+            // A render pass clears an attachment only when it is first used
+            if (attachment.description.loadOp == vk::AttachmentLoadOp::eClear || attachment.description.stencilLoadOp == vk::AttachmentLoadOp::eClear ||
+                attachment.description.format != existing->description.format || attachment.description.samples != existing->description.samples) {
+                return false;
+            }
+            shared = true;
+        }
+        // Without shared attachments merging saves no bandwidth and only gives up dynamic rendering
+        return shared;
+    }
+
+    void RenderGraphCompiler::Merge(Pass& into, Pass pass) {
+        const auto firstSubpass = static_cast<u32>(into.subpasses.size());
+
+        std::vector<u32> remap(pass.attachments.size());
+        std::vector<vk::SubpassDependency> dependencies;
+        for (u32 i = 0; i < pass.attachments.size(); i++) {
+            const auto& attachment = pass.attachments[i];
+            const auto existing = std::ranges::find(into.attachments, attachment.resource, &Attachment::resource);
+            if (existing == into.attachments.end()) {
+                remap[i] = static_cast<u32>(into.attachments.size());
+                into.attachments.emplace_back(attachment);
+                continue;
+            }
+            const auto index = static_cast<u32>(std::distance(into.attachments.begin(), existing));
+            remap[i] = index;
+            // Whatever the last user does not store never leaves the render pass
+            existing->description
+                .setStoreOp(attachment.description.storeOp)
+                .setStencilStoreOp(attachment.description.stencilStoreOp)
+                .setFinalLayout(attachment.description.finalLayout);
+
+            // From the last subpass using the attachment to the first one of the merged pass using it
+            auto dependency = vk::SubpassDependency().setDependencyFlags(vk::DependencyFlagBits::eByRegion);
+            for (u32 subpass = firstSubpass; subpass-- > 0;) {
+                auto stages = vk::PipelineStageFlags();
+                auto access = vk::AccessFlags();
+                SubpassAccess(into.subpasses[subpass], index, stages, access);
+                if (stages) {
+                    dependency.setSrcSubpass(subpass).setSrcStageMask(stages).setSrcAccessMask(access & (vk::AccessFlagBits::eColorAttachmentWrite |
+                        vk::AccessFlagBits::eDepthStencilAttachmentWrite));
+                    break;
+                }
+            }
+            for (u32 subpass = 0; subpass < pass.subpasses.size(); subpass++) {
+                auto stages = vk::PipelineStageFlags();
+                auto access = vk::AccessFlags();
+                SubpassAccess(pass.subpasses[subpass], i, stages, access);
+                if (stages) {
+                    dependency.setDstSubpass(firstSubpass + subpass).setDstStageMask(stages).setDstAccessMask(access);
+                    break;
+                }
+            }
+            if (!dependency.srcStageMask || !dependency.dstStageMask) {
+                continue;
+            }
+
+            // Attachments handed over between the same subpasses share one dependency
+            if (const auto same = std::ranges::find_if(dependencies, [&](const vk::SubpassDependency& other) {
+                    return other.srcSubpass == dependency.srcSubpass && other.dstSubpass == dependency.dstSubpass;
+                }); same != dependencies.end()) {
+                same->srcStageMask |= dependency.srcStageMask;
+                same->srcAccessMask |= dependency.srcAccessMask;
+                same->dstStageMask |= dependency.dstStageMask;
+                same->dstAccessMask |= dependency.dstAccessMask;
+            } else {
+                dependencies.emplace_back(dependency);
+            }
+        }
+
+        const auto remapReference = [&](vk::AttachmentReference& reference) {
+            if (reference.attachment != vk::AttachmentUnused) {
+                reference.attachment = remap.at(reference.attachment);
+            }
+        };
+        for (auto& subpass : pass.subpasses) {
+            std::ranges::for_each(subpass.colorAttachments, remapReference);
+            std::ranges::for_each(subpass.inputAttachments, remapReference);
+            std::ranges::for_each(subpass.resolveAttachments, remapReference);
+            if (subpass.depthStencilAttachment) {
+                remapReference(*subpass.depthStencilAttachment);
+            }
+            into.subpasses.emplace_back(std::move(subpass));
+        }
+
+        for (auto dependency : pass.dependencies) {
+            if (dependency.srcSubpass != vk::SubpassExternal) {
+                dependency.srcSubpass += firstSubpass;
+            }
+            if (dependency.dstSubpass != vk::SubpassExternal) {
+                dependency.dstSubpass += firstSubpass;
+            }
+            into.dependencies.emplace_back(dependency);
+        }
+        into.dependencies.insert(into.dependencies.end(), dependencies.begin(), dependencies.end());
+
+        for (auto& pipeline : pass.pipelines) {
+            pipeline.subpass += firstSubpass;
+            into.pipelines.emplace_back(std::move(pipeline));
+        }
+        for (const auto& name : pass.reads) {
+            AddUnique(into.reads, name);
+        }
+        for (const auto& name : pass.writes) {
+            AddUnique(into.writes, name);
+        }
+        into.sideEffects |= pass.sideEffects;
+        into.name += "+" + pass.name;
+    }
+
+    void RenderGraphCompiler::BuildDependencies(const std::vector<Pass>& passes, std::vector<std::vector<u32>>& edges, std::vector<std::vector<u32>>& producers) {
+        edges.assign(passes.size(), {});
+        producers.assign(passes.size(), {});
+        const auto addEdge = [&](const u32 from, const u32 to) {
+            if (from != to && std::ranges::find(edges[from], to) == edges[from].end()) {
+                edges[from].emplace_back(to);
+            }
+        };
+
+        std::vector<String> names;
+        for (const auto& pass : passes) {
+            for (const auto& name : pass.writes) {
+                AddUnique(names, name);
+            }
+        }
+
+        for (const auto& name : names) {
+            // Writers of a resource keep their declared order
+            std::vector<u32> writers;
+            for (u32 i = 0; i < passes.size(); i++) {
+                if (std::ranges::find(passes[i].writes, name) != passes[i].writes.end()) {
+                    writers.emplace_back(i);
+                }
+            }
+            for (u32 i = 1; i < writers.size(); i++) {
+                addEdge(writers[i - 1], writers[i]);
+            }
+
+            // A reader sees the last writer declared before it, or the first one when it is declared ahead of all of them
+            for (u32 i = 0; i < passes.size(); i++) {
+                if (std::ranges::find(passes[i].reads, name) == passes[i].reads.end()) {
+                    continue;
+                }
+                const auto next = std::ranges::lower_bound(writers, i);
+                if (next != writers.end() && *next == i) {
+                    // Reading and writing, e.g. a load op, continues the previous writer's contents
+                    if (next != writers.begin()) {
+                        producers[i].emplace_back(*std::prev(next));
+                    }
+                    continue;
+                }
+
+                const auto source = next == writers.begin() ? next : std::prev(next);
+                addEdge(*source, i);
+                producers[i].emplace_back(*source);
+                // The following writer must not overwrite the contents before they were read
+                if (std::next(source) != writers.end()) {
+                    addEdge(i, *std::next(source));
+                }
+            }
+        }
+    }
+
+    std::vector<u32> RenderGraphCompiler::Sort(const std::vector<Pass>& passes, const std::vector<std::vector<u32>>& edges) {
+        std::vector<u32> incoming(passes.size(), 0);
+        for (const auto& targets : edges) {
+            for (const auto target : targets) {
+                incoming[target]++;
+            }
+        }
+
+        // Ready passes are taken in declaration order, so independent passes keep the order they were written in
+        std::vector<u32> ready;
+        for (u32 i = 0; i < passes.size(); i++) {
+            if (incoming[i] == 0) {
+                ready.emplace_back(i);
+            }
+        }
+
+        std::vector<u32> order;
+        order.reserve(passes.size());
+        while (!ready.empty()) {
+            // Staying on the queue of the previous pass saves a run node and the semaphore wait between them
+            auto next = ready.begin();
+            if (!order.empty()) {
+                if (const auto sameQueue = std::ranges::find(ready, passes[order.back()].queue, [&](const u32 index) { return passes[index].queue; });
+                    sameQueue != ready.end()) {
+                    next = sameQueue;
+                }
+            }
+            const auto pass = *next;
+            ready.erase(next);
+            order.emplace_back(pass);
+            for (const auto target : edges[pass]) {
+                if (--incoming[target] == 0) {
+                    ready.insert(std::ranges::upper_bound(ready, target), target);
+                }
+            }
+        }
+
+        if (order.size() != passes.size()) {
+            String cycle;
+            for (u32 i = 0; i < passes.size(); i++) {
+                if (incoming[i] > 0) {
+                    cycle += (cycle.empty() ? "" : ", ") + passes[i].name;
+                }
+            }
+            throw std::runtime_error(std::format("RenderGraphCompiler::Compile : Dependency cycle between {}", cycle));
+        }
+        return order;
+    }
+
+    std::vector<bool> RenderGraphCompiler::Cull(const std::vector<Pass>& passes, const std::vector<std::vector<u32>>& producers, const String& output) {
+        std::vector<bool> live(passes.size(), false);
+        std::vector<u32> pending;
+
+        // Only the last writer produces the final contents of the output, earlier ones are reached through it if needed
+        for (u32 i = static_cast<u32>(passes.size()); i-- > 0;) {
+            if (std::ranges::find(passes[i].writes, output) != passes[i].writes.end()) {
+                pending.emplace_back(i);
+                break;
+            }
+        }
+        if (pending.empty()) {
+            throw std::runtime_error(std::format("RenderGraphCompiler::Compile : No pass writes the output '{}'", output));
+        }
+        for (u32 i = 0; i < passes.size(); i++) {
+            if (passes[i].sideEffects) {
+                pending.emplace_back(i);
+            }
+        }
+
+        while (!pending.empty()) {
+            const auto pass = pending.back();
+            pending.pop_back();
+            if (live[pass]) {
+                continue;
+            }
+            live[pass] = true;
+            for (const auto producer : producers[pass]) {
+                pending.emplace_back(producer);
+            }
+        }
+        return live;
+    }
+}
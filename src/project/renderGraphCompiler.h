@@ -0,0 +1,167 @@
+//
+// Created by radue on 10/17/2026.
+//
+
+#pragma once
+
+#include <filesystem>
+#include <optional>
+#include <vector>
+
+#include <nlohmann/json_fwd.hpp>
+#include <vulkan/vulkan.hpp>
+
+#include "graphics/renderPass.h"
+#include "utils/types.h"
+
+namespace Coral::Project {
+    // Turns a JSON render graph description into passes ordered by the resources they read and write.
+    // Passes contributing nothing to the output are culled, so describing an unused pass costs nothing at runtime.
+    // A pass either rasterizes through subpasses, dispatches a compute shader or copies images, and declares the queue
+    // it runs on. Consecutive passes on one queue form a run node, nodes wait on the nodes of other queues they depend on.
+    // Consecutive rasterizing passes sharing attachments are merged into the subpasses of one render pass, so what they
+    // hand to each other stays in tile memory instead of being stored and loaded again.
+    class RenderGraphCompiler {
+    public:
+        struct Resource {
+            String name;
+            vk::Format format = vk::Format::eUndefined;
+            vk::SampleCountFlagBits samples = vk::SampleCountFlagBits::e1;
+            vk::ImageUsageFlags usage;
+            vk::ImageLayout initialLayout = vk::ImageLayout::eUndefined;
+
+            bool operator==(const Resource &) const = default;
+        };
+
+        struct Attachment {
+            String resource;
+            vk::AttachmentDescription description;
+            vk::ClearValue clearValue;
+
+            bool operator==(const Attachment &other) const;
+        };
+
+        struct Pipeline {
+            String module;
+            std::vector<String> entryPoints;
+            vk::PrimitiveTopology topology = vk::PrimitiveTopology::eTriangleList;
+            vk::PolygonMode polygonMode = vk::PolygonMode::eFill;
+            vk::CullModeFlags cullMode = vk::CullModeFlagBits::eNone;
+            vk::FrontFace frontFace = vk::FrontFace::eClockwise;
+            // 0 disables tessellation
+            u32 patchControlPoints = 0;
+            // Index into the pass' subpasses
+            u32 subpass = 0;
+
+            bool operator==(const Pipeline &) const = default;
+        };
+
+        // An image bound to a compute dispatch
+        struct Binding {
+            String resource;
+            u32 set = 0;
+            u32 binding = 0;
+            // Storage images are accessed in the general layout, combined image samplers are only read
+            vk::DescriptorType type = vk::DescriptorType::eStorageImage;
+            bool read = false;
+            // A write without a read overwrites the whole image, its previous contents are discarded
+            bool write = false;
+
+            bool operator==(const Binding &) const = default;
+        };
+
+        struct Dispatch {
+            String module;
+            String entryPoint;
+            // Threads per workgroup, the dispatch covers the graph's extent
+            u32 groupSizeX = 8;
+            u32 groupSizeY = 8;
+            std::vector<Binding> bindings;
+
+            bool operator==(const Dispatch &) const = default;
+        };
+
+        // Copies the first mip level of the whole image
+        struct Copy {
+            String source;
+            String destination;
+
+            bool operator==(const Copy &) const = default;
+        };
+
+        struct Pass {
+            String name;
+            vk::QueueFlagBits queue = vk::QueueFlagBits::eGraphics;
+            std::vector<Attachment> attachments;
+            std::vector<Graphics::RenderPass::Subpass> subpasses;
+            std::vector<vk::SubpassDependency> dependencies;
+            std::vector<Pipeline> pipelines;
+            std::optional<Dispatch> dispatch;
+            std::vector<Copy> copies;
+            // Derived from the attachments' load ops and subpass references, plus whatever the description declares
+            std::vector<String> reads;
+            std::vector<String> writes;
+            // Never culled, for passes whose results leave the graph some other way
+            bool sideEffects = false;
+            // Lets the pass become subpasses of the previous one when it continues rendering into its attachments
+            bool merge = true;
+            u32 outputAttachmentIndex = 0;
+
+            [[nodiscard]] bool Rasterizes() const { return !subpasses.empty(); }
+
+            bool operator==(const Pass &) const = default;
+        };
+
+        struct RunNode {
+            vk::QueueFlagBits queue = vk::QueueFlagBits::eGraphics;
+            std::vector<String> passes;
+            // Earlier nodes on other queues producing or still reading something this node touches
+            std::vector<u32> waits;
+
+            bool operator==(const RunNode &) const = default;
+        };
+
+        struct Result {
+            // Only the resources used by the passes that survived culling
+            std::vector<Resource> resources;
+            // In execution order
+            std::vector<Pass> passes;
+            // Consecutive passes on the same queue, each recorded into one command buffer
+            std::vector<RunNode> runNodes;
+            std::vector<String> culled;
+            String output;
+            String outputPass;
+
+            bool operator==(const Result &) const = default;
+        };
+
+        // Without merging every rasterizing pass stays a render pass of its own
+        explicit RenderGraphCompiler(std::filesystem::path path, bool merge = true);
+
+        // Throws when the description cannot be read or has no valid order
+        [[nodiscard]] Result Compile();
+        // Compiles again only if the file was written since the last compilation, errors are reported and skipped
+        [[nodiscard]] std::optional<Result> CompileIfChanged();
+
+        [[nodiscard]] static Result Compile(const nlohmann::json &description, bool merge = true);
+
+        [[nodiscard]] const std::filesystem::path &Path() const { return m_path; }
+
+    private:
+        static std::vector<Resource> ParseResources(const nlohmann::json &description);
+        static Pass ParsePass(const nlohmann::json &description, const std::vector<Resource> &resources);
+        // Edges run from a pass to the passes that have to execute after it, producers only cover read-after-write
+        static void BuildDependencies(const std::vector<Pass> &passes, std::vector<std::vector<u32>> &edges, std::vector<std::vector<u32>> &producers);
+        // Among the ready passes the ones on the queue of the previous pass go first, which keeps the run nodes long
+        static std::vector<u32> Sort(const std::vector<Pass> &passes, const std::vector<std::vector<u32>> &edges);
+        // The pass has to load the shared attachments rather than clear them and must not sample what the other one renders
+        static bool CanMerge(const Pass &into, const Pass &pass);
+        // Appends the subpasses of pass to into, shared attachments keep the load of their first use and the store of their last
+        static void Merge(Pass &into, Pass pass);
+        static std::vector<bool> Cull(const std::vector<Pass> &passes, const std::vector<std::vector<u32>> &producers, const String &output);
+
+        std::filesystem::path m_path;
+        bool m_merge = true;
+        std::filesystem::file_time_type m_lastWriteTime;
+    };
+}
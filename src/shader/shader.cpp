@@ -9,6 +9,7 @@
 #include <slang/slang-com-ptr.h>
 
 #include "context.h"
+#include "core/deletionQueue.h"
 #include "core/device.h"
 #include "spirv_cross.hpp"
 
@@ -36,15 +37,15 @@ namespace Coral::Shader {
 
 	Shader::~Shader() {
 		if (m_handle) {
-			Context::Device()->destroyShaderModule(m_handle);
+			Context::DeletionQueue().Retire([handle = m_handle] { Context::Device()->destroyShaderModule(handle); });
 		}
 	}
 
 
 	void Shader::LoadSpirVShader() {
-		Context::Device()->waitIdle();
+		// Pipelines built from the old module may still be in flight, reloading must not stall the frame
 		if (m_handle) {
-			Context::Device()->destroyShaderModule(m_handle);
+			Context::DeletionQueue().Retire([handle = m_handle] { Context::Device()->destroyShaderModule(handle); });
 		}
 
 		const auto createInfo = vk::ShaderModuleCreateInfo()
@@ -58,6 +59,9 @@ namespace Coral::Shader {
 		const auto module = spirv_cross::Compiler(m_spirVCode);
 		const auto resources = module.get_shader_resources();
 		m_stage = static_cast<Stage>(1 << static_cast<u32>(module.get_execution_model()));
+		if (const auto entryPoints = module.get_entry_points_and_stages(); !entryPoints.empty()) {
+			m_entryPointName = entryPoints.front().name;
+		}
 
 		for (const auto& input : resources.stage_inputs) {
 			auto location = module.get_decoration(input.id, spv::DecorationLocation);
@@ -91,6 +91,8 @@ namespace Coral::Shader {
 		[[nodiscard]] const std::set<InOut>& Outputs() const { return m_outputs; }
 		[[nodiscard]] const std::set<Descriptor>& Descriptors() const { return m_descriptors; }
 		[[nodiscard]] const std::vector<PushConstantRange>& PushConstantRanges() const { return m_pushConstantRanges; }
+		// The entry point's name in the compiled module, which need not be the one it was requested by
+		[[nodiscard]] const std::string& EntryPointName() const { return m_entryPointName; }
 
 		void PrintLayoutInfo() const;
 
@@ -109,6 +111,7 @@ namespace Coral::Shader {
 		std::set<InOut> m_outputs {};
 		std::set<Descriptor> m_descriptors {};
 		std::vector<PushConstantRange> m_pushConstantRanges {};
+		std::string m_entryPointName = "main";
 
 
 		void LoadSpirVShader();
@@ -0,0 +1,95 @@
+//
+// Created by radue on 10/17/2026.
+//
+
+#include "benchmark.h"
+
+#include <chrono>
+#include <format>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "context.h"
+#include "core/device.h"
+#include "memory/allocator.h"
+
+namespace Coral::Test {
+    namespace {
+        using Clock = std::chrono::steady_clock;
+
+        f64 NanosecondsPer(const Clock::duration duration, const u64 count) {
+            return static_cast<f64>(std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count()) / static_cast<f64>(count);
+        }
+    }
+
+    void BenchmarkAllocator(const u32 allocationCount, const u32 rounds) {
+        auto random = std::mt19937(42);
+        // Mesh and uniform sized requests, everything below the dedicated threshold
+        auto sizeDistribution = std::uniform_int_distribution<vk::DeviceSize>(256, 64 * 1024);
+        std::vector<vk::DeviceSize> sizes(allocationCount);
+        for (auto& size : sizes) {
+            size = sizeDistribution(random);
+        }
+        constexpr vk::DeviceSize alignment = 256;
+        constexpr auto properties = vk::MemoryPropertyFlagBits::eDeviceLocal;
+
+        auto& allocator = Context::Allocator();
+        std::vector<Memory::Allocation> allocations(allocationCount);
+
+        // Warm up, so the block backing the run is already there like it is in a running engine
+        allocations[0] = allocator.Allocate(vk::MemoryRequirements(sizes[0], alignment, ~0u), properties, Memory::Allocator::ResourceKind::Buffer);
+        const auto memoryTypeIndex = allocations[0].memoryTypeIndex;
+        allocator.Free(allocations[0]);
+
+        Clock::duration tlsfAllocate {};
+        Clock::duration tlsfFree {};
+        for (u32 round = 0; round < rounds; round++) {
+            auto begin = Clock::now();
+            for (u32 i = 0; i < allocationCount; i++) {
+                allocations[i] = allocator.Allocate(vk::MemoryRequirements(sizes[i], alignment, ~0u), properties,
+                    Memory::Allocator::ResourceKind::Buffer);
+            }
+            tlsfAllocate += Clock::now() - begin;
+
+            begin = Clock::now();
+            // Every other allocation first, so half of the frees have to merge two neighbours
+            for (u32 parity : { 0u, 1u }) {
+                for (u32 i = parity; i < allocationCount; i += 2) {
+                    allocator.Free(allocations[i]);
+                }
+            }
+            tlsfFree += Clock::now() - begin;
+        }
+
+        // What Buffer and Image did before the allocator, one vkAllocateMemory per resource
+        std::vector<vk::DeviceMemory> memories(allocationCount);
+        Clock::duration driverAllocate {};
+        Clock::duration driverFree {};
+        for (u32 round = 0; round < rounds; round++) {
+            auto begin = Clock::now();
+            for (u32 i = 0; i < allocationCount; i++) {
+                memories[i] = Context::Device()->allocateMemory(vk::MemoryAllocateInfo()
+                    .setAllocationSize(sizes[i])
+                    .setMemoryTypeIndex(memoryTypeIndex));
+            }
+            driverAllocate += Clock::now() - begin;
+
+            begin = Clock::now();
+            for (const auto memory : memories) {
+                Context::Device()->freeMemory(memory);
+            }
+            driverFree += Clock::now() - begin;
+        }
+
+        const u64 count = static_cast<u64>(allocationCount) * rounds;
+        const auto tlsf = NanosecondsPer(tlsfAllocate + tlsfFree, count);
+        const auto driver = NanosecondsPer(driverAllocate + driverFree, count);
+        std::cout << std::format("{} allocate/free pairs of 256B to 64KiB in memory type {}", count, memoryTypeIndex) << std::endl;
+        std::cout << std::format("  TLSF allocator     : {:10.1f} ns allocate {:10.1f} ns free",
+            NanosecondsPer(tlsfAllocate, count), NanosecondsPer(tlsfFree, count)) << std::endl;
+        std::cout << std::format("  vkAllocateMemory   : {:10.1f} ns allocate {:10.1f} ns free",
+            NanosecondsPer(driverAllocate, count), NanosecondsPer(driverFree, count)) << std::endl;
+        std::cout << std::format("  speedup            : {:.1f}x", tlsf > 0.0 ? driver / tlsf : 0.0) << std::endl;
+    }
+}
@@ -0,0 +1,154 @@
+//
+// Created by radue on 10/17/2026.
+//
+
+#include "selfTest.h"
+
+#include <algorithm>
+#include <random>
+#include <tuple>
+#include <vector>
+
+#include "context.h"
+#include "memory/allocator.h"
+
+namespace Coral::Test {
+    namespace {
+        Memory::Allocation Allocate(const vk::DeviceSize size, const vk::DeviceSize alignment = 1,
+            const vk::MemoryPropertyFlags properties = vk::MemoryPropertyFlagBits::eDeviceLocal) {
+            return Context::Allocator().Allocate(vk::MemoryRequirements(size, alignment, ~0u), properties,
+                Memory::Allocator::ResourceKind::Buffer);
+        }
+
+        bool Overlap(const Memory::Allocation& a, const Memory::Allocation& b) {
+            return a.memory == b.memory && a.offset < b.offset + b.size && b.offset < a.offset + a.size;
+        }
+    }
+
+    CORAL_TEST(Allocator, HonoursAlignment) {
+        std::vector<Memory::Allocation> allocations;
+        for (const vk::DeviceSize alignment : { 1ull, 16ull, 256ull, 4096ull, 65536ull }) {
+            allocations.emplace_back(Allocate(1000, alignment));
+            CORAL_EXPECT(allocations.back());
+            CORAL_EXPECT(allocations.back().offset % alignment == 0);
+            CORAL_EXPECT(allocations.back().size >= 1000);
+        }
+        for (auto& allocation : allocations) {
+            Context::Allocator().Free(allocation);
+            CORAL_EXPECT(!allocation);
+        }
+    }
+
+    CORAL_TEST(Allocator, LiveAllocationsNeverOverlap) {
+        auto random = std::mt19937(7);
+        auto sizes = std::uniform_int_distribution<vk::DeviceSize>(16, 256 * 1024);
+        std::vector<Memory::Allocation> allocations;
+        for (u32 i = 0; i < 512; i++) {
+            allocations.emplace_back(Allocate(sizes(random), 256));
+            // Free every third one so later requests land in the holes
+            if (i % 3 == 2) {
+                Context::Allocator().Free(allocations[i - 1]);
+            }
+        }
+        std::erase_if(allocations, [](const auto& allocation) { return !allocation; });
+        std::ranges::sort(allocations, [](const auto& a, const auto& b) {
+            return std::tie(a.memory, a.offset) < std::tie(b.memory, b.offset);
+        });
+        for (u32 i = 1; i < allocations.size(); i++) {
+            CORAL_EXPECT(!Overlap(allocations[i - 1], allocations[i]));
+        }
+        for (auto& allocation : allocations) {
+            Context::Allocator().Free(allocation);
+        }
+    }
+
+    CORAL_TEST(Allocator, FreeCoalescesNeighbours) {
+        constexpr vk::DeviceSize size = 3 * 1024 * 1024 + 4096;
+        // Makes sure the pool already has the block the baseline counts, an empty pool keeps the first block it creates
+        auto warmUp = Allocate(size, 4096);
+        const auto memoryTypeIndex = warmUp.memoryTypeIndex;
+        Context::Allocator().Free(warmUp);
+        const auto before = Context::Allocator().Stats(memoryTypeIndex);
+
+        std::vector<Memory::Allocation> allocations;
+        for (u32 i = 0; i < 8; i++) {
+            allocations.emplace_back(Allocate(size, 4096));
+        }
+        // Every other one first leaves holes, the rest then merges with a free range on both sides wherever they are placed
+        for (u32 parity : { 0u, 1u }) {
+            for (u32 i = parity; i < allocations.size(); i += 2) {
+                Context::Allocator().Free(allocations[i]);
+            }
+        }
+
+        // Without merging every freed allocation would stay a free range of its own
+        const auto after = Context::Allocator().Stats(memoryTypeIndex);
+        CORAL_EXPECT(after.freeRangeCount == before.freeRangeCount);
+        CORAL_EXPECT(after.largestFreeRange == before.largestFreeRange);
+        CORAL_EXPECT(after.allocationCount == before.allocationCount);
+        CORAL_EXPECT(after.usedBytes == before.usedBytes);
+    }
+
+    CORAL_TEST(Allocator, LargeRequestsAreDedicated) {
+        const auto before = Context::Allocator().Stats();
+        auto allocation = Allocate(Memory::Allocator::CreateInfo {}.dedicatedThreshold);
+        CORAL_EXPECT(allocation && allocation.offset == 0);
+        CORAL_EXPECT(Context::Allocator().Stats().dedicatedAllocationCount == before.dedicatedAllocationCount + 1);
+
+        Context::Allocator().Free(allocation);
+        CORAL_EXPECT(Context::Allocator().Stats().dedicatedAllocationCount == before.dedicatedAllocationCount);
+    }
+
+    CORAL_TEST(Allocator, HostVisibleAllocationsAreMapped) {
+        auto first = Allocate(64, 1, vk::MemoryPropertyFlagBits::eHostVisible);
+        auto second = Allocate(64, 1, vk::MemoryPropertyFlagBits::eHostVisible);
+        CORAL_EXPECT(first.mapped && second.mapped);
+        if (first.memory == second.memory) {
+            CORAL_EXPECT(second.mapped - first.mapped == static_cast<isize>(second.offset) - static_cast<isize>(first.offset));
+        }
+        Context::Allocator().Free(first);
+        Context::Allocator().Free(second);
+    }
+
+    CORAL_TEST(Allocator, CategoriesBalance) {
+        const auto before = Context::Allocator().CategoryStats();
+        const auto requirements = vk::MemoryRequirements(4096, 256, ~0u);
+        auto texture = Context::Allocator().Allocate(requirements, vk::MemoryPropertyFlagBits::eDeviceLocal,
+            Memory::Allocator::ResourceKind::Image, Memory::Category::Texture);
+        auto staging = Context::Allocator().Allocate(requirements, vk::MemoryPropertyFlagBits::eHostVisible,
+            Memory::Allocator::ResourceKind::Buffer, Memory::Category::Staging);
+
+        const auto during = Context::Allocator().CategoryStats();
+        for (u32 i = 0; i < Memory::CategoryCount; i++) {
+            const auto category = static_cast<Memory::Category>(i);
+            const auto expected = category == Memory::Category::Texture ? texture.size : category == Memory::Category::Staging ? staging.size : 0;
+            CORAL_EXPECT(during[i].allocationCount == before[i].allocationCount + (expected ? 1 : 0));
+            CORAL_EXPECT(during[i].bytes == before[i].bytes + expected);
+        }
+
+        Context::Allocator().Free(texture);
+        Context::Allocator().Free(staging);
+        const auto after = Context::Allocator().CategoryStats();
+        for (u32 i = 0; i < Memory::CategoryCount; i++) {
+            CORAL_EXPECT(after[i].allocationCount == before[i].allocationCount);
+            CORAL_EXPECT(after[i].bytes == before[i].bytes);
+        }
+        // The peak remembers the allocation after it is gone
+        CORAL_EXPECT(after[static_cast<u32>(Memory::Category::Texture)].peakBytes == during[static_cast<u32>(Memory::Category::Texture)].peakBytes);
+    }
+
+    CORAL_TEST(Allocator, BudgetFallsBackToMostOfTheHeap) {
+        CORAL_EXPECT(Memory::Allocator::EstimatedBudget(1000) == 800);
+        CORAL_EXPECT(Memory::Allocator::EstimatedBudget(0) == 0);
+        if (Context::Allocator().HasBudgetExtension()) {
+            return;
+        }
+
+        // Without the extension nothing but the heap size goes into the budget
+        Context::Allocator().PollBudget();
+        for (const auto& heap : Context::Allocator().HeapBudgets()) {
+            CORAL_EXPECT(heap.budget == Memory::Allocator::EstimatedBudget(heap.size));
+            CORAL_EXPECT(heap.budget < heap.size || heap.size == 0);
+        }
+    }
+}
@@ -0,0 +1,210 @@
+//
+// Created by radue on 10/17/2026.
+//
+
+#include "selfTest.h"
+
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+#include "context.h"
+#include "core/device.h"
+#include "graphics/barrierTracker.h"
+#include "memory/image.h"
+
+namespace Coral::Test {
+    namespace {
+        using State = Graphics::BarrierTracker::State;
+
+        const State ColorWrite { vk::ImageLayout::eColorAttachmentOptimal, vk::PipelineStageFlagBits2::eColorAttachmentOutput,
+            vk::AccessFlagBits2::eColorAttachmentWrite };
+        const State SampledRead { vk::ImageLayout::eShaderReadOnlyOptimal, vk::PipelineStageFlagBits2::eFragmentShader,
+            vk::AccessFlagBits2::eShaderSampledRead };
+        const State StorageWrite { vk::ImageLayout::eGeneral, vk::PipelineStageFlagBits2::eComputeShader,
+            vk::AccessFlagBits2::eShaderStorageWrite };
+        const State StorageRead { vk::ImageLayout::eGeneral, vk::PipelineStageFlagBits2::eFragmentShader,
+            vk::AccessFlagBits2::eShaderStorageRead };
+
+        // A recording command buffer the queued barriers are flushed into, it is never submitted
+        class Fixture {
+        public:
+            explicit Fixture(const u32 mipLevels = 1) {
+                m_queue = Context::Device().RequestQueue(vk::QueueFlagBits::eGraphics);
+                m_commandBuffer = Context::Device().RequestCommandBuffer(*m_queue);
+                (*m_commandBuffer)->begin(vk::CommandBufferBeginInfo().setFlags(vk::CommandBufferUsageFlagBits::eOneTimeSubmit));
+                image = Memory::Image::Builder()
+                    .Format(vk::Format::eR8G8B8A8Unorm)
+                    .Extent({ 4u, 4u, 1u })
+                    .UsageFlags(vk::ImageUsageFlagBits::eColorAttachment)
+                    .UsageFlags(vk::ImageUsageFlagBits::eSampled)
+                    .UsageFlags(vk::ImageUsageFlagBits::eStorage)
+                    .MipLevels(mipLevels)
+                    .Build();
+            }
+
+            ~Fixture() {
+                (*m_commandBuffer)->end();
+            }
+
+            // The barriers queued since the previous call
+            std::vector<vk::ImageMemoryBarrier2> Flush() {
+                auto barriers = tracker.PendingImageBarriers();
+                tracker.Flush(**m_commandBuffer);
+                return barriers;
+            }
+
+            Graphics::BarrierTracker tracker;
+            std::unique_ptr<Memory::Image> image;
+
+        private:
+            std::unique_ptr<Core::Queue> m_queue;
+            std::unique_ptr<Core::CommandBuffer> m_commandBuffer;
+        };
+    }
+
+    CORAL_TEST(BarrierTracker, FirstUseOnlyTransitions) {
+        Fixture fixture;
+        fixture.tracker.Require(*fixture.image, ColorWrite);
+        const auto barriers = fixture.Flush();
+        CORAL_EXPECT(barriers.size() == 1);
+        CORAL_EXPECT(barriers[0].oldLayout == vk::ImageLayout::eUndefined);
+        CORAL_EXPECT(barriers[0].newLayout == vk::ImageLayout::eColorAttachmentOptimal);
+        // Nothing recorded before has to be waited on
+        CORAL_EXPECT(!barriers[0].srcStageMask);
+        CORAL_EXPECT(barriers[0].dstAccessMask == vk::AccessFlagBits2::eColorAttachmentWrite);
+    }
+
+    CORAL_TEST(BarrierTracker, WriteAfterWriteWaitsOnTheWrite) {
+        Fixture fixture;
+        fixture.tracker.Require(*fixture.image, ColorWrite);
+        std::ignore = fixture.Flush();
+
+        fixture.tracker.Require(*fixture.image, ColorWrite);
+        const auto barriers = fixture.Flush();
+        CORAL_EXPECT(barriers.size() == 1);
+        CORAL_EXPECT(barriers[0].oldLayout == barriers[0].newLayout);
+        CORAL_EXPECT(barriers[0].srcStageMask == vk::PipelineStageFlagBits2::eColorAttachmentOutput);
+        CORAL_EXPECT(barriers[0].srcAccessMask == vk::AccessFlagBits2::eColorAttachmentWrite);
+    }
+
+    CORAL_TEST(BarrierTracker, RepeatedReadsAreSkipped) {
+        Fixture fixture;
+        fixture.tracker.Require(*fixture.image, ColorWrite);
+        fixture.tracker.Require(*fixture.image, SampledRead);
+        // Both land in the same flush as two barriers, the second waits on the first's write
+        const auto barriers = fixture.Flush();
+        CORAL_EXPECT(barriers.size() == 2);
+        CORAL_EXPECT(barriers[1].oldLayout == vk::ImageLayout::eColorAttachmentOptimal);
+        CORAL_EXPECT(barriers[1].newLayout == vk::ImageLayout::eShaderReadOnlyOptimal);
+        CORAL_EXPECT(barriers[1].srcAccessMask == vk::AccessFlagBits2::eColorAttachmentWrite);
+
+        const auto skipped = fixture.tracker.Stats().skipped;
+        fixture.tracker.Require(*fixture.image, SampledRead);
+        CORAL_EXPECT(fixture.Flush().empty());
+        CORAL_EXPECT(fixture.tracker.Stats().skipped == skipped + 1);
+    }
+
+    CORAL_TEST(BarrierTracker, ReadsInNewStagesWaitOnTheWrite) {
+        Fixture fixture;
+        fixture.tracker.Require(*fixture.image, StorageWrite);
+        std::ignore = fixture.Flush();
+
+        fixture.tracker.Require(*fixture.image, StorageRead);
+        auto barriers = fixture.Flush();
+        CORAL_EXPECT(barriers.size() == 1);
+        CORAL_EXPECT(barriers[0].oldLayout == vk::ImageLayout::eGeneral && barriers[0].newLayout == vk::ImageLayout::eGeneral);
+        CORAL_EXPECT(barriers[0].srcStageMask == vk::PipelineStageFlagBits2::eComputeShader);
+        CORAL_EXPECT(barriers[0].srcAccessMask == vk::AccessFlagBits2::eShaderStorageWrite);
+
+        // The write is visible to fragment shaders now, not yet to the vertex stage
+        fixture.tracker.Require(*fixture.image, StorageRead);
+        CORAL_EXPECT(fixture.Flush().empty());
+        fixture.tracker.Require(*fixture.image, State { vk::ImageLayout::eGeneral, vk::PipelineStageFlagBits2::eVertexShader,
+            vk::AccessFlagBits2::eShaderStorageRead });
+        barriers = fixture.Flush();
+        CORAL_EXPECT(barriers.size() == 1);
+        CORAL_EXPECT(barriers[0].dstStageMask == vk::PipelineStageFlagBits2::eVertexShader);
+    }
+
+    CORAL_TEST(BarrierTracker, WriteAfterReadOnlyWaitsForExecution) {
+        Fixture fixture;
+        fixture.tracker.Assume(*fixture.image, SampledRead);
+        fixture.tracker.Require(*fixture.image, ColorWrite);
+        const auto barriers = fixture.Flush();
+        CORAL_EXPECT(barriers.size() == 1);
+        CORAL_EXPECT(barriers[0].srcStageMask == vk::PipelineStageFlagBits2::eFragmentShader);
+        // Reads leave nothing to make available
+        CORAL_EXPECT(!barriers[0].srcAccessMask);
+        CORAL_EXPECT(barriers[0].oldLayout == vk::ImageLayout::eShaderReadOnlyOptimal);
+    }
+
+    CORAL_TEST(BarrierTracker, DiscardStartsFromUndefined) {
+        Fixture fixture;
+        fixture.tracker.Assume(*fixture.image, ColorWrite);
+        auto discard = StorageWrite;
+        discard.discard = true;
+        fixture.tracker.Require(*fixture.image, discard);
+        const auto barriers = fixture.Flush();
+        CORAL_EXPECT(barriers.size() == 1);
+        CORAL_EXPECT(barriers[0].oldLayout == vk::ImageLayout::eUndefined);
+        CORAL_EXPECT(barriers[0].newLayout == vk::ImageLayout::eGeneral);
+    }
+
+    CORAL_TEST(BarrierTracker, MipLevelsAreTrackedApart) {
+        Fixture fixture(2);
+        fixture.tracker.Require(*fixture.image, ColorWrite, 0, 1);
+        std::ignore = fixture.Flush();
+
+        fixture.tracker.Require(*fixture.image, SampledRead, 0, 2);
+        const auto barriers = fixture.Flush();
+        CORAL_EXPECT(barriers.size() == 2);
+        CORAL_EXPECT(barriers[0].subresourceRange.baseMipLevel == 0 && barriers[0].subresourceRange.levelCount == 1);
+        CORAL_EXPECT(barriers[0].oldLayout == vk::ImageLayout::eColorAttachmentOptimal);
+        CORAL_EXPECT(barriers[1].subresourceRange.baseMipLevel == 1);
+        CORAL_EXPECT(barriers[1].oldLayout == vk::ImageLayout::eUndefined);
+        CORAL_EXPECT(!barriers[1].srcStageMask);
+    }
+
+    CORAL_TEST(BarrierTracker, AcquireRepeatsTheRelease) {
+        // Ownership only moves between families, devices with a single one have nothing to test
+        std::unique_ptr<Core::Queue> compute;
+        try {
+            compute = Context::Device().RequestQueue(vk::QueueFlagBits::eCompute, vk::QueueFlagBits::eGraphics, true);
+        } catch (const std::runtime_error&) {
+            return;
+        }
+
+        Fixture fixture;
+        const auto graphicsFamily = Context::Device().RequestQueue(vk::QueueFlagBits::eGraphics)->Family().Index();
+        const auto computeFamily = compute->Family().Index();
+        auto owned = ColorWrite;
+        owned.queueFamily = graphicsFamily;
+        fixture.tracker.Assume(*fixture.image, owned);
+
+        fixture.tracker.Release(*fixture.image, computeFamily, vk::ImageLayout::eGeneral);
+        auto barriers = fixture.Flush();
+        CORAL_EXPECT(barriers.size() == 1);
+        CORAL_EXPECT(barriers[0].srcQueueFamilyIndex == graphicsFamily && barriers[0].dstQueueFamilyIndex == computeFamily);
+        CORAL_EXPECT(barriers[0].oldLayout == vk::ImageLayout::eColorAttachmentOptimal);
+        CORAL_EXPECT(barriers[0].newLayout == vk::ImageLayout::eGeneral);
+
+        auto acquire = StorageWrite;
+        acquire.queueFamily = computeFamily;
+        fixture.tracker.Require(*fixture.image, acquire);
+        barriers = fixture.Flush();
+        CORAL_EXPECT(barriers.size() == 1);
+        CORAL_EXPECT(barriers[0].srcQueueFamilyIndex == graphicsFamily && barriers[0].dstQueueFamilyIndex == computeFamily);
+        CORAL_EXPECT(barriers[0].oldLayout == vk::ImageLayout::eColorAttachmentOptimal);
+        CORAL_EXPECT(barriers[0].newLayout == vk::ImageLayout::eGeneral);
+        // The release made the writes available, the acquire has nothing to wait on
+        CORAL_EXPECT(!barriers[0].srcStageMask);
+
+        // Owned by the compute family from here on
+        fixture.tracker.Require(*fixture.image, acquire);
+        barriers = fixture.Flush();
+        CORAL_EXPECT(barriers.size() == 1);
+        CORAL_EXPECT(barriers[0].srcQueueFamilyIndex == barriers[0].dstQueueFamilyIndex);
+    }
+}
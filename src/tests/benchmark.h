@@ -0,0 +1,13 @@
+//
+// Created by radue on 10/17/2026.
+//
+
+#pragma once
+
+#include "utils/types.h"
+
+namespace Coral::Test {
+    // Times allocate/free pairs through the allocator against one vkAllocateMemory per resource and prints both.
+    // allocationCount stays well below maxMemoryAllocationCount, which the driver path keeps live at once.
+    void BenchmarkAllocator(u32 allocationCount = 1024, u32 rounds = 32);
+}
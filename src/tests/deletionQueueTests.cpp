@@ -0,0 +1,117 @@
+//
+// Created by radue on 10/17/2026.
+//
+
+#include "selfTest.h"
+
+#include <memory>
+#include <vector>
+
+#include "context.h"
+#include "core/deletionQueue.h"
+#include "core/device.h"
+
+namespace Coral::Test {
+    namespace {
+        // Whatever the engine retired before is destroyed first, so only the test's batches remain.
+        // Leaving flushes too, no batch may outlive the queue it was stamped with.
+        class Fixture {
+        public:
+            Fixture() {
+                Context::Device()->waitIdle();
+                Context::DeletionQueue().Flush();
+                queue = Context::Device().RequestQueue(vk::QueueFlagBits::eGraphics);
+            }
+
+            ~Fixture() {
+                Context::Device()->waitIdle();
+                Context::DeletionQueue().Flush();
+            }
+
+            void Retire(const u32 id) {
+                Context::DeletionQueue().Retire([this, id] { destroyed.emplace_back(id); });
+            }
+
+            // Signals the next timeline value of the queue and waits for it
+            static void Complete(const Core::Queue& target) {
+                target.Wait(target.Submit({ Core::Queue::Submission {} }));
+            }
+
+            std::unique_ptr<Core::Queue> queue;
+            std::vector<u32> destroyed;
+        };
+    }
+
+    CORAL_TEST(DeletionQueue, WaitsForTheFrame) {
+        Fixture fixture;
+        auto& deletionQueue = Context::DeletionQueue();
+        fixture.Retire(1);
+        deletionQueue.Collect();
+        // Not even stamped yet
+        CORAL_EXPECT(fixture.destroyed.empty());
+
+        deletionQueue.EndFrame(*fixture.queue, fixture.queue->SubmittedValue() + 1);
+        deletionQueue.Collect();
+        CORAL_EXPECT(fixture.destroyed.empty());
+
+        fixture.Complete(*fixture.queue);
+        deletionQueue.Collect();
+        CORAL_EXPECT(fixture.destroyed == std::vector<u32>({ 1 }));
+    }
+
+    CORAL_TEST(DeletionQueue, RetiresFramesInOrder) {
+        Fixture fixture;
+        auto& deletionQueue = Context::DeletionQueue();
+        const auto base = fixture.queue->SubmittedValue();
+        for (u32 frame = 1; frame <= 3; frame++) {
+            fixture.Retire(frame * 10);
+            fixture.Retire(frame * 10 + 1);
+            deletionQueue.EndFrame(*fixture.queue, base + frame);
+        }
+
+        fixture.Complete(*fixture.queue);
+        deletionQueue.Collect();
+        CORAL_EXPECT(fixture.destroyed == std::vector<u32>({ 10, 11 }));
+
+        fixture.Complete(*fixture.queue);
+        fixture.Complete(*fixture.queue);
+        deletionQueue.Collect();
+        CORAL_EXPECT(fixture.destroyed == std::vector<u32>({ 10, 11, 20, 21, 30, 31 }));
+    }
+
+    CORAL_TEST(DeletionQueue, StopsAtTheFirstFrameInFlight) {
+        Fixture fixture;
+        auto& deletionQueue = Context::DeletionQueue();
+        const auto other = Context::Device().RequestQueue(vk::QueueFlagBits::eGraphics);
+
+        fixture.Retire(1);
+        deletionQueue.EndFrame(*fixture.queue, fixture.queue->SubmittedValue() + 1);
+        // Stamped on another timeline that already completed, it still waits for the batch ahead of it
+        fixture.Complete(*other);
+        fixture.Retire(2);
+        deletionQueue.EndFrame(*other, other->SubmittedValue());
+        deletionQueue.Collect();
+        CORAL_EXPECT(fixture.destroyed.empty());
+
+        fixture.Complete(*fixture.queue);
+        deletionQueue.Collect();
+        CORAL_EXPECT(fixture.destroyed == std::vector<u32>({ 1, 2 }));
+    }
+
+    CORAL_TEST(DeletionQueue, DeletersMayRetireMore) {
+        Fixture fixture;
+        auto& deletionQueue = Context::DeletionQueue();
+        deletionQueue.Retire([&fixture] {
+            fixture.destroyed.emplace_back(1);
+            // Owned by the first one, lands in the frame being recorded
+            fixture.Retire(2);
+        });
+        deletionQueue.EndFrame(*fixture.queue, fixture.queue->SubmittedValue() + 1);
+        fixture.Complete(*fixture.queue);
+        deletionQueue.Collect();
+        CORAL_EXPECT(fixture.destroyed == std::vector<u32>({ 1 }));
+
+        deletionQueue.Flush();
+        CORAL_EXPECT(fixture.destroyed == std::vector<u32>({ 1, 2 }));
+    }
+}
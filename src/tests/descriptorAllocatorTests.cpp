@@ -0,0 +1,104 @@
+//
+// Created by radue on 10/17/2026.
+//
+
+#include "selfTest.h"
+
+#include <stdexcept>
+#include <tuple>
+#include <vector>
+
+#include "memory/descriptor/allocator.h"
+
+namespace Coral::Test {
+    namespace {
+        using Descriptor = Memory::Descriptor::Allocator;
+
+        // Pools of 2, 4, 4, ... sets holding one uniform buffer each
+        Descriptor::CreateInfo SmallPools(const bool transient = false) {
+            return Descriptor::CreateInfo {
+                .descriptorsPerSet = { { vk::DescriptorType::eUniformBuffer, 1 } },
+                .initialSetCount = 2,
+                .maxSetCount = 4,
+                .transient = transient,
+            };
+        }
+
+        std::unique_ptr<Memory::Descriptor::SetLayout> UniformLayout() {
+            return Memory::Descriptor::SetLayout::Builder()
+                .AddBinding(0, vk::DescriptorType::eUniformBuffer, vk::ShaderStageFlagBits::eVertex)
+                .Build();
+        }
+    }
+
+    CORAL_TEST(DescriptorAllocator, GrowsWhenFull) {
+        Descriptor allocator(SmallPools());
+        const auto layout = UniformLayout();
+        std::vector<Descriptor::Allocation> allocations;
+        for (u32 i = 0; i < 2; i++) {
+            allocations.emplace_back(allocator.Allocate(*layout));
+        }
+        CORAL_EXPECT(allocator.PoolCount() == 1);
+
+        allocations.emplace_back(allocator.Allocate(*layout));
+        CORAL_EXPECT(allocator.PoolCount() == 2);
+        CORAL_EXPECT(allocations.back().pool == 1);
+
+        // The second pool is twice as large, the third one stops at the limit
+        for (u32 i = 0; i < 3; i++) {
+            allocations.emplace_back(allocator.Allocate(*layout));
+        }
+        CORAL_EXPECT(allocator.PoolCount() == 2);
+        allocations.emplace_back(allocator.Allocate(*layout));
+        CORAL_EXPECT(allocator.PoolCount() == 3);
+        for (const auto& allocation : allocations) {
+            CORAL_EXPECT(allocation.set);
+        }
+    }
+
+    CORAL_TEST(DescriptorAllocator, ReusesEmptiedPools) {
+        Descriptor allocator(SmallPools());
+        const auto layout = UniformLayout();
+        std::vector<Descriptor::Allocation> first;
+        for (u32 i = 0; i < 2; i++) {
+            first.emplace_back(allocator.Allocate(*layout));
+        }
+        std::vector<Descriptor::Allocation> second;
+        for (u32 i = 0; i < 4; i++) {
+            second.emplace_back(allocator.Allocate(*layout));
+        }
+        CORAL_EXPECT(allocator.PoolCount() == 2);
+
+        // The first pool left the rotation when it filled up, emptying it brings it back instead of a new pool
+        for (const auto& allocation : first) {
+            allocator.Free(allocation);
+        }
+        const auto reused = allocator.Allocate(*layout);
+        CORAL_EXPECT(reused.pool == 0);
+        CORAL_EXPECT(allocator.PoolCount() == 2);
+    }
+
+    CORAL_TEST(DescriptorAllocator, TransientPoolsResetAsAWhole) {
+        Descriptor allocator(SmallPools(true));
+        const auto layout = UniformLayout();
+        for (u32 i = 0; i < 6; i++) {
+            std::ignore = allocator.Allocate(*layout);
+        }
+        CORAL_EXPECT(allocator.PoolCount() == 2);
+
+        bool threw = false;
+        try {
+            allocator.Free(allocator.Allocate(*layout));
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+        CORAL_EXPECT(threw);
+
+        // Every pool, including the one the throwing allocation created, is empty again and the next frame fits without growing
+        allocator.Reset();
+        for (u32 i = 0; i < 6; i++) {
+            std::ignore = allocator.Allocate(*layout);
+        }
+        CORAL_EXPECT(allocator.PoolCount() == 3);
+    }
+}
@@ -0,0 +1,76 @@
+//
+// Created by radue on 10/17/2026.
+//
+
+#include "selfTest.h"
+
+#include <tuple>
+
+#include "graphics/geometryPool.h"
+
+namespace Coral::Test {
+    namespace {
+        using FreeList = Graphics::GeometryPool::FreeList;
+
+        // Three ranges of ten at 0, 10 and 20, the rest taken so nothing merges with the tail
+        FreeList Filled() {
+            FreeList list(100);
+            for (const u32 count : { 10u, 10u, 10u, 70u }) {
+                std::ignore = list.Allocate(count);
+            }
+            return list;
+        }
+    }
+
+    CORAL_TEST(GeometryPool, AllocationsSplitTheFirstFit) {
+        FreeList list(100);
+        CORAL_EXPECT(list.Allocate(30) == 0u);
+        CORAL_EXPECT(list.Allocate(20) == 30u);
+        CORAL_EXPECT(list.Used() == 50);
+        CORAL_EXPECT(list.RangeCount() == 1);
+        // Empty requests take nothing
+        CORAL_EXPECT(list.Allocate(0) == 0u);
+        CORAL_EXPECT(list.Used() == 50);
+    }
+
+    CORAL_TEST(GeometryPool, FreeMergesWithTheRangeBefore) {
+        auto list = Filled();
+        CORAL_EXPECT(list.RangeCount() == 0);
+        list.Free(0, 10);
+        list.Free(10, 10);
+        CORAL_EXPECT(list.RangeCount() == 1);
+        CORAL_EXPECT(list.Allocate(20) == 0u);
+    }
+
+    CORAL_TEST(GeometryPool, FreeMergesWithTheRangeAfter) {
+        auto list = Filled();
+        list.Free(20, 10);
+        list.Free(10, 10);
+        CORAL_EXPECT(list.RangeCount() == 1);
+        CORAL_EXPECT(list.Allocate(20) == 10u);
+    }
+
+    CORAL_TEST(GeometryPool, FreeBridgesBothNeighbours) {
+        auto list = Filled();
+        list.Free(0, 10);
+        list.Free(20, 10);
+        CORAL_EXPECT(list.RangeCount() == 2);
+        list.Free(10, 10);
+        CORAL_EXPECT(list.RangeCount() == 1);
+        CORAL_EXPECT(list.Used() == 70);
+        CORAL_EXPECT(list.Allocate(30) == 0u);
+    }
+
+    CORAL_TEST(GeometryPool, ExhaustedListsFail) {
+        FreeList list(10);
+        CORAL_EXPECT(list.Allocate(10) == 0u);
+        CORAL_EXPECT(!list.Allocate(1));
+
+        // Enough space in total, but not in one range
+        list.Free(0, 3);
+        list.Free(5, 3);
+        CORAL_EXPECT(list.Used() == 4);
+        CORAL_EXPECT(!list.Allocate(4));
+        CORAL_EXPECT(list.Allocate(3) == 0u);
+    }
+}
@@ -0,0 +1,70 @@
+//
+// Created by radue on 10/17/2026.
+//
+
+#include "selfTest.h"
+
+#include <vector>
+
+#include "context.h"
+#include "memory/descriptor/layoutCache.h"
+
+namespace Coral::Test {
+    namespace {
+        using Builder = Memory::Descriptor::SetLayout::Builder;
+
+        // Compute-only bindings past any the engine declares, so the engine's own layouts never collide with the test's
+        constexpr auto Stages = vk::ShaderStageFlags(vk::ShaderStageFlagBits::eCompute);
+    }
+
+    CORAL_TEST(LayoutCache, SharesIdenticalSetLayouts) {
+        auto& cache = Context::LayoutCache();
+        const auto count = cache.SetLayoutCount();
+        // Bindings added in another order describe the same layout
+        const auto first = cache.AcquireSetLayout(Builder()
+            .AddBinding(14, vk::DescriptorType::eUniformBuffer, Stages)
+            .AddBinding(15, vk::DescriptorType::eCombinedImageSampler, Stages, 4));
+        const auto second = cache.AcquireSetLayout(Builder()
+            .AddBinding(15, vk::DescriptorType::eCombinedImageSampler, Stages, 4)
+            .AddBinding(14, vk::DescriptorType::eUniformBuffer, Stages));
+        CORAL_EXPECT(first == second);
+        CORAL_EXPECT(cache.SetLayoutCount() == count + 1);
+
+        const auto other = cache.AcquireSetLayout(Builder()
+            .AddBinding(14, vk::DescriptorType::eUniformBuffer, Stages)
+            .AddBinding(15, vk::DescriptorType::eCombinedImageSampler, Stages, 4)
+            .BindingFlags(15, vk::DescriptorBindingFlagBits::ePartiallyBound));
+        CORAL_EXPECT(other != first);
+        CORAL_EXPECT(cache.SetLayoutCount() == count + 2);
+    }
+
+    CORAL_TEST(LayoutCache, SharesIdenticalPipelineLayouts) {
+        auto& cache = Context::LayoutCache();
+        const auto builders = std::vector { Builder().AddBinding(14, vk::DescriptorType::eStorageBuffer, Stages) };
+        const auto count = cache.PipelineLayoutCount();
+        // Push constant ranges are sorted before they are compared
+        const auto first = cache.AcquirePipelineLayout(builders, { { Stages, 0, 16 }, { Stages, 16, 16 } });
+        const auto second = cache.AcquirePipelineLayout(builders, { { Stages, 16, 16 }, { Stages, 0, 16 } });
+        CORAL_EXPECT(first == second);
+        CORAL_EXPECT(cache.PipelineLayoutCount() == count + 1);
+        CORAL_EXPECT(first->SetLayouts().front() == cache.AcquireSetLayout(builders.front()));
+
+        const auto other = cache.AcquirePipelineLayout(builders, { { Stages, 0, 32 } });
+        CORAL_EXPECT(other != first);
+        CORAL_EXPECT(cache.PipelineLayoutCount() == count + 2);
+    }
+
+    CORAL_TEST(LayoutCache, ReleasedLayoutsLeaveTheCache) {
+        auto& cache = Context::LayoutCache();
+        const auto setLayouts = cache.SetLayoutCount();
+        const auto pipelineLayouts = cache.PipelineLayoutCount();
+        {
+            const auto layout = cache.AcquirePipelineLayout({ Builder().AddBinding(13, vk::DescriptorType::eStorageImage, Stages) }, {});
+            CORAL_EXPECT(cache.SetLayoutCount() == setLayouts + 1);
+            CORAL_EXPECT(cache.PipelineLayoutCount() == pipelineLayouts + 1);
+        }
+        // The pipeline layout held the only reference to its set layout
+        CORAL_EXPECT(cache.SetLayoutCount() == setLayouts);
+        CORAL_EXPECT(cache.PipelineLayoutCount() == pipelineLayouts);
+    }
+}
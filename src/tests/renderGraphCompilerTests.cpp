@@ -0,0 +1,227 @@
+//
+// Created by radue on 10/17/2026.
+//
+
+#include "selfTest.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <tuple>
+
+#include <nlohmann/json.hpp>
+
+#include "project/renderGraphCompiler.h"
+
+namespace Coral::Test {
+    namespace {
+        using Compiler = Project::RenderGraphCompiler;
+
+        // Copy passes need neither shaders nor attachments, only the resources they move between
+        nlohmann::json Graph(const nlohmann::json& passes) {
+            const auto resource = nlohmann::json {
+                { "format", "vk::Format::eR8G8B8A8Unorm" },
+                { "usage", nlohmann::json::array({ "vk::ImageUsageFlagBits::eTransferSrc", "vk::ImageUsageFlagBits::eTransferDst" }) }
+            };
+            return nlohmann::json {
+                { "output", "out" },
+                { "resources", { { "a", resource }, { "b", resource }, { "c", resource }, { "d", resource }, { "out", resource } } },
+                { "renderPasses", passes }
+            };
+        }
+
+        nlohmann::json CopyPass(const String& name, const String& source, const String& destination, const String& queue = "graphics") {
+            return nlohmann::json {
+                { "name", name },
+                { "queue", queue },
+                { "copies", nlohmann::json::array({ { { "source", source }, { "destination", destination } } }) }
+            };
+        }
+
+        nlohmann::json Attachment(const String& resource, const String& loadOp, const String& storeOp, const String& finalLayout) {
+            return nlohmann::json {
+                { "resource", resource },
+                { "description", {
+                    { "loadOp", loadOp },
+                    { "storeOp", storeOp },
+                    { "initialLayout", loadOp == "eLoad" ? "eColorAttachmentOptimal" : "eUndefined" },
+                    { "finalLayout", finalLayout }
+                } }
+            };
+        }
+
+        nlohmann::json Reference(const u32 attachment, const String& layout) {
+            return nlohmann::json { { "attachment", attachment }, { "layout", layout } };
+        }
+
+        // Clears b, then a second pass reads it as an input attachment while drawing the output
+        nlohmann::json MergeableGraph() {
+            return Graph(nlohmann::json::array({
+                {
+                    { "name", "scene" },
+                    { "attachments", nlohmann::json::array({ Attachment("b", "eClear", "eStore", "eColorAttachmentOptimal") }) },
+                    { "subpasses", nlohmann::json::array({
+                        { { "colorAttachments", nlohmann::json::array({ Reference(0, "eColorAttachmentOptimal") }) } }
+                    }) }
+                },
+                {
+                    { "name", "lighting" },
+                    { "attachments", nlohmann::json::array({
+                        Attachment("out", "eClear", "eStore", "eTransferSrcOptimal"),
+                        Attachment("b", "eLoad", "eDontCare", "eShaderReadOnlyOptimal")
+                    }) },
+                    { "subpasses", nlohmann::json::array({ {
+                        { "colorAttachments", nlohmann::json::array({ Reference(0, "eColorAttachmentOptimal") }) },
+                        { "inputAttachments", nlohmann::json::array({ Reference(1, "eShaderReadOnlyOptimal") }) }
+                    } }) }
+                }
+            }));
+        }
+
+        std::vector<String> Names(const Compiler::Result& result) {
+            std::vector<String> names;
+            for (const auto& pass : result.passes) {
+                names.emplace_back(pass.name);
+            }
+            return names;
+        }
+    }
+
+    CORAL_TEST(RenderGraphCompiler, SortsByResourceFlow) {
+        // Declared backwards, readers ahead of their writers still wait for them
+        const auto result = Compiler::Compile(Graph({
+            CopyPass("resolve", "c", "out"),
+            CopyPass("blur", "b", "c"),
+            CopyPass("scene", "a", "b")
+        }));
+        CORAL_EXPECT(Names(result) == std::vector<String>({ "scene", "blur", "resolve" }));
+        CORAL_EXPECT(result.outputPass == "resolve");
+        CORAL_EXPECT(result.culled.empty());
+    }
+
+    CORAL_TEST(RenderGraphCompiler, CullsPassesNotReachingTheOutput) {
+        const auto result = Compiler::Compile(Graph({
+            CopyPass("scene", "a", "b"),
+            CopyPass("debug", "a", "d"),
+            CopyPass("resolve", "b", "out")
+        }));
+        CORAL_EXPECT(Names(result) == std::vector<String>({ "scene", "resolve" }));
+        CORAL_EXPECT(result.culled == std::vector<String>({ "debug" }));
+        // Only what the surviving passes touch is allocated
+        CORAL_EXPECT(std::ranges::find(result.resources, "d", &Compiler::Resource::name) == result.resources.end());
+    }
+
+    CORAL_TEST(RenderGraphCompiler, KeepsPassesWithSideEffects) {
+        auto debug = CopyPass("debug", "a", "d");
+        debug["sideEffects"] = true;
+        const auto result = Compiler::Compile(Graph({ CopyPass("scene", "a", "b"), debug, CopyPass("resolve", "b", "out") }));
+        CORAL_EXPECT(result.culled.empty());
+        CORAL_EXPECT(std::ranges::find(result.passes, "debug", &Compiler::Pass::name) != result.passes.end());
+    }
+
+    CORAL_TEST(RenderGraphCompiler, OnlyTheLastOutputWriterIsKept) {
+        // Nothing reads the first write of the output, the second one overwrites it
+        const auto result = Compiler::Compile(Graph({ CopyPass("early", "a", "out"), CopyPass("late", "b", "out") }));
+        CORAL_EXPECT(Names(result) == std::vector<String>({ "late" }));
+        CORAL_EXPECT(result.culled == std::vector<String>({ "early" }));
+    }
+
+    CORAL_TEST(RenderGraphCompiler, RejectsCycles) {
+        bool threw = false;
+        try {
+            std::ignore = Compiler::Compile(Graph({ CopyPass("forth", "b", "c"), CopyPass("back", "c", "b"), CopyPass("resolve", "c", "out") }));
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+        CORAL_EXPECT(threw);
+    }
+
+    CORAL_TEST(RenderGraphCompiler, QueueChangesSplitRunNodes) {
+        const auto result = Compiler::Compile(Graph({
+            CopyPass("scene", "a", "b"),
+            CopyPass("stream", "b", "c", "transfer"),
+            CopyPass("resolve", "c", "out")
+        }));
+        CORAL_EXPECT(result.runNodes.size() == 3);
+        CORAL_EXPECT(result.runNodes[1].queue == vk::QueueFlagBits::eTransfer);
+        CORAL_EXPECT(result.runNodes[0].waits.empty());
+        CORAL_EXPECT(result.runNodes[1].waits == std::vector<u32>({ 0 }));
+        CORAL_EXPECT(result.runNodes[2].waits == std::vector<u32>({ 1 }));
+    }
+
+    CORAL_TEST(RenderGraphCompiler, ParsesExtensionEnumerators) {
+        auto graph = Graph({ CopyPass("resolve", "a", "out") });
+        graph["resources"]["out"]["initialLayout"] = "vk::ImageLayout::ePresentSrcKHR";
+        graph["resources"]["a"]["initialLayout"] = "eShaderReadOnlyOptimal";
+        const auto result = Compiler::Compile(graph);
+        const auto resource = [&](const String& name) { return *std::ranges::find(result.resources, name, &Compiler::Resource::name); };
+        CORAL_EXPECT(resource("out").initialLayout == vk::ImageLayout::ePresentSrcKHR);
+        CORAL_EXPECT(resource("a").initialLayout == vk::ImageLayout::eShaderReadOnlyOptimal);
+
+        graph["resources"]["a"]["initialLayout"] = "eNotALayout";
+        bool threw = false;
+        try {
+            std::ignore = Compiler::Compile(graph);
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+        CORAL_EXPECT(threw);
+    }
+
+    CORAL_TEST(RenderGraphCompiler, MergesPassesSharingAttachments) {
+        const auto result = Compiler::Compile(MergeableGraph());
+        CORAL_EXPECT(Names(result) == std::vector<String>({ "scene+lighting" }));
+        CORAL_EXPECT(result.runNodes.size() == 1 && result.runNodes[0].passes == std::vector<String>({ "scene+lighting" }));
+
+        const auto& pass = result.passes.front();
+        CORAL_EXPECT(pass.subpasses.size() == 2);
+        CORAL_EXPECT(pass.attachments.size() == 2);
+        // The second subpass' references point at the merged pass' attachments
+        CORAL_EXPECT(pass.subpasses[1].inputAttachments.front().attachment == 0);
+        CORAL_EXPECT(pass.subpasses[1].colorAttachments.front().attachment == 1);
+
+        // Loaded as the first user left it, stored as the last user wants it
+        const auto& b = pass.attachments[0].description;
+        CORAL_EXPECT(pass.attachments[0].resource == "b");
+        CORAL_EXPECT(b.loadOp == vk::AttachmentLoadOp::eClear);
+        CORAL_EXPECT(b.storeOp == vk::AttachmentStoreOp::eDontCare);
+        CORAL_EXPECT(b.initialLayout == vk::ImageLayout::eUndefined);
+        CORAL_EXPECT(b.finalLayout == vk::ImageLayout::eShaderReadOnlyOptimal);
+        CORAL_EXPECT(pass.attachments[1].resource == "out");
+        CORAL_EXPECT(pass.attachments[1].description.storeOp == vk::AttachmentStoreOp::eStore);
+        CORAL_EXPECT(pass.outputAttachmentIndex == 1);
+
+        CORAL_EXPECT(pass.dependencies.size() == 1);
+        const auto& dependency = pass.dependencies.front();
+        CORAL_EXPECT(dependency.srcSubpass == 0 && dependency.dstSubpass == 1);
+        CORAL_EXPECT(dependency.srcStageMask == vk::PipelineStageFlagBits::eColorAttachmentOutput);
+        CORAL_EXPECT(dependency.srcAccessMask == vk::AccessFlagBits::eColorAttachmentWrite);
+        CORAL_EXPECT(dependency.dstStageMask == vk::PipelineStageFlagBits::eFragmentShader);
+        CORAL_EXPECT(dependency.dstAccessMask == vk::AccessFlagBits::eInputAttachmentRead);
+        CORAL_EXPECT(dependency.dependencyFlags == vk::DependencyFlagBits::eByRegion);
+    }
+
+    CORAL_TEST(RenderGraphCompiler, MergingCanBeTurnedOff) {
+        const auto check = [](const Compiler::Result& result) {
+            CORAL_EXPECT(Names(result) == std::vector<String>({ "scene", "lighting" }));
+            for (const auto& pass : result.passes) {
+                CORAL_EXPECT(pass.subpasses.size() == 1);
+                CORAL_EXPECT(pass.dependencies.empty());
+            }
+            // Handed over through memory, so the first pass keeps storing it
+            CORAL_EXPECT(result.passes.front().attachments.front().description.storeOp == vk::AttachmentStoreOp::eStore);
+        };
+        check(Compiler::Compile(MergeableGraph(), false));
+
+        auto graph = MergeableGraph();
+        graph["renderPasses"][1]["merge"] = false;
+        check(Compiler::Compile(graph));
+    }
+
+    CORAL_TEST(RenderGraphCompiler, ClearingASharedAttachmentPreventsMerging) {
+        auto graph = MergeableGraph();
+        graph["renderPasses"][0]["sideEffects"] = true;
+        graph["renderPasses"][1]["attachments"][1]["description"]["loadOp"] = "eClear";
+        // A render pass clears an attachment only when it is first used
+        CORAL_EXPECT(Names(Compiler::Compile(graph)) == std::vector<String>({ "scene", "lighting" }));
+    }
+}
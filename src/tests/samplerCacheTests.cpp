@@ -0,0 +1,38 @@
+//
+// Created by radue on 10/17/2026.
+//
+
+#include "selfTest.h"
+
+#include "context.h"
+#include "memory/samplerCache.h"
+
+namespace Coral::Test {
+    CORAL_TEST(SamplerCache, SharesEqualDescriptions) {
+        const auto count = Context::SamplerCache().Count();
+        const auto first = Context::SamplerCache().Acquire(Memory::Sampler::CreateInfo { .mipLodBias = 0.25f });
+        const auto second = Context::SamplerCache().Acquire(Memory::Sampler::CreateInfo { .mipLodBias = 0.25f });
+        CORAL_EXPECT(first == second);
+        CORAL_EXPECT(Context::SamplerCache().Count() == count + 1);
+
+        const auto other = Context::SamplerCache().Acquire(Memory::Sampler::CreateInfo { .mipLodBias = 0.5f });
+        CORAL_EXPECT(other != first);
+        CORAL_EXPECT(Context::SamplerCache().Count() == count + 2);
+    }
+
+    CORAL_TEST(SamplerCache, SignedZerosAreOneKey) {
+        const auto positive = Context::SamplerCache().Acquire(Memory::Sampler::CreateInfo { .mipLodBias = 0.0f, .minLod = 0.0f });
+        const auto negative = Context::SamplerCache().Acquire(Memory::Sampler::CreateInfo { .mipLodBias = -0.0f, .minLod = -0.0f });
+        CORAL_EXPECT(positive == negative);
+    }
+
+    CORAL_TEST(SamplerCache, ReleasedSamplersAreRecreated) {
+        const auto count = Context::SamplerCache().Count();
+        {
+            const auto sampler = Context::SamplerCache().Acquire(Memory::Sampler::CreateInfo { .maxAnisotropy = 3.0f });
+            CORAL_EXPECT(Context::SamplerCache().Count() == count + 1);
+        }
+        CORAL_EXPECT(Context::SamplerCache().Count() == count);
+        CORAL_EXPECT(Context::SamplerCache().Acquire(Memory::Sampler::CreateInfo { .maxAnisotropy = 3.0f }));
+    }
+}
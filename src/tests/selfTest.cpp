@@ -0,0 +1,59 @@
+//
+// Created by radue on 10/17/2026.
+//
+
+#include "selfTest.h"
+
+#include <format>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+
+namespace Coral::Test {
+    namespace {
+        struct Entry {
+            const char* name;
+            std::function<void()> function;
+        };
+
+        // Registrations run during static initialization, in whatever order the translation units are initialized
+        std::vector<Entry>& Registry() {
+            static std::vector<Entry> registry;
+            return registry;
+        }
+    }
+
+    Registration::Registration(const char* name, std::function<void()> function) {
+        Registry().emplace_back(Entry { .name = name, .function = std::move(function) });
+    }
+
+    void Expect(const bool condition, const std::string_view expression, const std::source_location location) {
+        if (!condition) {
+            throw std::runtime_error(std::format("{}:{} : expected {}", location.file_name(), location.line(), expression));
+        }
+    }
+
+    u32 RunAll(const std::string_view filter) {
+        u32 run = 0;
+        u32 failed = 0;
+        for (const auto& [name, function] : Registry()) {
+            if (!std::string_view(name).starts_with(filter)) {
+                continue;
+            }
+            run++;
+            try {
+                function();
+                std::cout << "[ PASS ] " << name << std::endl;
+            } catch (const std::exception& e) {
+                failed++;
+                std::cerr << "[ FAIL ] " << name << " : " << e.what() << std::endl;
+            }
+        }
+        std::cout << std::format("{} of {} tests passed", run - failed, run) << std::endl;
+        if (run == 0) {
+            std::cerr << "No test matches " << filter << std::endl;
+            return 1;
+        }
+        return failed;
+    }
+}
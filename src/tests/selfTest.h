@@ -0,0 +1,36 @@
+//
+// Created by radue on 10/17/2026.
+//
+
+#pragma once
+
+#include <functional>
+#include <source_location>
+#include <string_view>
+
+#include "utils/types.h"
+
+namespace Coral::Test {
+    // Tests run inside a headless engine, so the device, the allocator and every cache are available. A failed
+    // expectation throws, which ends the test it belongs to.
+    class Registration {
+    public:
+        Registration(const char* name, std::function<void()> function);
+    };
+
+    void Expect(bool condition, std::string_view expression, std::source_location location = std::source_location::current());
+
+    // Runs every test whose name starts with filter and returns how many failed
+    [[nodiscard]] u32 RunAll(std::string_view filter = {});
+}
+
+#define CORAL_TEST_CONCAT_IMPL(a, b) a##b
+#define CORAL_TEST_CONCAT(a, b) CORAL_TEST_CONCAT_IMPL(a, b)
+
+// Names are Group.Case, --self-test Group runs a single group
+#define CORAL_TEST(group, name) \
+    static void group##_##name(); \
+    static const ::Coral::Test::Registration CORAL_TEST_CONCAT(registration_, __LINE__)(#group "." #name, group##_##name); \
+    static void group##_##name()
+
+#define CORAL_EXPECT(condition) ::Coral::Test::Expect(static_cast<bool>(condition), #condition)
@@ -0,0 +1,65 @@
+//
+// Created by radue on 10/17/2026.
+//
+
+#include "selfTest.h"
+
+#include "memory/stagingRing.h"
+
+namespace Coral::Test {
+    CORAL_TEST(StagingRing, RejectsEmptyAndOversizedRequests) {
+        auto ring = Memory::StagingRing(256);
+        CORAL_EXPECT(!ring.Allocate(0, 1));
+        CORAL_EXPECT(!ring.Allocate(257, 1));
+        CORAL_EXPECT(ring.Allocate(256, 1));
+        CORAL_EXPECT(ring.Used() == 256);
+    }
+
+    CORAL_TEST(StagingRing, WrapsWithoutSplittingAllocations) {
+        auto ring = Memory::StagingRing(256);
+        const auto first = ring.Allocate(100, 1);
+        const auto second = ring.Allocate(100, 1);
+        CORAL_EXPECT(first && first->offset == 0);
+        CORAL_EXPECT(second && second->offset == 100);
+        CORAL_EXPECT(second->data == first->data + 100);
+
+        // 56 bytes are left before the end, the allocation would have to wrap onto memory still in use
+        CORAL_EXPECT(!ring.Allocate(100, 1));
+        CORAL_EXPECT(ring.Head() == 200);
+
+        ring.Release(50);
+        CORAL_EXPECT(!ring.Allocate(100, 1));
+        ring.Release(200);
+        const auto wrapped = ring.Allocate(100, 1);
+        CORAL_EXPECT(wrapped && wrapped->offset == 0);
+        CORAL_EXPECT(wrapped->data == first->data);
+        // The tail of the previous lap is skipped and counts as used until released
+        CORAL_EXPECT(ring.Head() == 356);
+        CORAL_EXPECT(ring.Used() == 156);
+    }
+
+    CORAL_TEST(StagingRing, AlignsAcrossLaps) {
+        auto ring = Memory::StagingRing(256);
+        CORAL_EXPECT(ring.Allocate(200, 1));
+        ring.Release(ring.Head());
+
+        const auto aligned = ring.Allocate(10, 64);
+        CORAL_EXPECT(aligned && aligned->offset == 0);
+        CORAL_EXPECT(ring.Head() == 266);
+
+        const auto next = ring.Allocate(10, 64);
+        CORAL_EXPECT(next && next->offset == 64);
+    }
+
+    CORAL_TEST(StagingRing, ReleaseNeverPassesTheHead) {
+        auto ring = Memory::StagingRing(256);
+        CORAL_EXPECT(ring.Allocate(64, 1));
+        ring.Release(1000);
+        CORAL_EXPECT(ring.Used() == 0);
+        ring.Release(0);
+        CORAL_EXPECT(ring.Used() == 0);
+        // The rest of the lap is free again
+        const auto rest = ring.Allocate(192, 1);
+        CORAL_EXPECT(rest && rest->offset == 64);
+    }
+}
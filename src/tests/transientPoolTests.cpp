@@ -0,0 +1,102 @@
+//
+// Created by radue on 10/17/2026.
+//
+
+#include "selfTest.h"
+
+#include <tuple>
+#include <vector>
+
+#include "memory/transientPool.h"
+#include "project/renderGraph.h"
+
+namespace Coral::Test {
+    namespace {
+        using Graph = Project::RenderGraph;
+        using Lifetime = Memory::TransientPool::Lifetime;
+
+        Graph::AttachmentUse Use(const String& image, const vk::AttachmentLoadOp loadOp, const vk::AttachmentStoreOp storeOp,
+            const bool attachment = true) {
+            return Graph::AttachmentUse {
+                .image = image,
+                .description = vk::AttachmentDescription()
+                    .setFormat(vk::Format::eR8G8B8A8Unorm)
+                    .setLoadOp(loadOp)
+                    .setStoreOp(storeOp)
+                    .setStencilLoadOp(vk::AttachmentLoadOp::eDontCare)
+                    .setStencilStoreOp(vk::AttachmentStoreOp::eDontCare)
+                    .setInitialLayout(loadOp == vk::AttachmentLoadOp::eLoad ? vk::ImageLayout::eColorAttachmentOptimal : vk::ImageLayout::eUndefined),
+                .attachment = attachment,
+            };
+        }
+
+        // Same size and usage, so every image fits every slot its lifetime allows
+        Memory::Image::Builder Attachment() {
+            return Memory::Image::Builder()
+                .Format(vk::Format::eR8G8B8A8Unorm)
+                .Extent({ 64u, 64u, 1u })
+                .UsageFlags(vk::ImageUsageFlagBits::eColorAttachment)
+                .UsageFlags(vk::ImageUsageFlagBits::eSampled);
+        }
+
+        u32 SlotCount(const std::vector<Lifetime>& lifetimes) {
+            Memory::TransientPool pool;
+            for (const auto& lifetime : lifetimes) {
+                std::ignore = pool.Add(Attachment(), lifetime);
+            }
+            pool.Bind();
+            CORAL_EXPECT(pool.Stats().imageCount == lifetimes.size());
+            CORAL_EXPECT(pool.Stats().allocatedBytes <= pool.Stats().requestedBytes);
+            return pool.Stats().slotCount;
+        }
+    }
+
+    CORAL_TEST(TransientPool, LifetimesSpanFirstToLastUse) {
+        const auto lifetimes = Graph::AnalyzeLifetimes({
+            { Use("gbuffer", vk::AttachmentLoadOp::eClear, vk::AttachmentStoreOp::eStore) },
+            { Use("gbuffer", vk::AttachmentLoadOp::eLoad, vk::AttachmentStoreOp::eDontCare),
+                Use("scratch", vk::AttachmentLoadOp::eDontCare, vk::AttachmentStoreOp::eDontCare) },
+            { Use("output", vk::AttachmentLoadOp::eClear, vk::AttachmentStoreOp::eStore) },
+        });
+
+        const auto& gbuffer = lifetimes.at("gbuffer");
+        CORAL_EXPECT(gbuffer.lifetime.first == 0 && gbuffer.lifetime.last == 1);
+        CORAL_EXPECT(gbuffer.transient);
+        // Stored for the next pass, so it has to reach memory
+        CORAL_EXPECT(!gbuffer.lazilyAllocated);
+
+        const auto& scratch = lifetimes.at("scratch");
+        CORAL_EXPECT(scratch.lifetime.first == 1 && scratch.lifetime.last == 1);
+        CORAL_EXPECT(scratch.transient && scratch.lazilyAllocated);
+
+        // Stored at the end of the frame
+        CORAL_EXPECT(!lifetimes.at("output").transient);
+    }
+
+    CORAL_TEST(TransientPool, ContentsKeptOutsideAPassAreNotTransient) {
+        const auto lifetimes = Graph::AnalyzeLifetimes({
+            { Use("loaded", vk::AttachmentLoadOp::eLoad, vk::AttachmentStoreOp::eDontCare) },
+            { Use("copied", vk::AttachmentLoadOp::eClear, vk::AttachmentStoreOp::eStore) },
+            { Use("copied", vk::AttachmentLoadOp::eLoad, vk::AttachmentStoreOp::eDontCare, false) },
+        });
+        // Reads what an earlier frame left behind
+        CORAL_EXPECT(!lifetimes.at("loaded").transient);
+        // A copy reads it outside of a render pass
+        CORAL_EXPECT(!lifetimes.at("copied").transient);
+    }
+
+    CORAL_TEST(TransientPool, DisjointLifetimesShareASlot) {
+        CORAL_EXPECT(SlotCount({ { 0, 0 }, { 1, 1 }, { 2, 2 } }) == 1);
+    }
+
+    CORAL_TEST(TransientPool, OverlappingLifetimesGetSlotsOfTheirOwn) {
+        CORAL_EXPECT(SlotCount({ { 0, 2 }, { 1, 3 }, { 2, 2 } }) == 3);
+        // Sharing the last pass of one with the first pass of the other is an overlap too
+        CORAL_EXPECT(SlotCount({ { 0, 1 }, { 1, 2 } }) == 2);
+    }
+
+    CORAL_TEST(TransientPool, SlotsAreReusedOnceFree) {
+        // The first two share a slot, the third overlaps both and the fourth fits after either
+        CORAL_EXPECT(SlotCount({ { 0, 1 }, { 2, 3 }, { 1, 2 }, { 4, 4 } }) == 2);
+    }
+}
@@ -0,0 +1,94 @@
+//
+// Created by radue on 10/17/2026.
+//
+
+#include "selfTest.h"
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+
+#include "core/physicalDevice.h"
+#include "core/runtime.h"
+#include "memory/uniformRing.h"
+
+namespace Coral::Test {
+    namespace {
+        using Ring = Memory::UniformRing;
+
+        // Small regions so a handful of allocations exhausts one
+        std::unique_ptr<Ring> SmallRing() {
+            return std::make_unique<Ring>(Ring::CreateInfo { .regionCount = 2, .regionSize = 4096, .bindingRange = 256 });
+        }
+
+        bool Throws(Ring& ring, const vk::DeviceSize size) {
+            try {
+                std::ignore = ring.Allocate(size);
+            } catch (const std::runtime_error&) {
+                return true;
+            }
+            return false;
+        }
+    }
+
+    CORAL_TEST(UniformRing, OffsetsHonourTheDeviceAlignment) {
+        const auto ring = SmallRing();
+        const auto limits = Core::Runtime::Get().PhysicalDevice()->getProperties().limits;
+        CORAL_EXPECT(ring->Alignment() == std::max<vk::DeviceSize>(1, limits.minUniformBufferOffsetAlignment));
+        CORAL_EXPECT(ring->RegionSize() % ring->Alignment() == 0);
+
+        ring->Begin(0);
+        u32 previous = 0;
+        for (const vk::DeviceSize size : { 1ull, 3ull, 100ull, 17ull }) {
+            const auto allocation = ring->Allocate(size);
+            CORAL_EXPECT(allocation.offset % ring->Alignment() == 0);
+            CORAL_EXPECT(allocation.offset >= previous);
+            previous = allocation.offset;
+            // Only the start is padded
+            CORAL_EXPECT(ring->Used() == allocation.offset + size);
+        }
+    }
+
+    CORAL_TEST(UniformRing, RegionsWrapAround) {
+        const auto ring = SmallRing();
+        ring->Begin(0);
+        const auto first = ring->Push(u32 { 1 });
+        CORAL_EXPECT(first == 0);
+
+        // Each frame in flight has a region of its own
+        ring->Begin(1);
+        const auto second = ring->Push(u32 { 2 });
+        CORAL_EXPECT(second == ring->RegionSize());
+
+        // Back to the first region, which starts over from its beginning
+        ring->Begin(0);
+        CORAL_EXPECT(ring->Used() == 0);
+        CORAL_EXPECT(ring->Push(u32 { 3 }) == first);
+
+        bool threw = false;
+        try {
+            ring->Begin(2);
+        } catch (const std::runtime_error&) {
+            threw = true;
+        }
+        CORAL_EXPECT(threw);
+    }
+
+    CORAL_TEST(UniformRing, ExhaustedRegionsThrow) {
+        const auto ring = SmallRing();
+        ring->Begin(0);
+        const auto stride = (256 + ring->Alignment() - 1) / ring->Alignment() * ring->Alignment();
+        const auto fitting = (ring->RegionSize() - 256) / stride + 1;
+        for (u32 i = 0; i < fitting; i++) {
+            CORAL_EXPECT(!Throws(*ring, 256));
+        }
+        CORAL_EXPECT(Throws(*ring, 256));
+
+        // Larger than a shader can see through one binding, no matter how much space is left
+        ring->Begin(1);
+        CORAL_EXPECT(Throws(*ring, 257));
+        CORAL_EXPECT(Throws(*ring, 0));
+        CORAL_EXPECT(ring->Used() == 0);
+    }
+}